@@ -0,0 +1,22 @@
+#version 150
+
+uniform sampler2D m_samp0;
+in vec4 m_cord0;
+in vec4 m_colour;
+out vec4 fragColor;
+
+// SM_FONTS_SDF shader
+// m_samp0 holds the distance to the glyph outline, which is at 0.5
+void main ()
+{
+  float distance = texture(m_samp0, m_cord0.xy).r;
+  float width = 0.7 * fwidth(distance);
+  fragColor.r = m_colour.r;
+  fragColor.g = m_colour.g;
+  fragColor.b = m_colour.b;
+  fragColor.a = m_colour.a * smoothstep(0.5 - width, 0.5 + width, distance);
+#if defined(KODI_LIMITED_RANGE)
+  fragColor.rgb *= (235.0-16.0) / 255.0;
+  fragColor.rgb += 16.0 / 255.0;
+#endif
+}
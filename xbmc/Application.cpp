@@ -65,6 +65,7 @@
 #include "filesystem/PluginDirectory.h"
 #include "utils/SystemInfo.h"
 #include "utils/TimeUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "GUILargeTextureManager.h"
 #include "TextureCache.h"
 #include "playlists/SmartPlayList.h"
@@ -1495,6 +1496,8 @@ void CApplication::Render()
   if (m_bStop)
     return;
 
+  CTimelineScope timelineScope("app", "CApplication::Render");
+
   bool hasRendered = false;
 
   // Whether externalplayer is playing and we're unfocused
@@ -1548,6 +1551,7 @@ void CApplication::Render()
   if (hasRendered)
   {
     infoMgr.GetInfoProviders().GetSystemInfoProvider().UpdateFPS();
+    CTimelineProfiler::NextFrame();
   }
 
   CServiceBroker::GetWinSystem()->GetGfxContext().Flip(hasRendered, m_appPlayer.IsRenderingVideoLayer());
@@ -2312,6 +2316,8 @@ void CApplication::UnlockFrameMoveGuard()
 
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
+  CTimelineScope timelineScope("app", "CApplication::FrameMove");
+
   if (processEvents)
   {
     // currently we calculate the repeat time (ie time from last similar keypress) just global as fps
@@ -25,6 +25,7 @@
 #include "settings/SkinSettings.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
@@ -9305,6 +9306,8 @@ TIME_FORMAT CGUIInfoManager::TranslateTimeFormat(const std::string &format)
 
 std::string CGUIInfoManager::GetLabel(int info, int contextWindow, std::string *fallback) const
 {
+  CTimelineScope timelineScope("info", "CGUIInfoManager::GetLabel", true);
+
   if (info >= CONDITIONAL_LABEL_START && info <= CONDITIONAL_LABEL_END)
   {
     return GetSkinVariableString(info, false);
@@ -9378,6 +9381,8 @@ bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWin
 
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
 {
+  CTimelineScope timelineScope("info", "CGUIInfoManager::GetBool", true);
+
   bool bReturn = false;
   int condition = std::abs(condition1);
 
@@ -9618,6 +9623,8 @@ std::string CGUIInfoManager::GetMultiInfoLabel(const CGUIInfo &constinfo, int co
 /// \brief Obtains the filename of the image to show from whichever subsystem is needed
 std::string CGUIInfoManager::GetImage(int info, int contextWindow, std::string *fallback)
 {
+  CTimelineScope timelineScope("info", "CGUIInfoManager::GetImage", true);
+
   if (info >= CONDITIONAL_LABEL_START && info <= CONDITIONAL_LABEL_END)
   {
     return GetSkinVariableString(info, true);
@@ -9699,6 +9706,8 @@ void CGUIInfoManager::Clear()
 
 void CGUIInfoManager::UpdateAVInfo()
 {
+  CTimelineScope timelineScope("info", "CGUIInfoManager::UpdateAVInfo");
+
   if (CServiceBroker::GetDataCacheCore().HasAVInfoChanges())
   {
     VideoStreamInfo video;
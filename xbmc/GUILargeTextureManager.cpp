@@ -8,8 +8,11 @@
 
 #include "GUILargeTextureManager.h"
 
+#include "ServiceBroker.h"
 #include "TextureCache.h"
 #include "guilib/Texture.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "utils/JobManager.h"
@@ -19,11 +22,12 @@
 
 #include <cassert>
 
-CImageLoader::CImageLoader(const std::string &path, const bool useCache):
+CImageLoader::CImageLoader(const std::string &path, const bool useCache, const bool listSize):
   m_path(path)
 {
   m_texture = NULL;
   m_use_cache = useCache;
+  m_listSize = listSize;
 }
 
 CImageLoader::~CImageLoader()
@@ -40,7 +44,12 @@ bool CImageLoader::DoWork()
   if (texturePath.empty())
     return false;
 
-  if (m_use_cache)
+  if (m_use_cache && m_listSize)
+  {
+    const unsigned int listRes = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageListRes;
+    loadPath = CTextureCache::GetInstance().CheckCachedImage(texturePath, needsChecking, listRes * 16 / 9, listRes);
+  }
+  else if (m_use_cache)
     loadPath = CTextureCache::GetInstance().CheckCachedImage(texturePath, needsChecking);
   else
     loadPath = texturePath;
@@ -74,8 +83,9 @@ bool CImageLoader::DoWork()
   return (m_texture != NULL);
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path):
-  m_path(path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path, bool listSize):
+  m_path(path),
+  m_listSize(listSize)
 {
   m_refCount = 1;
   m_timeToDelete = 0;
@@ -145,13 +155,13 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
-bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache)
+bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache, bool listSize)
 {
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->Matches(path, listSize))
     {
       if (firstRequest)
         image->AddRef();
@@ -161,18 +171,18 @@ bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &t
   }
 
   if (firstRequest)
-    QueueImage(path, useCache);
+    QueueImage(path, useCache, listSize);
 
   return true;
 }
 
-void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immediately)
+void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immediately, bool listSize)
 {
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->Matches(path, listSize))
     {
       if (image->DecrRef(immediately) && immediately)
         m_allocated.erase(it);
@@ -183,7 +193,7 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
   {
     unsigned int id = it->first;
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path && image->DecrRef(true))
+    if (image->Matches(path, listSize) && image->DecrRef(true))
     {
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
@@ -194,7 +204,7 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
 }
 
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
+void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache, bool listSize)
 {
   if (path.empty())
     return;
@@ -203,7 +213,7 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path)
+    if (image->Matches(path, listSize))
     {
       image->AddRef();
       return; // already queued
@@ -211,8 +221,8 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
   }
 
   // queue the item
-  CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
+  CLargeTexture *image = new CLargeTexture(path, listSize);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache, listSize), this, CJob::PRIORITY_NORMAL);
   m_queued.emplace_back(jobID, image);
 }
 
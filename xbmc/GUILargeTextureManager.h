@@ -26,7 +26,7 @@
 class CImageLoader : public CJob
 {
 public:
-  CImageLoader(const std::string &path, const bool useCache);
+  CImageLoader(const std::string &path, const bool useCache, const bool listSize = false);
   ~CImageLoader() override;
 
   /*!
@@ -35,6 +35,7 @@ public:
   bool DoWork() override;
 
   bool          m_use_cache; ///< Whether or not to use any caching with this image
+  bool          m_listSize; ///< Whether the list-size variant of the cached image is large enough
   std::string    m_path; ///< path of image to load
   CBaseTexture *m_texture; ///< Texture object to load the image into \sa CBaseTexture.
 };
@@ -74,10 +75,11 @@ public:
    \param texture texture object to hold the resulting texture
    \param orientation orientation of resulting texture
    \param firstRequest true if this is the first time we are requesting this texture
+   \param listSize true if the image is shown no larger than the list-size variant of cached images
    \return true if the image exists, else false.
-   \sa CGUITextureArray and CGUITexture
+   \sa CGUITextureArray and CGUITexture, CTextureCache::CheckCachedImage
    */
-  bool GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, bool useCache = true);
+  bool GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, bool useCache = true, bool listSize = false);
 
   /*!
    \brief Request a texture to be unloaded.
@@ -89,8 +91,9 @@ public:
    \param path path of the image to release.
    \param immediately if set true the image is immediately unloaded once its reference count reaches zero
                       rather than being unloaded after a delay.
+   \param listSize whether the image was requested at list size.
    */
-  void ReleaseImage(const std::string &path, bool immediately = false);
+  void ReleaseImage(const std::string &path, bool immediately = false, bool listSize = false);
 
   /*!
    \brief Cleanup images that are no longer in use.
@@ -107,7 +110,7 @@ private:
   class CLargeTexture
   {
   public:
-    explicit CLargeTexture(const std::string &path);
+    CLargeTexture(const std::string &path, bool listSize);
     virtual ~CLargeTexture();
 
     void AddRef();
@@ -116,6 +119,7 @@ private:
     void SetTexture(CBaseTexture* texture);
 
     const std::string &GetPath() const { return m_path; };
+    bool Matches(const std::string &path, bool listSize) const { return m_listSize == listSize && m_path == path; };
     const CTextureArray &GetTexture() const { return m_texture; };
 
   private:
@@ -123,11 +127,12 @@ private:
 
     unsigned int m_refCount;
     std::string m_path;
+    bool m_listSize;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
   };
 
-  void QueueImage(const std::string &path, bool useCache = true);
+  void QueueImage(const std::string &path, bool useCache = true, bool listSize = false);
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
@@ -10,8 +10,14 @@
 
 #include "ServiceBroker.h"
 #include "TextureCacheJob.h"
+#include "TexturePrecacheJob.h"
 #include "URL.h"
+#include "XBDateTime.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "filesystem/File.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIWindowManager.h"
+#include "guilib/LocalizeStrings.h"
 #include "profiles/ProfileManager.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
@@ -21,15 +27,27 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <chrono>
+#include <inttypes.h>
+
 using namespace XFILE;
 
+namespace
+{
+// exists while library art is being cached, so caching continues after a restart
+const std::string PRECACHE_PENDING = "precache.pending";
+}
+
 CTextureCache &CTextureCache::GetInstance()
 {
   static CTextureCache s_cache;
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+// two jobs, so one image is fetched while the other is decoded and encoded. The job
+// manager doesn't run more low priority pausable jobs at once anyway.
+CTextureCache::CTextureCache()
+  : CJobQueue(false, 2, CJob::PRIORITY_LOW_PAUSABLE), m_index(INDEX_SIZE)
 {
 }
 
@@ -40,13 +58,30 @@ void CTextureCache::Initialize()
   CSingleLock lock(m_databaseSection);
   if (!m_database.IsOpen())
     m_database.Open();
+  lock.Leave();
+
+  if (CFile::Exists(GetCachedPath(PRECACHE_PENDING)))
+    CacheLibraryArt(false);
 }
 
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
+  {
+    CSingleLock lock(m_precacheSection);
+    if (m_precacheJob)
+      CJobManager::GetInstance().CancelJob(m_precacheJob);
+    m_precacheJob = 0;
+    if (m_precacheProgress)
+      m_precacheProgress->MarkFinished();
+    m_precacheProgress = nullptr;
+    m_precacher.reset();
+  }
   CSingleLock lock(m_databaseSection);
   m_database.Close();
+  LogIndexStats();
+  CSingleLock indexLock(m_indexSection);
+  m_index.Clear();
 }
 
 bool CTextureCache::IsCachedImage(const std::string &url) const
@@ -97,14 +132,24 @@ bool CTextureCache::CanCacheImageURL(const CURL &url)
           StringUtils::StartsWith(url.GetUserName(), "video_");
 }
 
-std::string CTextureCache::CheckCachedImage(const std::string &url, bool &needsRecaching)
+std::string CTextureCache::CheckCachedImage(const std::string &url, bool &needsRecaching, unsigned int width /* = 0 */, unsigned int height /* = 0 */)
 {
   CTextureDetails details;
-  std::string path(GetCachedImage(url, details, true));
+  std::string path(GetCachedImage(url, details, false));
   needsRecaching = !details.hash.empty();
-  if (!path.empty())
-    return path;
-  return "";
+  if (path.empty())
+    return "";
+
+  if (details.id >= 0 && details.listWidth && (width || height) &&
+      ((width && details.listWidth >= width) || (height && details.listHeight >= height)))
+  { // the image is shown no larger than its list-size variant
+    details.width = details.listWidth;
+    details.height = details.listHeight;
+    path = GetCachedPath(GetListFile(details.file));
+  }
+  if (details.id >= 0)
+    IncrementUseCount(details);
+  return path;
 }
 
 void CTextureCache::BackgroundCacheImage(const std::string &url)
@@ -180,6 +225,8 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
     path = GetCachedPath(cachedFile);
   if (CFile::Exists(path))
     CFile::Delete(path);
+  if (!cachedFile.empty() && CFile::Exists(GetCachedPath(GetListFile(cachedFile))))
+    CFile::Delete(GetCachedPath(GetListFile(cachedFile)));
   path = URIUtils::ReplaceExtension(path, ".dds");
   if (CFile::Exists(path))
     CFile::Delete(path);
@@ -190,6 +237,9 @@ bool CTextureCache::ClearCachedImage(int id)
   std::string cachedFile;
   if (ClearCachedTexture(id, cachedFile))
   {
+    const std::string listFile = GetCachedPath(GetListFile(cachedFile));
+    if (CFile::Exists(listFile))
+      CFile::Delete(listFile);
     cachedFile = GetCachedPath(cachedFile);
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
@@ -203,16 +253,71 @@ bool CTextureCache::ClearCachedImage(int id)
 
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
+  typedef CTextureCacheIndex::Clock Clock;
+  {
+    CSingleLock lock(m_indexSection);
+    if (m_index.Get(url, details, Clock::now()))
+      return true;
+  }
+
   CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  const Clock::time_point start = Clock::now();
+  CDateTime lastHashCheck;
+  bool found = m_database.GetCachedTexture(url, details, &lastHashCheck);
+  const Clock::time_point end = Clock::now();
+  m_databaseLookups++;
+  m_databaseLookupTime += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+  // images due for a hash check are about to be recached, so they're not worth indexing
+  if (found && details.hash.empty())
+  {
+    Clock::time_point expires = Clock::time_point::max();
+    if (lastHashCheck.IsValid())
+    {
+      CDateTimeSpan due = lastHashCheck + CDateTimeSpan(1, 0, 0, 0) - CDateTime::GetCurrentDateTime();
+      expires = end + std::chrono::seconds(due.GetSecondsTotal());
+    }
+    CSingleLock indexLock(m_indexSection);
+    m_index.Put(url, details, expires);
+  }
+  return found;
 }
 
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
+  { // the new database id is only known to the database
+    CSingleLock indexLock(m_indexSection);
+    m_index.Erase(url);
+  }
   return m_database.AddCachedTexture(url, details);
 }
 
+void CTextureCache::InvalidateIndexedImage(const std::string &image)
+{
+  std::string url = CTextureUtils::UnwrapImageURL(image);
+  CSingleLock lock(m_indexSection);
+  m_index.Erase(url);
+}
+
+void CTextureCache::LogIndexStats()
+{
+  uint64_t hits, misses;
+  {
+    CSingleLock lock(m_indexSection);
+    hits = m_index.GetHits();
+    misses = m_index.GetMisses();
+  }
+  const uint64_t lookups = m_databaseLookups;
+  if (!hits && !misses)
+    return;
+
+  // every hit would have cost an average database lookup
+  const double lookupTime = lookups ? static_cast<double>(m_databaseLookupTime) / lookups : 0.0;
+  CLog::Log(LOGINFO, "CTextureCache: index hit %.1f%% of %" PRIu64" lookups, saving %.1f ms of database queries (%.3f ms per query)",
+            100.0 * hits / (hits + misses), hits + misses, hits * lookupTime / 1000.0, lookupTime / 1000.0);
+}
+
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
   static const size_t count_before_update = 100;
@@ -229,18 +334,30 @@ void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
+  {
+    CSingleLock indexLock(m_indexSection);
+    m_index.Erase(url);
+  }
   return m_database.SetCachedTextureValid(url, updateable);
 }
 
 bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  {
+    CSingleLock indexLock(m_indexSection);
+    m_index.Erase(url);
+  }
   return m_database.ClearCachedTexture(url, cachedURL);
 }
 
 bool CTextureCache::ClearCachedTexture(int id, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  {
+    CSingleLock indexLock(m_indexSection);
+    m_index.Erase(id);
+  }
   return m_database.ClearCachedTexture(id, cachedURL);
 }
 
@@ -259,6 +376,11 @@ std::string CTextureCache::GetCachedPath(const std::string &file)
   return URIUtils::AddFileToFolder(profileManager->GetThumbnailsFolder(), file);
 }
 
+std::string CTextureCache::GetListFile(const std::string &file)
+{
+  return URIUtils::ReplaceExtension(file, "-list" + URIUtils::GetExtension(file));
+}
+
 void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
 {
   if (success)
@@ -279,8 +401,55 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
   m_completeEvent.Set();
 }
 
+bool CTextureCache::CacheLibraryArt(bool showProgress /* = true */)
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precacheJob || (m_precacher && !m_precacher->IsFinished()))
+    return false;
+  m_precacher.reset();
+
+  const std::string pending = GetCachedPath(PRECACHE_PENDING);
+  CFile file;
+  if (!CFile::Exists(pending) && !file.OpenForWrite(pending, true))
+    CLog::Log(LOGWARNING, "%s - unable to create %s, caching won't continue after a restart", __FUNCTION__, pending.c_str());
+  file.Close();
+
+  if (showProgress)
+  {
+    CGUIDialogExtendedProgressBar* dialog = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogExtendedProgressBar>(WINDOW_DIALOG_EXT_PROGRESS);
+    if (dialog)
+      m_precacheProgress = dialog->GetHandle(g_localizeStrings.Get(36922));
+  }
+  m_precacheJob = CJobManager::GetInstance().AddJob(new CTexturePrecacheJob(), this, CJob::PRIORITY_LOW_PAUSABLE);
+  return true;
+}
+
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
+  if (strcmp(job->GetType(), kJobTypePrecacheArt) == 0)
+  {
+    CSingleLock lock(m_precacheSection);
+    if (jobID != m_precacheJob)
+      return;
+    m_precacheJob = 0;
+
+    // the images are fetched in jobs of their own, which start the next fetch when done
+    m_precacher.reset(new CTexturePrecacher(std::move(static_cast<CTexturePrecacheJob*>(job)->GetHosts()),
+                                            [](const std::string &url) {
+      if (CTextureCache::GetInstance().HasCachedImage(url))
+        return CTexturePrecacher::Result::SKIPPED;
+      CTextureDetails details;
+      if (!CTextureCache::GetInstance().CacheImage(url, details))
+        return CTexturePrecacher::Result::FAILED;
+      return CTexturePrecacher::Result::CACHED;
+    }));
+    m_precacher->SetProgressBar(m_precacheProgress);
+    m_precacheProgress = nullptr;
+    const std::string pending = GetCachedPath(PRECACHE_PENDING);
+    m_precacher->SetFinishedCallback([pending]() { CFile::Delete(pending); });
+    m_precacher->Start();
+    return;
+  }
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
     OnCachingComplete(success, static_cast<CTextureCacheJob*>(job));
   return CJobQueue::OnJobComplete(jobID, success, job);
@@ -8,16 +8,22 @@
 
 #pragma once
 
+#include "TextureCacheIndex.h"
 #include "TextureDatabase.h"
 #include "threads/Event.h"
 #include "utils/JobManager.h"
 
+#include <atomic>
+#include <memory>
 #include <set>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 class CURL;
 class CBaseTexture;
+class CGUIDialogProgressBarHandle;
+class CTexturePrecacher;
 
 /*!
  \ingroup textures
@@ -53,10 +59,12 @@ public:
 
    \param image url of the image to check
    \param needsRecaching [out] whether the image needs recaching.
-   \return cached url of this image
+   \param width the largest width the image is shown at, keeping its aspect ratio. 0 for any size.
+   \param height the largest height the image is shown at, keeping its aspect ratio. 0 for any size.
+   \return cached url of this image, which is its list-size variant if that is large enough for the given size
    \sa GetCachedImage
    */
-  std::string CheckCachedImage(const std::string &image, bool &needsRecaching);
+  std::string CheckCachedImage(const std::string &image, bool &needsRecaching, unsigned int width = 0, unsigned int height = 0);
 
   /*! \brief Cache image (if required) using a background job
 
@@ -122,6 +130,13 @@ public:
    */
   static std::string GetCachedPath(const std::string &file);
 
+  /*! \brief retrieve the cache file of the list-size variant of the given cached file
+   \param file name of the cached file, relative to the cache path
+   \return name of the variant, relative to the cache path
+   \sa CTextureDetails::listWidth
+   */
+  static std::string GetListFile(const std::string &file);
+
   /*! \brief check whether an image:// URL may be cached
    \param url the URL to the image
    \return true if the given URL may be cached, false otherwise
@@ -136,6 +151,21 @@ public:
    */
   bool AddCachedTexture(const std::string &image, const CTextureDetails &details);
 
+  /*! \brief Drop an image from the in-memory index
+   Needs to be called after changing the texture database directly, e.g. after
+   CTextureDatabase::InvalidateCachedTexture, so the change isn't hidden by the index.
+   \param image url of the original image
+   */
+  void InvalidateIndexedImage(const std::string &image);
+
+  /*! \brief Cache the art of the video and music libraries in the background
+   Caching continues after a restart until all art is cached or the user cancels it.
+   \param showProgress whether to show the progress in the extended progress bar
+   \return true if caching was started, false if it is already running.
+   \sa CTexturePrecacheJob
+   */
+  bool CacheLibraryArt(bool showProgress = true);
+
   /*! \brief Export a (possibly) cached image to a file
    \param image url of the original image
    \param destination url of the destination image, excluding extension.
@@ -208,12 +238,26 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Log how well the in-memory index did since the last call
+   */
+  void LogIndexStats();
+
+  static const size_t INDEX_SIZE = 4096; ///< number of images kept in the in-memory index
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
+  CCriticalSection m_indexSection; ///< always taken after m_databaseSection
+  CTextureCacheIndex m_index; ///< recently looked up images, in front of m_database
+  std::atomic<uint64_t> m_databaseLookups{0}; ///< lookups that went to the database
+  std::atomic<uint64_t> m_databaseLookupTime{0}; ///< time spent in those lookups, in microseconds
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
   CCriticalSection             m_useCountSection;
+  CCriticalSection m_precacheSection;
+  unsigned int m_precacheJob = 0; ///< id of the running CTexturePrecacheJob, 0 if none
+  CGUIDialogProgressBarHandle* m_precacheProgress = nullptr; ///< handed to m_precacher once the art is collected
+  std::unique_ptr<CTexturePrecacher> m_precacher;
 };
 
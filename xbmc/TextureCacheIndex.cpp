@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureCacheIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+CTextureCacheIndex::CTextureCacheIndex(size_t maxEntries)
+  : m_maxEntries(std::max<size_t>(maxEntries, 1))
+{
+}
+
+bool CTextureCacheIndex::Get(const std::string &url, CTextureDetails &details, Clock::time_point now)
+{
+  auto it = m_lookup.find(url);
+  if (it == m_lookup.end())
+  {
+    m_misses++;
+    return false;
+  }
+
+  if (it->second->expires <= now)
+  { // due for a hash check, which only the database knows about
+    Erase(it->second);
+    m_misses++;
+    return false;
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  details = it->second->details;
+  m_hits++;
+  return true;
+}
+
+void CTextureCacheIndex::Put(const std::string &url, const CTextureDetails &details, Clock::time_point expires)
+{
+  auto it = m_lookup.find(url);
+  if (it != m_lookup.end())
+  {
+    it->second->details = details;
+    it->second->expires = expires;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+
+  if (m_entries.size() >= m_maxEntries)
+    Erase(std::prev(m_entries.end()));
+
+  m_entries.push_front({ url, details, expires });
+  m_lookup.insert(std::make_pair(url, m_entries.begin()));
+}
+
+void CTextureCacheIndex::Erase(const std::string &url)
+{
+  auto it = m_lookup.find(url);
+  if (it != m_lookup.end())
+    Erase(it->second);
+}
+
+void CTextureCacheIndex::Erase(int id)
+{
+  auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                         [id](const Entry &entry) { return entry.details.id == id; });
+  if (it != m_entries.end())
+    Erase(it);
+}
+
+void CTextureCacheIndex::Erase(EntryList::iterator entry)
+{
+  m_lookup.erase(entry->url);
+  m_entries.erase(entry);
+}
+
+void CTextureCacheIndex::Clear()
+{
+  m_lookup.clear();
+  m_entries.clear();
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "TextureCacheJob.h"
+
+#include <chrono>
+#include <list>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+/*!
+ \ingroup textures
+ \brief Bounded in-memory index of recently looked up cached textures.
+
+ Keeps the texture details of the most recently used images, so repeated lookups of the
+ same art don't need a database query. Entries expire when their image is due for a hash
+ check, after which the lookup has to go to the database again. Once full, the least
+ recently used entry is dropped.
+
+ Not thread-safe, callers have to lock.
+
+ \sa CTextureCache
+ */
+class CTextureCacheIndex
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  explicit CTextureCacheIndex(size_t maxEntries);
+
+  /*! \brief Look up the details of a cached image
+   \param url url of the original image.
+   \param details [out] the details of the cached image.
+   \param now the current time, used to expire entries.
+   \return true if the image is in the index, false otherwise.
+   */
+  bool Get(const std::string &url, CTextureDetails &details, Clock::time_point now);
+
+  /*! \brief Add or replace the details of a cached image
+   \param url url of the original image.
+   \param details the details of the cached image.
+   \param expires when the entry has to be looked up in the database again.
+   */
+  void Put(const std::string &url, const CTextureDetails &details, Clock::time_point expires);
+
+  /*! \brief Drop an image from the index
+   \param url url of the original image.
+   */
+  void Erase(const std::string &url);
+
+  /*! \brief Drop an image from the index by its database id
+   \param id database id of the image.
+   */
+  void Erase(int id);
+
+  void Clear();
+
+  size_t GetSize() const { return m_entries.size(); }
+  uint64_t GetHits() const { return m_hits; }
+  uint64_t GetMisses() const { return m_misses; }
+
+private:
+  struct Entry
+  {
+    std::string url;
+    CTextureDetails details;
+    Clock::time_point expires;
+  };
+  typedef std::list<Entry> EntryList;
+
+  void Erase(EntryList::iterator entry);
+
+  size_t m_maxEntries;
+  EntryList m_entries; ///< most recently used first
+  std::unordered_map<std::string, EntryList::iterator> m_lookup;
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+};
@@ -26,6 +26,8 @@
 #include "cores/omxplayer/OMXImage.h"
 #endif
 
+#include <algorithm>
+
 CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &oldHash):
   m_url(url),
   m_oldHash(oldHash),
@@ -92,7 +94,17 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  unsigned int loadWidth = width, loadHeight = height;
+  if (!out_texture)
+  {
+    // the cached image is never larger than this, so there is no point in decoding
+    // more, and JPEGs can be downscaled cheaply while decoding
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    const unsigned int maxHeight = std::max(advancedSettings->m_imageRes, advancedSettings->m_fanartRes);
+    loadWidth = width ? std::min(width, maxHeight * 16 / 9) : maxHeight * 16 / 9;
+    loadHeight = height ? std::min(height, maxHeight) : maxHeight;
+  }
+  CBaseTexture *texture = LoadImage(image, loadWidth, loadHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
@@ -106,6 +118,7 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     {
       m_details.width = width;
       m_details.height = height;
+      CacheListVariant(texture, scalingAlgorithm);
       if (out_texture) // caller wants the texture
         *out_texture = texture;
       else
@@ -117,6 +130,52 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   return false;
 }
 
+bool CTextureCacheJob::GetListVariantSize(unsigned int width, unsigned int height, unsigned int listRes,
+                                          unsigned int &listWidth, unsigned int &listHeight)
+{
+  if (!listRes || !width || !height)
+    return false;
+
+  // skip it unless the variant has at most half the pixels of the cached image
+  listWidth = listRes * 16 / 9;
+  listHeight = listRes;
+  const float scale = std::min(static_cast<float>(listWidth) / width, static_cast<float>(listHeight) / height);
+  return scale * scale <= 0.5f;
+}
+
+void CTextureCacheJob::CacheListVariant(CBaseTexture *texture, CPictureScalingAlgorithm::Algorithm scalingAlgorithm)
+{
+  const std::string file = CTextureCache::GetListFile(m_details.file);
+  if (!m_oldHash.empty())
+  { // a variant of the image we recache is stale, and it may have had the other extension
+    for (const char* extension : { ".jpg", ".png" })
+    {
+      const std::string path = CTextureCache::GetCachedPath(CTextureCache::GetListFile(m_cachePath + extension));
+      if (XFILE::CFile::Exists(path))
+        XFILE::CFile::Delete(path);
+    }
+  }
+
+  unsigned int width, height;
+  if (!GetListVariantSize(m_details.width, m_details.height,
+                          CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageListRes, width, height))
+    return;
+
+  if (!CPicture::CacheTexture(texture, width, height, CTextureCache::GetCachedPath(file), scalingAlgorithm))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to cache list-size variant of '%s'", __FUNCTION__, m_details.file.c_str());
+    return;
+  }
+  m_details.listWidth = width;
+  m_details.listHeight = height;
+
+  struct __stat64 full, list;
+  if (XFILE::CFile::Stat(CTextureCache::GetCachedPath(m_details.file), &full) == 0 &&
+      XFILE::CFile::Stat(CTextureCache::GetCachedPath(file), &list) == 0)
+    CLog::Log(LOGDEBUG, "%s - %ux%u variant of '%s' takes %" PRId64" of %" PRId64" bytes", __FUNCTION__,
+              width, height, m_details.file.c_str(), list.st_size, full.st_size);
+}
+
 bool CTextureCacheJob::ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size)
 {
   result = NULL;
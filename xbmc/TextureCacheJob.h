@@ -28,6 +28,7 @@ public:
   {
     id = -1;
     width = height = 0;
+    listWidth = listHeight = 0;
     updateable = false;
   };
   bool operator==(const CTextureDetails &right) const
@@ -41,6 +42,8 @@ public:
   std::string  hash;
   unsigned int width;
   unsigned int height;
+  unsigned int listWidth;  ///< size of the list-size variant, 0 if there is none
+  unsigned int listHeight;
   bool         updateable;
 };
 
@@ -69,6 +72,17 @@ public:
 
   static bool ResizeTexture(const std::string &url, uint8_t* &result, size_t &result_size);
 
+  /*! \brief Work out whether a cached image gets a list-size variant, and how large it may be
+   \param width width of the cached image
+   \param height height of the cached image
+   \param listRes the largest height of a variant, as set by <imagelistres>. 0 to never make one.
+   \param listWidth [out] the largest width of the variant
+   \param listHeight [out] the largest height of the variant
+   \return true if the variant has at most half the pixels of the cached image, false otherwise
+   */
+  static bool GetListVariantSize(unsigned int width, unsigned int height, unsigned int listRes,
+                                 unsigned int &listWidth, unsigned int &listHeight);
+
   std::string m_url;
   std::string m_oldHash;
   CTextureDetails m_details;
@@ -80,6 +94,15 @@ private:
    */
   static std::string GetImageHash(const std::string &url);
 
+  /*! \brief Cache a list-size variant of the cached image
+   Views showing the image small can load the variant rather than decoding the full image.
+   Only done if the variant is considerably smaller than the cached image.
+   \param texture the loaded image.
+   \param scalingAlgorithm the scaling algorithm to use.
+   \sa CTextureCache::GetListFile
+   */
+  void CacheListVariant(CBaseTexture *texture, CPictureScalingAlgorithm::Algorithm scalingAlgorithm);
+
   /*! \brief Check whether a given URL represents an image that can be updated
    We currently don't check http:// and https:// URLs for updates, under the assumption that
    a image URL is much more likely to be static and the actual image at the URL is unlikely
@@ -236,7 +236,7 @@ bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
   return ExecuteQuery(sql);
 }
 
-bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details)
+bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details, CDateTime *lastHashCheck /* = nullptr */)
 {
   try
   {
@@ -245,7 +245,9 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
     if (!m_pDS)
       return false;
 
-    std::string sql = PrepareSQL("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url='%s'", url.c_str());
+    std::string sql = PrepareSQL("SELECT id, cachedurl, lasthashcheck, imagehash, sizes.width, sizes.height, listsize.width, listsize.height FROM texture "
+                                 "JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) "
+                                 "LEFT JOIN sizes AS listsize ON (texture.id=listsize.idtexture AND listsize.size=2) WHERE url='%s'", url.c_str());
     m_pDS->query(sql);
     if (!m_pDS->eof())
     { // have some information
@@ -255,8 +257,12 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
       lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
       if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
         details.hash = m_pDS->fv(3).get_asString();
+      if (lastHashCheck)
+        *lastHashCheck = lastCheck;
       details.width = m_pDS->fv(4).get_asInt();
       details.height = m_pDS->fv(5).get_asInt();
+      details.listWidth = m_pDS->fv(6).get_asInt();
+      details.listHeight = m_pDS->fv(7).get_asInt();
       m_pDS->close();
       return true;
     }
@@ -333,7 +339,10 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
     if (!m_pDS)
       return false;
 
-    std::string sql = PrepareSQL("DELETE FROM texture WHERE url='%s'", url.c_str());
+    // the sizes of the old image go with it, including a list-size variant the new one may not have
+    std::string sql = PrepareSQL("DELETE FROM sizes WHERE idtexture IN (SELECT id FROM texture WHERE url='%s')", url.c_str());
+    m_pDS->exec(sql);
+    sql = PrepareSQL("DELETE FROM texture WHERE url='%s'", url.c_str());
     m_pDS->exec(sql);
 
     std::string date = details.updateable ? CDateTime::GetCurrentDateTime().GetAsDBDateTime() : "";
@@ -344,6 +353,13 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
     // set the size information
     sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", textureID, details.width, details.height);
     m_pDS->exec(sql);
+
+    // and of the list-size variant
+    if (details.listWidth && details.listHeight)
+    {
+      sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 2, 0, CURRENT_TIMESTAMP, %u, %u)", textureID, details.listWidth, details.listHeight);
+      m_pDS->exec(sql);
+    }
   }
   catch (...)
   {
@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+class CDateTime;
 class CVariant;
 
 class CTextureRule : public CDatabaseQueryRule
@@ -62,7 +63,13 @@ public:
   ~CTextureDatabase() override;
   bool Open() override;
 
-  bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details);
+  /*! \brief Get the details of a cached image
+   \param originalURL url of the original image.
+   \param details [out] the details of the cached image. The hash is only set if the image is due for a hash check.
+   \param lastHashCheck [out] optional time of the last hash check, invalid if the image isn't checked for updates.
+   \return true if the image is cached, false otherwise.
+   */
+  bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details, CDateTime *lastHashCheck = nullptr);
   bool AddCachedTexture(const std::string &originalURL, const CTextureDetails &details);
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
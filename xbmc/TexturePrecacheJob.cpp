@@ -0,0 +1,275 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TexturePrecacheJob.h"
+
+#include "TextureCache.h"
+#include "TextureDatabase.h"
+#include "URL.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
+#include "guilib/LocalizeStrings.h"
+#include "music/MusicDatabase.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+bool CTexturePrecacheJob::operator==(const CJob* job) const
+{
+  return strcmp(job->GetType(), GetType()) == 0;
+}
+
+std::map<std::string, std::deque<std::string>> CTexturePrecacheJob::GroupByHost(const std::vector<std::string> &urls)
+{
+  std::map<std::string, std::deque<std::string>> hosts;
+  std::unordered_set<std::string> seen;
+  for (const auto& url : urls)
+  {
+    if (url.empty() || !seen.insert(url).second)
+      continue;
+
+    // image:// urls wrap embedded art, which is read from the file it's embedded in
+    const CURL image(CTextureUtils::UnwrapImageURL(url));
+    hosts[image.GetHostName()].push_back(url);
+  }
+  return hosts;
+}
+
+bool CTexturePrecacheJob::DoWork()
+{
+  std::vector<std::string> urls;
+  CVideoDatabase videodatabase;
+  if (videodatabase.Open())
+  {
+    videodatabase.GetArtURLs(urls);
+    videodatabase.Close();
+  }
+  CMusicDatabase musicdatabase;
+  if (musicdatabase.Open())
+  {
+    musicdatabase.GetArtURLs(urls);
+    musicdatabase.Close();
+  }
+
+  m_hosts = GroupByHost(urls);
+  return true;
+}
+
+namespace
+{
+class CPrecacheFetchJob : public CJob
+{
+public:
+  CPrecacheFetchJob(const CTexturePrecacher::Fetch& fetch, const std::string& url)
+    : m_fetch(fetch), m_url(url)
+  {
+  }
+
+  bool DoWork() override
+  {
+    m_result = m_fetch(m_url);
+    return m_result != CTexturePrecacher::Result::FAILED;
+  }
+
+  CTexturePrecacher::Result GetResult() const { return m_result; }
+
+private:
+  CTexturePrecacher::Fetch m_fetch;
+  std::string m_url;
+  CTexturePrecacher::Result m_result = CTexturePrecacher::Result::FAILED;
+};
+}
+
+const unsigned int CTexturePrecacher::MAX_PER_HOST;
+
+CTexturePrecacher::CTexturePrecacher(std::map<std::string, std::deque<std::string>> hosts, Fetch fetch,
+                                     unsigned int maxPerHost /* = MAX_PER_HOST */,
+                                     unsigned int maxRunning /* = 0 */)
+  : m_hosts(std::move(hosts)),
+    m_fetch(std::move(fetch)),
+    m_maxPerHost(std::max(maxPerHost, 1u)),
+    m_maxRunning(maxRunning ? maxRunning : CJobManager::GetMaxWorkers(CJob::PRIORITY_LOW_PAUSABLE))
+{
+  for (const auto& host : m_hosts)
+    m_total += host.second.size();
+}
+
+CTexturePrecacher::~CTexturePrecacher()
+{
+  Cancel();
+}
+
+void CTexturePrecacher::SetProgressBar(CGUIDialogProgressBarHandle* progressBar)
+{
+  CSingleLock lock(m_section);
+  m_progressBar = progressBar;
+  if (m_progressBar)
+    m_progressBar->SetTitle(g_localizeStrings.Get(36922));
+}
+
+void CTexturePrecacher::SetFinishedCallback(std::function<void()> finished)
+{
+  CSingleLock lock(m_section);
+  m_finished = std::move(finished);
+}
+
+void CTexturePrecacher::Start()
+{
+  CSingleLock lock(m_section);
+  CLog::Log(LOGINFO, "CTexturePrecacher: caching %u images from %u hosts, %u at once", m_total,
+            static_cast<unsigned int>(m_hosts.size()), m_maxRunning);
+  m_start = std::chrono::steady_clock::now();
+  QueueFetches();
+  if (!m_running.empty())
+    return;
+
+  // nothing to fetch
+  if (m_progressBar)
+    m_progressBar->MarkFinished();
+  m_progressBar = nullptr;
+  m_finishedEvent.Set();
+  std::function<void()> finished = m_finished;
+  lock.Leave();
+  if (finished)
+    finished();
+}
+
+void CTexturePrecacher::Cancel()
+{
+  CSingleLock lock(m_section);
+  if (m_cancelled || m_finishedEvent.Signaled())
+    return;
+
+  m_cancelled = true;
+  for (const auto& fetch : m_running)
+    CJobManager::GetInstance().CancelJob(fetch.first);
+  m_running.clear();
+  if (m_progressBar)
+    m_progressBar->MarkFinished();
+  m_progressBar = nullptr;
+
+  CLog::Log(LOGINFO, "CTexturePrecacher: cancelled after %u of %u images, %u cached, %u failed",
+            m_done, m_total, m_cached, m_failed);
+}
+
+bool CTexturePrecacher::IsFinished() const
+{
+  CSingleLock lock(m_section);
+  return !m_cancelled && m_running.empty() && m_hosts.empty();
+}
+
+bool CTexturePrecacher::WaitFinished(unsigned int milliseconds)
+{
+  return m_finishedEvent.WaitMSec(milliseconds);
+}
+
+unsigned int CTexturePrecacher::GetDone() const
+{
+  CSingleLock lock(m_section);
+  return m_done;
+}
+
+unsigned int CTexturePrecacher::GetCached() const
+{
+  CSingleLock lock(m_section);
+  return m_cached;
+}
+
+unsigned int CTexturePrecacher::GetFailed() const
+{
+  CSingleLock lock(m_section);
+  return m_failed;
+}
+
+void CTexturePrecacher::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  CSingleLock lock(m_section);
+  auto fetch = m_running.find(jobID);
+  if (fetch == m_running.end())
+    return;
+
+  m_fetching[fetch->second]--;
+  m_running.erase(fetch);
+  m_done++;
+  const Result result = static_cast<CPrecacheFetchJob*>(job)->GetResult();
+  if (result == Result::CACHED)
+    m_cached++;
+  else if (result == Result::FAILED)
+    m_failed++;
+
+  QueueFetches();
+  UpdateProgress();
+  if (!m_running.empty())
+    return;
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+  CLog::Log(LOGINFO, "CTexturePrecacher: finished %u images in %.1f s (%.1f per second), %u cached, %u failed",
+            m_done, seconds, seconds > 0.0 ? m_done / seconds : 0.0, m_cached, m_failed);
+  if (m_progressBar)
+    m_progressBar->MarkFinished();
+  m_progressBar = nullptr;
+  m_finishedEvent.Set();
+  std::function<void()> finished = m_finished;
+  lock.Leave();
+  if (finished)
+    finished();
+}
+
+void CTexturePrecacher::QueueFetches()
+{
+  while (!m_cancelled && m_running.size() < m_maxRunning && !m_hosts.empty())
+  {
+    // take turns between hosts, continuing after the host we last started a fetch for
+    auto host = m_hosts.upper_bound(m_lastHost);
+    bool started = false;
+    for (size_t turns = m_hosts.size(); turns > 0 && m_running.size() < m_maxRunning; turns--)
+    {
+      if (host == m_hosts.end())
+        host = m_hosts.begin();
+      const std::string hostName = host->first;
+      if (m_fetching[hostName] >= m_maxPerHost)
+      {
+        ++host;
+        continue;
+      }
+
+      const std::string url = host->second.front();
+      host->second.pop_front();
+      if (host->second.empty())
+        host = m_hosts.erase(host);
+      else
+        ++host;
+
+      m_fetching[hostName]++;
+      m_lastHost = hostName;
+      started = true;
+      const unsigned int jobID = CJobManager::GetInstance().AddJob(new CPrecacheFetchJob(m_fetch, url), this,
+                                                                   CJob::PRIORITY_LOW_PAUSABLE);
+      m_running.insert(std::make_pair(jobID, hostName));
+    }
+    // all hosts left are at their limit
+    if (!started)
+      break;
+  }
+}
+
+void CTexturePrecacher::UpdateProgress()
+{
+  if (!m_progressBar)
+    return;
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+  m_progressBar->SetText(StringUtils::Format(g_localizeStrings.Get(36923).c_str(), m_done, m_total,
+                                             seconds > 0.0 ? m_done / seconds : 0.0));
+  m_progressBar->SetProgress(m_done, m_total);
+}
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+class CGUIDialogProgressBarHandle;
+
+/*!
+ \ingroup textures
+ \brief Job collecting the art of the video and music libraries to cache ahead of time.
+
+ Reading the art tables of both databases may take a while, so it's done in a job. The
+ images themselves are fetched by a CTexturePrecacher once the job is complete.
+
+ \sa CTextureCache::CacheLibraryArt
+ */
+class CTexturePrecacheJob : public CJob
+{
+public:
+  CTexturePrecacheJob() = default;
+
+  const char* GetType() const override { return kJobTypePrecacheArt; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+  /*! \brief The urls of the art in the libraries, grouped by host
+   \sa GroupByHost
+   */
+  std::map<std::string, std::deque<std::string>>& GetHosts() { return m_hosts; }
+
+  /*! \brief Group image urls by the host they are fetched from
+   \param urls the urls of the images, duplicates and empty urls are dropped.
+   \return the urls to fetch per host, embedded and local images are grouped under an empty host.
+   */
+  static std::map<std::string, std::deque<std::string>> GroupByHost(const std::vector<std::string> &urls);
+
+private:
+  std::map<std::string, std::deque<std::string>> m_hosts;
+};
+
+/*!
+ \ingroup textures
+ \brief Fetches the images of a CTexturePrecacheJob in the background.
+
+ Only a few images are fetched from each host at once, so a slow server doesn't hold up
+ the others and no server gets flooded with requests. Hosts take turns. Each image is
+ fetched in a job of its own at PRIORITY_LOW_PAUSABLE, and the next one is started when
+ a fetch completes, so no worker is kept waiting and fetching stops while pausable jobs
+ are paused, e.g. during playback.
+ */
+class CTexturePrecacher : public IJobCallback
+{
+public:
+  enum class Result
+  {
+    SKIPPED, ///< the image was cached already
+    CACHED,
+    FAILED
+  };
+  typedef std::function<Result(const std::string& url)> Fetch;
+
+  /*!
+   \param hosts the urls to fetch per host, as returned by CTexturePrecacheJob::GroupByHost
+   \param fetch function fetching an image, called from the job workers.
+   \param maxPerHost images fetched from one host at once
+   \param maxRunning images fetched at once, 0 for as many as there are pausable workers.
+   */
+  CTexturePrecacher(std::map<std::string, std::deque<std::string>> hosts, Fetch fetch,
+                    unsigned int maxPerHost = MAX_PER_HOST, unsigned int maxRunning = 0);
+  ~CTexturePrecacher() override;
+
+  /*! \brief Show the progress in an extended progress bar, which is marked finished when done
+   */
+  void SetProgressBar(CGUIDialogProgressBarHandle* progressBar);
+
+  /*! \brief Called once all images are fetched, from the worker of the last fetch
+   */
+  void SetFinishedCallback(std::function<void()> finished);
+
+  void Start();
+
+  /*! \brief Stop fetching, fetches already running carry on but aren't reported anymore
+   */
+  void Cancel();
+
+  /*! \brief Whether all images were fetched
+   */
+  bool IsFinished() const;
+  bool WaitFinished(unsigned int milliseconds);
+
+  unsigned int GetDone() const;
+  unsigned int GetCached() const;
+  unsigned int GetFailed() const;
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override;
+
+  static const unsigned int MAX_PER_HOST = 2; ///< images fetched from one host at once
+
+private:
+  void QueueFetches();
+  void UpdateProgress();
+
+  mutable CCriticalSection m_section;
+  std::map<std::string, std::deque<std::string>> m_hosts;
+  Fetch m_fetch;
+  const unsigned int m_maxPerHost;
+  const unsigned int m_maxRunning;
+  std::map<unsigned int, std::string> m_running; ///< fetch job ids and their host
+  std::map<std::string, unsigned int> m_fetching; ///< images being fetched per host
+  std::string m_lastHost;
+  unsigned int m_total = 0;
+  unsigned int m_done = 0;
+  unsigned int m_cached = 0; ///< images that had to be cached, i.e. weren't before
+  unsigned int m_failed = 0;
+  bool m_cancelled = false;
+  CEvent m_finishedEvent{true};
+  std::function<void()> m_finished;
+  CGUIDialogProgressBarHandle* m_progressBar = nullptr;
+  std::chrono::steady_clock::time_point m_start;
+};
@@ -10,6 +10,7 @@
 
 #include "FileItem.h"
 #include "ServiceBroker.h"
+#include "TextureCache.h"
 #include "TextureDatabase.h"
 #include "URL.h"
 #include "addons/AddonDatabase.h"
@@ -31,6 +32,7 @@
 #include <iterator>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace XFILE;
 using namespace ADDON;
@@ -302,6 +304,7 @@ bool CRepositoryUpdateJob::DoWork()
     textureDB.Open();
     textureDB.BeginMultipleExecute();
 
+    std::vector<std::string> invalidated;
     for (const auto& addon : addons)
     {
       AddonPtr oldAddon;
@@ -311,16 +314,29 @@ bool CRepositoryUpdateJob::DoWork()
           CLog::Log(LOGDEBUG, "CRepository: invalidating cached art for '%s'", addon->ID().c_str());
 
         if (!oldAddon->Icon().empty())
+        {
           textureDB.InvalidateCachedTexture(oldAddon->Icon());
+          invalidated.push_back(oldAddon->Icon());
+        }
 
         for (const auto& path : oldAddon->Screenshots())
+        {
           textureDB.InvalidateCachedTexture(path);
+          invalidated.push_back(path);
+        }
 
         for (const auto& art : oldAddon->Art())
+        {
           textureDB.InvalidateCachedTexture(art.second);
+          invalidated.push_back(art.second);
+        }
       }
     }
     textureDB.CommitMultipleExecute();
+
+    // only once the rows are gone, or a lookup in between could index them again
+    for (const auto& path : invalidated)
+      CTextureCache::GetInstance().InvalidateIndexedImage(path);
   }
 
   database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons);
@@ -15,6 +15,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "windowing/WinSystem.h"
 
 #include "Application.h"
@@ -689,6 +690,7 @@ RESOLUTION CRenderManager::GetResolution()
 void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 {
   CSingleExit exitLock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CTimelineScope timelineScope("video", "CRenderManager::Render");
 
   {
     CSingleLock lock(m_statelock);
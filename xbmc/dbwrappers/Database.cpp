@@ -12,6 +12,7 @@
 #include "profiles/ProfileManager.h"
 #include "settings/SettingsComponent.h"
 #include "utils/log.h"
+#include "utils/NameIndex.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "sqlitedataset.h"
@@ -30,6 +31,7 @@
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
+#define MAX_SEARCH_INDEX_IDS 10000
 
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
@@ -743,6 +745,63 @@ bool CDatabase::BuildSQL(const std::string &strQuery, const Filter &filter, std:
   return true;
 }
 
+bool CDatabase::FindInSearchIndex(CNameIndex &index, const std::string &table, const std::string &idField,
+                                  const std::string &nameField, const std::string &term, std::string &ids)
+{
+  // the wildcards of LIKE can't be looked up
+  const std::string key = GetSearchIndexKey();
+  if (key.empty() || nullptr == m_pDS2 || term.find_first_of("%_") != std::string::npos)
+    return false;
+
+  try
+  {
+    if (!index.IsLoaded(key))
+    {
+      const unsigned int token = index.BeginLoad();
+      std::vector<std::pair<int, std::string>> names;
+      if (!m_pDS2->query(PrepareSQL("SELECT %s, %s FROM %s", idField.c_str(), nameField.c_str(), table.c_str())))
+        return false;
+      names.reserve(m_pDS2->num_rows());
+      while (!m_pDS2->eof())
+      {
+        names.emplace_back(m_pDS2->fv(0).get_asInt(), m_pDS2->fv(1).get_asString());
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+
+      if (!index.Load(key, token, names))
+        return false;
+      CLog::Log(LOGDEBUG, "%s - indexed %u names of %s", __FUNCTION__, static_cast<unsigned int>(names.size()), table.c_str());
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to index %s", __FUNCTION__, table.c_str());
+    return false;
+  }
+
+  std::vector<int> found;
+  if (!index.Find(key, term, found, MAX_SEARCH_INDEX_IDS))
+    return false;
+
+  ids.clear();
+  for (int id : found)
+  {
+    if (!ids.empty())
+      ids += ",";
+    ids += StringUtils::Format("%i", id);
+  }
+  return true;
+}
+
+std::string CDatabase::GetSearchIndexKey() const
+{
+  if (!m_sqlite || nullptr == m_pDB)
+    return "";
+
+  return std::string(m_pDB->getHostName()) + m_pDB->getDatabase();
+}
+
 bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl)
 {
   SortDescription sorting;
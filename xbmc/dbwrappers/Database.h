@@ -19,6 +19,7 @@ namespace dbiplus {
 
 class DatabaseSettings; // forward
 class CDbUrl;
+class CNameIndex;
 class CProfileManager;
 struct SortDescription;
 
@@ -103,7 +104,7 @@ public:
 
   void BeginTransaction();
   virtual bool CommitTransaction();
-  void RollbackTransaction();
+  virtual void RollbackTransaction();
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -234,6 +235,25 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Find items by name through a search index, loading the names into the index first if needed
+   The query still has to check the names, the index may hold items that were removed.
+   \param index the index, shared by all connections to the database.
+   \param table the table of the items.
+   \param idField the id column of the table.
+   \param nameField the name column of the table.
+   \param term the term the names have to contain.
+   \param ids [out] the comma separated ids of the items found, empty if none were.
+   \return false if the index can't be used and the table has to be searched, e.g. when too many items are found.
+   \sa GetSearchIndexKey
+   */
+  bool FindInSearchIndex(CNameIndex &index, const std::string &table, const std::string &idField,
+                         const std::string &nameField, const std::string &term, std::string &ids);
+
+  /*! \brief The key of this database in the search indexes, empty if they aren't used
+   Only sqlite databases are indexed, other clients may change a MySQL database meanwhile.
+   */
+  std::string GetSearchIndexKey() const;
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -341,7 +341,9 @@ long CCurlFile::CReadState::Connect(unsigned int size)
   m_stillRunning = 1;
 
   // (Try to) fill buffer
-  if (FillBuffer(1) != FILLBUFFER_OK)
+  int8_t result = FillBuffer(1);
+  g_curlInterface.UpdateStatistics(m_easyHandle);
+  if (result != FILLBUFFER_OK)
   {
     // Check response code
     long response;
@@ -471,6 +473,9 @@ void CCurlFile::SetCommonOptions(CReadState* state, bool failOnError /* = true *
   g_curlInterface.easy_setopt(h, CURLOPT_READDATA, state);
   g_curlInterface.easy_setopt(h, CURLOPT_READFUNCTION, read_callback);
 
+  // keep pooled connections alive while they're idle
+  g_curlInterface.easy_setopt(h, CURLOPT_TCP_KEEPALIVE, 1L);
+
   // set username and password for current handle
   if (m_username.length() > 0 && m_password.length() > 0)
   {
@@ -1237,6 +1242,7 @@ bool CCurlFile::Exists(const CURL& url)
   }
 
   CURLcode result = g_curlInterface.easy_perform(m_state->m_easyHandle);
+  g_curlInterface.UpdateStatistics(m_state->m_easyHandle);
 
   if (result == CURLE_WRITE_ERROR || result == CURLE_OK)
   {
@@ -1263,6 +1269,7 @@ bool CCurlFile::Exists(const CURL& url)
         g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_HTTPHEADER, list);
         
         CURLcode result = g_curlInterface.easy_perform(m_state->m_easyHandle);
+        g_curlInterface.UpdateStatistics(m_state->m_easyHandle);
         g_curlInterface.slist_free_all(list);
         
         if (result == CURLE_WRITE_ERROR || result == CURLE_OK)
@@ -1439,6 +1446,7 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
   }
 
   CURLcode result = g_curlInterface.easy_perform(m_state->m_easyHandle);
+  g_curlInterface.UpdateStatistics(m_state->m_easyHandle);
 
   if(result == CURLE_HTTP_RETURNED_ERROR)
   {
@@ -1470,7 +1478,7 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
     g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_NOPROGRESS, 0);
 
     result = g_curlInterface.easy_perform(m_state->m_easyHandle);
-
+    g_curlInterface.UpdateStatistics(m_state->m_easyHandle);
   }
 
   if( result != CURLE_ABORTED_BY_CALLBACK && result != CURLE_OK )
@@ -12,8 +12,15 @@
 #include "threads/SystemClock.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <assert.h>
 
+namespace
+{
+/* idle time before closing a session */
+const unsigned int IDLE_TIMEOUT = 30000;
+} // namespace
+
 namespace XCURL
 {
 CURLcode DllLibCurl::global_init(long flags)
@@ -130,41 +137,198 @@ DllLibCurlGlobal::DllLibCurlGlobal()
   {
     CLog::Log(LOGERROR, "Error initializing libcurl");
   }
+
+  share_init();
 }
 
 DllLibCurlGlobal::~DllLibCurlGlobal()
 {
+  {
+    CSingleLock lock(m_critSection);
+    VEC_CURLSESSIONS::iterator it = m_sessions.begin();
+    while (it != m_sessions.end())
+    {
+      if (!it->m_busy)
+      {
+        session_cleanup(*it);
+        it = m_sessions.erase(it);
+        continue;
+      }
+      ++it;
+    }
+    share_cleanup();
+  }
+
   // close libcurl
   curl_global_cleanup();
 }
 
+void DllLibCurlGlobal::share_init()
+{
+  m_share = curl_share_init();
+  if (!m_share)
+  {
+    CLog::Log(LOGERROR, "Error initializing libcurl share");
+    return;
+  }
+
+  curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock);
+  curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+  curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+  curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+void DllLibCurlGlobal::share_cleanup()
+{
+  /* fails as long as a handle uses the share */
+  if (m_share && curl_share_cleanup(m_share) == CURLSHE_OK)
+    m_share = nullptr;
+}
+
+void DllLibCurlGlobal::share_attach(CURL_HANDLE* easy_handle)
+{
+  /* kept by easy_reset() */
+  if (m_share && easy_handle)
+    easy_setopt(easy_handle, CURLOPT_SHARE, m_share);
+}
+
+void DllLibCurlGlobal::share_lock(CURL_HANDLE* handle,
+                                  curl_lock_data data,
+                                  curl_lock_access access,
+                                  void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].lock();
+}
+
+void DllLibCurlGlobal::share_unlock(CURL_HANDLE* handle, curl_lock_data data, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].unlock();
+}
+
+void DllLibCurlGlobal::session_cleanup(SSession& session)
+{
+  CLog::Log(LOGINFO, "%s - Closing session to %s://%s (easy=%p, multi=%p)\n", __FUNCTION__,
+            session.m_protocol.c_str(), session.m_hostname.c_str(),
+            static_cast<void*>(session.m_easy), static_cast<void*>(session.m_multi));
+
+  if (session.m_multi && session.m_easy)
+    multi_remove_handle(session.m_multi, session.m_easy);
+  if (session.m_easy)
+    easy_cleanup(session.m_easy);
+  if (session.m_multi)
+    multi_cleanup(session.m_multi);
+
+  session.m_easy = NULL;
+  session.m_multi = NULL;
+}
+
 void DllLibCurlGlobal::CheckIdle()
 {
   CSingleLock lock(m_critSection);
-  /* 20 seconds idle time before closing handle */
-  const unsigned int idletime = 30000;
 
+  bool closed = false;
   VEC_CURLSESSIONS::iterator it = m_sessions.begin();
   while (it != m_sessions.end())
   {
-    if (!it->m_busy && (XbmcThreads::SystemClockMillis() - it->m_idletimestamp) > idletime)
+    if (!it->m_busy && (XbmcThreads::SystemClockMillis() - it->m_idletimestamp) > IDLE_TIMEOUT)
     {
-      CLog::Log(LOGINFO, "%s - Closing session to %s://%s (easy=%p, multi=%p)\n", __FUNCTION__,
-                it->m_protocol.c_str(), it->m_hostname.c_str(), static_cast<void*>(it->m_easy),
-                static_cast<void*>(it->m_multi));
-
-      if (it->m_multi && it->m_easy)
-        multi_remove_handle(it->m_multi, it->m_easy);
-      if (it->m_easy)
-        easy_cleanup(it->m_easy);
-      if (it->m_multi)
-        multi_cleanup(it->m_multi);
-
+      session_cleanup(*it);
       it = m_sessions.erase(it);
+      closed = true;
       continue;
     }
     ++it;
   }
+
+  if (closed && m_sessions.empty())
+  {
+    SConnectionStatistics statistics = GetStatistics();
+    CLog::Log(LOGDEBUG, "%s - %u transfers, %u handshakes (%u TLS) taking %.3fs, %.3fs saved by reusing connections",
+              __FUNCTION__, statistics.m_transfers, statistics.m_handshakes, statistics.m_tlsHandshakes,
+              statistics.m_handshakeTime, statistics.m_timeSaved);
+  }
+}
+
+void DllLibCurlGlobal::UpdateStatistics(CURL_HANDLE* easy_handle)
+{
+  if (!easy_handle)
+    return;
+
+  /* transfers that never got connected don't count */
+  char* ip = NULL;
+  if (easy_getinfo(easy_handle, CURLINFO_PRIMARY_IP, &ip) != CURLE_OK || !ip || !*ip)
+    return;
+
+  long connects = 0;
+  double namelookup = 0.0;
+  double connect = 0.0;
+  double appconnect = 0.0;
+  easy_getinfo(easy_handle, CURLINFO_NUM_CONNECTS, &connects);
+  easy_getinfo(easy_handle, CURLINFO_NAMELOOKUP_TIME, &namelookup);
+  easy_getinfo(easy_handle, CURLINFO_CONNECT_TIME, &connect);
+  easy_getinfo(easy_handle, CURLINFO_APPCONNECT_TIME, &appconnect);
+
+  CSingleLock lock(m_critSection);
+
+  for (const auto& it : m_sessions)
+  {
+    if (it.m_easy != easy_handle)
+      continue;
+
+    SConnectionStatistics& statistics = m_statistics[it.m_protocol + "://" + it.m_hostname];
+    statistics.m_transfers++;
+    if (connects > 0)
+    {
+      statistics.m_handshakes += connects;
+      if (appconnect > 0.0)
+        statistics.m_tlsHandshakes += connects;
+      statistics.m_handshakeTime += std::max(0.0, std::max(connect, appconnect) - namelookup);
+    }
+    else
+    {
+      /* a kept alive connection saves what a handshake with this host takes on average */
+      statistics.m_reused++;
+      if (statistics.m_handshakes > 0)
+        statistics.m_timeSaved += statistics.m_handshakeTime / statistics.m_handshakes;
+    }
+    return;
+  }
+}
+
+DllLibCurlGlobal::SConnectionStatistics DllLibCurlGlobal::GetStatistics()
+{
+  CSingleLock lock(m_critSection);
+
+  SConnectionStatistics total;
+  for (const auto& it : m_statistics)
+  {
+    total.m_transfers += it.second.m_transfers;
+    total.m_handshakes += it.second.m_handshakes;
+    total.m_tlsHandshakes += it.second.m_tlsHandshakes;
+    total.m_reused += it.second.m_reused;
+    total.m_handshakeTime += it.second.m_handshakeTime;
+    total.m_timeSaved += it.second.m_timeSaved;
+  }
+  return total;
+}
+
+DllLibCurlGlobal::SConnectionStatistics DllLibCurlGlobal::GetStatistics(const std::string& protocol,
+                                                                        const std::string& hostname)
+{
+  CSingleLock lock(m_critSection);
+
+  auto it = m_statistics.find(protocol + "://" + hostname);
+  if (it == m_statistics.end())
+    return SConnectionStatistics();
+  return it->second;
+}
+
+unsigned int DllLibCurlGlobal::CountPooled(const std::string& protocol, const std::string& hostname) const
+{
+  return static_cast<unsigned int>(std::count_if(m_sessions.begin(), m_sessions.end(), [&](const SSession& session) {
+    return session.m_pooled && session.m_protocol == protocol && session.m_hostname == hostname;
+  }));
 }
 
 void DllLibCurlGlobal::easy_acquire(const char* protocol,
@@ -188,7 +352,10 @@ void DllLibCurlGlobal::easy_acquire(const char* protocol,
         if (easy_handle)
         {
           if (!it.m_easy)
+          {
             it.m_easy = easy_init();
+            share_attach(it.m_easy);
+          }
 
           *easy_handle = it.m_easy;
         }
@@ -206,14 +373,20 @@ void DllLibCurlGlobal::easy_acquire(const char* protocol,
     }
   }
 
+  /* never wait for a session to be released, beyond the sessions pooled for a host
+     the caller gets one of its own, closed again on release */
+  const unsigned int pooled = CountPooled(protocol, hostname);
+
   SSession session = {};
   session.m_busy = true;
+  session.m_pooled = pooled < MAX_CONNECTIONS_PER_HOST;
   session.m_protocol = protocol;
   session.m_hostname = hostname;
 
   if (easy_handle)
   {
     session.m_easy = easy_init();
+    share_attach(session.m_easy);
     *easy_handle = session.m_easy;
   }
 
@@ -225,7 +398,11 @@ void DllLibCurlGlobal::easy_acquire(const char* protocol,
 
   m_sessions.push_back(session);
 
-  CLog::Log(LOGINFO, "%s - Created session to %s://%s\n", __FUNCTION__, protocol, hostname);
+  if (session.m_pooled)
+    CLog::Log(LOGINFO, "%s - Created session to %s://%s\n", __FUNCTION__, protocol, hostname);
+  else
+    CLog::Log(LOGDEBUG, "%s - Created unpooled session to %s://%s, %u pooled sessions in use\n",
+              __FUNCTION__, protocol, hostname, pooled);
 }
 
 void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle)
@@ -247,15 +424,35 @@ void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_han
     *multi_handle = NULL;
   }
 
-  for (auto& it : m_sessions)
+  for (VEC_CURLSESSIONS::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
   {
-    if (it.m_easy == easy && (multi == nullptr || it.m_multi == multi))
+    if (it->m_easy == easy && (multi == nullptr || it->m_multi == multi))
     {
       /* reset session so next caller doesn't reuse options, only connections */
       /* will reset verbose too so it won't print that it closed connections on cleanup*/
       easy_reset(easy);
-      it.m_busy = false;
-      it.m_idletimestamp = XbmcThreads::SystemClockMillis();
+      it->m_busy = false;
+      it->m_idletimestamp = XbmcThreads::SystemClockMillis();
+
+      /* sessions beyond the pool aren't kept */
+      if (!it->m_pooled)
+      {
+        session_cleanup(*it);
+        m_sessions.erase(it);
+        return;
+      }
+
+      /* don't keep more idle sessions than needed */
+      const std::string& protocol = it->m_protocol;
+      const std::string& hostname = it->m_hostname;
+      size_t idle = std::count_if(m_sessions.begin(), m_sessions.end(), [&](const SSession& session) {
+        return !session.m_busy && session.m_protocol == protocol && session.m_hostname == hostname;
+      });
+      if (idle > MAX_IDLE_SESSIONS_PER_HOST)
+      {
+        session_cleanup(*it);
+        m_sessions.erase(it);
+      }
       return;
     }
   }
@@ -270,7 +467,9 @@ CURL_HANDLE* DllLibCurlGlobal::easy_duphandle(CURL_HANDLE* easy_handle)
     if (it.m_easy == easy_handle)
     {
       SSession session = it;
+      session.m_pooled = CountPooled(it.m_protocol, it.m_hostname) < MAX_CONNECTIONS_PER_HOST;
       session.m_easy = DllLibCurl::easy_duphandle(easy_handle);
+      share_attach(session.m_easy);
       m_sessions.push_back(session);
       return session.m_easy;
     }
@@ -296,8 +495,12 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy,
     if (it.m_easy == easy)
     {
       SSession session = it;
+      session.m_pooled = CountPooled(it.m_protocol, it.m_hostname) < MAX_CONNECTIONS_PER_HOST;
       if (easy_out && easy)
+      {
         session.m_easy = *easy_out;
+        share_attach(session.m_easy);
+      }
       else
         session.m_easy = NULL;
 
@@ -10,6 +10,7 @@
 
 #include "threads/CriticalSection.h"
 
+#include <map>
 #include <stdio.h>
 #include <string>
 #include <sys/time.h>
@@ -77,6 +78,26 @@ public:
   CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle) override;
   void CheckIdle();
 
+  /* sessions to a host kept in the pool, easy_acquire() opens sessions closed on release beyond that */
+  static const unsigned int MAX_CONNECTIONS_PER_HOST = 6;
+  /* idle sessions kept per host, the others are closed with their connections */
+  static const unsigned int MAX_IDLE_SESSIONS_PER_HOST = 4;
+
+  /* connections used by the transfers to a host */
+  struct SConnectionStatistics
+  {
+    unsigned int m_transfers = 0;
+    unsigned int m_handshakes = 0; // new connections, TCP and possibly TLS handshake
+    unsigned int m_tlsHandshakes = 0;
+    unsigned int m_reused = 0; // transfers over a kept alive connection
+    double m_handshakeTime = 0.0; // seconds spent on handshakes
+    double m_timeSaved = 0.0; // estimated seconds saved by reusing connections
+  };
+
+  void UpdateStatistics(CURL_HANDLE* easy_handle);
+  SConnectionStatistics GetStatistics();
+  SConnectionStatistics GetStatistics(const std::string& protocol, const std::string& hostname);
+
   /* overloaded load and unload with reference counter */
 
   /* structure holding a session info */
@@ -86,6 +107,7 @@ public:
     std::string m_protocol;
     std::string m_hostname;
     bool m_busy;
+    bool m_pooled; // kept for reuse once released, otherwise closed
     CURL_HANDLE* m_easy;
     CURLM* m_multi;
   } SSession;
@@ -94,6 +116,24 @@ public:
 
   VEC_CURLSESSIONS m_sessions;
   CCriticalSection m_critSection;
+
+private:
+  /* TLS sessions and DNS entries are shared by all sessions, connections are kept by
+     the session handles as libcurl doesn't support sharing them between threads */
+  void share_init();
+  void share_cleanup();
+  void share_attach(CURL_HANDLE* easy_handle);
+  void session_cleanup(SSession& session);
+  unsigned int CountPooled(const std::string& protocol, const std::string& hostname) const;
+  static void share_lock(CURL_HANDLE* handle,
+                         curl_lock_data data,
+                         curl_lock_access access,
+                         void* userptr);
+  static void share_unlock(CURL_HANDLE* handle, curl_lock_data data, void* userptr);
+
+  CURLSH* m_share = nullptr;
+  CCriticalSection m_shareLocks[CURL_LOCK_DATA_LAST];
+  std::map<std::string, SConnectionStatistics> m_statistics; // by protocol://hostname
 };
 } // namespace XCURL
 
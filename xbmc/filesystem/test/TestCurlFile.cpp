@@ -0,0 +1,251 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/DllLibCurl.h"
+#include "utils/StringUtils.h"
+
+#if !defined(TARGET_WINDOWS)
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace XCURL;
+
+namespace
+{
+const std::string BODY = "Kodi";
+
+// minimal HTTP/1.1 server counting the connections it accepts
+class CHTTPStandIn
+{
+public:
+  explicit CHTTPStandIn(bool keepAlive) : m_keepAlive(keepAlive)
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+        listen(m_socket, 16) == 0 &&
+        getsockname(m_socket, reinterpret_cast<sockaddr*>(&addr), &length) == 0)
+      m_port = ntohs(addr.sin_port);
+
+    m_acceptor = std::thread([this]() {
+      int client;
+      while ((client = accept(m_socket, nullptr, nullptr)) >= 0)
+      {
+        m_connections++;
+        m_clients.emplace_back(&CHTTPStandIn::Serve, this, client);
+      }
+    });
+  }
+
+  ~CHTTPStandIn()
+  {
+    // connections kept alive by the pool are dropped
+    m_stop = true;
+    shutdown(m_socket, SHUT_RDWR);
+    close(m_socket);
+    m_acceptor.join();
+    for (auto& client : m_clients)
+      client.join();
+  }
+
+  std::string URL() const { return StringUtils::Format("http://127.0.0.1:%d/file", m_port); }
+  int Connections() const { return m_connections; }
+
+private:
+  void Serve(int client)
+  {
+    timeval timeout = {0, 100000};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (!m_stop)
+    {
+      ssize_t size = recv(client, buffer, sizeof(buffer), 0);
+      if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        continue;
+      if (size <= 0)
+        break;
+
+      request.append(buffer, size);
+      size_t end;
+      while ((end = request.find("\r\n\r\n")) != std::string::npos)
+      {
+        const bool head = StringUtils::StartsWith(request, "HEAD");
+        request.erase(0, end + 4);
+
+        std::string response = StringUtils::Format("HTTP/1.1 200 OK\r\nContent-Length: %d\r\n", static_cast<int>(BODY.size()));
+        response += m_keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        if (!head)
+          response += BODY;
+        send(client, response.data(), response.size(), MSG_NOSIGNAL);
+
+        if (!m_keepAlive)
+        {
+          close(client);
+          return;
+        }
+      }
+    }
+    close(client);
+  }
+
+  bool m_keepAlive;
+  int m_socket = -1;
+  int m_port = 0;
+  std::atomic<int> m_connections{0};
+  std::atomic<bool> m_stop{false};
+  std::thread m_acceptor;
+  std::vector<std::thread> m_clients;
+};
+
+size_t Discard(char* buffer, size_t size, size_t nitems, void* userp)
+{
+  return size * nitems;
+}
+
+void Perform(DllLibCurlGlobal& pool, CURL_HANDLE* easy, const std::string& url)
+{
+  pool.easy_setopt(easy, CURLOPT_URL, url.c_str());
+  pool.easy_setopt(easy, CURLOPT_WRITEFUNCTION, Discard);
+  EXPECT_EQ(CURLE_OK, pool.easy_perform(easy));
+  pool.UpdateStatistics(easy);
+}
+}
+
+TEST(TestCurlFile, SessionsKeepTheirConnections)
+{
+  CHTTPStandIn server(true);
+  DllLibCurlGlobal pool;
+
+  // two files of the same host open at once get a session and a connection each
+  CURL_HANDLE* first = nullptr;
+  CURL_HANDLE* second = nullptr;
+  CURLM* multi = nullptr;
+  pool.easy_acquire("http", "127.0.0.1", &first, &multi);
+  pool.easy_acquire("http", "127.0.0.1", &second, &multi);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  ASSERT_NE(first, second);
+
+  Perform(pool, first, server.URL());
+  Perform(pool, second, server.URL());
+  Perform(pool, first, server.URL());
+  pool.easy_release(&first, nullptr);
+
+  // the next file gets the released session and its kept alive connection
+  CURL_HANDLE* third = nullptr;
+  pool.easy_acquire("http", "127.0.0.1", &third, &multi);
+  Perform(pool, third, server.URL());
+
+  DllLibCurlGlobal::SConnectionStatistics statistics = pool.GetStatistics("http", "127.0.0.1");
+  EXPECT_EQ(4u, statistics.m_transfers);
+  EXPECT_EQ(2u, statistics.m_handshakes);
+  EXPECT_EQ(2u, statistics.m_reused);
+  EXPECT_EQ(0u, statistics.m_tlsHandshakes);
+  EXPECT_EQ(2, server.Connections());
+
+  pool.easy_release(&second, nullptr);
+  pool.easy_release(&third, nullptr);
+}
+
+TEST(TestCurlFile, BusySessionsDontStallRequests)
+{
+  CHTTPStandIn server(true);
+  DllLibCurlGlobal pool;
+  CURLM* multi = nullptr;
+
+  // long lived files, like streams, keep all sessions the pool has for the host busy
+  std::vector<CURL_HANDLE*> handles(DllLibCurlGlobal::MAX_CONNECTIONS_PER_HOST);
+  for (auto& handle : handles)
+  {
+    pool.easy_acquire("http", "127.0.0.1", &handle, &multi);
+    ASSERT_NE(nullptr, handle);
+  }
+
+  // a short request of another thread gets a session of its own right away
+  auto request = std::async(std::launch::async, [&]() {
+    CURL_HANDLE* handle = nullptr;
+    CURLM* multi = nullptr;
+    pool.easy_acquire("http", "127.0.0.1", &handle, &multi);
+    if (!handle)
+      return false;
+    Perform(pool, handle, server.URL());
+    pool.easy_release(&handle, &multi);
+    return true;
+  });
+  ASSERT_EQ(std::future_status::ready, request.wait_for(std::chrono::seconds(10)));
+  EXPECT_TRUE(request.get());
+  EXPECT_EQ(1u, pool.GetStatistics("http", "127.0.0.1").m_transfers);
+
+  // which isn't pooled, so the pool doesn't grow
+  EXPECT_EQ(handles.size(), pool.m_sessions.size());
+  for (const auto& session : pool.m_sessions)
+    EXPECT_TRUE(session.m_pooled);
+
+  // once released, the pooled sessions are reused
+  CURL_HANDLE* released = handles.back();
+  pool.easy_release(&released, nullptr);
+  CURL_HANDLE* reused = nullptr;
+  pool.easy_acquire("http", "127.0.0.1", &reused, &multi);
+  EXPECT_EQ(handles.back(), reused);
+  EXPECT_EQ(handles.size(), pool.m_sessions.size());
+  handles.back() = reused;
+
+  for (auto& handle : handles)
+    pool.easy_release(&handle, nullptr);
+}
+
+TEST(TestCurlFile, IdleSessionsAreLimited)
+{
+  DllLibCurlGlobal pool;
+  CURLM* multi = nullptr;
+
+  std::vector<CURL_HANDLE*> handles(DllLibCurlGlobal::MAX_IDLE_SESSIONS_PER_HOST + 2);
+  for (auto& handle : handles)
+    pool.easy_acquire("http", "127.0.0.1", &handle, &multi);
+  CURL_HANDLE* other = nullptr;
+  pool.easy_acquire("http", "127.0.0.2", &other, &multi);
+  for (auto& handle : handles)
+    pool.easy_release(&handle, nullptr);
+  pool.easy_release(&other, nullptr);
+
+  // the surplus sessions are closed with their connections, other hosts keep theirs
+  unsigned int sessions = 0;
+  for (const auto& session : pool.m_sessions)
+  {
+    EXPECT_FALSE(session.m_busy);
+    if (session.m_hostname == "127.0.0.1")
+      sessions++;
+  }
+  EXPECT_EQ(static_cast<unsigned int>(DllLibCurlGlobal::MAX_IDLE_SESSIONS_PER_HOST), sessions);
+  EXPECT_EQ(static_cast<size_t>(DllLibCurlGlobal::MAX_IDLE_SESSIONS_PER_HOST) + 1, pool.m_sessions.size());
+}
+
+#endif
@@ -10,6 +10,8 @@
 
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdio.h>
 
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
@@ -71,3 +73,85 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CTileDirtyRegionSolver::CTileDirtyRegionSolver(int tileSize)
+{
+  m_tileSize = std::max(tileSize, 8);
+}
+
+void CTileDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  Solve(input, CServiceBroker::GetWinSystem()->GetGfxContext().GetViewWindow(), output);
+}
+
+void CTileDirtyRegionSolver::Solve(const CDirtyRegionList &input, const CRect &viewport, CDirtyRegionList &output)
+{
+  if (input.empty() || viewport.IsEmpty())
+    return;
+
+  const float tileSize = static_cast<float>(m_tileSize);
+  const int columns = static_cast<int>(std::ceil(viewport.Width() / tileSize));
+  const int rows = static_cast<int>(std::ceil(viewport.Height() / tileSize));
+
+  // mark the tiles touched by any of the regions
+  m_tiles.assign(columns * rows, false);
+  for (const auto& region : input)
+  {
+    CRect rect(region);
+    rect.Intersect(viewport);
+    if (rect.IsEmpty())
+      continue;
+
+    int left = static_cast<int>((rect.x1 - viewport.x1) / tileSize);
+    int top = static_cast<int>((rect.y1 - viewport.y1) / tileSize);
+    int right = std::min(static_cast<int>(std::ceil((rect.x2 - viewport.x1) / tileSize)), columns);
+    int bottom = std::min(static_cast<int>(std::ceil((rect.y2 - viewport.y1) / tileSize)), rows);
+    for (int y = top; y < bottom; y++)
+      std::fill(m_tiles.begin() + y * columns + left, m_tiles.begin() + y * columns + right, true);
+  }
+
+  // a run of marked tiles [first, last) in a row, open since row start
+  struct Span
+  {
+    int first;
+    int last;
+    int start;
+  };
+
+  auto emit = [&](const Span &span, int end)
+  {
+    CDirtyRegion region(viewport.x1 + span.first * tileSize, viewport.y1 + span.start * tileSize,
+                        viewport.x1 + span.last * tileSize, viewport.y1 + end * tileSize);
+    region.Intersect(viewport);
+    output.push_back(region);
+  };
+
+  std::vector<Span> open;
+  std::vector<Span> current;
+  for (int y = 0; y <= rows; y++)
+  {
+    current.clear();
+    for (int x = 0; y < rows && x < columns; x++)
+    {
+      if (!m_tiles[y * columns + x])
+        continue;
+      int first = x;
+      while (x < columns && m_tiles[y * columns + x])
+        x++;
+      current.push_back({ first, x, y });
+    }
+
+    // extend the spans of the previous row that continue unchanged, close the others
+    auto it = current.begin();
+    for (const auto& span : open)
+    {
+      while (it != current.end() && it->first < span.first)
+        ++it;
+      if (it != current.end() && it->first == span.first && it->last == span.last)
+        it->start = span.start;
+      else
+        emit(span, y);
+    }
+    open.swap(current);
+  }
+}
@@ -10,6 +10,8 @@
 
 #include "IDirtyRegionSolver.h"
 
+#include <vector>
+
 class CUnionDirtyRegionSolver : public IDirtyRegionSolver
 {
 public:
@@ -37,3 +39,23 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Solver marking the screen tiles touched by dirty regions.
+
+ The viewport is split into a grid of square tiles. Every tile touched by a dirty
+ region is marked, and the marked tiles are then merged into as few non-overlapping
+ rectangles as possible (runs of tiles per row, extended downwards while the next row
+ has the exact same run). Each rectangle is rendered with scissoring, so no pixel is
+ drawn twice and small changes far apart don't cause the area between them to be redrawn.
+ */
+class CTileDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  explicit CTileDirtyRegionSolver(int tileSize);
+  void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) override;
+  void Solve(const CDirtyRegionList &input, const CRect &viewport, CDirtyRegionList &output);
+private:
+  int m_tileSize;
+  std::vector<bool> m_tiles;
+};
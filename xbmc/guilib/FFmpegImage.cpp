@@ -139,7 +139,7 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
                                       unsigned int width, unsigned int height)
 {
 
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, width, height))
   {
     //log
     return false;
@@ -151,7 +151,8 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
   return !(m_pFrame == nullptr);
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
+bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize,
+                              unsigned int maxWidth /* = 0 */, unsigned int maxHeight /* = 0 */)
 {
   int bufferSize = 4096;
   uint8_t* fbuffer = (uint8_t*)av_malloc(bufferSize + AV_INPUT_BUFFER_PADDING_SIZE);
@@ -249,6 +250,24 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
     return false;
   }
 
+  if (codec_params->codec_id == AV_CODEC_ID_MJPEG && maxWidth && maxHeight &&
+      codec_params->width > 0 && codec_params->height > 0)
+  {
+    // scale down in the DCT domain, which saves most of the decoding work for images
+    // much larger than needed. The result must not be smaller than the image fitted
+    // into maxWidth x maxHeight, so the final scale is always a downscale.
+    const float scale = std::min(1.0f, std::min(static_cast<float>(maxWidth) / codec_params->width,
+                                                static_cast<float>(maxHeight) / codec_params->height));
+    const int fitWidth = static_cast<int>(codec_params->width * scale + 0.5f);
+    const int fitHeight = static_cast<int>(codec_params->height * scale + 0.5f);
+    int lowres = 0;
+    while (lowres < codec->max_lowres &&
+           (codec_params->width >> (lowres + 1)) >= fitWidth &&
+           (codec_params->height >> (lowres + 1)) >= fitHeight)
+      lowres++;
+    m_codec_ctx->lowres = lowres;
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -293,8 +312,10 @@ AVFrame* CFFmpegImage::ExtractFrame()
   frame->pkt_duration = av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 });
   m_height = frame->height;
   m_width = frame->width;
-  m_originalWidth = m_width;
-  m_originalHeight = m_height;
+  // frames decoded at reduced resolution are smaller than the image
+  const AVCodecParameters* codec_params = m_fctx->streams[0]->codecpar;
+  m_originalWidth = std::max(m_width, static_cast<unsigned int>(codec_params->width));
+  m_originalHeight = std::max(m_height, static_cast<unsigned int>(codec_params->height));
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -468,8 +489,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -481,7 +502,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -494,7 +515,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
@@ -69,7 +69,15 @@ public:
                                   unsigned int &bufferoutSize) override;
   void ReleaseThumbnailBuffer() override;
 
-  bool Initialize(unsigned char* buffer, size_t bufSize);
+  /*! \brief Open the image for decoding
+   \param buffer the encoded image.
+   \param bufSize size of the encoded image.
+   \param maxWidth maximum width the image will be shown at, 0 if unknown.
+   \param maxHeight maximum height the image will be shown at, 0 if unknown.
+   Given a maximum size, JPEGs are downscaled while decoding as far as possible without
+   getting smaller than that size.
+   */
+  bool Initialize(unsigned char* buffer, size_t bufSize, unsigned int maxWidth = 0, unsigned int maxHeight = 0);
 
   std::shared_ptr<Frame> ReadFrame();
 
@@ -14,6 +14,7 @@
 */
 
 #include "GUIAction.h"
+#include "GUIListItemLayoutPool.h"
 #include "IGUIContainer.h"
 #include "utils/Stopwatch.h"
 
@@ -152,6 +153,8 @@ protected:
   bool m_layoutCondition = false;
   bool m_focusedLayoutCondition = false;
 
+  CGUIListItemLayoutPool m_layoutPool; ///< \brief layouts of the items currently in view, recycled as items scroll in and out
+
   void ScrollToOffset(int offset);
   void SetContainerMoving(int direction);
   void UpdateScrollOffset(unsigned int currentTime);
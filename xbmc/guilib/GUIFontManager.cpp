@@ -15,6 +15,7 @@
 #include "addons/FontResource.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "LocalizeStrings.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
@@ -32,6 +33,10 @@
 #include "filesystem/SpecialProtocol.h"
 #endif
 
+#include <algorithm>
+
+#define PREWARM_CHARACTERS 512 // most used characters of the language to prewarm fonts with
+
 using namespace ADDON;
 
 GUIFontManager::GUIFontManager(void)
@@ -129,7 +134,8 @@ CGUIFont* GUIFontManager::LoadTTF(const std::string& strFontName, const std::str
   }
 
   // check if we already have this font file loaded (font object could differ only by color or style)
-  std::string TTFfontName = StringUtils::Format("%s_%f_%f%s", strFilename.c_str(), newSize, aspect, border ? "_border" : "");
+  // key on the resolved path, so fonts referring to the same file differently share it too
+  std::string TTFfontName = StringUtils::Format("%s_%f_%f%s", strPath.c_str(), newSize, aspect, border ? "_border" : "");
 
   CGUIFontTTFBase* pFontFile = GetFontFile(TTFfontName);
   if (!pFontFile)
@@ -218,11 +224,10 @@ void GUIFontManager::ReloadTTFFonts(void)
     float aspect = fontInfo.aspect;
     float newSize = (float)fontInfo.size;
     std::string& strPath = fontInfo.fontFilePath;
-    std::string& strFilename = fontInfo.fileName;
 
     RescaleFontSizeAndAspect(&newSize, &aspect, fontInfo.sourceRes, fontInfo.preserveAspect);
 
-    std::string TTFfontName = StringUtils::Format("%s_%f_%f%s", strFilename.c_str(), newSize, aspect, fontInfo.border ? "_border" : "");
+    std::string TTFfontName = StringUtils::Format("%s_%f_%f%s", strPath.c_str(), newSize, aspect, fontInfo.border ? "_border" : "");
     CGUIFontTTFBase* pFontFile = GetFontFile(TTFfontName);
     if (!pFontFile)
     {
@@ -240,6 +245,39 @@ void GUIFontManager::ReloadTTFFonts(void)
 
     font->SetFont(pFontFile);
   }
+
+  PrewarmFonts();
+}
+
+void GUIFontManager::PrewarmFonts()
+{
+  const std::wstring letters = g_localizeStrings.GetCommonCharacters(PREWARM_CHARACTERS);
+  if (letters.empty())
+    return;
+
+  for (CGUIFontTTFBase* fontFile : m_vecFontFiles)
+  {
+    std::vector<uint32_t> styles;
+    for (const CGUIFont* font : m_vecFonts)
+    {
+      // only these styles change the glyphs, the others change the text
+      const uint32_t style = font->GetStyle() & (FONT_STYLE_BOLD | FONT_STYLE_ITALICS | FONT_STYLE_LIGHT);
+      if (font->GetFont() == fontFile && std::find(styles.begin(), styles.end(), style) == styles.end())
+        styles.push_back(style);
+    }
+    if (!styles.empty())
+      fontFile->Prewarm(letters, styles);
+  }
+}
+
+void GUIFontManager::GetGlyphCounters(unsigned int &onDemand, unsigned int &prewarmed) const
+{
+  onDemand = prewarmed = 0;
+  for (const CGUIFontTTFBase* fontFile : m_vecFontFiles)
+  {
+    onDemand += fontFile->GetOnDemandRasterizations();
+    prewarmed += fontFile->GetPrewarmedGlyphs();
+  }
 }
 
 void GUIFontManager::Unload(const std::string& strFontName)
@@ -376,6 +414,7 @@ void GUIFontManager::LoadFonts(const std::string& fontSet)
       if (StringUtils::EqualsNoCase(fontSet, idAttr))
       {
         LoadFonts(pChild->FirstChild("font"));
+        PrewarmFonts();
         return;
       }
     }
@@ -66,10 +66,17 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief Get the glyph counters of all loaded fonts
+   \param onDemand number of glyphs rasterized on demand while rendering.
+   \param prewarmed number of glyphs rasterized on a worker ahead of rendering.
+   */
+  void GetGlyphCounters(unsigned int &onDemand, unsigned int &prewarmed) const;
+
   static void SettingOptionsFontsFiller(std::shared_ptr<const CSetting> setting, std::vector<StringSettingOption> &list, std::string &current, void *data);
 
 protected:
   void ReloadTTFFonts();
+  void PrewarmFonts();
   static void RescaleFontSizeAndAspect(float *size, float *aspect, const RESOLUTION_INFO &sourceRes, bool preserveAspect);
   void LoadFonts(const TiXmlNode* fontNode);
   CGUIFontTTFBase* GetFontFile(const std::string& strFontFile);
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIFontSDFAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+
+CGUIFontSDFAtlas::CGUIFontSDFAtlas(unsigned int width, unsigned int height, unsigned int spread)
+  : m_width(width), m_height(height), m_spread(std::max(spread, 1u)), m_pixels(width * height, 0)
+{
+}
+
+const CGUIFontSDFAtlas::Glyph* CGUIFontSDFAtlas::Find(uint32_t key) const
+{
+  auto it = m_glyphs.find(key);
+  if (it == m_glyphs.end())
+    return nullptr;
+  return &it->second;
+}
+
+const CGUIFontSDFAtlas::Glyph* CGUIFontSDFAtlas::Add(uint32_t key, const unsigned char* coverage,
+                                                     unsigned int width, unsigned int rows, int pitch,
+                                                     int left, int top, float advance)
+{
+  Glyph glyph = {};
+  glyph.left = left;
+  glyph.top = top;
+  glyph.advance = advance;
+
+  if (coverage && width > 0 && rows > 0)
+  {
+    glyph.width = width + 2 * m_spread;
+    glyph.height = rows + 2 * m_spread;
+    if (glyph.width > m_width)
+      return nullptr;
+
+    if (m_posX + glyph.width > m_width)
+    { // start a new row
+      m_posX = 0;
+      m_posY += m_rowHeight + GLYPH_SPACING;
+      m_rowHeight = 0;
+    }
+    if (m_posY + glyph.height > m_height)
+      return nullptr;
+
+    glyph.x = m_posX;
+    glyph.y = m_posY;
+    GenerateDistanceField(coverage, width, rows, pitch, m_spread,
+                          &m_pixels[glyph.y * m_width + glyph.x], m_width);
+
+    m_posX += glyph.width + GLYPH_SPACING;
+    m_rowHeight = std::max(m_rowHeight, glyph.height);
+    MarkDirty(glyph.y, glyph.y + glyph.height);
+    m_version++;
+  }
+
+  m_rasterized++;
+  return &(m_glyphs[key] = glyph);
+}
+
+void CGUIFontSDFAtlas::Clear()
+{
+  MarkDirty(0, std::min(m_posY + m_rowHeight, m_height));
+  m_glyphs.clear();
+  std::fill(m_pixels.begin(), m_pixels.end(), 0);
+  m_posX = m_posY = m_rowHeight = 0;
+  m_version++;
+  m_epoch++;
+}
+
+bool CGUIFontSDFAtlas::TakeDirtyRows(unsigned int &y1, unsigned int &y2)
+{
+  y1 = m_dirtyY1;
+  y2 = m_dirtyY2;
+  m_dirtyY1 = m_dirtyY2 = 0;
+  return y1 < y2;
+}
+
+void CGUIFontSDFAtlas::MarkDirty(unsigned int y1, unsigned int y2)
+{
+  if (y1 >= y2)
+    return;
+
+  if (m_dirtyY1 < m_dirtyY2)
+  {
+    m_dirtyY1 = std::min(m_dirtyY1, y1);
+    m_dirtyY2 = std::max(m_dirtyY2, y2);
+  }
+  else
+  {
+    m_dirtyY1 = y1;
+    m_dirtyY2 = y2;
+  }
+}
+
+void CGUIFontSDFAtlas::GenerateDistanceField(const unsigned char* coverage, unsigned int width, unsigned int rows,
+                                             int pitch, unsigned int spread, unsigned char* field,
+                                             unsigned int fieldPitch)
+{
+  const int fieldWidth = width + 2 * spread;
+  const int fieldRows = rows + 2 * spread;
+  const int radius = spread;
+
+  // inside/outside mask of the padded glyph, so lookups need no bounds checks
+  std::vector<bool> inside(fieldWidth * fieldRows, false);
+  for (unsigned int y = 0; y < rows; y++)
+  {
+    const unsigned char* src = coverage + static_cast<int>(y) * pitch;
+    for (unsigned int x = 0; x < width; x++)
+      inside[(y + spread) * fieldWidth + x + spread] = src[x] >= 128;
+  }
+
+  for (int y = 0; y < fieldRows; y++)
+  {
+    for (int x = 0; x < fieldWidth; x++)
+    {
+      const bool in = inside[y * fieldWidth + x];
+
+      // distance to the nearest pixel on the other side of the outline
+      int best = (radius + 1) * (radius + 1);
+      const int y1 = std::max(y - radius, 0), y2 = std::min(y + radius, fieldRows - 1);
+      const int x1 = std::max(x - radius, 0), x2 = std::min(x + radius, fieldWidth - 1);
+      for (int sy = y1; sy <= y2; sy++)
+      {
+        const int dy2 = (sy - y) * (sy - y);
+        if (dy2 >= best)
+          continue;
+        for (int sx = x1; sx <= x2; sx++)
+        {
+          if (inside[sy * fieldWidth + sx] == in)
+            continue;
+          const int d2 = dy2 + (sx - x) * (sx - x);
+          if (d2 < best)
+            best = d2;
+        }
+      }
+
+      // the outline runs half way between the two pixel centres
+      float distance = std::sqrt(static_cast<float>(best)) - 0.5f;
+      if (!in)
+        distance = -distance;
+      const float value = 128.0f + distance * 127.0f / radius;
+      field[y * fieldPitch + x] = static_cast<unsigned char>(std::min(std::max(value, 0.0f), 255.0f));
+    }
+  }
+}
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <map>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Glyph atlas holding signed distance fields.
+
+ Glyphs are rasterized once at a base size and stored as distance to the glyph outline,
+ with the outline at 128 (inside above, outside below). A distance field can be scaled
+ up and down without getting blurry, so one atlas serves all sizes of a font face, where
+ bitmap fonts need a texture (and rasterization) per size.
+
+ Glyphs are packed in rows. Once the atlas is full, Add() fails and the atlas has to be
+ cleared, which invalidates all glyphs handed out before (see GetEpoch()).
+ */
+class CGUIFontSDFAtlas
+{
+public:
+  struct Glyph
+  {
+    unsigned int x, y;          //!< position of the distance field in the atlas
+    unsigned int width, height; //!< size of the distance field, including the spread on each side
+    int left, top;              //!< bearing of the glyph bitmap at base size, excluding the spread
+    float advance;              //!< advance at base size
+  };
+
+  /*! \brief Create an empty atlas
+   \param width width of the atlas in pixels.
+   \param height height of the atlas in pixels.
+   \param spread distance in pixels (at base size) covered by the field on each side of the outline.
+   */
+  CGUIFontSDFAtlas(unsigned int width, unsigned int height, unsigned int spread);
+
+  /*! \brief Look up a glyph
+   \param key letter and style of the glyph.
+   \return the glyph, nullptr if it is not in the atlas.
+   */
+  const Glyph* Find(uint32_t key) const;
+
+  /*! \brief Convert a rasterized glyph into a distance field and add it to the atlas
+   \param key letter and style of the glyph.
+   \param coverage 8 bit coverage bitmap of the glyph at base size, may be nullptr for empty glyphs.
+   \param width width of the bitmap.
+   \param rows height of the bitmap.
+   \param pitch bytes per row of the bitmap (negative for bottom-up bitmaps).
+   \param left horizontal bearing of the bitmap.
+   \param top vertical bearing of the bitmap.
+   \param advance horizontal advance of the glyph.
+   \return the glyph, nullptr if the atlas is full.
+   */
+  const Glyph* Add(uint32_t key, const unsigned char* coverage, unsigned int width, unsigned int rows, int pitch,
+                   int left, int top, float advance);
+
+  /*! \brief Drop all glyphs
+   */
+  void Clear();
+
+  unsigned int GetWidth() const { return m_width; }
+  unsigned int GetHeight() const { return m_height; }
+  unsigned int GetSpread() const { return m_spread; }
+  const unsigned char* GetPixels() const { return m_pixels.data(); }
+
+  /*! \brief Changes whenever the pixels of the atlas change
+   */
+  unsigned int GetVersion() const { return m_version; }
+
+  /*! \brief Get the rows that changed since the last call, so only those need uploading
+   \param[out] y1 first changed row.
+   \param[out] y2 row after the last changed row.
+   \return false if no pixels changed.
+   */
+  bool TakeDirtyRows(unsigned int &y1, unsigned int &y2);
+
+  /*! \brief Changes whenever glyphs are dropped from the atlas
+   */
+  unsigned int GetEpoch() const { return m_epoch; }
+
+  size_t GetGlyphCount() const { return m_glyphs.size(); }
+
+  /*! \brief Number of glyphs added since the atlas was created, including dropped ones
+   */
+  unsigned int GetRasterizedCount() const { return m_rasterized; }
+
+  /*! \brief Bytes of the atlas holding glyphs, i.e. the rows filled so far
+   */
+  size_t GetUsedBytes() const { return static_cast<size_t>(m_posY + m_rowHeight) * m_width; }
+
+  /*! \brief Compute the signed distance field of a coverage bitmap
+   \param coverage 8 bit coverage bitmap, pixels of at least 128 are inside the glyph.
+   \param width width of the bitmap.
+   \param rows height of the bitmap.
+   \param pitch bytes per row of the bitmap.
+   \param spread distance in pixels covered by the field on each side of the outline.
+   \param[out] field (width + 2 * spread) x (rows + 2 * spread) distance field.
+   \param fieldPitch bytes per row of the field.
+   */
+  static void GenerateDistanceField(const unsigned char* coverage, unsigned int width, unsigned int rows, int pitch,
+                                    unsigned int spread, unsigned char* field, unsigned int fieldPitch);
+
+private:
+  static const unsigned int GLYPH_SPACING = 1;
+
+  void MarkDirty(unsigned int y1, unsigned int y2);
+
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_spread;
+  std::vector<unsigned char> m_pixels;
+  std::map<uint32_t, Glyph> m_glyphs;
+
+  unsigned int m_posX = 0;
+  unsigned int m_posY = 0;
+  unsigned int m_rowHeight = 0;
+
+  unsigned int m_dirtyY1 = 0;
+  unsigned int m_dirtyY2 = 0;
+
+  unsigned int m_version = 0;
+  unsigned int m_epoch = 0;
+  unsigned int m_rasterized = 0;
+};
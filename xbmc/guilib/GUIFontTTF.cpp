@@ -9,11 +9,18 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GUIFontManager.h"
+#include "GUIFontSDFAtlas.h"
 #include "Texture.h"
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/log.h"
 #include "rendering/RenderSystem.h"
 #include "windowing/WinSystem.h"
@@ -21,6 +28,9 @@
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <math.h>
 #include <memory>
 #include <queue>
@@ -41,6 +51,10 @@
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
+#define SDF_BASE_SIZE 48.0f   // size distance field glyphs are rasterized at
+#define SDF_SPREAD    6       // pixels covered by the distance field on each side of the outline
+#define SDF_ATLAS_SIZE 1024
+#define PREWARM_GLYPHS_PER_FRAME 32
 
 
 class CFreeTypeLibrary
@@ -59,6 +73,9 @@ public:
 
   FT_Face GetFont(const std::string &filename, float size, float aspect, XUTILS::auto_buffer& memoryBuf)
   {
+    // fonts are also loaded by the workers prewarming glyphs
+    CSingleLock lock(m_critSection);
+
     // don't have it yet - create it
     if (!m_library)
       FT_Init_FreeType(&m_library);
@@ -112,6 +129,7 @@ public:
 
   FT_Stroker GetStroker()
   {
+    CSingleLock lock(m_critSection);
     if (!m_library)
       return NULL;
 
@@ -122,25 +140,132 @@ public:
     return stroker;
   };
 
-  static void ReleaseFont(FT_Face face)
+  void ReleaseFont(FT_Face face)
   {
     assert(face);
+    CSingleLock lock(m_critSection);
     FT_Done_Face(face);
   };
 
-  static void ReleaseStroker(FT_Stroker stroker)
+  void ReleaseStroker(FT_Stroker stroker)
   {
     assert(stroker);
+    CSingleLock lock(m_critSection);
     FT_Stroker_Done(stroker);
   }
 
 private:
   FT_Library   m_library;
+  CCriticalSection m_critSection;
 };
 
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 #define g_freeTypeLibrary XBMC_GLOBAL_USE(CFreeTypeLibrary)
 
+/*!
+ \brief Font face at base size and the distance field atlas of its glyphs,
+ shared by all sizes of a font file.
+ */
+class CGUIFontSDFFace
+{
+public:
+  CGUIFontSDFFace() : m_atlas(SDF_ATLAS_SIZE, SDF_ATLAS_SIZE, SDF_SPREAD)
+  {
+  }
+
+  ~CGUIFontSDFFace()
+  {
+    if (m_face)
+      g_freeTypeLibrary.ReleaseFont(m_face);
+  }
+
+  static std::shared_ptr<CGUIFontSDFFace> Get(const std::string &filename, float aspect)
+  {
+    static CCriticalSection critSection;
+    static std::map<std::string, std::weak_ptr<CGUIFontSDFFace>> faces;
+
+    CSingleLock lock(critSection);
+    const std::string key = StringUtils::Format("%s_%f", filename.c_str(), aspect);
+    std::shared_ptr<CGUIFontSDFFace> sdfFace = faces[key].lock();
+    if (!sdfFace)
+    {
+      sdfFace = std::make_shared<CGUIFontSDFFace>();
+      sdfFace->m_face = g_freeTypeLibrary.GetFont(filename, SDF_BASE_SIZE, aspect, sdfFace->m_fontFileInMemory);
+      if (!sdfFace->m_face)
+        return nullptr;
+      faces[key] = sdfFace;
+    }
+    return sdfFace;
+  }
+
+  FT_Face m_face = nullptr;
+  XUTILS::auto_buffer m_fontFileInMemory;
+  CGUIFontSDFAtlas m_atlas;
+  std::unique_ptr<CBaseTexture> m_texture;
+};
+
+/*!
+ \brief Glyphs rasterized by a worker, waiting to be cached by the font on the render thread.
+ */
+class CGUIFontTTFBase::CPrewarmedGlyphs
+{
+public:
+  struct Glyph
+  {
+    std::vector<unsigned char> pixels; // pitch is width
+    unsigned int width;
+    unsigned int rows;
+    int left;
+    int top;
+    float advance;
+  };
+
+  void Add(character_t letterAndStyle, Glyph glyph)
+  {
+    CSingleLock lock(m_critSection);
+    m_glyphs[letterAndStyle] = std::move(glyph);
+  }
+
+  bool Take(character_t letterAndStyle, Glyph &glyph)
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_glyphs.find(letterAndStyle);
+    if (it == m_glyphs.end())
+      return false;
+    glyph = std::move(it->second);
+    m_glyphs.erase(it);
+    return true;
+  }
+
+  std::vector<character_t> GetWaiting(size_t maxCount) const
+  {
+    std::vector<character_t> waiting;
+    CSingleLock lock(m_critSection);
+    for (auto it = m_glyphs.begin(); it != m_glyphs.end() && waiting.size() < maxCount; ++it)
+      waiting.push_back(it->first);
+    return waiting;
+  }
+
+  void Discard(character_t letterAndStyle)
+  {
+    CSingleLock lock(m_critSection);
+    m_glyphs.erase(letterAndStyle);
+  }
+
+  bool IsDone() const
+  {
+    CSingleLock lock(m_critSection);
+    return m_finished && m_glyphs.empty();
+  }
+
+  std::atomic<bool> m_cancelled{false};
+  std::atomic<bool> m_finished{false};
+
+private:
+  mutable CCriticalSection m_critSection;
+  std::map<character_t, Glyph> m_glyphs;
+};
+
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
   m_texture = NULL;
@@ -203,6 +328,19 @@ void CGUIFontTTFBase::ClearCharacterCache()
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
   m_textureHeight = 0;
+
+  if (m_sdfFace)
+  {
+    // either the atlas is full, or another font sharing it found it full - all
+    // fonts sharing the atlas start over, and the cached texture coordinates are stale
+    CGUIFontSDFAtlas &atlas = m_sdfFace->m_atlas;
+    if (atlas.GetEpoch() == m_sdfEpoch)
+      atlas.Clear();
+    m_sdfEpoch = atlas.GetEpoch();
+    m_textureHeight = atlas.GetHeight();
+    m_staticCache.Flush();
+    m_dynamicCache.Flush();
+  }
 }
 
 void CGUIFontTTFBase::Clear()
@@ -224,6 +362,11 @@ void CGUIFontTTFBase::Clear()
   if (m_stroker)
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
+  m_sdfFace.reset();
+  m_glyphScale = 1.0f;
+  if (m_prewarmedGlyphs)
+    m_prewarmedGlyphs->m_cancelled = true;
+  m_prewarmedGlyphs.reset();
 
   m_vertexTrans.clear();
   m_vertex.clear();
@@ -268,9 +411,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
      add on the strength of any border - the non-bordered font needs
      aligning with the bordered font by utilising GetTextBaseLine()
      */
-    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_face->size->metrics.y_scale) / 12;
-    if (strength < 128)
-      strength = 128;
+    FT_Pos strength = GetBorderStrength(m_face);
 
     cellDescender -= strength;
     cellAscender  += strength;
@@ -289,6 +430,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   m_cellHeight   = cellAscender - cellDescender;
 
   m_height = height;
+  m_aspect = aspect;
 
   delete(m_texture);
   m_texture = NULL;
@@ -309,6 +451,25 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_textureWidth = m_renderSystem->GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
+  // bordered glyphs are stroked per size, so they can't come from the distance field
+  if (!border && SupportsSDF() &&
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiFontSDF)
+  {
+    m_sdfFace = CGUIFontSDFFace::Get(strFilename, aspect);
+    if (m_sdfFace)
+    {
+      const CGUIFontSDFAtlas &atlas = m_sdfFace->m_atlas;
+      m_glyphScale = height / SDF_BASE_SIZE;
+      m_sdfEpoch = atlas.GetEpoch();
+      m_textureWidth = atlas.GetWidth();
+      m_textureHeight = atlas.GetHeight();
+      m_textureScaleX = 1.0f / m_textureWidth;
+      m_textureScaleY = 1.0f / m_textureHeight;
+    }
+    else
+      CLog::Log(LOGWARNING, "%s: Unable to load %s for distance field rendering", __FUNCTION__, strFilename.c_str());
+  }
+
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
@@ -320,9 +481,119 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   return true;
 }
 
+void CGUIFontTTFBase::Prewarm(const std::wstring &letters, const std::vector<uint32_t> &styles)
+{
+  // distance field glyphs are shared between all sizes and cheap to add
+  if (!m_face || m_sdfFace)
+    return;
+
+  // only ask for glyphs we don't have yet
+  std::vector<character_t> glyphs;
+  for (uint32_t style : styles)
+  {
+    for (wchar_t letter : letters)
+    {
+      if (letter < L' ')
+        continue;
+      const character_t letterAndStyle = (style << 16) | (letter & 0xffff);
+      const Character *begin = m_char;
+      const Character *end = m_char + m_numChars;
+      const Character *ch = std::lower_bound(begin, end, letterAndStyle, [](const Character &c, character_t value)
+      {
+        return c.letterAndStyle < value;
+      });
+      if (ch == end || ch->letterAndStyle != letterAndStyle)
+        glyphs.push_back(letterAndStyle);
+    }
+  }
+  if (glyphs.empty())
+    return;
+
+  if (m_prewarmedGlyphs)
+    m_prewarmedGlyphs->m_cancelled = true;
+  auto prewarmed = std::make_shared<CPrewarmedGlyphs>();
+  m_prewarmedGlyphs = prewarmed;
+
+  // the worker needs a face of its own, as faces can't be shared between threads
+  const std::string filename = m_strFilename;
+  const float height = m_height;
+  const float aspect = m_aspect;
+  const bool border = m_stroker != nullptr;
+  CJobManager::GetInstance().Submit([prewarmed, glyphs, filename, height, aspect, border]()
+  {
+    XUTILS::auto_buffer memoryBuf;
+    FT_Face face = g_freeTypeLibrary.GetFont(filename, height, aspect, memoryBuf);
+    if (!face)
+    {
+      prewarmed->m_finished = true;
+      return;
+    }
+    FT_Stroker stroker = NULL;
+    if (border)
+    {
+      stroker = g_freeTypeLibrary.GetStroker();
+      if (stroker)
+        FT_Stroker_Set(stroker, GetBorderStrength(face), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+    }
+
+    for (character_t letterAndStyle : glyphs)
+    {
+      if (prewarmed->m_cancelled)
+        break;
+
+      FT_Glyph glyph = RenderGlyph(face, stroker, letterAndStyle & 0xffff, letterAndStyle >> 16);
+      if (!glyph)
+        continue;
+
+      const FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+      const FT_Bitmap &bitmap = bitGlyph->bitmap;
+      CPrewarmedGlyphs::Glyph prewarmedGlyph;
+      prewarmedGlyph.width = bitmap.width;
+      prewarmedGlyph.rows = bitmap.rows;
+      prewarmedGlyph.left = bitGlyph->left;
+      prewarmedGlyph.top = bitGlyph->top;
+      prewarmedGlyph.advance = (float)face->glyph->advance.x / 64;
+      prewarmedGlyph.pixels.resize(bitmap.width * bitmap.rows);
+      for (unsigned int y = 0; y < static_cast<unsigned int>(bitmap.rows); y++)
+        memcpy(&prewarmedGlyph.pixels[y * bitmap.width], bitmap.buffer + static_cast<int>(y) * bitmap.pitch, bitmap.width);
+      FT_Done_Glyph(glyph);
+
+      prewarmed->Add(letterAndStyle, std::move(prewarmedGlyph));
+    }
+
+    if (stroker)
+      g_freeTypeLibrary.ReleaseStroker(stroker);
+    g_freeTypeLibrary.ReleaseFont(face);
+    prewarmed->m_finished = true;
+  }, CJob::PRIORITY_LOW_PAUSABLE);
+}
+
+void CGUIFontTTFBase::CachePrewarmedGlyphs()
+{
+  if (m_prewarmedGlyphs->IsDone())
+  {
+    m_prewarmedGlyphs.reset();
+    return;
+  }
+
+  // spread the work over a few frames, copying glyphs into the texture is cheap
+  // but inserting them in our table isn't
+  for (character_t letterAndStyle : m_prewarmedGlyphs->GetWaiting(PREWARM_GLYPHS_PER_FRAME))
+  {
+    // takes the prewarmed glyph, unless we cached the character in the meantime
+    GetCharacter(((letterAndStyle & 0xffff0000) << 8) | (letterAndStyle & 0xffff));
+    if (!m_prewarmedGlyphs)
+      return;
+    m_prewarmedGlyphs->Discard(letterAndStyle);
+  }
+}
+
 void CGUIFontTTFBase::Begin()
 {
-  if (m_nestedBeginCount == 0 && m_texture != NULL && FirstBegin())
+  if (m_nestedBeginCount == 0 && m_prewarmedGlyphs)
+    CachePrewarmedGlyphs();
+
+  if (m_nestedBeginCount == 0 && (m_texture != NULL || m_sdfFace) && FirstBegin())
   {
     m_vertexTrans.clear();
     m_vertex.clear();
@@ -349,6 +620,10 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
     return;
   }
 
+  // another font sharing our distance field atlas may have cleared it
+  if (m_sdfFace && m_sdfFace->m_atlas.GetEpoch() != m_sdfEpoch)
+    ClearCharacterCache();
+
   Begin();
 
   uint32_t rawAlignment = alignment;
@@ -564,7 +839,7 @@ float CGUIFontTTFBase::GetTextWidthInternal(vecText::const_iterator start, vecTe
       // and not advance distance - this makes sure that italic text isn't
       // choped on the end (as render width is larger than advance then).
       if (start == end)
-        width += std::max(c->right - c->left + c->offsetX, c->advance);
+        width += std::max((c->right - c->left) * m_glyphScale + c->offsetX, c->advance);
       else
         width += c->advance;
     }
@@ -687,38 +962,83 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  CTimelineScope timelineScope("font", "CGUIFontTTFBase::CacheCharacter");
+
+  if (m_sdfFace)
+    return CacheCharacterSDF(letter, style, ch);
+
+  const character_t letterAndStyle = (style << 16) | letter;
+  if (m_prewarmedGlyphs)
+  {
+    CPrewarmedGlyphs::Glyph prewarmed;
+    if (m_prewarmedGlyphs->Take(letterAndStyle, prewarmed))
+    {
+      FT_BitmapGlyphRec bitGlyph = {};
+      bitGlyph.left = prewarmed.left;
+      bitGlyph.top = prewarmed.top;
+      bitGlyph.bitmap.width = prewarmed.width;
+      bitGlyph.bitmap.rows = prewarmed.rows;
+      bitGlyph.bitmap.pitch = prewarmed.width;
+      bitGlyph.bitmap.buffer = prewarmed.pixels.data();
+      bitGlyph.bitmap.num_grays = 256;
+      bitGlyph.bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+      m_prewarmedGlyphCount++;
+      return CacheBitmap(letterAndStyle, &bitGlyph, prewarmed.advance, ch);
+    }
+  }
+
+  FT_Glyph glyph = RenderGlyph(m_face, m_stroker, letter, style);
+  if (!glyph)
+    return false;
+  m_onDemandRasterizations++;
+
+  bool cached = CacheBitmap(letterAndStyle, (FT_BitmapGlyph)glyph, (float)m_face->glyph->advance.x / 64, ch);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return cached;
+}
+
+FT_Glyph CGUIFontTTFBase::RenderGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style)
+{
+  int glyph_index = FT_Get_Char_Index( face, letter );
 
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  if (FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
-    return false;
+    return NULL;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_BOLD);
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_BOLD);
   // and italics if applicable
   if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
+    ObliqueGlyph(face->glyph);
   // and light if applicable
   if (style & FONT_STYLE_LIGHT)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_LIGHT);
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_LIGHT);
   // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (FT_Get_Glyph(face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
-    return false;
+    return NULL;
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+  if (stroker)
+    FT_Glyph_StrokeBorder(&glyph, stroker, 0, 1);
   // render the glyph
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, static_cast<uint32_t>(letter));
-    return false;
+    FT_Done_Glyph(glyph);
+    return NULL;
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+  return glyph;
+}
+
+bool CGUIFontTTFBase::CacheBitmap(character_t letterAndStyle, FT_BitmapGlyph bitGlyph, float advance, Character *ch)
+{
   FT_Bitmap bitmap = bitGlyph->bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
@@ -744,7 +1064,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         if (newHeight > m_renderSystem->GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -752,7 +1071,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -762,20 +1080,19 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
+  ch->letterAndStyle = letterAndStyle;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->advance = (float)MathUtils::round_int(advance);
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -791,18 +1108,102 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   }
   m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
+  return true;
+}
+
+bool CGUIFontTTFBase::CacheCharacterSDF(wchar_t letter, uint32_t style, Character *ch)
+{
+  const character_t letterAndStyle = (style << 16) | letter;
+  CGUIFontSDFAtlas &atlas = m_sdfFace->m_atlas;
+
+  // only rasterize glyphs no other size of our font has asked for yet
+  const CGUIFontSDFAtlas::Glyph *glyph = atlas.Find(letterAndStyle);
+  if (!glyph)
+  {
+    FT_Face face = m_sdfFace->m_face;
+    if (FT_Load_Glyph(face, FT_Get_Char_Index(face, letter), FT_LOAD_TARGET_LIGHT))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
+      return false;
+    }
+    if (style & FONT_STYLE_BOLD)
+      SetGlyphStrength(face->glyph, GLYPH_STRENGTH_BOLD);
+    if (style & FONT_STYLE_ITALICS)
+      ObliqueGlyph(face->glyph);
+    if (style & FONT_STYLE_LIGHT)
+      SetGlyphStrength(face->glyph, GLYPH_STRENGTH_LIGHT);
+    if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, static_cast<uint32_t>(letter));
+      return false;
+    }
+
+    m_onDemandRasterizations++;
+
+    const FT_Bitmap &bitmap = face->glyph->bitmap;
+    glyph = atlas.Add(letterAndStyle, bitmap.buffer, bitmap.width, bitmap.rows, bitmap.pitch,
+                      face->glyph->bitmap_left, face->glyph->bitmap_top,
+                      static_cast<float>(face->glyph->advance.x) / 64);
+    if (!glyph)
+    {
+      CLog::Log(LOGDEBUG, "%s: Distance field atlas is full (%u glyphs)", __FUNCTION__,
+                static_cast<unsigned int>(atlas.GetGlyphCount()));
+      return false;
+    }
+  }
+
+  // the texture rect is at base size, everything else at our size
+  const float spread = static_cast<float>(atlas.GetSpread());
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = (short)MathUtils::round_int((glyph->left - spread) * m_glyphScale);
+  ch->offsetY = (short)MathUtils::round_int(m_cellBaseLine - (glyph->top + spread) * m_glyphScale);
+  ch->left = (float)glyph->x;
+  ch->top = (float)glyph->y;
+  ch->right = ch->left + glyph->width;
+  ch->bottom = ch->top + glyph->height;
+  ch->advance = (float)MathUtils::round_int(glyph->advance * m_glyphScale);
+  m_numChars++;
 
   return true;
 }
 
+CBaseTexture* CGUIFontTTFBase::GetSDFTexture()
+{
+  if (!m_sdfFace)
+    return nullptr;
+
+  CGUIFontSDFFace &sdfFace = *m_sdfFace;
+  CGUIFontSDFAtlas &atlas = sdfFace.m_atlas;
+  unsigned int y1, y2;
+  if (!sdfFace.m_texture)
+  {
+    std::unique_ptr<CBaseTexture> texture(new CTexture());
+    texture->Allocate(atlas.GetWidth(), atlas.GetHeight(), XB_FMT_A8);
+    if (!texture->GetPixels())
+      return nullptr;
+
+    const unsigned int width = std::min(atlas.GetWidth(), texture->GetTextureWidth());
+    const unsigned int height = std::min(atlas.GetHeight(), texture->GetTextureHeight());
+    for (unsigned int y = 0; y < height; y++)
+      memcpy(texture->GetPixels() + y * texture->GetPitch(), atlas.GetPixels() + y * atlas.GetWidth(), width);
+    texture->LoadToGPU();
+    sdfFace.m_texture = std::move(texture);
+    atlas.TakeDirtyRows(y1, y2); // all of it is uploaded
+  }
+  else if (atlas.TakeDirtyRows(y1, y2))
+  {
+    // only the rows glyphs got added to since the last upload
+    UpdateSDFTexture(sdfFace.m_texture.get(), atlas, y1, y2);
+  }
+  return sdfFace.m_texture.get();
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices)
 {
   // actual image width isn't same as the character width as that is
   // just baseline width and height should include the descent
-  const float width = ch->right - ch->left;
-  const float height = ch->bottom - ch->top;
+  const float width = (ch->right - ch->left) * m_glyphScale;
+  const float height = (ch->bottom - ch->top) * m_glyphScale;
 
   // return early if nothing to render
   if (width == 0 || height == 0)
@@ -961,6 +1362,14 @@ void CGUIFontTTFBase::ObliqueGlyph(FT_GlyphSlot slot)
 }
 
 
+long CGUIFontTTFBase::GetBorderStrength(FT_Face face)
+{
+  FT_Pos strength = FT_MulFix( face->units_per_EM, face->size->metrics.y_scale) / 12;
+  if (strength < 128)
+    strength = 128;
+  return strength;
+}
+
 // Embolden code - original taken from freetype2 (ftsynth.c)
 void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
 {
@@ -968,8 +1377,8 @@ void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
     return;
 
   /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / glyphStrength;
+  FT_Pos strength = FT_MulFix( slot->face->units_per_EM,
+                    slot->face->size->metrics.y_scale ) / glyphStrength;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -27,6 +28,8 @@ using namespace DirectX::PackedVector;
 constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
 
 class CBaseTexture;
+class CGUIFontSDFAtlas;
+class CGUIFontSDFFace;
 class CRenderSystemBase;
 
 struct FT_FaceRec_;
@@ -34,12 +37,14 @@ struct FT_LibraryRec_;
 struct FT_GlyphSlotRec_;
 struct FT_BitmapGlyphRec_;
 struct FT_StrokerRec_;
+struct FT_GlyphRec_;
 
 typedef struct FT_FaceRec_ *FT_Face;
 typedef struct FT_LibraryRec_ *FT_Library;
 typedef struct FT_GlyphSlotRec_ *FT_GlyphSlot;
 typedef struct FT_BitmapGlyphRec_ *FT_BitmapGlyph;
 typedef struct FT_StrokerRec_ *FT_Stroker;
+typedef struct FT_GlyphRec_ *FT_Glyph;
 
 typedef uint32_t character_t;
 typedef std::vector<character_t> vecText;
@@ -85,6 +90,22 @@ public:
 
   const std::string& GetFileName() const { return m_strFileName; };
 
+  /*! \brief Rasterize glyphs on a worker, so they don't have to be rasterized when first rendered.
+   The rasterized glyphs are added to the character cache over the next frames.
+   \param letters the letters to rasterize.
+   \param styles the styles (FONT_STYLE_BOLD, ...) to rasterize each letter in.
+   */
+  void Prewarm(const std::wstring &letters, const std::vector<uint32_t> &styles);
+
+  /*! \brief Number of glyphs that had to be rasterized on demand while rendering
+   Distance field glyphs are only counted by the font that added them to the shared atlas.
+   */
+  unsigned int GetOnDemandRasterizations() const { return m_onDemandRasterizations; }
+
+  /*! \brief Number of glyphs cached from the ones rasterized by Prewarm()
+   */
+  unsigned int GetPrewarmedGlyphs() const { return m_prewarmedGlyphCount; }
+
 protected:
   struct Character
   {
@@ -112,6 +133,9 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool CacheCharacterSDF(wchar_t letter, uint32_t style, Character *ch);
+  bool CacheBitmap(character_t letterAndStyle, FT_BitmapGlyph bitGlyph, float advance, Character *ch);
+  void CachePrewarmedGlyphs();
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
@@ -119,9 +143,25 @@ protected:
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
+  /*! \brief Whether the font can render glyphs from a signed distance field atlas
+   (see CGUIFontSDFAtlas), which requires a distance field shader.
+   */
+  virtual bool SupportsSDF() const { return false; }
+  bool IsSDF() const { return m_sdfFace != nullptr; }
+  /*! \brief Get the texture of the distance field atlas, uploading any glyphs added since the last call
+   \return the texture, nullptr if the font doesn't render from a distance field atlas.
+   */
+  CBaseTexture* GetSDFTexture();
+  /*! \brief Upload the given rows of the distance field atlas to its texture
+   Only called for fonts supporting distance fields, once the texture has been loaded.
+   */
+  virtual void UpdateSDFTexture(CBaseTexture* texture, const CGUIFontSDFAtlas& atlas, unsigned int y1, unsigned int y2) {}
+
   // modifying glyphs
-  void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
+  static void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
   static void ObliqueGlyph(FT_GlyphSlot slot);
+  static long GetBorderStrength(FT_Face face);
+  static FT_Glyph RenderGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style);
 
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
 
@@ -174,6 +214,18 @@ protected:
   float    m_textureScaleX;
   float    m_textureScaleY;
 
+  // distance field glyphs, shared between all sizes of our font file
+  std::shared_ptr<CGUIFontSDFFace> m_sdfFace;
+  unsigned int m_sdfEpoch = 0;
+  float m_glyphScale = 1.0f;         // size of glyphs on screen relative to the texture
+
+  // glyphs rasterized by Prewarm(), waiting to be cached
+  class CPrewarmedGlyphs;
+  std::shared_ptr<CPrewarmedGlyphs> m_prewarmedGlyphs;
+  float m_aspect = 1.0f;
+  unsigned int m_onDemandRasterizations = 0;
+  unsigned int m_prewarmedGlyphCount = 0;
+
   std::string m_strFileName;
   XUTILS::auto_buffer m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont()
 
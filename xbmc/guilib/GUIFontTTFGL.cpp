@@ -9,6 +9,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTFGL.h"
 #include "GUIFontManager.h"
+#include "GUIFontSDFAtlas.h"
 #include "Texture.h"
 #include "TextureManager.h"
 #include "windowing/GraphicContext.h"
@@ -23,6 +24,7 @@
 #endif
 #include "rendering/MatrixGL.h"
 
+#include <algorithm>
 #include <cassert>
 
 // stuff for freetype
@@ -53,6 +55,19 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+  if (IsSDF())
+  {
+    // glyphs live in the distance field atlas shared by all sizes of this font
+    CBaseTexture* texture = GetSDFTexture();
+    if (!texture)
+      return false;
+
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    glEnable(GL_BLEND);
+    texture->BindToUnit(0);
+    return true;
+  }
+
 #if defined(HAS_GL)
   GLenum pixformat = GL_RED;
   GLenum internalFormat;
@@ -117,7 +132,7 @@ void CGUIFontTTFGL::LastEnd()
 {
 #ifdef HAS_GL
   CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
-  renderSystem->EnableShader(SM_FONTS);
+  renderSystem->EnableShader(IsSDF() ? SM_FONTS_SDF : SM_FONTS);
 
   GLint posLoc = renderSystem->ShaderGetPos();
   GLint colLoc = renderSystem->ShaderGetCol();
@@ -418,6 +433,33 @@ void CGUIFontTTFGL::DeleteHardwareTexture()
   }
 }
 
+bool CGUIFontTTFGL::SupportsSDF() const
+{
+#if defined(HAS_GL)
+  // the distance field shader may have failed to compile
+  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  return renderSystem && renderSystem->IsShaderValid(SM_FONTS_SDF);
+#else
+  return false;
+#endif
+}
+
+void CGUIFontTTFGL::UpdateSDFTexture(CBaseTexture* texture, const CGUIFontSDFAtlas& atlas, unsigned int y1, unsigned int y2)
+{
+#if defined(HAS_GL)
+  y2 = std::min(y2, texture->GetTextureHeight());
+  if (y1 >= y2)
+    return;
+
+  texture->BindToUnit(0);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, atlas.GetWidth());
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y1, std::min(atlas.GetWidth(), texture->GetTextureWidth()), y2 - y1,
+                  GL_RED, GL_UNSIGNED_BYTE, atlas.GetPixels() + y1 * atlas.GetWidth());
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  VerifyGLState();
+#endif
+}
+
 void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
 {
   if (m_staticVertexBufferCreated)
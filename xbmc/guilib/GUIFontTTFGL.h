@@ -33,6 +33,8 @@ protected:
   CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
   bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
   void DeleteHardwareTexture() override;
+  bool SupportsSDF() const override;
+  void UpdateSDFTexture(CBaseTexture* texture, const CGUIFontSDFAtlas& atlas, unsigned int y1, unsigned int y2) override;
 
   static GLuint m_elementArrayHandle;
 
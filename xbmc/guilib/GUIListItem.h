@@ -127,9 +127,11 @@ public:
 
   void SetLayout(CGUIListItemLayoutPtr layout);
   CGUIListItemLayout *GetLayout();
+  CGUIListItemLayoutPtr ReleaseLayout();
 
   void SetFocusedLayout(CGUIListItemLayoutPtr layout);
   CGUIListItemLayout *GetFocusedLayout();
+  CGUIListItemLayoutPtr ReleaseFocusedLayout();
 
   void FreeIcons();
   void FreeMemory(bool immediately = false);
@@ -48,6 +48,11 @@ void CGUIListItemLayout::ResetAnimation(ANIMATION_TYPE animType)
   return m_group.ResetAnimation(animType);
 }
 
+void CGUIListItemLayout::ResetAnimations()
+{
+  m_group.ResetAnimations();
+}
+
 float CGUIListItemLayout::Size(ORIENTATION orientation) const
 {
   return (orientation == HORIZONTAL) ? m_width : m_height;
@@ -29,6 +29,7 @@ public:
   void SetFocusedItem(unsigned int focus);
   bool IsAnimating(ANIMATION_TYPE animType);
   void ResetAnimation(ANIMATION_TYPE animType);
+  void ResetAnimations();
   void SetInvalid() { m_invalidated = true; };
   void FreeResources(bool immediately = false);
   void SetParentControl(CGUIControl *control) { m_group.SetParentControl(control); };
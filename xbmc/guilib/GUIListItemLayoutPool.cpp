@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIListItemLayoutPool.h"
+
+#include "GUIListItemLayout.h"
+
+#include <algorithm>
+
+CGUIListItemLayoutPool::CGUIListItemLayoutPool() = default;
+
+CGUIListItemLayoutPool::CGUIListItemLayoutPool(const CGUIListItemLayoutPool &)
+{
+}
+
+CGUIListItemLayoutPool& CGUIListItemLayoutPool::operator=(const CGUIListItemLayoutPool &)
+{
+  Clear();
+  return *this;
+}
+
+CGUIListItemLayoutPool::~CGUIListItemLayoutPool() = default;
+
+void CGUIListItemLayoutPool::BindLayout(const CGUIListItemPtr &item, const CGUIListItemLayout &layoutTemplate, CGUIControl *parent)
+{
+  CGUIListItemLayoutPtr layout = Acquire(m_layouts, m_layoutTemplate, layoutTemplate, parent);
+  BoundItem &bound = GetBoundItem(item);
+  bound.layout = layout.get();
+  bound.layoutTemplate = &layoutTemplate;
+  item->SetLayout(std::move(layout));
+}
+
+void CGUIListItemLayoutPool::BindFocusedLayout(const CGUIListItemPtr &item, const CGUIListItemLayout &layoutTemplate, CGUIControl *parent)
+{
+  CGUIListItemLayoutPtr layout = Acquire(m_focusedLayouts, m_focusedLayoutTemplate, layoutTemplate, parent);
+  BoundItem &bound = GetBoundItem(item);
+  bound.focusedLayout = layout.get();
+  bound.focusedLayoutTemplate = &layoutTemplate;
+  item->SetFocusedLayout(std::move(layout));
+}
+
+void CGUIListItemLayoutPool::UnbindOutside(int keepStart, int keepEnd, const std::vector<CGUIListItemPtr> &items)
+{
+  auto isOutside = [keepStart, keepEnd, &items](const BoundItem &bound)
+  {
+    // our containers keep the current position (starting at 1) of each item up to date
+    int index = static_cast<int>(bound.item->GetCurrentItem()) - 1;
+    if (index < 0 || index >= static_cast<int>(items.size()) || items[index] != bound.item)
+      return true;
+    if (keepStart < keepEnd)
+      return index < keepStart || index > keepEnd;
+    return index > keepEnd && index < keepStart; // wrapping
+  };
+
+  auto it = std::partition(m_boundItems.begin(), m_boundItems.end(),
+                           [&isOutside](const BoundItem &bound) { return !isOutside(bound); });
+  for (auto unbind = it; unbind != m_boundItems.end(); ++unbind)
+    Unbind(*unbind);
+  m_boundItems.erase(it, m_boundItems.end());
+}
+
+void CGUIListItemLayoutPool::UnbindAll()
+{
+  for (auto &bound : m_boundItems)
+    Unbind(bound);
+  m_boundItems.clear();
+}
+
+void CGUIListItemLayoutPool::Clear()
+{
+  UnbindAll();
+  m_layouts.clear();
+  m_focusedLayouts.clear();
+  m_layoutTemplate = nullptr;
+  m_focusedLayoutTemplate = nullptr;
+}
+
+CGUIListItemLayoutPool::BoundItem &CGUIListItemLayoutPool::GetBoundItem(const CGUIListItemPtr &item)
+{
+  auto it = std::find_if(m_boundItems.begin(), m_boundItems.end(),
+                         [&item](const BoundItem &bound) { return bound.item == item; });
+  if (it != m_boundItems.end())
+    return *it;
+
+  m_boundItems.emplace_back();
+  m_boundItems.back().item = item;
+  return m_boundItems.back();
+}
+
+void CGUIListItemLayoutPool::Unbind(BoundItem &bound)
+{
+  // only take back layouts that are still ours - the item may have been freed or
+  // bound by someone else in the meantime
+  if (bound.layout && bound.item->GetLayout() == bound.layout)
+    Recycle(bound.item->ReleaseLayout(), m_layouts, m_layoutTemplate, bound.layoutTemplate);
+  if (bound.focusedLayout && bound.item->GetFocusedLayout() == bound.focusedLayout)
+    Recycle(bound.item->ReleaseFocusedLayout(), m_focusedLayouts, m_focusedLayoutTemplate, bound.focusedLayoutTemplate);
+  bound = BoundItem();
+}
+
+CGUIListItemLayoutPtr CGUIListItemLayoutPool::Acquire(std::vector<CGUIListItemLayoutPtr> &layouts,
+                                                      const CGUIListItemLayout *&currentTemplate,
+                                                      const CGUIListItemLayout &layoutTemplate,
+                                                      CGUIControl *parent)
+{
+  if (currentTemplate != &layoutTemplate)
+  { // recycled layouts are copies of another template, which we can't use
+    layouts.clear();
+    currentTemplate = &layoutTemplate;
+  }
+
+  if (layouts.empty())
+    return CGUIListItemLayoutPtr(new CGUIListItemLayout(layoutTemplate, parent));
+
+  CGUIListItemLayoutPtr layout = std::move(layouts.back());
+  layouts.pop_back();
+  layout->SetParentControl(parent);
+  layout->ResetAnimations();
+  layout->SetFocusedItem(0);
+  layout->SetInvalid();
+  return layout;
+}
+
+void CGUIListItemLayoutPool::Recycle(CGUIListItemLayoutPtr layout,
+                                     std::vector<CGUIListItemLayoutPtr> &layouts,
+                                     const CGUIListItemLayout *currentTemplate,
+                                     const CGUIListItemLayout *layoutTemplate)
+{
+  layout->FreeResources();
+  // the number of layouts in use never exceeds the number of items the container
+  // shows at once, so neither does the number of recycled layouts
+  if (layoutTemplate == currentTemplate)
+    layouts.push_back(std::move(layout));
+}
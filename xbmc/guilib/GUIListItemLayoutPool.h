@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "GUIListItem.h"
+
+#include <memory>
+#include <vector>
+
+class CGUIControl;
+class CGUIListItemLayout;
+
+typedef std::shared_ptr<CGUIListItem> CGUIListItemPtr;
+
+/*!
+ \ingroup controls
+ \brief Recycles the item layouts of a container.
+
+ Containers only need layouts for the items that are on screen (plus the preloaded
+ items around them). Rather than allocating a fresh copy of the layout template each
+ time an item scrolls into view and destroying it again once it scrolls out, layouts
+ are unbound from items leaving the view and handed to the next item entering it.
+ Only items bound by the pool are tracked, so the cost of unbinding is independent
+ of the number of items in the container.
+ */
+class CGUIListItemLayoutPool
+{
+public:
+  CGUIListItemLayoutPool();
+  /*! \brief Copies start out empty, as bound layouts belong to the parent control they were created for
+   */
+  CGUIListItemLayoutPool(const CGUIListItemLayoutPool &);
+  CGUIListItemLayoutPool& operator=(const CGUIListItemLayoutPool &);
+  ~CGUIListItemLayoutPool();
+
+  /*! \brief Attach an (unfocused) layout to the item, reusing a recycled layout if possible.
+   \param item the item to attach the layout to.
+   \param layoutTemplate the layout the container currently uses for items.
+   \param parent the control the layout is rendered in.
+   */
+  void BindLayout(const CGUIListItemPtr &item, const CGUIListItemLayout &layoutTemplate, CGUIControl *parent);
+
+  /*! \brief Attach a focused layout to the item, reusing a recycled layout if possible.
+   \sa BindLayout
+   */
+  void BindFocusedLayout(const CGUIListItemPtr &item, const CGUIListItemLayout &layoutTemplate, CGUIControl *parent);
+
+  /*! \brief Recycle the layouts of all bound items outside of the given range.
+   \param keepStart first item index to keep.
+   \param keepEnd last item index to keep. If smaller than keepStart the range wraps around.
+   \param items the items of the container. Bound items no longer in it are always unbound.
+   */
+  void UnbindOutside(int keepStart, int keepEnd, const std::vector<CGUIListItemPtr> &items);
+
+  /*! \brief Recycle the layouts of all bound items
+   */
+  void UnbindAll();
+
+  /*! \brief Unbind all items and drop all recycled layouts, e.g. when the layout template changed
+   */
+  void Clear();
+
+  size_t GetBoundCount() const { return m_boundItems.size(); }
+  size_t GetRecycledCount() const { return m_layouts.size() + m_focusedLayouts.size(); }
+
+private:
+  struct BoundItem
+  {
+    CGUIListItemPtr item;
+    CGUIListItemLayout *layout = nullptr;
+    CGUIListItemLayout *focusedLayout = nullptr;
+    const CGUIListItemLayout *layoutTemplate = nullptr;
+    const CGUIListItemLayout *focusedLayoutTemplate = nullptr;
+  };
+
+  BoundItem &GetBoundItem(const CGUIListItemPtr &item);
+  void Unbind(BoundItem &bound);
+  static CGUIListItemLayoutPtr Acquire(std::vector<CGUIListItemLayoutPtr> &layouts,
+                                       const CGUIListItemLayout *&currentTemplate,
+                                       const CGUIListItemLayout &layoutTemplate,
+                                       CGUIControl *parent);
+  static void Recycle(CGUIListItemLayoutPtr layout,
+                      std::vector<CGUIListItemLayoutPtr> &layouts,
+                      const CGUIListItemLayout *currentTemplate,
+                      const CGUIListItemLayout *layoutTemplate);
+
+  std::vector<BoundItem> m_boundItems;
+
+  std::vector<CGUIListItemLayoutPtr> m_layouts;
+  std::vector<CGUIListItemLayoutPtr> m_focusedLayouts;
+  const CGUIListItemLayout *m_layoutTemplate = nullptr;
+  const CGUIListItemLayout *m_focusedLayoutTemplate = nullptr;
+};
@@ -9,7 +9,10 @@
 #include "GUITexture.h"
 
 #include "GUILargeTextureManager.h"
+#include "ServiceBroker.h"
 #include "TextureManager.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
 #include "windowing/GraphicContext.h"
@@ -56,6 +59,7 @@ CGUITextureBase::CGUITextureBase(float posX, float posY, float width, float heig
 
   m_allocateDynamically = false;
   m_isAllocated = NO;
+  m_listSize = false;
   m_invalid = true;
   m_use_cache = true;
 }
@@ -92,6 +96,7 @@ CGUITextureBase::CGUITextureBase(const CGUITextureBase &right) :
   ResetAnimState();
 
   m_isAllocated = NO;
+  m_listSize = false;
   m_invalid = true;
 }
 
@@ -289,8 +294,10 @@ bool CGUITextureBase::AllocResources()
     }
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
+      if (!IsAllocated())
+        m_listSize = IsListSize();
       CTextureArray texture;
-      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache))
+      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache, m_listSize))
       {
         m_isAllocated = LARGE;
 
@@ -334,6 +341,19 @@ bool CGUITextureBase::AllocResources()
   return changed;
 }
 
+bool CGUITextureBase::IsListSize() const
+{
+  const unsigned int listRes = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageListRes;
+  if (!listRes)
+    return false;
+
+  // the size on screen, which decides which variant of a cached image is loaded
+  const CGraphicContext &context = CServiceBroker::GetWinSystem()->GetGfxContext();
+  const float width = m_width * context.GetGUIScaleX();
+  const float height = m_height * context.GetGUIScaleY();
+  return width > 0 && height > 0 && width <= listRes * 16 / 9 && height <= listRes;
+}
+
 bool CGUITextureBase::CalculateSize()
 {
   if (m_currentFrame >= m_texture.size())
@@ -432,7 +452,7 @@ bool CGUITextureBase::CalculateSize()
 void CGUITextureBase::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
-    CServiceBroker::GetGUI()->GetLargeTextureManager().ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+    CServiceBroker::GetGUI()->GetLargeTextureManager().ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED), m_listSize);
   else if (m_isAllocated == NORMAL && m_texture.size())
     CServiceBroker::GetGUI()->GetTextureManager().ReleaseTexture(m_info.filename, immediately);
 
@@ -109,6 +109,7 @@ protected:
   bool CalculateSize();
   void LoadDiffuseImage();
   bool AllocateOnDemand();
+  bool IsListSize() const; ///< whether we're shown no larger than the list-size variant of cached images
   bool UpdateAnimFrame(unsigned int currentTime);
   void Render(float left, float top, float bottom, float right, float u1, float v1, float u2, float v2, float u3, float v3);
   static void OrientateTexture(CRect &rect, float width, float height, int orientation);
@@ -149,6 +150,7 @@ protected:
   bool m_allocateDynamically;
   enum ALLOCATE_TYPE { NO = 0, NORMAL, LARGE, NORMAL_FAILED, LARGE_FAILED };
   ALLOCATE_TYPE m_isAllocated;
+  bool m_listSize; ///< whether the large texture was requested at list size
 
   CTextureInfo m_info;
   CAspectRatio m_aspect;
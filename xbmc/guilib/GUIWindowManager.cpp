@@ -24,6 +24,7 @@
 #include "input/Key.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimelineProfiler.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -1082,6 +1083,7 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CTimelineScope timelineScope("gui", "CGUIWindowManager::Process");
 
   m_dirtyregions.clear();
 
@@ -1163,15 +1165,20 @@ bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
   CSingleExit lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CTimelineScope timelineScope("gui", "CGUIWindowManager::Render");
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
+  const CRect viewWindow = CServiceBroker::GetWinSystem()->GetGfxContext().GetViewWindow();
+  float redrawnArea = 0.0f;
+
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
   if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiVisualizeDirtyRegions || CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
     RenderPass();
     hasRendered = true;
+    redrawnArea = viewWindow.Area();
   }
   else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE)
   {
@@ -1179,6 +1186,7 @@ bool CGUIWindowManager::Render()
     {
       RenderPass();
       hasRendered = true;
+      redrawnArea = viewWindow.Area();
     }
   }
   else
@@ -1191,10 +1199,15 @@ bool CGUIWindowManager::Render()
       CServiceBroker::GetWinSystem()->GetGfxContext().SetScissors(i);
       RenderPass();
       hasRendered = true;
+      redrawnArea += CRect(i).Intersect(viewWindow).Area();
     }
     CServiceBroker::GetWinSystem()->GetGfxContext().ResetScissors();
   }
 
+  // keep track of how much of the screen we redraw, for tuning the dirty region solvers
+  m_redrawnFraction = viewWindow.IsEmpty() ? 0.0f : redrawnArea / viewWindow.Area();
+  m_averageRedrawnFraction += (m_redrawnFraction - m_averageRedrawnFraction) * 0.05f;
+
   if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiVisualizeDirtyRegions)
   {
     CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo(), false);
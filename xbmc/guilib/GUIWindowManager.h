@@ -99,6 +99,16 @@ public:
 
   void RenderEx() const;
 
+  /*! \brief Fraction of the viewport redrawn by the last call to Render()
+   Overlapping render passes are counted once per pass, so this may exceed 1.
+   */
+  float GetRedrawnFraction() const { return m_redrawnFraction; }
+
+  /*! \brief Running average of the fraction of the viewport redrawn per frame
+   \sa GetRedrawnFraction
+   */
+  float GetAverageRedrawnFraction() const { return m_averageRedrawnFraction; }
+
   /*! \brief Do any post render activities.
    */
   void AfterRender();
@@ -267,4 +277,6 @@ private:
 
   CDirtyRegionList m_dirtyregions;
   CDirtyRegionTracker m_tracker;
+  float m_redrawnFraction = 0.0f;
+  float m_averageRedrawnFraction = 0.0f;
 };
@@ -18,6 +18,9 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 /*! \brief Tries to load ids and strings from a strings.po file to the `strings` map.
  * It should only be called from the LoadStr2Mem function to have a fallback.
@@ -198,6 +201,35 @@ const std::string& CLocalizeStrings::Get(uint32_t dwCode) const
   return i->second.strTranslated;
 }
 
+std::wstring CLocalizeStrings::GetCommonCharacters(size_t maxCount) const
+{
+  std::unordered_map<wchar_t, unsigned int> counts;
+  {
+    CSharedLock lock(m_stringsMutex);
+    std::wstring translated;
+    for (const auto& it : m_strings)
+    {
+      g_charsetConverter.utf8ToW(it.second.strTranslated, translated, false);
+      for (wchar_t letter : translated)
+      {
+        if (letter >= L' ')
+          counts[letter]++;
+      }
+    }
+  }
+
+  std::vector<std::pair<wchar_t, unsigned int>> sorted(counts.begin(), counts.end());
+  std::sort(sorted.begin(), sorted.end(), [](const std::pair<wchar_t, unsigned int> &a, const std::pair<wchar_t, unsigned int> &b)
+  {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  });
+
+  std::wstring characters;
+  for (size_t i = 0; i < sorted.size() && i < maxCount; i++)
+    characters += sorted[i].first;
+  return characters;
+}
+
 void CLocalizeStrings::Clear()
 {
   CExclusiveLock lock(m_stringsMutex);
@@ -45,6 +45,11 @@ public:
   bool LoadAddonStrings(const std::string& path, const std::string& language, const std::string& addonId);
   void ClearSkinStrings();
   const std::string& Get(uint32_t code) const;
+  /*! \brief Get the characters used most in the loaded strings
+   \param maxCount maximum number of characters to return.
+   \return the characters, most used first.
+   */
+  std::wstring GetCommonCharacters(size_t maxCount) const;
   std::string GetAddonString(const std::string& addonId, uint32_t code);
   void Clear();
 
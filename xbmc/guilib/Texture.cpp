@@ -51,13 +51,15 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
   m_textureWidth = m_imageWidth;
   m_textureHeight = m_imageHeight;
 
-  if (m_format & XB_FMT_DXT_MASK)
+  // there is none without a window, e.g. in tests, where the pixels are never uploaded
+  CRenderSystemBase *renderSystem = CServiceBroker::GetRenderSystem();
+  if (m_format & XB_FMT_DXT_MASK && renderSystem)
   {
-    while (GetPitch() < CServiceBroker::GetRenderSystem()->GetMinDXTPitch())
+    while (GetPitch() < renderSystem->GetMinDXTPitch())
       m_textureWidth += GetBlockSize();
   }
 
-  if (!CServiceBroker::GetRenderSystem()->SupportsNPOT((m_format & XB_FMT_DXT_MASK) != 0))
+  if (renderSystem && !renderSystem->SupportsNPOT((m_format & XB_FMT_DXT_MASK) != 0))
   {
     m_textureWidth = PadPow2(m_textureWidth);
     m_textureHeight = PadPow2(m_textureHeight);
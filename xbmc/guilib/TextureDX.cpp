@@ -9,6 +9,7 @@
 #include "TextureDX.h"
 
 #include "utils/MemUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/log.h"
 
 /************************************************************************/
@@ -70,6 +71,8 @@ void CDXTexture::LoadToGPU()
     return;
   }
 
+  CTimelineScope timelineScope("texture", "CDXTexture::LoadToGPU");
+
   bool needUpdate = true;
   D3D11_USAGE usage = D3D11_USAGE_DEFAULT;
   if (m_format == XB_FMT_RGB8)
@@ -13,6 +13,7 @@
 #include "settings/AdvancedSettings.h"
 #include "utils/GLUtils.h"
 #include "utils/MemUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/log.h"
 
 /************************************************************************/
@@ -50,6 +51,9 @@ void CGLTexture::LoadToGPU()
     // nothing to load - probably same image (no change)
     return;
   }
+
+  CTimelineScope timelineScope("texture", "CGLTexture::LoadToGPU");
+
   if (m_texture == 0)
   {
     // Have OpenGL generate a texture object handle for us
@@ -119,6 +123,10 @@ void CGLTexture::LoadToGPU()
     format = GL_RGB;
     numcomponents = GL_RGB;
     break;
+  case XB_FMT_A8:
+    format = GL_RED;
+    numcomponents = m_isOglVersion3orNewer ? GL_R8 : GL_LUMINANCE;
+    break;
   case XB_FMT_A8R8G8B8:
   default:
     break;
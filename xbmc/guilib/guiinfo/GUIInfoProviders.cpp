@@ -9,6 +9,7 @@
 #include "guilib/guiinfo/GUIInfoProviders.h"
 
 #include "guilib/guiinfo/IGUIInfoProvider.h"
+#include "utils/TimelineProfiler.h"
 
 #include <algorithm>
 
@@ -69,6 +70,8 @@ void CGUIInfoProviders::UnregisterProvider(IGUIInfoProvider *provider)
 
 bool CGUIInfoProviders::InitCurrentItem(CFileItem *item)
 {
+  CTimelineScope timelineScope("info", "CGUIInfoProviders::InitCurrentItem");
+
   bool bReturn = false;
 
   for (const auto& provider : m_providers)
@@ -110,6 +113,8 @@ bool CGUIInfoProviders::GetBool(bool& value, const CGUIListItem *item, int conte
 
 void CGUIInfoProviders::UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo)
 {
+  CTimelineScope timelineScope("info", "CGUIInfoProviders::UpdateAVInfo");
+
   for (const auto& provider : m_providers)
   {
     provider->UpdateAVInfo(audioInfo, videoInfo, subtitleInfo);
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIListItem.h"
+#include "guilib/GUIListItemLayout.h"
+#include "guilib/GUIListItemLayoutPool.h"
+#include "test/TestBasicEnvironment.h"
+#include "test/TestUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<CGUIListItemPtr> CreateItems(int count)
+{
+  std::vector<CGUIListItemPtr> items;
+  items.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    items.push_back(std::make_shared<CGUIListItem>());
+    items.back()->SetCurrentItem(i + 1);
+  }
+  return items;
+}
+
+// what CGUIBaseContainer::Process() does for the items in view, followed by FreeMemory()
+void ProcessFrame(CGUIListItemLayoutPool &pool, const CGUIListItemLayout &layoutTemplate,
+                  const std::vector<CGUIListItemPtr> &items, int offset, int visible)
+{
+  for (int i = offset; i < offset + visible && i < static_cast<int>(items.size()); i++)
+  {
+    if (!items[i]->GetLayout())
+      pool.BindLayout(items[i], layoutTemplate, nullptr);
+  }
+  pool.UnbindOutside(offset, offset + visible - 1, items);
+}
+}
+
+TEST(BenchmarkGUIListItemLayoutPool, ScrollLargeList)
+{
+  const int count = 100000;
+  const int visible = 20;
+  const int frames = 2000;
+  const int step = count / frames;
+
+  CGUIListItemLayout layoutTemplate;
+  std::vector<CGUIListItemPtr> items = CreateItems(count);
+
+  // scrolling through the whole list a page at a time
+  CGUIListItemLayoutPool pool;
+  size_t layouts = 0;
+  const auto pooledBegin = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+  {
+    ProcessFrame(pool, layoutTemplate, items, frame * step, visible);
+    layouts = std::max(layouts, pool.GetBoundCount() + pool.GetRecycledCount());
+  }
+  const auto pooled = std::chrono::steady_clock::now() - pooledBegin;
+  pool.Clear();
+
+  // copying the template for every item scrolling in and walking every item
+  // to free the layouts outside of the view, like containers used to
+  const auto copiedBegin = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+  {
+    const int offset = frame * step;
+    for (int i = offset; i < offset + visible; i++)
+    {
+      if (!items[i]->GetLayout())
+        items[i]->SetLayout(CGUIListItemLayoutPtr(new CGUIListItemLayout(layoutTemplate, nullptr)));
+    }
+    for (int i = 0; i < count; i++)
+    {
+      if (i < offset || i >= offset + visible)
+        items[i]->FreeMemory();
+    }
+  }
+  const auto copied = std::chrono::steady_clock::now() - copiedBegin;
+
+  RecordProperty("items", count);
+  RecordProperty("pooled.layouts", static_cast<int>(layouts));
+  RecordProperty("pooled.layout_bytes", static_cast<int>(layouts * sizeof(CGUIListItemLayout)));
+  RecordProperty("pooled.frame_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(pooled).count() / frames));
+  RecordProperty("copied.frame_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(copied).count() / frames));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  CXBMCTestUtils::Instance().ParseArgs(argc, argv);
+
+  if (!testing::AddGlobalTestEnvironment(new TestBasicEnvironment()))
+  {
+    fprintf(stderr, "Unable to add basic test environment.\n");
+    exit(EXIT_FAILURE);
+  }
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/DirtyRegionSolvers.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+float TotalArea(const CDirtyRegionList &regions)
+{
+  float area = 0.0f;
+  for (const auto& region : regions)
+    area += region.Area();
+  return area;
+}
+}
+
+TEST(TestTileDirtyRegionSolver, NoRegions)
+{
+  CTileDirtyRegionSolver solver(64);
+  CDirtyRegionList output;
+  solver.Solve(CDirtyRegionList(), CRect(0, 0, 1920, 1080), output);
+  EXPECT_TRUE(output.empty());
+}
+
+TEST(TestTileDirtyRegionSolver, SnapsToTiles)
+{
+  CTileDirtyRegionSolver solver(64);
+  CDirtyRegionList input;
+  input.emplace_back(10, 10, 20, 20);
+  CDirtyRegionList output;
+  solver.Solve(input, CRect(0, 0, 1920, 1080), output);
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(0, 0, 64, 64), output[0]);
+}
+
+TEST(TestTileDirtyRegionSolver, ClipsToViewport)
+{
+  CTileDirtyRegionSolver solver(64);
+  CDirtyRegionList input;
+  input.emplace_back(1900, 1000, 2500, 1500);
+  CDirtyRegionList output;
+  solver.Solve(input, CRect(0, 0, 1920, 1080), output);
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(1856, 960, 1920, 1080), output[0]);
+}
+
+TEST(TestTileDirtyRegionSolver, MergesOverlappingRegions)
+{
+  CTileDirtyRegionSolver solver(64);
+  CDirtyRegionList input;
+  input.emplace_back(0, 0, 128, 128);
+  input.emplace_back(64, 64, 128, 128);
+  input.emplace_back(0, 64, 128, 128);
+  CDirtyRegionList output;
+  solver.Solve(input, CRect(0, 0, 1920, 1080), output);
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(0, 0, 128, 128), output[0]);
+}
+
+TEST(TestTileDirtyRegionSolver, KeepsDistantRegionsApart)
+{
+  CTileDirtyRegionSolver solver(64);
+  CDirtyRegionList input;
+  input.emplace_back(0, 0, 64, 64);
+  input.emplace_back(1856, 960, 1920, 1024);
+  CDirtyRegionList output;
+  solver.Solve(input, CRect(0, 0, 1920, 1080), output);
+  ASSERT_EQ(2u, output.size());
+  EXPECT_FLOAT_EQ(64.0f * 64.0f * 2, TotalArea(output));
+}
+
+TEST(TestTileDirtyRegionSolver, OutputDoesNotOverlap)
+{
+  CTileDirtyRegionSolver solver(64);
+  CDirtyRegionList input;
+  // an L shape - the marked tiles can't be covered by a single rectangle
+  input.emplace_back(0, 0, 256, 64);
+  input.emplace_back(0, 0, 64, 256);
+  input.emplace_back(100, 100, 110, 110);
+  CDirtyRegionList output;
+  solver.Solve(input, CRect(0, 0, 1920, 1080), output);
+  EXPECT_FLOAT_EQ(64.0f * 64.0f * 8, TotalArea(output));
+  for (size_t i = 0; i < output.size(); i++)
+  {
+    for (size_t j = i + 1; j < output.size(); j++)
+    {
+      CRect intersection(output[i]);
+      EXPECT_TRUE(intersection.Intersect(output[j]).IsEmpty());
+    }
+  }
+}
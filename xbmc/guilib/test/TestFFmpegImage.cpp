@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+#include "pictures/Picture.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<unsigned char> CreateJpeg(unsigned int width, unsigned int height)
+{
+  std::vector<uint32_t> pixels(width * height);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+      pixels[y * width + x] = 0xff000000 | ((x * 255 / width) << 16) | ((y * 255 / height) << 8) | 0x80;
+  }
+
+  uint8_t* jpeg = nullptr;
+  size_t size = 0;
+  std::vector<unsigned char> result;
+  if (CPicture::GetThumbnailFromSurface(reinterpret_cast<const unsigned char*>(pixels.data()), width, height,
+                                        width * 4, "image.jpg", jpeg, size))
+    result.assign(jpeg, jpeg + size);
+  delete[] jpeg;
+  return result;
+}
+
+std::vector<uint32_t> Decode(CFFmpegImage& image, unsigned int width, unsigned int height)
+{
+  std::vector<uint32_t> pixels(width * height);
+  EXPECT_TRUE(image.Decode(reinterpret_cast<unsigned char*>(pixels.data()), width, height, width * 4, XB_FMT_A8R8G8B8));
+  return pixels;
+}
+}
+
+TEST(TestFFmpegImage, LowresDecode)
+{
+  std::vector<unsigned char> jpeg = CreateJpeg(1600, 1200);
+  ASSERT_FALSE(jpeg.empty());
+
+  // without a size the whole image is decoded
+  CFFmpegImage full("image/jpeg");
+  ASSERT_TRUE(full.LoadImageFromMemory(jpeg.data(), jpeg.size(), 0, 0));
+  EXPECT_EQ(1600u, full.Width());
+  EXPECT_EQ(1200u, full.Height());
+
+  // a quarter is just large enough, an eighth would be too small
+  CFFmpegImage quarter("image/jpeg");
+  ASSERT_TRUE(quarter.LoadImageFromMemory(jpeg.data(), jpeg.size(), 500, 300));
+  EXPECT_EQ(400u, quarter.Width());
+  EXPECT_EQ(300u, quarter.Height());
+  EXPECT_EQ(1600u, quarter.originalWidth());
+  EXPECT_EQ(1200u, quarter.originalHeight());
+
+  // never smaller than asked for
+  CFFmpegImage half("image/jpeg");
+  ASSERT_TRUE(half.LoadImageFromMemory(jpeg.data(), jpeg.size(), 401, 301));
+  EXPECT_EQ(800u, half.Width());
+  EXPECT_EQ(600u, half.Height());
+
+  // and the same picture as decoding everything and scaling down
+  std::vector<uint32_t> expected = Decode(full, 400, 300);
+  std::vector<uint32_t> actual = Decode(quarter, 400, 300);
+  long difference = 0;
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    for (int shift = 0; shift < 24; shift += 8)
+      difference += std::abs(static_cast<int>((expected[i] >> shift) & 0xff) - static_cast<int>((actual[i] >> shift) & 0xff));
+  }
+  EXPECT_LT(difference / static_cast<long>(expected.size() * 3), 4);
+}
+
+TEST(TestFFmpegImage, OtherFormatsAreDecodedWhole)
+{
+  std::vector<uint32_t> pixels(64 * 64, 0xff808080);
+  uint8_t* png = nullptr;
+  size_t size = 0;
+  ASSERT_TRUE(CPicture::GetThumbnailFromSurface(reinterpret_cast<const unsigned char*>(pixels.data()), 64, 64,
+                                                64 * 4, "image.png", png, size));
+
+  CFFmpegImage image("image/png");
+  EXPECT_TRUE(image.LoadImageFromMemory(png, size, 16, 16));
+  EXPECT_EQ(64u, image.Width());
+  EXPECT_EQ(64u, image.Height());
+  delete[] png;
+}
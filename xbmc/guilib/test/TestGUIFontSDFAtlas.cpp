@@ -0,0 +1,380 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "guilib/GUIFontSDFAtlas.h"
+#include "guilib/GUIFontTTF.h"
+#include "guilib/Texture.h"
+#include "rendering/RenderSystem.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "test/TestUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ft2build.h>
+#include <gtest/gtest.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+
+namespace
+{
+// a glyph like coverage bitmap: a filled box with a one pixel anti-aliased border
+std::vector<unsigned char> MakeGlyph(unsigned int width, unsigned int rows)
+{
+  std::vector<unsigned char> coverage(width * rows, 255);
+  for (unsigned int y = 0; y < rows; y++)
+  {
+    coverage[y * width] = 64;
+    coverage[y * width + width - 1] = 64;
+  }
+  return coverage;
+}
+
+// bilinear lookup of a glyph's distance field, like the texture unit does
+float SampleField(const CGUIFontSDFAtlas& atlas, const CGUIFontSDFAtlas::Glyph& glyph, float x, float y)
+{
+  auto pixel = [&](int px, int py) {
+    px = std::min(std::max(px, 0), static_cast<int>(glyph.width) - 1);
+    py = std::min(std::max(py, 0), static_cast<int>(glyph.height) - 1);
+    return static_cast<float>(atlas.GetPixels()[(glyph.y + py) * atlas.GetWidth() + glyph.x + px]);
+  };
+  const int x0 = static_cast<int>(std::floor(x));
+  const int y0 = static_cast<int>(std::floor(y));
+  const float dx = x - x0;
+  const float dy = y - y0;
+  return (pixel(x0, y0) * (1 - dx) + pixel(x0 + 1, y0) * dx) * (1 - dy) +
+         (pixel(x0, y0 + 1) * (1 - dx) + pixel(x0 + 1, y0 + 1) * dx) * dy;
+}
+
+// fonts only ask the render system for its maximum texture size
+class CTestRenderSystem : public CRenderSystemBase
+{
+public:
+  CTestRenderSystem() { m_maxTextureSize = 4096; }
+
+  bool InitRenderSystem() override { return true; }
+  bool DestroyRenderSystem() override { return true; }
+  bool ResetRenderSystem(int width, int height) override { return true; }
+  bool BeginRender() override { return true; }
+  bool EndRender() override { return true; }
+  void PresentRender(bool rendered, bool videoLayer) override {}
+  bool ClearBuffers(UTILS::Color color) override { return true; }
+  bool IsExtSupported(const char* extension) const override { return false; }
+  void SetViewPort(const CRect& viewPort) override {}
+  void GetViewPort(CRect& viewPort) override {}
+  void SetScissors(const CRect& rect) override {}
+  void ResetScissors() override {}
+  void CaptureStateBlock() override {}
+  void ApplyStateBlock() override {}
+  void SetCameraPosition(const CPoint& camera, int screenWidth, int screenHeight, float stereoFactor = 0.f) override {}
+};
+
+class CTestTexture : public CBaseTexture
+{
+public:
+  CTestTexture(unsigned int width, unsigned int height) : CBaseTexture(width, height, XB_FMT_A8) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+/*!
+ \brief TTF font caching its glyphs like the GL font does, without uploading them.
+ */
+class CTestFontTTF : public CGUIFontTTFBase
+{
+public:
+  CTestFontTTF(const std::string& fileName, CRenderSystemBase& renderSystem, bool sdf)
+    : CGUIFontTTFBase(fileName), m_sdf(sdf)
+  {
+    m_renderSystem = &renderSystem;
+  }
+
+  using CGUIFontTTFBase::GetTextWidthInternal;
+  using CGUIFontTTFBase::IsSDF;
+
+  //! bytes of the texture holding the glyphs, the shared atlas for distance field fonts
+  size_t GetGlyphCacheBytes() const { return static_cast<size_t>(m_textureWidth) * m_textureHeight; }
+
+protected:
+  CBaseTexture* ReallocTexture(unsigned int& newHeight) override
+  {
+    newHeight = CBaseTexture::PadPow2(newHeight);
+    CBaseTexture* newTexture = new CTestTexture(m_textureWidth, newHeight);
+    memset(newTexture->GetPixels(), 0, newTexture->GetRows() * newTexture->GetPitch());
+    if (m_texture)
+    {
+      memcpy(newTexture->GetPixels(), m_texture->GetPixels(), m_texture->GetRows() * m_texture->GetPitch());
+      delete m_texture;
+    }
+    m_textureHeight = newTexture->GetHeight();
+    m_textureScaleY = 1.0f / m_textureHeight;
+    return newTexture;
+  }
+
+  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override
+  {
+    const unsigned char* source = bitGlyph->bitmap.buffer;
+    for (unsigned int y = y1; y < y2; y++, source += bitGlyph->bitmap.pitch)
+      memcpy(m_texture->GetPixels() + y * m_texture->GetPitch() + x1, source, x2 - x1);
+    return true;
+  }
+
+  void DeleteHardwareTexture() override {}
+  bool SupportsSDF() const override { return m_sdf; }
+
+private:
+  bool FirstBegin() override { return true; }
+  void LastEnd() override {}
+
+  bool m_sdf;
+};
+}
+
+TEST(TestGUIFontSDFAtlas, DistanceField)
+{
+  const unsigned int spread = 4;
+  std::vector<unsigned char> coverage = MakeGlyph(10, 10);
+  std::vector<unsigned char> field((10 + 2 * spread) * (10 + 2 * spread));
+  CGUIFontSDFAtlas::GenerateDistanceField(coverage.data(), 10, 10, 10, spread, field.data(), 10 + 2 * spread);
+
+  const unsigned int pitch = 10 + 2 * spread;
+  // the centre is deep inside, the corners of the padding far outside
+  EXPECT_GT(field[(spread + 5) * pitch + spread + 5], 224);
+  EXPECT_EQ(0, field[0]);
+  EXPECT_EQ(0, field[pitch * pitch - 1]);
+  // the outline is at 128, between the left most inside pixel and the pixel left of it
+  EXPECT_GT(field[(spread + 5) * pitch + spread + 1], 128);
+  EXPECT_LT(field[(spread + 5) * pitch + spread], 128);
+  // the field falls off monotonically away from the glyph
+  for (unsigned int x = 1; x <= spread + 1; x++)
+    EXPECT_LE(field[(spread + 5) * pitch + x - 1], field[(spread + 5) * pitch + x]);
+}
+
+TEST(TestGUIFontSDFAtlas, AddAndFind)
+{
+  CGUIFontSDFAtlas atlas(256, 256, 4);
+  std::vector<unsigned char> coverage = MakeGlyph(12, 16);
+
+  EXPECT_EQ(nullptr, atlas.Find('A'));
+  const CGUIFontSDFAtlas::Glyph* glyph = atlas.Add('A', coverage.data(), 12, 16, 12, 1, 15, 14.0f);
+  ASSERT_NE(nullptr, glyph);
+  EXPECT_EQ(glyph, atlas.Find('A'));
+  EXPECT_EQ(20u, glyph->width);
+  EXPECT_EQ(24u, glyph->height);
+  EXPECT_EQ(1, glyph->left);
+  EXPECT_EQ(15, glyph->top);
+  EXPECT_FLOAT_EQ(14.0f, glyph->advance);
+
+  // glyphs don't overlap
+  const CGUIFontSDFAtlas::Glyph* other = atlas.Add('B', coverage.data(), 12, 16, 12, 1, 15, 14.0f);
+  ASSERT_NE(nullptr, other);
+  EXPECT_GE(other->x, glyph->x + glyph->width);
+
+  // empty glyphs only have an advance
+  unsigned int version = atlas.GetVersion();
+  const CGUIFontSDFAtlas::Glyph* space = atlas.Add(' ', nullptr, 0, 0, 0, 0, 0, 7.0f);
+  ASSERT_NE(nullptr, space);
+  EXPECT_EQ(0u, space->width);
+  EXPECT_EQ(version, atlas.GetVersion());
+
+  EXPECT_EQ(3u, atlas.GetGlyphCount());
+  EXPECT_EQ(3u, atlas.GetRasterizedCount());
+}
+
+TEST(TestGUIFontSDFAtlas, FullAndClear)
+{
+  CGUIFontSDFAtlas atlas(64, 64, 4);
+  std::vector<unsigned char> coverage = MakeGlyph(20, 20);
+
+  // 28x28 fields, so two rows of two fit
+  uint32_t letter = 'A';
+  while (atlas.Add(letter, coverage.data(), 20, 20, 20, 0, 20, 20.0f))
+    letter++;
+  EXPECT_EQ(4u, atlas.GetGlyphCount());
+
+  unsigned int epoch = atlas.GetEpoch();
+  atlas.Clear();
+  EXPECT_NE(epoch, atlas.GetEpoch());
+  EXPECT_EQ(0u, atlas.GetGlyphCount());
+  EXPECT_EQ(nullptr, atlas.Find('A'));
+  EXPECT_NE(nullptr, atlas.Add(letter, coverage.data(), 20, 20, 20, 0, 20, 20.0f));
+
+  // too wide for the atlas
+  std::vector<unsigned char> wide = MakeGlyph(60, 10);
+  EXPECT_EQ(nullptr, atlas.Add('W', wide.data(), 60, 10, 60, 0, 10, 60.0f));
+}
+
+TEST(TestGUIFontSDFAtlas, DirtyRows)
+{
+  CGUIFontSDFAtlas atlas(64, 64, 4);
+  std::vector<unsigned char> coverage = MakeGlyph(10, 10);
+  unsigned int y1, y2;
+  EXPECT_FALSE(atlas.TakeDirtyRows(y1, y2));
+
+  // 18x18 fields, three to a row
+  for (uint32_t letter = 'A'; letter < 'D'; letter++)
+    ASSERT_NE(nullptr, atlas.Add(letter, coverage.data(), 10, 10, 10, 0, 10, 10.0f));
+  ASSERT_TRUE(atlas.TakeDirtyRows(y1, y2));
+  EXPECT_EQ(0u, y1);
+  EXPECT_EQ(18u, y2);
+  EXPECT_FALSE(atlas.TakeDirtyRows(y1, y2));
+
+  // a glyph in the next row only dirties that row
+  const CGUIFontSDFAtlas::Glyph* glyph = atlas.Add('D', coverage.data(), 10, 10, 10, 0, 10, 10.0f);
+  ASSERT_NE(nullptr, glyph);
+  ASSERT_TRUE(atlas.TakeDirtyRows(y1, y2));
+  EXPECT_EQ(glyph->y, y1);
+  EXPECT_EQ(glyph->y + glyph->height, y2);
+
+  // empty glyphs change no pixels
+  ASSERT_NE(nullptr, atlas.Add(' ', nullptr, 0, 0, 0, 0, 0, 5.0f));
+  EXPECT_FALSE(atlas.TakeDirtyRows(y1, y2));
+
+  // clearing wipes everything filled so far
+  atlas.Clear();
+  ASSERT_TRUE(atlas.TakeDirtyRows(y1, y2));
+  EXPECT_EQ(0u, y1);
+  EXPECT_EQ(glyph->y + glyph->height, y2);
+}
+
+TEST(TestGUIFontSDFAtlas, FontGlyphsScale)
+{
+  const std::string fontPath = XBMC_REF_FILE_PATH("media/Fonts/teletext.ttf");
+  const unsigned int baseSize = 48;
+  const unsigned int spread = 6;
+
+  FT_Library library;
+  ASSERT_EQ(0, FT_Init_FreeType(&library));
+  FT_Face face;
+  ASSERT_EQ(0, FT_New_Face(library, fontPath.c_str(), 0, &face));
+
+  auto render = [&](wchar_t letter, unsigned int size) {
+    EXPECT_EQ(0, FT_Set_Pixel_Sizes(face, 0, size));
+    EXPECT_EQ(0, FT_Load_Char(face, letter, FT_LOAD_NO_HINTING | FT_LOAD_RENDER));
+    return face->glyph;
+  };
+
+  // glyphs are rasterized at base size only
+  CGUIFontSDFAtlas atlas(1024, 1024, spread);
+  const std::wstring letters = L"AgOW@&8%";
+  for (wchar_t letter : letters)
+  {
+    FT_GlyphSlot slot = render(letter, baseSize);
+    ASSERT_NE(nullptr, atlas.Add(letter, slot->bitmap.buffer, slot->bitmap.width, slot->bitmap.rows,
+                                 slot->bitmap.pitch, slot->bitmap_left, slot->bitmap_top,
+                                 slot->advance.x / 64.0f));
+  }
+  EXPECT_EQ(letters.size(), atlas.GetGlyphCount());
+
+  // the field sampled like the shader does matches the glyph FreeType renders at the size
+  for (unsigned int size : { 16u, 24u, 48u, 96u })
+  {
+    const float scale = static_cast<float>(size) / baseSize;
+    unsigned int matching = 0;
+    unsigned int covered = 0;
+    for (wchar_t letter : letters)
+    {
+      const CGUIFontSDFAtlas::Glyph* glyph = atlas.Find(letter);
+      ASSERT_NE(nullptr, glyph);
+      FT_GlyphSlot slot = render(letter, size);
+      for (unsigned int y = 0; y < slot->bitmap.rows; y++)
+      {
+        for (unsigned int x = 0; x < slot->bitmap.width; x++)
+        {
+          // pixel centre at our size to the field at base size
+          const float fx = (slot->bitmap_left + static_cast<int>(x) + 0.5f) / scale - glyph->left + spread - 0.5f;
+          const float fy = glyph->top - (slot->bitmap_top - static_cast<int>(y) - 0.5f) / scale + spread - 0.5f;
+          const bool inside = SampleField(atlas, *glyph, fx, fy) >= 128.0f;
+          const bool expected = slot->bitmap.buffer[y * slot->bitmap.pitch + x] >= 128;
+          if (inside || expected)
+          {
+            covered++;
+            if (inside == expected)
+              matching++;
+          }
+        }
+      }
+    }
+    ASSERT_GT(covered, 0u);
+    const float overlap = static_cast<float>(matching) / covered;
+    // exact at base size, scaling only rounds the outline off by a pixel here and there
+    if (size == baseSize)
+      EXPECT_FLOAT_EQ(1.0f, overlap);
+    else
+      EXPECT_GT(overlap, 0.85f) << "at size " << size;
+    RecordProperty("overlap_" + std::to_string(size), std::to_string(overlap));
+  }
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+}
+
+TEST(TestGUIFontSDFAtlas, SkinFontSet)
+{
+  const std::string fontPath = XBMC_REF_FILE_PATH("media/Fonts/teletext.ttf");
+  // the sizes of a typical skin's font set, all using the same font file
+  const std::vector<float> sizes = { 13, 20, 24, 28, 32, 40, 48, 60 };
+  vecText text;
+  for (character_t letter = ' '; letter <= '~'; letter++)
+    text.push_back(letter);
+
+  std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const bool fontSDF = advancedSettings->m_guiFontSDF;
+  advancedSettings->m_guiFontSDF = true;
+
+  CTestRenderSystem renderSystem;
+  std::vector<std::unique_ptr<CTestFontTTF>> bitmapFonts;
+  std::vector<std::unique_ptr<CTestFontTTF>> sdfFonts;
+  unsigned int bitmapRasterizations = 0;
+  unsigned int sdfRasterizations = 0;
+  size_t bitmapBytes = 0;
+  for (float size : sizes)
+  {
+    bitmapFonts.emplace_back(new CTestFontTTF("bitmap", renderSystem, false));
+    CTestFontTTF& bitmapFont = *bitmapFonts.back();
+    ASSERT_TRUE(bitmapFont.Load(fontPath, size));
+    EXPECT_FALSE(bitmapFont.IsSDF());
+
+    sdfFonts.emplace_back(new CTestFontTTF("sdf", renderSystem, true));
+    CTestFontTTF& sdfFont = *sdfFonts.back();
+    ASSERT_TRUE(sdfFont.Load(fontPath, size));
+    EXPECT_TRUE(sdfFont.IsSDF());
+
+    // both lay the text out at the same size, give or take rounding of the advances
+    const float bitmapWidth = bitmapFont.GetTextWidthInternal(text.begin(), text.end());
+    const float sdfWidth = sdfFont.GetTextWidthInternal(text.begin(), text.end());
+    EXPECT_NEAR(bitmapWidth, sdfWidth, text.size()) << "at size " << size;
+
+    bitmapRasterizations += bitmapFont.GetOnDemandRasterizations();
+    sdfRasterizations += sdfFont.GetOnDemandRasterizations();
+    bitmapBytes += bitmapFont.GetGlyphCacheBytes();
+  }
+  // all distance field fonts share one atlas
+  const size_t sdfBytes = sdfFonts.front()->GetGlyphCacheBytes();
+
+  advancedSettings->m_guiFontSDF = fontSDF;
+
+  // bitmap fonts rasterize every glyph once per size, distance field fonts once for all sizes
+  EXPECT_EQ(sizes.size() * text.size(), bitmapRasterizations);
+  EXPECT_EQ(text.size(), sdfRasterizations);
+  EXPECT_LT(sdfBytes, bitmapBytes);
+
+  RecordProperty("bitmap_rasterizations", std::to_string(bitmapRasterizations));
+  RecordProperty("sdf_rasterizations", std::to_string(sdfRasterizations));
+  RecordProperty("bitmap_bytes", std::to_string(bitmapBytes));
+  RecordProperty("sdf_bytes", std::to_string(sdfBytes));
+}
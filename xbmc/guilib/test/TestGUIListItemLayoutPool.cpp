@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIListItem.h"
+#include "guilib/GUIListItemLayout.h"
+#include "guilib/GUIListItemLayoutPool.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<CGUIListItemPtr> CreateItems(int count)
+{
+  std::vector<CGUIListItemPtr> items;
+  items.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    items.push_back(std::make_shared<CGUIListItem>());
+    items.back()->SetCurrentItem(i + 1);
+  }
+  return items;
+}
+
+// what CGUIBaseContainer::Process() does for the items in view, followed by FreeMemory()
+void ProcessFrame(CGUIListItemLayoutPool &pool, const CGUIListItemLayout &layoutTemplate,
+                  const std::vector<CGUIListItemPtr> &items, int offset, int visible)
+{
+  for (int i = offset; i < offset + visible && i < static_cast<int>(items.size()); i++)
+  {
+    if (!items[i]->GetLayout())
+      pool.BindLayout(items[i], layoutTemplate, nullptr);
+  }
+  pool.UnbindOutside(offset, offset + visible - 1, items);
+}
+}
+
+TEST(TestGUIListItemLayoutPool, LayoutsAreRecycled)
+{
+  CGUIListItemLayout layoutTemplate;
+  CGUIListItemLayoutPool pool;
+  std::vector<CGUIListItemPtr> items = CreateItems(100);
+
+  ProcessFrame(pool, layoutTemplate, items, 0, 10);
+  EXPECT_EQ(10u, pool.GetBoundCount());
+  EXPECT_EQ(0u, pool.GetRecycledCount());
+  CGUIListItemLayout *layout = items[0]->GetLayout();
+  ASSERT_NE(nullptr, layout);
+
+  // the first item scrolls out, its layout is handed to the item scrolling in
+  pool.UnbindOutside(1, 10, items);
+  EXPECT_EQ(nullptr, items[0]->GetLayout());
+  EXPECT_EQ(1u, pool.GetRecycledCount());
+  ProcessFrame(pool, layoutTemplate, items, 1, 10);
+  EXPECT_EQ(layout, items[10]->GetLayout());
+  EXPECT_EQ(10u, pool.GetBoundCount());
+  EXPECT_EQ(0u, pool.GetRecycledCount());
+}
+
+TEST(TestGUIListItemLayoutPool, WrappingRange)
+{
+  CGUIListItemLayout layoutTemplate;
+  CGUIListItemLayoutPool pool;
+  std::vector<CGUIListItemPtr> items = CreateItems(20);
+
+  for (int i : { 18, 19, 0, 1, 10 })
+    pool.BindLayout(items[i], layoutTemplate, nullptr);
+
+  pool.UnbindOutside(18, 1, items);
+  EXPECT_EQ(4u, pool.GetBoundCount());
+  EXPECT_NE(nullptr, items[18]->GetLayout());
+  EXPECT_NE(nullptr, items[1]->GetLayout());
+  EXPECT_EQ(nullptr, items[10]->GetLayout());
+}
+
+TEST(TestGUIListItemLayoutPool, RemovedItemsAreUnbound)
+{
+  CGUIListItemLayout layoutTemplate;
+  CGUIListItemLayoutPool pool;
+  std::vector<CGUIListItemPtr> items = CreateItems(10);
+  ProcessFrame(pool, layoutTemplate, items, 0, 10);
+
+  // the list got replaced, none of the bound items are part of it anymore
+  std::vector<CGUIListItemPtr> oldItems = items;
+  items = CreateItems(10);
+  pool.UnbindOutside(0, 9, items);
+  EXPECT_EQ(0u, pool.GetBoundCount());
+  EXPECT_EQ(10u, pool.GetRecycledCount());
+  for (const auto &item : oldItems)
+    EXPECT_EQ(nullptr, item->GetLayout());
+}
+
+TEST(TestGUIListItemLayoutPool, TemplateChangeDropsRecycledLayouts)
+{
+  CGUIListItemLayout layoutTemplate;
+  CGUIListItemLayout otherTemplate;
+  CGUIListItemLayoutPool pool;
+  std::vector<CGUIListItemPtr> items = CreateItems(10);
+
+  ProcessFrame(pool, layoutTemplate, items, 0, 5);
+  pool.UnbindAll();
+  EXPECT_EQ(5u, pool.GetRecycledCount());
+
+  ProcessFrame(pool, otherTemplate, items, 0, 2);
+  EXPECT_EQ(2u, pool.GetBoundCount());
+  EXPECT_EQ(0u, pool.GetRecycledCount());
+
+  pool.Clear();
+  EXPECT_EQ(0u, pool.GetBoundCount());
+  EXPECT_EQ(0u, pool.GetRecycledCount());
+  EXPECT_EQ(nullptr, items[0]->GetLayout());
+}
+
+TEST(TestGUIListItemLayoutPool, ScrollingKeepsLayoutsOfTheView)
+{
+  const int count = 1000;
+  const int visible = 20;
+
+  CGUIListItemLayout layoutTemplate;
+  CGUIListItemLayoutPool pool;
+  std::vector<CGUIListItemPtr> items = CreateItems(count);
+
+  // scrolling through the whole list a few items at a time
+  for (int offset = 0; offset + visible <= count; offset += 3)
+  {
+    ProcessFrame(pool, layoutTemplate, items, offset, visible);
+    ASSERT_EQ(static_cast<size_t>(visible), pool.GetBoundCount()) << "offset " << offset;
+    ASSERT_LE(pool.GetBoundCount() + pool.GetRecycledCount(), static_cast<size_t>(2 * visible));
+  }
+
+  const int withLayout = static_cast<int>(std::count_if(items.begin(), items.end(),
+      [](const CGUIListItemPtr &item) { return item->GetLayout() != nullptr; }));
+  EXPECT_EQ(visible, withLayout);
+}
@@ -103,11 +103,39 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
 
   {
     CSingleLock lock (m_queueCritSection);
+    m_announcementCount++;
+
+    // a burst of identical announcements (volume or property changes, library updates during a scan)
+    // is delivered once, as long as the last one isn't delivered yet. Announcements of addons are
+    // always delivered, they may well count them.
+    if (!m_announcementQueue.empty() && flag != Other && item == nullptr)
+    {
+      const CAnnounceData& last = m_announcementQueue.back();
+      if (last.item == nullptr && last.flag == flag && last.message == announcement.message &&
+          last.sender == announcement.sender && last.data == announcement.data)
+      {
+        m_coalescedCount++;
+        return;
+      }
+    }
+
     m_announcementQueue.push_back(announcement);
   }
   m_queueEvent.Set();
 }
 
+uint64_t CAnnouncementManager::GetAnnouncementCount() const
+{
+  CSingleLock lock (m_queueCritSection);
+  return m_announcementCount;
+}
+
+uint64_t CAnnouncementManager::GetCoalescedCount() const
+{
+  CSingleLock lock (m_queueCritSection);
+  return m_coalescedCount;
+}
+
 void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
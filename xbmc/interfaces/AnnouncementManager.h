@@ -41,6 +41,16 @@ namespace ANNOUNCEMENT
     void Announce(AnnouncementFlag flag, const char *sender, const char *message,
         const std::shared_ptr<const CFileItem>& item, const CVariant &data);
 
+    /*!
+     \brief Get the number of announcements made since startup
+     */
+    uint64_t GetAnnouncementCount() const;
+
+    /*!
+     \brief Get the number of announcements dropped for being identical to an announcement not delivered yet
+     */
+    uint64_t GetCoalescedCount() const;
+
   protected:
     void Process() override;
     void DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, const CVariant &data);
@@ -56,13 +66,15 @@ namespace ANNOUNCEMENT
     };
     std::list<CAnnounceData> m_announcementQueue;
     CEvent m_queueEvent;
+    uint64_t m_announcementCount = 0;
+    uint64_t m_coalescedCount = 0;
 
   private:
     CAnnouncementManager(const CAnnouncementManager&) = delete;
     CAnnouncementManager const& operator=(CAnnouncementManager const&) = delete;
 
     CCriticalSection m_announcersCritSection;
-    CCriticalSection m_queueCritSection;
+    mutable CCriticalSection m_queueCritSection;
     std::vector<IAnnouncer *> m_announcers;
   };
 }
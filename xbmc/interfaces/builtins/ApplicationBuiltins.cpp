@@ -10,6 +10,7 @@
 
 #include "Application.h"
 #include "ServiceBroker.h"
+#include "filesystem/SpecialProtocol.h"
 #include "filesystem/ZipManager.h"
 #include "interfaces/AnnouncementManager.h"
 #include "messaging/ApplicationMessenger.h"
@@ -20,6 +21,7 @@
 #include "utils/FileOperationJob.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -108,6 +110,30 @@ static int SetVolume(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Start recording the frame timeline.
+ *  \param params (ignored)
+ */
+static int StartTimelineProfiler(const std::vector<std::string>& params)
+{
+  CTimelineProfiler::GetInstance().Start();
+
+  return 0;
+}
+
+/*! \brief Stop recording the frame timeline and save it.
+ *  \param params The parameters.
+ *  \details params[0] = File to save the timeline to (optional).
+ */
+static int StopTimelineProfiler(const std::vector<std::string>& params)
+{
+  std::string file = params.empty() ? "special://home/timeline.json" : params[0];
+
+  CTimelineProfiler::GetInstance().Stop();
+  CTimelineProfiler::GetInstance().SaveChromeTrace(CSpecialProtocol::TranslatePath(file));
+
+  return 0;
+}
+
 /*! \brief Toggle debug info.
  *  \param params (ignored)
  */
@@ -182,6 +208,21 @@ static int WakeOnLAN(const std::vector<std::string>& params)
 ///     @param[in] showvolumebar         Add "showVolumeBar" to show volume bar (optional).
 ///   }
 ///   \table_row2_l{
+///     <b>`StartTimelineProfiler`</b>
+///     ,
+///     Starts recording a timeline of the work done per frame (GUI processing and
+///     rendering\, texture uploads\, font glyph caching\, job completions\, video
+///     presentation).
+///   }
+///   \table_row2_l{
+///     <b>`StopTimelineProfiler([file])`</b>
+///     ,
+///     Stops recording the timeline and saves it in the Chrome trace event format\,
+///     which can be viewed with chrome://tracing.
+///     @param[in] file                  File to save to (optional).
+///             @note If not given\, saves to special://home/timeline.json.
+///   }
+///   \table_row2_l{
 ///     <b>`ToggleDebug`</b>
 ///     ,
 ///     Toggles debug mode on/off
@@ -208,6 +249,8 @@ CBuiltins::CommandMap CApplicationBuiltins::GetOperations() const
            {"mute", {"Mute the player", 0, Mute}},
            {"notifyall", {"Notify all connected clients", 2, NotifyAll}},
            {"setvolume", {"Set the current volume", 1, SetVolume}},
+           {"starttimelineprofiler", {"Start recording the frame timeline", 0, StartTimelineProfiler}},
+           {"stoptimelineprofiler", {"Stop recording the frame timeline and save it", 0, StopTimelineProfiler}},
            {"toggledebug", {"Enables/disables debug mode", 0, ToggleDebug}},
            {"toggledpms", {"Toggle DPMS mode manually", 0, ToggleDPMS}},
            {"wakeonlan", {"Sends the wake-up packet to the broadcast address for the specified MAC address", 1, WakeOnLAN}}
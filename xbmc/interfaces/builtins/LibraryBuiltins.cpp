@@ -12,6 +12,7 @@
 #include "GUIUserMessages.h"
 #include "MediaSource.h"
 #include "ServiceBroker.h"
+#include "TextureCache.h"
 #include "dialogs/GUIDialogFileBrowser.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "guilib/GUIComponent.h"
@@ -27,6 +28,17 @@
 
 using namespace KODI::MESSAGING;
 
+/*! \brief Cache the art of the video and music libraries.
+ *  \param params (ignored)
+ */
+static int CacheLibraryArt(const std::vector<std::string>& params)
+{
+  if (!CTextureCache::GetInstance().CacheLibraryArt())
+    CLog::Log(LOGINFO, "CacheLibraryArt: library art is already being cached");
+
+  return 0;
+}
+
 /*! \brief Clean a library.
  *  \param params The parameters.
  *  \details params[0] = "video" or "music".
@@ -293,6 +305,11 @@ static int SearchVideoLibrary(const std::vector<std::string>& params)
 ///     Function,
 ///     Description }
 ///   \table_row2_l{
+///     <b>`cachelibraryart`</b>
+///     ,
+///     Cache the artwork of the video and music libraries in the background
+///   }
+///   \table_row2_l{
 ///     <b>`cleanlibrary(type)`</b>
 ///     ,
 ///      Clean the video/music library
@@ -344,6 +361,7 @@ static int SearchVideoLibrary(const std::vector<std::string>& params)
 CBuiltins::CommandMap CLibraryBuiltins::GetOperations() const
 {
   return {
+          {"cachelibraryart",     {"Cache the artwork of the video and music libraries", 0, CacheLibraryArt}},
           {"cleanlibrary",        {"Clean the video/music library", 1, CleanLibrary}},
           {"exportlibrary",       {"Export the video/music library", 1, ExportLibrary}},
           {"exportlibrary2",      {"Export the video/music library", 1, ExportLibrary2}},
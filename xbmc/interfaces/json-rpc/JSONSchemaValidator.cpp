@@ -0,0 +1,319 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "JSONSchemaValidator.h"
+
+#include "JSONServiceDescription.h"
+
+#include <algorithm>
+
+using namespace JSONRPC;
+
+bool CJSONSchemaValidator::CompileType(const JSONSchemaTypeDefinition &type)
+{
+  m_nodes.clear();
+  m_parameters.clear();
+  m_isMethod = false;
+
+  CompiledTypes compiled;
+  size_t node;
+  m_compiled = compileNode(type, compiled, node);
+  if (!m_compiled)
+    m_nodes.clear();
+
+  return m_compiled;
+}
+
+bool CJSONSchemaValidator::CompileParameters(const std::vector<JSONSchemaTypeDefinitionPtr> &parameters)
+{
+  m_nodes.clear();
+  m_parameters.clear();
+  m_isMethod = true;
+  m_compiled = true;
+
+  CompiledTypes compiled;
+  for (const auto& parameter : parameters)
+  {
+    size_t node;
+    if (!compileNode(*parameter, compiled, node))
+    {
+      m_compiled = false;
+      break;
+    }
+    m_parameters.push_back(node);
+  }
+
+  if (!m_compiled)
+  {
+    m_nodes.clear();
+    m_parameters.clear();
+  }
+
+  return m_compiled;
+}
+
+bool CJSONSchemaValidator::Validate(const CVariant &value, CVariant &outputValue) const
+{
+  if (!m_compiled)
+    return false;
+
+  if (!m_isMethod)
+    return validateNode(0, value, outputValue);
+
+  // Same as JsonRpcMethod::Check() and checkParameter()
+  unsigned int handled = 0;
+  for (unsigned int position = 0; position < m_parameters.size(); position++)
+  {
+    const Node &parameter = m_nodes[m_parameters[position]];
+    const CVariant *parameterValue = nullptr;
+    if (value.isMember(parameter.name))
+      parameterValue = &value[parameter.name];
+    else if (value.isArray() && value.size() > position)
+      parameterValue = &value[position];
+
+    if (parameterValue != nullptr)
+    {
+      if (!validateNode(m_parameters[position], *parameterValue, outputValue[parameter.name]))
+        return false;
+      handled++;
+    }
+    else if (parameter.optional)
+      outputValue[parameter.name] = parameter.defaultValue;
+    else
+      return false;
+  }
+
+  return handled >= value.size();
+}
+
+bool CJSONSchemaValidator::compileNode(const JSONSchemaTypeDefinition &type, CompiledTypes &compiled, size_t &node)
+{
+  // types referencing themselves (e.g. filters) are compiled once
+  CompiledTypes::const_iterator it = compiled.find(&type);
+  if (it != compiled.end())
+  {
+    node = it->second;
+    return true;
+  }
+
+  // tuple typing isn't used by the schema and left to the full check
+  if (type.items.size() > 1 || !type.additionalItems.empty())
+    return false;
+
+  node = m_nodes.size();
+  compiled.insert(std::make_pair(&type, node));
+  m_nodes.emplace_back();
+
+  Node compiledNode;
+  compiledNode.name = type.name;
+  compiledNode.type = type.type;
+  compiledNode.optional = type.optional;
+  compiledNode.defaultValue = type.defaultValue;
+  compiledNode.enums = type.enums;
+  compiledNode.minimum = type.minimum;
+  compiledNode.maximum = type.maximum;
+  compiledNode.exclusiveMinimum = type.exclusiveMinimum;
+  compiledNode.exclusiveMaximum = type.exclusiveMaximum;
+  compiledNode.divisibleBy = type.divisibleBy;
+  compiledNode.minLength = type.minLength;
+  compiledNode.maxLength = type.maxLength;
+  compiledNode.minItems = type.minItems;
+  compiledNode.maxItems = type.maxItems;
+  compiledNode.uniqueItems = type.uniqueItems;
+  compiledNode.hasAdditionalProperties = type.hasAdditionalProperties;
+
+  if (!compiledNode.enums.empty() &&
+      std::all_of(compiledNode.enums.begin(), compiledNode.enums.end(), [](const CVariant &value) { return value.isString(); }))
+  {
+    for (const auto& value : compiledNode.enums)
+      compiledNode.stringEnums.push_back(value.asString());
+    std::sort(compiledNode.stringEnums.begin(), compiledNode.stringEnums.end());
+  }
+
+  // the nodes may be reallocated while compiling the nested types
+  size_t nested;
+  for (const auto& unionType : type.unionTypes)
+  {
+    if (!compileNode(*unionType, compiled, nested))
+      return false;
+    compiledNode.unionTypes.push_back(nested);
+  }
+
+  for (const auto& extendedType : type.extends)
+  {
+    if (!compileNode(*extendedType, compiled, nested))
+      return false;
+    compiledNode.extends.push_back(nested);
+  }
+
+  if (!type.items.empty())
+  {
+    if (!compileNode(*type.items.at(0), compiled, compiledNode.items))
+      return false;
+    compiledNode.hasItems = true;
+  }
+
+  // the properties map is ordered by the lower case names
+  for (const auto& property : type.properties)
+  {
+    if (!compileNode(*property.second, compiled, nested))
+      return false;
+    compiledNode.properties.push_back(nested);
+    compiledNode.propertyKeys.push_back(property.first);
+  }
+
+  if (type.additionalProperties != nullptr)
+  {
+    if (!compileNode(*type.additionalProperties, compiled, compiledNode.additionalProperties))
+      return false;
+    compiledNode.hasAdditionalPropertiesType = true;
+  }
+
+  m_nodes[node] = std::move(compiledNode);
+  return true;
+}
+
+bool CJSONSchemaValidator::validateNode(size_t index, const CVariant &value, CVariant &outputValue) const
+{
+  // Follows JSONSchemaTypeDefinition::Check() step by step
+  const Node &node = m_nodes[index];
+
+  if (!IsType(value, node.type) || (value.isNull() && !HasType(node.type, NullValue)))
+    return false;
+
+  if (!node.unionTypes.empty())
+  {
+    bool ok = false;
+    for (size_t unionType : node.unionTypes)
+    {
+      CVariant testOutput = outputValue;
+      if (validateNode(unionType, value, testOutput))
+      {
+        ok = true;
+        outputValue = std::move(testOutput);
+        break;
+      }
+    }
+
+    if (!ok)
+      return false;
+  }
+
+  for (size_t extendedType : node.extends)
+  {
+    if (!validateNode(extendedType, value, outputValue))
+      return false;
+  }
+
+  if (HasType(node.type, ArrayValue) && value.isArray())
+  {
+    outputValue = CVariant(CVariant::VariantTypeArray);
+    if ((node.minItems > 0 && value.size() < node.minItems) || (node.maxItems > 0 && value.size() > node.maxItems))
+      return false;
+
+    if (!node.hasItems)
+      outputValue = value;
+    else
+    {
+      for (CVariant::const_iterator_array it = value.begin_array(); it != value.end_array(); ++it)
+      {
+        CVariant item;
+        if (!validateNode(node.items, *it, item))
+          return false;
+        outputValue.push_back(std::move(item));
+      }
+    }
+
+    if (node.uniqueItems)
+    {
+      const CVariant &items = outputValue;
+      for (CVariant::const_iterator_array checking = items.begin_array(); checking != items.end_array(); ++checking)
+      {
+        if (std::find(checking + 1, items.end_array(), *checking) != items.end_array())
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+  if (HasType(node.type, ObjectValue) && value.isObject())
+  {
+    unsigned int handled = 0;
+    for (size_t property : node.properties)
+    {
+      const Node &propertyNode = m_nodes[property];
+      if (value.isMember(propertyNode.name))
+      {
+        if (!validateNode(property, value[propertyNode.name], outputValue[propertyNode.name]))
+          return false;
+        handled++;
+      }
+      else if (propertyNode.optional)
+        outputValue[propertyNode.name] = propertyNode.defaultValue;
+      else
+        return false;
+    }
+
+    if (handled < value.size())
+    {
+      if (!node.hasAdditionalProperties || !node.hasAdditionalPropertiesType)
+        return false;
+
+      for (CVariant::const_iterator_map it = value.begin_map(); it != value.end_map(); ++it)
+      {
+        if (std::binary_search(node.propertyKeys.begin(), node.propertyKeys.end(), it->first))
+          continue;
+
+        if (m_nodes[node.additionalProperties].type == AnyValue)
+          outputValue[it->first] = it->second;
+        else if (!validateNode(node.additionalProperties, it->second, outputValue[it->first]))
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+  if (!node.enums.empty() && !isEnumValue(node, value))
+    return false;
+
+  if ((HasType(node.type, NumberValue) && value.isDouble()) || (HasType(node.type, IntegerValue) && value.isInteger()))
+  {
+    double numberValue;
+    if (value.isDouble())
+      numberValue = value.asDouble();
+    else
+      numberValue = (double)value.asInteger();
+
+    if ((node.exclusiveMinimum && numberValue <= node.minimum) || (!node.exclusiveMinimum && numberValue < node.minimum) ||
+        (node.exclusiveMaximum && numberValue >= node.maximum) || (!node.exclusiveMaximum && numberValue > node.maximum))
+      return false;
+
+    if (HasType(node.type, IntegerValue) && node.divisibleBy > 0 && ((int)numberValue % node.divisibleBy) != 0)
+      return false;
+  }
+
+  if (HasType(node.type, StringValue) && value.isString())
+  {
+    int size = value.size();
+    if (size < node.minLength || (node.maxLength >= 0 && size > node.maxLength))
+      return false;
+  }
+
+  outputValue = value;
+  return true;
+}
+
+bool CJSONSchemaValidator::isEnumValue(const Node &node, const CVariant &value) const
+{
+  if (!node.stringEnums.empty())
+    return value.isString() && std::binary_search(node.stringEnums.begin(), node.stringEnums.end(), value.asString());
+
+  return std::find(node.enums.begin(), node.enums.end(), value) != node.enums.end();
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "JSONUtils.h"
+#include "utils/Variant.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace JSONRPC
+{
+  class JSONSchemaTypeDefinition;
+  typedef std::shared_ptr<JSONSchemaTypeDefinition> JSONSchemaTypeDefinitionPtr;
+
+  /*!
+   \ingroup jsonrpc
+   \brief Validator compiled from json schema
+   type definitions.
+
+   Checks a value or the parameters of a method
+   call in a single pass and produces the same
+   output as JSONSchemaTypeDefinition::Check()
+   without collecting any error information,
+   with referenced types resolved and enums of
+   strings sorted for lookup. A value it rejects
+   has to be checked again to explain the error.
+   */
+  class CJSONSchemaValidator : protected CJSONUtils
+  {
+  public:
+    /*!
+     \brief Compiles the validator for a value of the given type
+     \return False if the type uses features the validator doesn't support
+     */
+    bool CompileType(const JSONSchemaTypeDefinition &type);
+
+    /*!
+     \brief Compiles the validator for the parameters of a method
+     \return False if a parameter uses features the validator doesn't support
+     */
+    bool CompileParameters(const std::vector<JSONSchemaTypeDefinitionPtr> &parameters);
+
+    bool IsCompiled() const { return m_compiled; }
+
+    /*!
+     \brief Validates a value or the parameters of a method call
+     \param value Value or parameters (by name or by position) to validate
+     \param outputValue Cleaned up value or parameters with default values added
+     \return True if the value is valid, false if it is invalid or the validator isn't compiled
+     */
+    bool Validate(const CVariant &value, CVariant &outputValue) const;
+
+  private:
+    struct Node
+    {
+      std::string name;
+      JSONSchemaType type = AnyValue;
+      bool optional = true;
+      CVariant defaultValue;
+      std::vector<size_t> unionTypes;
+      std::vector<size_t> extends;
+      std::vector<CVariant> enums;
+      std::vector<std::string> stringEnums; //!< sorted, only set if all enums are strings
+      double minimum = 0.0;
+      double maximum = 0.0;
+      bool exclusiveMinimum = false;
+      bool exclusiveMaximum = false;
+      unsigned int divisibleBy = 0;
+      int minLength = -1;
+      int maxLength = -1;
+      bool hasItems = false;
+      size_t items = 0;
+      unsigned int minItems = 0;
+      unsigned int maxItems = 0;
+      bool uniqueItems = false;
+      std::vector<size_t> properties;
+      std::vector<std::string> propertyKeys; //!< lower case names of the properties, sorted
+      bool hasAdditionalProperties = false;
+      bool hasAdditionalPropertiesType = false;
+      size_t additionalProperties = 0;
+    };
+
+    typedef std::map<const JSONSchemaTypeDefinition*, size_t> CompiledTypes;
+
+    bool compileNode(const JSONSchemaTypeDefinition &type, CompiledTypes &compiled, size_t &node);
+    bool validateNode(size_t node, const CVariant &value, CVariant &outputValue) const;
+    bool isEnumValue(const Node &node, const CVariant &value) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<size_t> m_parameters;
+    bool m_isMethod = false;
+    bool m_compiled = false;
+  };
+}
@@ -224,6 +224,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 // Textures operations
   { "Textures.GetTextures",                         CTextureOperations::GetTextures },
   { "Textures.RemoveTexture",                       CTextureOperations::RemoveTexture },
+  { "Textures.CacheLibraryArt",                     CTextureOperations::CacheLibraryArt },
 
 // Settings operations
   { "Settings.GetSections",                         CSettingsOperations::GetSections },
@@ -235,7 +236,9 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 
 // XBMC operations
   { "XBMC.GetInfoLabels",                           CXBMCOperations::GetInfoLabels },
-  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans }
+  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans },
+  { "XBMC.StartTimelineProfiler",                   CXBMCOperations::StartTimelineProfiler },
+  { "XBMC.GetTimelineProfile",                      CXBMCOperations::GetTimelineProfile }
 };
 
 JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
@@ -1308,6 +1311,12 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
     {
       methodCall = method;
 
+      // Valid parameters pass the compiled validator, the full
+      // check only runs to explain why parameters are invalid
+      if (validator.Validate(requestParameters, outputParameters))
+        return OK;
+      outputParameters = CVariant();
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1411,6 +1420,9 @@ void CJSONServiceDescription::ResolveReferences()
 {
   for (auto it : m_types)
     it.second->ResolveReference();
+
+  // the methods share the now resolved type definitions
+  m_actionMap.compile();
 }
 
 void CJSONServiceDescription::Cleanup()
@@ -2063,6 +2075,20 @@ void CJSONServiceDescription::CJsonRpcMethodMap::add(const JsonRpcMethod &method
   m_actionmap[name] = method;
 }
 
+void CJSONServiceDescription::CJsonRpcMethodMap::compile()
+{
+  unsigned int compiled = 0;
+  for (auto& method : m_actionmap)
+  {
+    if (method.second.validator.CompileParameters(method.second.parameters))
+      compiled++;
+    else
+      CLog::Log(LOGDEBUG, "JSONRPC: Parameters of method \"%s\" are always fully checked", method.second.name.c_str());
+  }
+
+  CLog::Log(LOGDEBUG, "JSONRPC: Compiled validators for %u of %u methods", compiled, static_cast<unsigned int>(m_actionmap.size()));
+}
+
 CJSONServiceDescription::CJsonRpcMethodMap::JsonRpcMethodIterator CJSONServiceDescription::CJsonRpcMethodMap::begin() const
 {
   return m_actionmap.begin();
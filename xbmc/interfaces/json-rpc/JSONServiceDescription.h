@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "JSONSchemaValidator.h"
 #include "JSONUtils.h"
 #include "utils/Variant.h"
 
@@ -263,6 +264,12 @@ namespace JSONRPC
      \brief Definition of the return value
      */
     JSONSchemaTypeDefinitionPtr returns;
+    /*!
+     \brief Validator compiled from the
+     parameters, checked before the full
+     (and slower) parameter check
+     */
+    CJSONSchemaValidator validator;
 
   private:
     bool parseParameter(const CVariant &value, JSONSchemaTypeDefinitionPtr parameter);
@@ -401,6 +408,7 @@ namespace JSONRPC
       CJsonRpcMethodMap();
 
       void add(const JsonRpcMethod &method);
+      void compile();
 
       typedef std::map<std::string, JsonRpcMethod>::const_iterator JsonRpcMethodIterator;
       JsonRpcMethodIterator begin() const;
@@ -91,3 +91,11 @@ JSONRPC_STATUS CTextureOperations::RemoveTexture(const std::string &method, ITra
 
   return ACK;
 }
+
+JSONRPC_STATUS CTextureOperations::CacheLibraryArt(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (!CTextureCache::GetInstance().CacheLibraryArt(parameterObject["showdialogs"].asBoolean()))
+    return FailedToExecute;
+
+  return ACK;
+}
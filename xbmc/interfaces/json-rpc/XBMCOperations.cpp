@@ -11,6 +11,7 @@
 #include "ServiceBroker.h"
 #include "messaging/ApplicationMessenger.h"
 #include "powermanagement/PowerManager.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/Variant.h"
 
 using namespace JSONRPC;
@@ -85,3 +86,20 @@ JSONRPC_STATUS CXBMCOperations::GetInfoBooleans(const std::string &method, ITran
 
   return OK;
 }
+
+JSONRPC_STATUS CXBMCOperations::StartTimelineProfiler(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CTimelineProfiler::GetInstance().Start();
+
+  return ACK;
+}
+
+JSONRPC_STATUS CXBMCOperations::GetTimelineProfile(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (parameterObject["stop"].asBoolean())
+    CTimelineProfiler::GetInstance().Stop();
+
+  CTimelineProfiler::GetInstance().GetChromeTrace(result);
+
+  return OK;
+}
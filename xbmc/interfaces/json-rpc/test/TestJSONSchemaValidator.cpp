@@ -0,0 +1,186 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceDescription.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONSchemaValidator.h"
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace JSONRPC;
+
+namespace
+{
+class CTestTransport : public ITransportLayer
+{
+public:
+  bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) override { return false; }
+  bool Download(const char *path, CVariant &result) override { return false; }
+  int GetCapabilities() override { return Response; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  int GetPermissionFlags() override { return OPERATION_PERMISSION_ALL; }
+  int GetAnnouncementFlags() override { return 0; }
+  bool SetAnnouncementFlags(int flags) override { return true; }
+};
+
+std::string ToJson(const CVariant &value)
+{
+  std::string json;
+  CJSONVariantWriter::Write(value, json, true);
+  return json;
+}
+
+class TestJSONSchemaValidator : public testing::Test
+{
+protected:
+  TestJSONSchemaValidator() { CJSONRPC::Initialize(); }
+
+  // parse a method the way CJSONServiceDescription does
+  static bool GetMethod(const std::string &name, JsonRpcMethod &method)
+  {
+    const std::string prefix = "\"" + name + "\":";
+    for (const char *description : JSONRPC_SERVICE_METHODS)
+    {
+      if (std::string(description).compare(0, prefix.size(), prefix) != 0)
+        continue;
+
+      CVariant descriptionObject;
+      if (!CJSONVariantParser::Parse("{" + std::string(description) + "}", descriptionObject))
+        return false;
+
+      method.name = name;
+      if (!method.Parse(descriptionObject[name]))
+        return false;
+
+      // compiled once the references are resolved, see CJSONServiceDescription::ResolveReferences()
+      method.validator.CompileParameters(method.parameters);
+      return true;
+    }
+    return false;
+  }
+
+  JSONRPC_STATUS Check(const JsonRpcMethod &method, const std::string &parameters, CVariant &outputParameters)
+  {
+    CVariant requestParameters;
+    EXPECT_TRUE(CJSONVariantParser::Parse(parameters, requestParameters));
+
+    MethodCall methodCall;
+    return method.Check(requestParameters, &m_transport, &m_client, false, methodCall, outputParameters);
+  }
+
+  CTestTransport m_transport;
+  CTestClient m_client;
+};
+}
+
+TEST_F(TestJSONSchemaValidator, MatchesFullCheck)
+{
+  const struct
+  {
+    const char *method;
+    const char *parameters;
+    JSONRPC_STATUS status;
+  } requests[] = {
+    { "Player.GetProperties", "{\"playerid\":1,\"properties\":[\"time\",\"speed\",\"percentage\",\"totaltime\"]}", OK },
+    { "Player.GetProperties", "[1,[\"time\",\"speed\"]]", OK },
+    { "Player.GetProperties", "{\"playerid\":1,\"properties\":[\"time\",\"time\"]}", InvalidParams },
+    { "Player.GetProperties", "{\"playerid\":1,\"properties\":[\"unknown\"]}", InvalidParams },
+    { "Player.GetProperties", "{\"playerid\":\"1\",\"properties\":[\"time\"]}", InvalidParams },
+    { "Player.GetProperties", "{\"properties\":[\"time\"]}", InvalidParams },
+    { "Player.GetProperties", "{\"playerid\":1,\"properties\":[\"time\"],\"other\":1}", InvalidParams },
+    { "Player.GetItem", "{\"playerid\":1}", OK },
+    { "Player.GetItem", "{\"playerid\":1,\"properties\":[\"title\",\"thumbnail\",\"file\"]}", OK },
+    { "Application.GetProperties", "{\"properties\":[\"volume\",\"muted\"]}", OK },
+    { "VideoLibrary.GetMovies", "{}", OK },
+    { "VideoLibrary.GetMovies", "{\"properties\":[\"title\",\"year\"],\"limits\":{\"start\":0,\"end\":50},\"sort\":{\"method\":\"title\",\"ignorearticle\":true}}", OK },
+    { "VideoLibrary.GetMovies", "{\"filter\":{\"genre\":\"Drama\"}}", OK },
+    { "VideoLibrary.GetMovies", "{\"filter\":{\"and\":[{\"field\":\"year\",\"operator\":\"greaterthan\",\"value\":\"2000\"},{\"or\":[{\"field\":\"genre\",\"operator\":\"is\",\"value\":[\"Drama\",\"Comedy\"]}]}]}}", OK },
+    { "VideoLibrary.GetMovies", "{\"filter\":{\"genre\":\"\"}}", InvalidParams },
+    { "VideoLibrary.GetMovies", "{\"limits\":{\"start\":-1}}", InvalidParams },
+  };
+
+  for (const auto& request : requests)
+  {
+    JsonRpcMethod method;
+    ASSERT_TRUE(GetMethod(request.method, method)) << request.method;
+    ASSERT_TRUE(method.validator.IsCompiled()) << request.method;
+
+    CVariant compiledOutput;
+    EXPECT_EQ(request.status, Check(method, request.parameters, compiledOutput)) << request.parameters;
+
+    // without the validator the full check does all the work
+    method.validator = CJSONSchemaValidator();
+    CVariant fullOutput;
+    EXPECT_EQ(request.status, Check(method, request.parameters, fullOutput)) << request.parameters;
+    // null values never compare equal
+    EXPECT_EQ(ToJson(fullOutput), ToJson(compiledOutput)) << request.parameters;
+  }
+}
+
+TEST_F(TestJSONSchemaValidator, InvalidParametersAreExplained)
+{
+  JsonRpcMethod method;
+  ASSERT_TRUE(GetMethod("Player.GetProperties", method));
+
+  CVariant output;
+  ASSERT_EQ(InvalidParams, Check(method, "{\"playerid\":1,\"properties\":[\"unknown\"]}", output));
+  EXPECT_STREQ("Player.GetProperties", output["method"].c_str());
+  EXPECT_STREQ("properties", output["stack"]["name"].c_str());
+  EXPECT_TRUE(output["stack"].isMember("message"));
+}
+
+TEST_F(TestJSONSchemaValidator, RequestsPerSecond)
+{
+  const struct
+  {
+    const char *method;
+    const char *parameters;
+  } requests[] = {
+    { "Player.GetProperties", "{\"playerid\":1,\"properties\":[\"time\",\"totaltime\",\"percentage\",\"speed\",\"position\",\"playlistid\",\"repeat\",\"shuffled\"]}" },
+    { "Player.GetItem", "{\"playerid\":1,\"properties\":[\"title\",\"album\",\"artist\",\"season\",\"episode\",\"duration\",\"showtitle\",\"tvshowid\",\"thumbnail\",\"file\",\"fanart\",\"streamdetails\"]}" },
+    { "Application.GetProperties", "{\"properties\":[\"volume\",\"muted\"]}" },
+    { "VideoLibrary.GetMovies", "{\"properties\":[\"title\",\"year\",\"rating\",\"thumbnail\",\"playcount\"],\"limits\":{\"start\":0,\"end\":50},\"sort\":{\"method\":\"title\",\"ignorearticle\":true}}" },
+  };
+  const int iterations = 2000;
+
+  for (const auto& request : requests)
+  {
+    JsonRpcMethod method;
+    ASSERT_TRUE(GetMethod(request.method, method)) << request.method;
+
+    // parse and validate the parameters like CJSONRPC::HandleMethodCall()
+    auto requestsPerSecond = [&]() {
+      const auto begin = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++)
+      {
+        CVariant output;
+        EXPECT_EQ(OK, Check(method, request.parameters, output));
+      }
+      const auto time = std::chrono::steady_clock::now() - begin;
+      return static_cast<int>(iterations / std::chrono::duration<double>(time).count());
+    };
+
+    const int compiled = requestsPerSecond();
+    method.validator = CJSONSchemaValidator();
+    const int full = requestsPerSecond();
+
+    RecordProperty(std::string(request.method) + ".compiled", compiled);
+    RecordProperty(std::string(request.method) + ".full", full);
+  }
+}
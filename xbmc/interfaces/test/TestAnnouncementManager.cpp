@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/AnnouncementManager.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ANNOUNCEMENT;
+
+namespace
+{
+class CTestAnnouncer : public IAnnouncer
+{
+public:
+  void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override
+  {
+    CSingleLock lock(m_critSection);
+    m_messages.push_back(std::string(message) + ":" + data.asString());
+  }
+
+  std::vector<std::string> WaitForMessages(size_t count)
+  {
+    XbmcThreads::EndTime timeout(5000);
+    while (!timeout.IsTimePast())
+    {
+      {
+        CSingleLock lock(m_critSection);
+        if (m_messages.size() >= count)
+          return m_messages;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    CSingleLock lock(m_critSection);
+    return m_messages;
+  }
+
+private:
+  CCriticalSection m_critSection;
+  std::vector<std::string> m_messages;
+};
+
+class TestAnnouncementManager : public testing::Test
+{
+protected:
+  TestAnnouncementManager() { m_manager.AddAnnouncer(&m_announcer); }
+  ~TestAnnouncementManager() override { m_manager.Deinitialize(); }
+
+  CAnnouncementManager m_manager;
+  CTestAnnouncer m_announcer;
+};
+}
+
+TEST_F(TestAnnouncementManager, CoalesceBurst)
+{
+  // announced before the manager runs, i.e. faster than they are delivered
+  for (int i = 0; i < 100; i++)
+    m_manager.Announce(Application, "xbmc", "OnVolumeChanged", CVariant(50));
+  m_manager.Announce(Application, "xbmc", "OnVolumeChanged", CVariant(60));
+  m_manager.Start();
+
+  const std::vector<std::string> messages = m_announcer.WaitForMessages(2);
+  ASSERT_EQ(2u, messages.size());
+  EXPECT_EQ("OnVolumeChanged:50", messages[0]);
+  EXPECT_EQ("OnVolumeChanged:60", messages[1]);
+  EXPECT_EQ(101u, m_manager.GetAnnouncementCount());
+  EXPECT_EQ(99u, m_manager.GetCoalescedCount());
+}
+
+TEST_F(TestAnnouncementManager, KeepOrder)
+{
+  // only the last queued announcement is coalesced, so the last state delivered is the last state announced
+  m_manager.Announce(Application, "xbmc", "OnVolumeChanged", CVariant(50));
+  m_manager.Announce(Application, "xbmc", "OnVolumeChanged", CVariant(60));
+  m_manager.Announce(Application, "xbmc", "OnVolumeChanged", CVariant(50));
+  m_manager.Start();
+
+  const std::vector<std::string> messages = m_announcer.WaitForMessages(3);
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ("OnVolumeChanged:50", messages[2]);
+  EXPECT_EQ(0u, m_manager.GetCoalescedCount());
+}
+
+TEST_F(TestAnnouncementManager, DeliverAddonAnnouncements)
+{
+  m_manager.Announce(Other, "addon", "Ping", CVariant("data"));
+  m_manager.Announce(Other, "addon", "Ping", CVariant("data"));
+  m_manager.Start();
+
+  EXPECT_EQ(2u, m_announcer.WaitForMessages(2).size());
+  EXPECT_EQ(0u, m_manager.GetCoalescedCount());
+}
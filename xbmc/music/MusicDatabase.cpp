@@ -54,6 +54,7 @@
 #include "utils/FileUtils.h"
 #include "utils/LegacyPathTranslation.h"
 #include "utils/MathUtils.h"
+#include "utils/NameIndex.h"
 #include "utils/Random.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -100,6 +101,18 @@ static void AnnounceUpdate(const std::string& content, int id, bool added = fals
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnUpdate", data);
 }
 
+// names searched for, shared by all connections and kept up to date when items are added, changed or removed
+static CNameIndex songSearchIndex;
+static CNameIndex albumSearchIndex;
+static CNameIndex artistSearchIndex;
+
+static void InvalidateSearchIndexes()
+{
+  songSearchIndex.Invalidate();
+  albumSearchIndex.Invalidate();
+  artistSearchIndex.Invalidate();
+}
+
 CMusicDatabase::CMusicDatabase(void)
 {
   m_translateBlankArtist = true;
@@ -628,6 +641,7 @@ int CMusicDatabase::AddSong(const int idAlbum,
                       iTimesPlayed, iStartOffset, iEndOffset, rating, userrating, votes, strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
       m_pDS->exec(strSQL);
       idSong = (int)m_pDS->lastinsertid();
+      songSearchIndex.Set(GetSearchIndexKey(), idSong, strTitle);
     }
     else
     {
@@ -807,7 +821,10 @@ int CMusicDatabase::UpdateSong(int idSong,
   UpdateFileDateAdded(idSong, strPathAndFileName);
 
   if (status)
+  {
+    songSearchIndex.Set(GetSearchIndexKey(), idSong, strTitle);
     AnnounceUpdate(MediaTypeSong, idSong);
+  }
   return idSong;
 }
 
@@ -866,7 +883,9 @@ int CMusicDatabase::AddAlbum(const std::string& strAlbum, const std::string& str
       strSQL += ")";
       m_pDS->exec(strSQL);
 
-      return (int)m_pDS->lastinsertid();
+      int idAlbum = (int)m_pDS->lastinsertid();
+      albumSearchIndex.Set(GetSearchIndexKey(), idAlbum, strAlbum);
+      return idAlbum;
     }
     else
     {
@@ -905,6 +924,8 @@ int CMusicDatabase::AddAlbum(const std::string& strAlbum, const std::string& str
         CAlbum::ReleaseTypeToString(releaseType).c_str(),
         idAlbum);
       m_pDS->exec(strSQL);
+      if (!strMusicBrainzAlbumID.empty())
+        albumSearchIndex.Set(GetSearchIndexKey(), idAlbum, strAlbum);
       DeleteAlbumArtistsByAlbum(idAlbum);
       DeleteAlbumSources(idAlbum);
       return idAlbum;
@@ -967,7 +988,10 @@ int  CMusicDatabase::UpdateAlbum(int idAlbum,
 
   bool status = ExecuteQuery(strSQL);
   if (status)
+  {
+    albumSearchIndex.Set(GetSearchIndexKey(), idAlbum, strAlbum);
     AnnounceUpdate(MediaTypeAlbum, idAlbum);
+  }
   return idAlbum;
 }
 
@@ -1241,6 +1265,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
           strSQL = PrepareSQL("UPDATE artist SET strArtist = '%s' WHERE idArtist = %i", strArtist.c_str(), idArtist);
           m_pDS->exec(strSQL);
           m_pDS->close();
+          artistSearchIndex.Set(GetSearchIndexKey(), idArtist, strArtist);
         }
         return idArtist;
       }
@@ -1262,6 +1287,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
           bScrapedMBID,
           idArtist);
         m_pDS->exec(strSQL);
+        artistSearchIndex.Set(GetSearchIndexKey(), idArtist, strArtist);
         return idArtist;
       }
 
@@ -1296,6 +1322,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
 
     m_pDS->exec(strSQL);
     int idArtist = (int)m_pDS->lastinsertid();
+    artistSearchIndex.Set(GetSearchIndexKey(), idArtist, strArtist);
     return idArtist;
   }
   catch (...)
@@ -1355,7 +1382,10 @@ int  CMusicDatabase::UpdateArtist(int idArtist,
 
   bool status = ExecuteQuery(strSQL);
   if (status)
+  {
+    artistSearchIndex.Set(GetSearchIndexKey(), idArtist, strArtist);
     AnnounceUpdate(MediaTypeArtist, idArtist);
+  }
   return idArtist;
 }
 
@@ -2492,6 +2522,15 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
                                 "where strArtist like '%s%%' and strArtist <> '%s' "
                                 , search.c_str(), strVariousArtists.c_str() );
 
+    // the index narrows the search down to the artists whose name contains the term
+    std::string artistIds;
+    if (FindInSearchIndex(artistSearchIndex, "artist", "idArtist", "strArtist", search, artistIds))
+    {
+      if (artistIds.empty())
+        return false;
+      strSQL += "and idArtist in (" + artistIds + ")";
+    }
+
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0)
     {
@@ -3049,9 +3088,19 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
 
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
+      strSQL=PrepareSQL("select * from songview where (strTitle like '%s%%' or strTitle like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%'", search.c_str());
+
+    // the index narrows the search down to the songs whose title contains the term
+    std::string songIds;
+    if (FindInSearchIndex(songSearchIndex, "song", "idSong", "strTitle", search, songIds))
+    {
+      if (songIds.empty())
+        return false;
+      strSQL += " and idSong in (" + songIds + ")";
+    }
+    strSQL += " limit 1000";
 
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -3087,10 +3136,19 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
 
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
+      strSQL=PrepareSQL("select * from albumview where (strAlbum like '%s%%' or strAlbum like '%% %s%%')", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
 
+    // the index narrows the search down to the albums whose name contains the term
+    std::string albumIds;
+    if (FindInSearchIndex(albumSearchIndex, "album", "idAlbum", "strAlbum", search, albumIds))
+    {
+      if (albumIds.empty())
+        return true;
+      strSQL += " and idAlbum in (" + albumIds + ")";
+    }
+
     if (!m_pDS->query(strSQL)) return false;
 
     std::string albumLabel(g_localizeStrings.Get(558)); // Album
@@ -3163,6 +3221,8 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string &strSongIds)
       strSQL = "delete from song where idSong in " + strSongsToDelete;
       m_pDS->exec(strSQL);
       m_pDS->close();
+      for (const auto& idSong : songsToDelete)
+        songSearchIndex.Remove(GetSearchIndexKey(), atoi(idSong.c_str()));
     }
     return true;
   }
@@ -3260,6 +3320,8 @@ bool CMusicDatabase::CleanupAlbums()
     // ok, now we can delete them and the references in the linked tables
     strSQL = "delete from album where idAlbum in " + strAlbumIds;
     m_pDS->exec(strSQL);
+    for (const auto& idAlbum : albumIds)
+      albumSearchIndex.Remove(GetSearchIndexKey(), atoi(idAlbum.c_str()));
     return true;
   }
   catch (...)
@@ -3344,6 +3406,7 @@ bool CMusicDatabase::CleanupArtists()
     m_pDS->exec("CREATE TEMPORARY TABLE tmp_keep (idArtist INTEGER PRIMARY KEY)");
     m_pDS->exec("INSERT INTO tmp_keep SELECT DISTINCT idArtist from tmp_delartists");
     m_pDS->exec("DELETE FROM artist WHERE idArtist NOT IN (SELECT idArtist FROM tmp_keep)");
+    artistSearchIndex.Invalidate();
     // Tidy up temp tables
     m_pDS->exec("DROP TABLE tmp_delartists");
     m_pDS->exec("DROP TABLE tmp_keep");
@@ -4634,12 +4697,48 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
       strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
     }
 
+    // The join with songartistview has a row for every artist so can't be sorted with limits.
+    // Instead sort and limit songview first and only join the songs within the limits
+    bool limitedInDataset = artistData && !limitedInSQL && extFilter.limit.empty() &&
+      sortDescription.sortBy != SortByNone &&
+      (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0);
+    std::vector<int> songIds;
+    if (limitedInDataset)
+    {
+      if (!m_pDS->query("SELECT songview.* FROM songview " + strSQLExtra))
+        return false;
+
+      DatabaseResults limited;
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, limited))
+      {
+        m_pDS->close();
+        return false;
+      }
+      const dbiplus::query_data &data = m_pDS->get_result_set().records;
+      for (const auto &i : limited)
+        songIds.push_back(data.at((unsigned int)i.at(FieldRow).asInteger())->at(song_idSong).get_asInt());
+      m_pDS->close();
+
+      if (songIds.empty())
+        return true;
+    }
+
     std::string strSQL;
     if (artistData)
     { // Get data from song and song_artist tables to fully populate songs with artists
       // All songs now have at least one artist so inner join sufficient
       // Need guaranteed ordering for dataset processing to extract songs
-      if (limitedInSQL)
+      if (limitedInDataset)
+      {
+        std::vector<std::string> ids;
+        ids.reserve(songIds.size());
+        for (int id : songIds)
+          ids.push_back(StringUtils::Format("%i", id));
+        strSQL = "SELECT songview.*, songartistview.* "
+          "FROM songview JOIN songartistview ON songartistview.idsong = songview.idsong "
+          "WHERE songview.idSong IN (" + StringUtils::Join(ids, ",") + ")";
+      }
+      else if (limitedInSQL)
         //Apply where clause, limits and random order to songview, then join as multiple records in result set per song
         strSQL = "SELECT sv.*, songartistview.* "
           "FROM (SELECT songview.* FROM songview " + strSQLExtra + ") AS sv "
@@ -4733,9 +4832,25 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     // cleanup
     m_pDS->close();
 
+    if (limitedInDataset)
+    { // Songs within the limits were joined in id order, put them back in sorted order
+      std::map<int, CFileItemPtr> songs;
+      for (int i = 0; i < items.Size(); i++)
+        songs[items[i]->GetMusicInfoTag()->GetDatabaseId()] = items[i];
+      items.ClearItems();
+      count = 0;
+      for (int id : songIds)
+      {
+        const auto song = songs.find(id);
+        if (song == songs.end())
+          continue;
+        song->second->m_iprogramCount = ++count;
+        items.Add(song->second);
+      }
+    }
     // Finally do any sorting in items list we have not been able to do before in SQL or dataset,
     // that is when have join with songartistview and sorting other than random with limit
-    if (artistData && sortDescription.sortBy != SortByNone && !(limitedInSQL && sortDescription.sortBy == SortByRandom))
+    else if (artistData && sortDescription.sortBy != SortByNone && !(limitedInSQL && sortDescription.sortBy == SortByRandom))
       items.Sort(sortDescription);
 
     CLog::Log(LOGDEBUG, "%s(%s) - took %d ms", __FUNCTION__, filter.where.c_str(), XbmcThreads::SystemClockMillis() - time);
@@ -9162,6 +9277,8 @@ bool CMusicDatabase::RemoveSongsFromPath(const std::string &path1, MAPSONGS& son
       // and delete all songs, and anything linked to them
       sql = "delete from song where idSong in (" + StringUtils::Join(songIds, ",") + ")";
       m_pDS->exec(sql);
+      for (const auto &song : songs)
+        songSearchIndex.Remove(GetSearchIndexKey(), song.second.idSong);
     }
     // and remove the path as well (it'll be re-added later on with the new hash if it's non-empty)
     sql = "delete from path" + where;
@@ -9353,6 +9470,13 @@ bool CMusicDatabase::CommitTransaction()
   return false;
 }
 
+void CMusicDatabase::RollbackTransaction()
+{
+  CDatabase::RollbackTransaction();
+  // names changed in the transaction are back to what they were
+  InvalidateSearchIndexes();
+}
+
 bool CMusicDatabase::SetScraperAll(const std::string & strBaseDir, const ADDON::ScraperPtr scraper)
 {
   if (nullptr == m_pDB)
@@ -10769,6 +10893,34 @@ bool CMusicDatabase::GetArtTypes(const MediaType &mediaType, std::vector<std::st
   return false;
 }
 
+bool CMusicDatabase::GetArtURLs(std::vector<std::string> &urls)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    if (!m_pDS->query("SELECT DISTINCT url FROM art"))
+      return false;
+
+    urls.reserve(urls.size() + m_pDS->num_rows());
+    while (!m_pDS->eof())
+    {
+      urls.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 std::vector<std::string> CMusicDatabase::GetAvailableArtTypesForItem(int mediaId,
   const MediaType& mediaType)
 {
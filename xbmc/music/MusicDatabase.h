@@ -105,6 +105,7 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+  void RollbackTransaction() override;
   void EmptyCache();
   void Clean();
   int  Cleanup(CGUIDialogProgress* progressDialog = nullptr);
@@ -596,6 +597,12 @@ public:
   */
   bool GetArtTypes(const MediaType &mediaType, std::vector<std::string> &artTypes);
 
+  /*! \brief Fetch the urls of all art in the database, without duplicates.
+  \param urls [out] the urls of the art.
+  \return true on success, false otherwise.
+  */
+  bool GetArtURLs(std::vector<std::string> &urls);
+
   /*! \brief Fetch the distinct types of available-but-unassigned art held in the
   database for a specific media item.
   \param mediaId the id in the media (artist/album) table.
@@ -119,73 +119,138 @@ bool CEventClient::AddPacket(CEventPacket *packet)
   if ( packet->Size() > 1 )
   {
     //! @todo limit payload size
-    if (m_seqPackets[ packet->Sequence() ])
+    if (packet->Size() > MAX_SEQUENCE_PACKETS ||
+        packet->Sequence() < 1 || packet->Sequence() > packet->Size())
+    {
+      CLog::Log(LOGDEBUG, "ES: Received packet %u of %u from eventclient %s, dropping it",
+                packet->Sequence(), packet->Size(), m_deviceName.c_str());
+      delete packet;
+      return false;
+    }
+
+    // a message of a different length starts over
+    if (m_seqPackets.size() != packet->Size())
+    {
+      FreeSequencePackets();
+      m_seqPackets.resize(packet->Size(), nullptr);
+    }
+
+    CEventPacket* &seqPacket = m_seqPackets[ packet->Sequence() - 1 ];
+    if (seqPacket)
     {
       if(!m_bSequenceError)
         CLog::Log(LOGWARNING, "CEventClient::AddPacket - received packet with same sequence number (%d) as previous packet from eventclient %s", packet->Sequence(), m_deviceName.c_str());
       m_bSequenceError = true;
-      delete m_seqPackets[ packet->Sequence() ];
+      delete seqPacket;
     }
+    else
+      m_iSeqPacketsReceived++;
 
-    m_seqPackets[ packet->Sequence() ] = packet;
-    if (m_seqPackets.size() == packet->Size())
+    seqPacket = packet;
+    if (m_iSeqPacketsReceived == m_seqPackets.size())
     {
       unsigned int iSeqPayloadSize = 0;
-      for (unsigned int i = 1 ; i<=packet->Size() ; i++)
+      for (CEventPacket* part : m_seqPackets)
       {
-        iSeqPayloadSize += m_seqPackets[i]->PayloadSize();
+        iSeqPayloadSize += part->PayloadSize();
       }
-      unsigned int offset = 0;
-      void *newPayload = NULL;
-      newPayload = malloc(iSeqPayloadSize);
-      if (newPayload)
-      {
-        unsigned char *payloadPtr = (unsigned char *)newPayload;
-        unsigned int packets = packet->Size(); // packet can be deleted in this loop
-        for (unsigned int i = 1 ; i<=packets ; i++)
-        {
-          memcpy((void*)(payloadPtr + offset), m_seqPackets[i]->Payload(),
-                 m_seqPackets[i]->PayloadSize());
-          offset += m_seqPackets[i]->PayloadSize();
-          if (i>1)
-          {
-            delete m_seqPackets[i];
-            m_seqPackets[i] = NULL;
-          }
-        }
-        m_seqPackets[1]->SetPayload(iSeqPayloadSize, newPayload);
-        m_readyPackets.push(m_seqPackets[1]);
-        m_seqPackets.clear();
-      }
-      else
+
+      unsigned char *newPayload = (unsigned char *)malloc(iSeqPayloadSize);
+      if (!newPayload)
       {
         CLog::Log(LOGERROR, "ES: Could not assemble packets, Out of Memory");
         FreePacketQueues();
         return false;
       }
+
+      unsigned int offset = 0;
+      for (CEventPacket* part : m_seqPackets)
+      {
+        memcpy(newPayload + offset, part->Payload(), part->PayloadSize());
+        offset += part->PayloadSize();
+      }
+
+      // the first packet carries the whole message
+      CEventPacket* message = m_seqPackets.front();
+      m_seqPackets.front() = nullptr;
+      message->SetPayload(iSeqPayloadSize, newPayload);
+      m_readyPackets.push_back(message);
+      FreeSequencePackets();
     }
   }
   else
   {
-    m_readyPackets.push(packet);
+    m_readyPackets.push_back(packet);
   }
   return true;
 }
 
-void CEventClient::ProcessEvents()
+unsigned int CEventClient::ProcessEvents()
 {
-  if (!m_readyPackets.empty())
+  unsigned int coalesced = CoalesceReadyPackets();
+
+  while ( ! m_readyPackets.empty() )
   {
-    while ( ! m_readyPackets.empty() )
+    ProcessPacket( m_readyPackets.front() );
+    if ( ! m_readyPackets.empty() ) // in case the BYE packet cleared the queues
     {
-      ProcessPacket( m_readyPackets.front() );
-      if ( ! m_readyPackets.empty() ) // in case the BYE packet cleared the queues
-      {
-        delete m_readyPackets.front();
-        m_readyPackets.pop();
-      }
+      delete m_readyPackets.front();
+      m_readyPackets.pop_front();
     }
   }
+
+  return coalesced;
+}
+
+unsigned int CEventClient::CoalesceReadyPackets()
+{
+  if (m_readyPackets.size() < 2)
+    return 0;
+
+  // walk back from the latest packet and keep the first one of every kind
+  bool mouseMoved = false;
+  std::map<std::string, unsigned short> buttons; // button -> flags of its next packet
+  std::deque<CEventPacket*> readyPackets;
+  unsigned int coalesced = 0;
+
+  for (auto it = m_readyPackets.rbegin(); it != m_readyPackets.rend(); ++it)
+  {
+    CEventPacket* packet = *it;
+    const unsigned char* payload = (const unsigned char*)packet->Payload();
+    bool superseded = false;
+
+    if (packet->Type() == EVENTPACKET::PT_MOUSE && packet->PayloadSize() >= 5 && (payload[0] & PTM_ABSOLUTE))
+    {
+      // only the last position counts
+      superseded = mouseMoved;
+      mouseMoved = true;
+    }
+    else if (packet->Type() == PT_BUTTON && packet->PayloadSize() >= 6)
+    {
+      // a button is identified by its code, map and name, leaving out the flags and amount
+      unsigned short flags = (unsigned short)((payload[2] << 8) | payload[3]);
+      std::string button((const char*)payload, 2);
+      button.append((const char*)payload + 6, packet->PayloadSize() - 6);
+
+      // an axis update is superseded by a later update of the same axis
+      auto next = buttons.find(button);
+      superseded = next != buttons.end() && next->second == flags &&
+                   (flags & (PTB_AXIS | PTB_AXISSINGLE)) &&
+                   (flags & PTB_USE_AMOUNT) && (flags & PTB_DOWN);
+      buttons[button] = flags;
+    }
+
+    if (superseded)
+    {
+      delete packet;
+      coalesced++;
+    }
+    else
+      readyPackets.push_front(packet);
+  }
+
+  m_readyPackets.swap(readyPackets);
+  return coalesced;
 }
 
 bool CEventClient::GetNextAction(CEventAction &action)
@@ -194,6 +259,7 @@ bool CEventClient::GetNextAction(CEventAction &action)
   if (!m_actionQueue.empty())
   {
     // grab the next action in line
+    AddQueueLatency(m_actionQueue.front().queued);
     action = m_actionQueue.front();
     m_actionQueue.pop();
     return true;
@@ -421,6 +487,7 @@ bool CEventClient::OnPacketBUTTON(CEventPacket *packet)
       state.m_bRepeat = false;
       state.m_fAmount = 0.0;
     }
+    state.m_iQueued = XbmcThreads::SystemClockMillis();
 
     std::list<CEventButtonState>::reverse_iterator it;
     it = find_if( m_buttonQueue.rbegin() , m_buttonQueue.rend(), ButtonStateFinder(state));
@@ -485,6 +552,7 @@ bool CEventClient::OnPacketBUTTON(CEventPacket *packet)
       m_currentButton.m_bRepeat    = (flags & PTB_NO_REPEAT)  ? false : true;
       m_currentButton.m_bAxis      = (flags & PTB_AXIS)       ? true : false;
       m_currentButton.m_iNextRepeat = 0;
+      m_currentButton.m_iQueued = XbmcThreads::SystemClockMillis();
       m_currentButton.SetActive();
       m_currentButton.Load();
     }
@@ -501,6 +569,7 @@ bool CEventClient::OnPacketBUTTON(CEventPacket *packet)
                                  m_currentButton.m_bAxis,
                                  false,
                                  true );
+        state.m_iQueued = XbmcThreads::SystemClockMillis();
 
         m_buttonQueue.push_back (state);
       }
@@ -534,6 +603,8 @@ bool CEventClient::OnPacketMOUSE(CEventPacket *packet)
     CSingleLock lock(m_critSection);
     if ( flags & PTM_ABSOLUTE )
     {
+      if (!m_bMouseMoved)
+        m_iMouseQueued = XbmcThreads::SystemClockMillis();
       m_iMouseX = mx;
       m_iMouseY = my;
       m_bMouseMoved = true;
@@ -642,7 +713,9 @@ bool CEventClient::OnPacketACTION(CEventPacket *packet)
   case AT_BUTTON:
     {
       CSingleLock lock(m_critSection);
-      m_actionQueue.push(CEventAction(actionString.c_str(), actionType));
+      CEventAction action(actionString.c_str(), actionType);
+      action.queued = XbmcThreads::SystemClockMillis();
+      m_actionQueue.push(action);
     }
     break;
 
@@ -708,19 +781,18 @@ void CEventClient::FreePacketQueues()
   while ( ! m_readyPackets.empty() )
   {
     delete m_readyPackets.front();
-    m_readyPackets.pop();
+    m_readyPackets.pop_front();
   }
 
-  std::map<unsigned int, EVENTPACKET::CEventPacket*>::iterator iter = m_seqPackets.begin();
-  while (iter != m_seqPackets.end())
-  {
-    if (iter->second)
-    {
-      delete iter->second;
-    }
-    ++iter;
-  }
+  FreeSequencePackets();
+}
+
+void CEventClient::FreeSequencePackets()
+{
+  for (CEventPacket* packet : m_seqPackets)
+    delete packet;
   m_seqPackets.clear();
+  m_iSeqPacketsReceived = 0;
 }
 
 unsigned int CEventClient::GetButtonCode(std::string& strMapName, bool& isAxis, float& amount, bool &isJoystick)
@@ -749,6 +821,8 @@ unsigned int CEventClient::GetButtonCode(std::string& strMapName, bool& isAxis,
       if ( ! CheckButtonRepeat(m_currentButton.m_iNextRepeat) )
         bcode = 0;
     }
+    if (bcode)
+      AddQueueLatency(m_currentButton.m_iQueued);
     return bcode;
   }
 
@@ -778,6 +852,8 @@ unsigned int CEventClient::GetButtonCode(std::string& strMapName, bool& isAxis,
       /* MUST update m_iNextRepeat before resend */
       bool skip = !it->Axis() && !CheckButtonRepeat(it->m_iNextRepeat);
 
+      if(!skip)
+        AddQueueLatency(it->m_iQueued);
       repeat.push_back(*it);
       if(skip)
       {
@@ -785,6 +861,8 @@ unsigned int CEventClient::GetButtonCode(std::string& strMapName, bool& isAxis,
         continue;
       }
     }
+    else
+      AddQueueLatency(it->m_iQueued);
   }
 
   m_buttonQueue.erase(m_buttonQueue.begin(), it);
@@ -800,11 +878,29 @@ bool CEventClient::GetMousePos(float& x, float& y)
     x = (m_iMouseX / 65535.0f) * CServiceBroker::GetWinSystem()->GetGfxContext().GetWidth();
     y = (m_iMouseY / 65535.0f) * CServiceBroker::GetWinSystem()->GetGfxContext().GetHeight();
     m_bMouseMoved = false;
+    AddQueueLatency(m_iMouseQueued);
     return true;
   }
   return false;
 }
 
+CQueueLatency CEventClient::TakeQueueLatency()
+{
+  CSingleLock lock(m_critSection);
+  CQueueLatency latency = m_queueLatency;
+  m_queueLatency = CQueueLatency();
+  return latency;
+}
+
+void CEventClient::AddQueueLatency(unsigned int &queued)
+{
+  if (queued == 0)
+    return;
+
+  m_queueLatency.Add(XbmcThreads::SystemClockMillis() - queued);
+  queued = 0;
+}
+
 bool CEventClient::CheckButtonRepeat(unsigned int &next)
 {
   unsigned int now = XbmcThreads::SystemClockMillis();
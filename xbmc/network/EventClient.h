@@ -16,30 +16,62 @@
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 
+#include <deque>
 #include <list>
-#include <map>
 #include <queue>
+#include <vector>
 
 namespace EVENTCLIENT
 {
 
   #define ES_FLAG_UNICODE    0x80000000 // new 16bit key flag to support real unicode over EventServer
 
+  // maximum number of packets a message may be split into
+  const unsigned int MAX_SEQUENCE_PACKETS = 65536;
+
+  // time in ms events wait in a client's queues before they are handed out
+  class CQueueLatency
+  {
+  public:
+    void Add(unsigned int latency)
+    {
+      total += latency;
+      count++;
+      if (latency > maximum)
+        maximum = latency;
+    }
+
+    void Add(const CQueueLatency& latency)
+    {
+      total += latency.total;
+      count += latency.count;
+      if (latency.maximum > maximum)
+        maximum = latency.maximum;
+    }
+
+    unsigned long long total = 0;
+    unsigned int       count = 0;
+    unsigned int       maximum = 0;
+  };
+
   class CEventAction
   {
   public:
     CEventAction()
     {
       actionType = 0;
+      queued = 0;
     }
     CEventAction(const char* action, unsigned char type):
       actionName(action)
     {
       actionType = type;
+      queued = 0;
     }
 
     std::string    actionName;
     unsigned char  actionType;
+    unsigned int   queued;
   };
 
   class CEventButtonState
@@ -55,6 +87,7 @@ namespace EVENTCLIENT
       m_bAxis      = false;
       m_iControllerNumber = 0;
       m_iNextRepeat = 0;
+      m_iQueued = 0;
     }
 
     CEventButtonState(unsigned int iKeyCode,
@@ -75,6 +108,7 @@ namespace EVENTCLIENT
       m_bAxis      = isAxis;
       m_iControllerNumber = 0;
       m_iNextRepeat = 0;
+      m_iQueued = 0;
       Load();
     }
 
@@ -103,6 +137,7 @@ namespace EVENTCLIENT
     bool              m_bActive;
     bool              m_bAxis;
     unsigned int      m_iNextRepeat;
+    unsigned int      m_iQueued;
   };
 
 
@@ -135,7 +170,9 @@ namespace EVENTCLIENT
       m_lastSeq = 0;
       m_iRemotePort = 0;
       m_bMouseMoved = false;
+      m_iMouseQueued = 0;
       m_bSequenceError = false;
+      m_iSeqPacketsReceived = 0;
       RefreshSettings();
     }
 
@@ -170,14 +207,16 @@ namespace EVENTCLIENT
     // process the packet queue
     bool ProcessQueue();
 
-    // process the queued up events (packets)
-    void ProcessEvents();
+    // process the queued up events (packets), returns the number of
+    // packets dropped because a later packet superseded them
+    unsigned int ProcessEvents();
 
     // gets the next action in the action queue
     bool GetNextAction(CEventAction& action);
 
     // deallocate all packets in the queues
     void FreePacketQueues();
+    void FreeSequencePackets();
 
     // return event states
     unsigned int GetButtonCode(std::string& strMapName, bool& isAxis, float& amount, bool &isJoystick);
@@ -185,9 +224,18 @@ namespace EVENTCLIENT
     // update mouse position
     bool GetMousePos(float& x, float& y);
 
+    // return and reset the latency of the events handed out so far
+    CQueueLatency TakeQueueLatency();
+
   protected:
     bool ProcessPacket(EVENTPACKET::CEventPacket *packet);
 
+    // drop mouse and axis packets superseded by later ones in the ready queue
+    unsigned int CoalesceReadyPackets();
+
+    // record the latency of an event queued at the given time, once
+    void AddQueueLatency(unsigned int &queued);
+
     // packet handlers
     virtual bool OnPacketHELO(EVENTPACKET::CEventPacket *packet);
     virtual bool OnPacketBYE(EVENTPACKET::CEventPacket *packet);
@@ -237,6 +285,7 @@ namespace EVENTCLIENT
     unsigned int      m_iMouseX;
     unsigned int      m_iMouseY;
     bool              m_bMouseMoved;
+    unsigned int      m_iMouseQueued;
     bool              m_bSequenceError;
 
     SOCKETS::CAddress m_remoteAddr;
@@ -244,13 +293,15 @@ namespace EVENTCLIENT
     EVENTPACKET::LogoType m_eLogoType;
     CCriticalSection  m_critSection;
 
-    std::map <unsigned int, EVENTPACKET::CEventPacket*>  m_seqPackets;
-    std::queue <EVENTPACKET::CEventPacket*> m_readyPackets;
+    std::vector <EVENTPACKET::CEventPacket*> m_seqPackets; // indexed by sequence number - 1
+    unsigned int      m_iSeqPacketsReceived;
+    std::deque <EVENTPACKET::CEventPacket*> m_readyPackets;
 
     // button and mouse state
     std::list<CEventButtonState>  m_buttonQueue;
     std::queue<CEventAction>      m_actionQueue;
     CEventButtonState m_currentButton;
+    CQueueLatency     m_queueLatency;
   };
 
 }
@@ -20,6 +20,7 @@
 #include "input/actions/ActionTranslator.h"
 #include "interfaces/builtins/Builtins.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/SystemInfo.h"
 #include "utils/log.h"
 
@@ -32,6 +33,9 @@ using namespace EVENTPACKET;
 using namespace EVENTCLIENT;
 using namespace SOCKETS;
 
+// maximum number of datagrams received at once
+static const int PACKET_BATCH = 32;
+
 /************************************************************************/
 /* CEventServer                                                         */
 /************************************************************************/
@@ -43,6 +47,8 @@ CEventServer::CEventServer() : CThread("EventServer")
   m_bStop         = false;
   m_bRunning      = false;
   m_bRefreshSettings = false;
+  m_iStatisticsStart = 0;
+  m_iStatisticsPackets = 0;
 
   // default timeout in ms for receiving a single packet
   m_iListenTimeout = 1000;
@@ -128,6 +134,16 @@ int CEventServer::GetNumberOfClients()
   return m_clients.size();
 }
 
+CEventServer::Statistics CEventServer::GetStatistics()
+{
+  CSingleLock lock(m_critSection);
+  Statistics statistics = m_statistics;
+  if (m_queueLatency.count > 0)
+    statistics.averageQueueLatency = static_cast<unsigned int>(m_queueLatency.total / m_queueLatency.count);
+  statistics.maximumQueueLatency = m_queueLatency.maximum;
+  return statistics;
+}
+
 void CEventServer::Process()
 {
   while(!m_bStop)
@@ -141,7 +157,8 @@ void CEventServer::Process()
 void CEventServer::Run()
 {
   CSocketListener listener;
-  int packetSize = 0;
+  CAddress addrs[PACKET_BATCH];
+  int packetSizes[PACKET_BATCH];
 
   CLog::Log(LOGNOTICE, "ES: Starting UDP Event server on port %d", m_iPort);
 
@@ -154,7 +171,7 @@ void CEventServer::Run()
     CLog::Log(LOGERROR, "ES: Could not create socket, aborting!");
     return;
   }
-  m_pPacketBuffer = (unsigned char *)malloc(PACKET_SIZE);
+  m_pPacketBuffer = (unsigned char *)malloc(PACKET_SIZE * PACKET_BATCH);
 
   if (!m_pPacketBuffer)
   {
@@ -187,19 +204,28 @@ void CEventServer::Run()
   // add our socket to the 'select' listener
   listener.AddSocket(m_pSocket);
 
+  {
+    CSingleLock lock(m_critSection);
+    m_statistics = Statistics();
+    m_queueLatency = CQueueLatency();
+    m_iStatisticsStart = XbmcThreads::SystemClockMillis();
+    m_iStatisticsPackets = 0;
+  }
+
   m_bRunning = true;
 
   while (!m_bStop)
   {
+    int packets = 0;
     try
     {
-      // start listening until we timeout
+      // start listening until we timeout, then take everything that has arrived
       if (listener.Listen(m_iListenTimeout))
       {
-        CAddress addr;
-        if ((packetSize = m_pSocket->Read(addr, PACKET_SIZE, (void *)m_pPacketBuffer)) > -1)
+        packets = m_pSocket->ReadBatch(addrs, packetSizes, PACKET_BATCH, PACKET_SIZE, (void *)m_pPacketBuffer);
+        for (int i = 0; i < packets; i++)
         {
-          ProcessPacket(addr, packetSize);
+          ProcessPacket(addrs[i], packetSizes[i], m_pPacketBuffer + i * PACKET_SIZE);
         }
       }
     }
@@ -215,19 +241,25 @@ void CEventServer::Run()
     // refresh client list
     RefreshClients();
 
+    UpdateStatistics(packets);
+
     // broadcast
     // BroadcastBeacon();
   }
 
+  Statistics statistics = GetStatistics();
+  CLog::Log(LOGDEBUG, "ES: Received %llu packets, %llu coalesced, queue latency %u ms average, %u ms maximum",
+            (unsigned long long)statistics.packets, (unsigned long long)statistics.coalesced,
+            statistics.averageQueueLatency, statistics.maximumQueueLatency);
   CLog::Log(LOGNOTICE, "ES: UDP Event server stopped");
   m_bRunning = false;
   Cleanup();
 }
 
-void CEventServer::ProcessPacket(CAddress& addr, int pSize)
+void CEventServer::ProcessPacket(CAddress& addr, int pSize, const unsigned char* packetBuffer)
 {
   // check packet validity
-  CEventPacket* packet = new CEventPacket(pSize, m_pPacketBuffer);
+  CEventPacket* packet = new CEventPacket(pSize, packetBuffer);
   if(packet == NULL)
   {
     CLog::Log(LOGERROR, "ES: Out of memory, cannot accept packet");
@@ -282,6 +314,8 @@ void CEventServer::RefreshClients()
 
   while ( iter != m_clients.end() )
   {
+    m_queueLatency.Add(iter->second->TakeQueueLatency());
+
     if (! (iter->second->Alive()))
     {
       CLog::Log(LOGNOTICE, "ES: Client %s from %s timed out", iter->second->Name().c_str(),
@@ -309,11 +343,30 @@ void CEventServer::ProcessEvents()
 
   while (iter != m_clients.end())
   {
-    iter->second->ProcessEvents();
+    m_statistics.coalesced += iter->second->ProcessEvents();
     ++iter;
   }
 }
 
+void CEventServer::UpdateStatistics(int packets)
+{
+  CSingleLock lock(m_critSection);
+  if (packets > 0)
+  {
+    m_statistics.packets += packets;
+    m_iStatisticsPackets += packets;
+  }
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int elapsed = now - m_iStatisticsStart;
+  if (elapsed >= 1000)
+  {
+    m_statistics.packetsPerSecond = static_cast<unsigned int>(m_iStatisticsPackets * 1000ULL / elapsed);
+    m_iStatisticsStart = now;
+    m_iStatisticsPackets = 0;
+  }
+}
+
 bool CEventServer::ExecuteNextAction()
 {
   CSingleLock lock(m_critSection);
@@ -15,6 +15,7 @@
 #include "threads/Thread.h"
 
 #include <atomic>
+#include <stdint.h>
 #include <map>
 #include <queue>
 #include <vector>
@@ -28,6 +29,15 @@ namespace EVENTSERVER
   class CEventServer : private CThread
   {
   public:
+    struct Statistics
+    {
+      uint64_t     packets = 0;             // datagrams received
+      uint64_t     coalesced = 0;           // packets dropped as later ones superseded them
+      unsigned int packetsPerSecond = 0;
+      unsigned int averageQueueLatency = 0; // ms from receiving an event until it is handed out
+      unsigned int maximumQueueLatency = 0;
+    };
+
     static void RemoveInstance();
     static CEventServer* GetInstance();
     ~CEventServer() override = default;
@@ -55,14 +65,16 @@ namespace EVENTSERVER
     bool ExecuteNextAction();
     bool GetMousePos(float &x, float &y);
     int GetNumberOfClients();
+    Statistics GetStatistics();
 
   protected:
     CEventServer();
     void Cleanup();
     void Run();
-    void ProcessPacket(SOCKETS::CAddress& addr, int packetSize);
+    void ProcessPacket(SOCKETS::CAddress& addr, int packetSize, const unsigned char* packetBuffer);
     void ProcessEvents();
     void RefreshClients();
+    void UpdateStatistics(int packets);
 
     std::map<unsigned long, EVENTCLIENT::CEventClient*>  m_clients;
     static CEventServer* m_pInstance;
@@ -74,6 +86,10 @@ namespace EVENTSERVER
     std::atomic<bool>  m_bRunning;
     CCriticalSection m_critSection;
     bool             m_bRefreshSettings;
+    Statistics       m_statistics;
+    EVENTCLIENT::CQueueLatency m_queueLatency;
+    unsigned int     m_iStatisticsStart;
+    unsigned int     m_iStatisticsPackets;
   };
 
 }
@@ -20,6 +20,20 @@ using namespace SOCKETS;
 #define close closesocket
 #endif
 
+/**********************************************************************/
+/* CUDPSocket                                                         */
+/**********************************************************************/
+
+int CUDPSocket::ReadBatch(CAddress* addrs, int* sizes, const int count,
+                          const int buffersize, void *buffers)
+{
+  if (count < 1)
+    return 0;
+
+  sizes[0] = Read(addrs[0], buffersize, buffers);
+  return sizes[0] < 0 ? -1 : 1;
+}
+
 /**********************************************************************/
 /* CPosixUDPSocket                                                    */
 /**********************************************************************/
@@ -177,6 +191,43 @@ int CPosixUDPSocket::Read(CAddress& addr, const int buffersize, void *buffer)
                        (struct sockaddr*)&addr.saddr, &addr.size);
 }
 
+int CPosixUDPSocket::ReadBatch(CAddress* addrs, int* sizes, const int count,
+                               const int buffersize, void *buffers)
+{
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  if (count < 1)
+    return 0;
+
+  std::vector<mmsghdr> messages(count);
+  std::vector<iovec> vectors(count);
+  for (int i = 0; i < count; i++)
+  {
+    if (m_ipv6Socket)
+      addrs[i].SetAddress("::");
+    vectors[i].iov_base = (char*)buffers + i * buffersize;
+    vectors[i].iov_len = (size_t)buffersize;
+    messages[i].msg_hdr.msg_name = &addrs[i].saddr;
+    messages[i].msg_hdr.msg_namelen = addrs[i].size;
+    messages[i].msg_hdr.msg_iov = &vectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // only the first datagram is waited for, the others are taken if they are already queued
+  int received = recvmmsg(m_iSock, messages.data(), (unsigned int)count, MSG_WAITFORONE, NULL);
+  if (received < 0)
+    return -1;
+
+  for (int i = 0; i < received; i++)
+  {
+    addrs[i].size = messages[i].msg_hdr.msg_namelen;
+    sizes[i] = (int)messages[i].msg_len;
+  }
+  return received;
+#else
+  return CUDPSocket::ReadBatch(addrs, sizes, count, buffersize, buffers);
+#endif
+}
+
 int CPosixUDPSocket::SendTo(const CAddress& addr, const int buffersize,
                           const void *buffer)
 {
@@ -173,6 +173,12 @@ namespace SOCKETS
 
     // read datagrams, return no. of bytes read or -1 or error
     virtual int Read(CAddress& addr, const int buffersize, void *buffer) = 0;
+
+    // read up to count datagrams into consecutive buffers of buffersize bytes,
+    // only waits for the first one, return no. of datagrams read or -1 on error
+    virtual int ReadBatch(CAddress* addrs, int* sizes, const int count,
+                          const int buffersize, void *buffers);
+
     virtual bool Broadcast(const CAddress& addr, const int datasize,
                            const void* data) = 0;
   };
@@ -196,6 +202,8 @@ namespace SOCKETS
     bool Listen(int timeout);
     int SendTo(const CAddress& addr, const int datasize, const void* data) override;
     int Read(CAddress& addr, const int buffersize, void *buffer) override;
+    int ReadBatch(CAddress* addrs, int* sizes, const int count,
+                  const int buffersize, void *buffers) override;
     bool Broadcast(const CAddress& addr, const int datasize, const void* data) override
     {
       //! @todo implement
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SocketSendQueue.h"
+
+#include <errno.h>
+
+#if !defined(TARGET_WINDOWS)
+#include <sys/socket.h>
+#endif
+
+#if defined(MSG_NOSIGNAL)
+// a peer gone away is reported through the result, not by SIGPIPE
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+const size_t CSocketSendQueue::MAX_QUEUED_BYTES;
+
+bool CSocketSendQueue::Send(SOCKET socket, const char *data, size_t size)
+{
+  // a single response may exceed the limit, but nothing is added to a full queue
+  if (GetQueuedBytes() > MAX_QUEUED_BYTES)
+    return false;
+
+  size_t sent = 0;
+  if (IsEmpty())
+  {
+    while (sent < size)
+    {
+      int result = send(socket, data + sent, size - sent, SEND_FLAGS);
+      if (result > 0)
+        sent += result;
+      else if (result < 0 && WouldBlock())
+        break;
+      else
+        return false;
+    }
+  }
+
+  if (sent < size)
+  {
+    if (IsEmpty())
+      Clear();
+    m_buffer.append(data + sent, size - sent);
+  }
+
+  return true;
+}
+
+bool CSocketSendQueue::Flush(SOCKET socket)
+{
+  while (!IsEmpty())
+  {
+    int result = send(socket, m_buffer.data() + m_offset, m_buffer.size() - m_offset, SEND_FLAGS);
+    if (result > 0)
+      m_offset += result;
+    else if (result < 0 && WouldBlock())
+      break;
+    else
+      return false;
+  }
+
+  if (IsEmpty())
+    Clear();
+  else if (m_offset > m_buffer.size() / 2)
+  {
+    // drop the data already sent once it makes up most of the buffer
+    m_buffer.erase(0, m_offset);
+    m_offset = 0;
+  }
+
+  return true;
+}
+
+void CSocketSendQueue::Clear()
+{
+  m_buffer.clear();
+  m_offset = 0;
+}
+
+bool CSocketSendQueue::WouldBlock()
+{
+#if defined(TARGET_WINDOWS)
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
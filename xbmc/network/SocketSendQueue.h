@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "PlatformDefs.h"
+
+/*!
+ \brief Outbound data of a non-blocking socket.
+
+ Data is written to the socket right away as far as the socket takes it, the rest is queued until
+ the socket is writable again. A peer not reading its data can't block the sender this way; once
+ more than MAX_QUEUED_BYTES are waiting, further data is refused and the connection should be closed.
+ The queue is not thread-safe.
+ */
+class CSocketSendQueue
+{
+public:
+  static const size_t MAX_QUEUED_BYTES = 16 * 1024 * 1024;
+
+  /*!
+   \brief Send data, queueing what the socket doesn't take right away
+   \param socket the non-blocking socket.
+   \param data the data.
+   \param size the size of the data.
+   \return false if the socket failed or too much data is queued already, true otherwise.
+   */
+  bool Send(SOCKET socket, const char *data, size_t size);
+
+  /*!
+   \brief Send as much of the queued data as the socket takes
+   \param socket the non-blocking socket.
+   \return false if the socket failed, true otherwise.
+   */
+  bool Flush(SOCKET socket);
+
+  bool IsEmpty() const { return m_offset == m_buffer.size(); }
+  size_t GetQueuedBytes() const { return m_buffer.size() - m_offset; }
+  void Clear();
+
+private:
+  static bool WouldBlock();
+
+  std::string m_buffer;
+  size_t m_offset = 0;
+};
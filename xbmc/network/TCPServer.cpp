@@ -7,16 +7,29 @@
  */
 
 #include "TCPServer.h"
+#include <algorithm>
+#include <utility>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#define HAS_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#if !defined(TARGET_WINDOWS)
+#include <fcntl.h>
+#endif
+
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
@@ -49,6 +62,31 @@ static const bdaddr_t bt_bdaddr_local = {{0, 0, 0, 0xff, 0xff, 0xff}};
 using namespace JSONRPC;
 
 #define RECEIVEBUFFER 1024
+#define MAX_EVENTS    64
+
+#define RESPONSE_PIECE_SIZE (64 * 1024)
+
+namespace
+{
+bool SetNonBlocking(SOCKET socket)
+{
+#ifdef TARGET_WINDOWS
+  u_long nonblocking = 1;
+  return ioctlsocket(socket, FIONBIO, &nonblocking) == 0;
+#else
+  return fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK) == 0;
+#endif
+}
+
+bool WouldBlock()
+{
+#ifdef TARGET_WINDOWS
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+}
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -70,6 +108,11 @@ void CTCPServer::StopServer(bool bWait)
 {
   if (ServerInstance)
   {
+    uint64_t announcements, notifications, bytes;
+    ServerInstance->GetAnnouncementStatistics(announcements, notifications, bytes);
+    CLog::Log(LOGDEBUG, "JSONRPC Server: %" PRIu64 " announcements sent as %" PRIu64 " notifications, %" PRIu64 " bytes",
+              announcements, notifications, bytes);
+
     ServerInstance->StopThread(bWait);
     if (bWait)
     {
@@ -92,6 +135,11 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_connectionsFailed = false;
+  m_announcementCount = 0;
+  m_notificationCount = 0;
+  m_notificationBytes = 0;
+  m_epoll = -1;
 }
 
 void CTCPServer::Process()
@@ -100,111 +148,242 @@ void CTCPServer::Process()
 
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
+    std::vector<SOCKET> readable;
+    std::vector<SOCKET> writable;
+    if (!WaitForEvents(readable, writable))
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
+      Sleep(1000);
+      Initialize();
+      continue;
+    }
 
-    for (auto& it : m_servers)
+    for (SOCKET socket : writable)
     {
-      FD_SET(it, &rfds);
-      if ((intptr_t)it > (intptr_t)max_fd)
-        max_fd = it;
+      const auto it = m_connections.find(socket);
+      if (it != m_connections.end())
+        it->second->Flush();
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    for (SOCKET socket : readable)
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      if (std::find(m_servers.begin(), m_servers.end(), socket) != m_servers.end())
+        AcceptConnection(socket);
+      else
+        ReadConnection(socket);
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    CloseFailedConnections();
+  }
+
+  Deinitialize();
+}
+
+bool CTCPServer::WaitForEvents(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable)
+{
+#ifdef HAS_EPOLL
+  // only the sockets with events are returned, no matter how many clients are connected
+  struct epoll_event events[MAX_EVENTS];
+  int res = epoll_wait(m_epoll, events, MAX_EVENTS, 1000);
+  if (res < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < res; i++)
+  {
+    if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+      readable.push_back(events[i].data.fd);
+    if (events[i].events & EPOLLOUT)
+      writable.push_back(events[i].data.fd);
+  }
+  return true;
+#else
+  SOCKET          max_fd = 0;
+  fd_set          rfds;
+  fd_set          wfds;
+  struct timeval  to     = {1, 0};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (auto& it : m_servers)
+  {
+    FD_SET(it, &rfds);
+    if ((intptr_t)it > (intptr_t)max_fd)
+      max_fd = it;
+  }
+
+  for (auto& it : m_connections)
+  {
+    bool readable, writable;
+    it.second->GetEvents(readable, writable);
+    if (readable)
+      FD_SET(it.first, &rfds);
+    if (writable)
+      FD_SET(it.first, &wfds);
+    if ((intptr_t)it.first > (intptr_t)max_fd)
+      max_fd = it.first;
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+  for (auto& it : m_connections)
+  {
+    if (FD_ISSET(it.first, &wfds))
+      writable.push_back(it.first);
+    if (FD_ISSET(it.first, &rfds))
+      readable.push_back(it.first);
+  }
+
+  for (auto& it : m_servers)
+  {
+    if (FD_ISSET(it, &rfds))
+      readable.push_back(it);
+  }
+  return true;
+#endif
+}
+
+void CTCPServer::WatchSocket(SOCKET socket)
+{
+#ifdef HAS_EPOLL
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = socket;
+  if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, socket, &event) < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch socket: %d", errno);
+#endif
+}
+
+void CTCPServer::WatchSocketEvents(SOCKET socket, bool readable, bool writable)
+{
+#ifdef HAS_EPOLL
+  // epoll_ctl may be called while another thread waits for events, errors and hangups are always reported
+  struct epoll_event event = {};
+  event.events = (readable ? EPOLLIN : 0) | (writable ? EPOLLOUT : 0);
+  event.data.fd = socket;
+  epoll_ctl(m_epoll, EPOLL_CTL_MOD, socket, &event);
+#endif
+}
+
+void CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket =
+      accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+    delete newconnection;
+    if (EBADF == errno)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
     }
-    else if (res > 0)
+    return;
+  }
+
+  if (!SetNonBlocking(newconnection->m_socket))
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to make new connection non-blocking");
+    newconnection->Disconnect();
+    delete newconnection;
+    return;
+  }
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  newconnection->m_server = this;
+  {
+    CSingleLock lock(m_connectionsSection);
+    m_connections[newconnection->m_socket] = newconnection;
+  }
+  WatchSocket(newconnection->m_socket);
+}
+
+void CTCPServer::ReadConnection(SOCKET socket)
+{
+  auto it = m_connections.find(socket);
+  if (it == m_connections.end())
+    return;
+
+  char buffer[RECEIVEBUFFER] = {};
+  int  nread = 0;
+  nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  if (nread < 0 && WouldBlock())
+    return;
+
+  bool close = false;
+  if (nread > 0)
+  {
+    std::string response;
+    if (it->second->IsNew())
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (!response.empty())
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
 
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+      if (!response.empty())
+        it->second->Send(response.c_str(), response.size());
 
-      for (auto& it : m_servers)
+      if (websocket != NULL)
       {
-        if (FD_ISSET(it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket =
-              accept(it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+        // Replace the CTCPClient with a CWebSocketClient
+        CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(it->second));
+        CSingleLock lock(m_connectionsSection);
+        delete it->second;
+        it->second = websocketClient;
       }
     }
+
+    if (response.size() <= 0)
+      it->second->PushBuffer(this, buffer, nread);
+
+    close = it->second->Closing();
+  }
+  else
+    close = true;
+
+  if (close)
+  {
+    CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+    CloseConnection(socket);
   }
+}
 
-  Deinitialize();
+void CTCPServer::CloseConnection(SOCKET socket)
+{
+  CTCPClient *connection = nullptr;
+  {
+    CSingleLock lock(m_connectionsSection);
+    const auto it = m_connections.find(socket);
+    if (it == m_connections.end())
+      return;
+
+    connection = it->second;
+    m_connections.erase(it);
+  }
+
+  connection->Disconnect();
+  delete connection;
+}
+
+void CTCPServer::CloseFailedConnections()
+{
+  if (!m_connectionsFailed.exchange(false))
+    return;
+
+  std::vector<SOCKET> failed;
+  for (auto& it : m_connections)
+  {
+    if (it.second->HasFailed())
+      failed.push_back(it.first);
+  }
+
+  for (SOCKET socket : failed)
+  {
+    CLog::Log(LOGINFO, "JSONRPC Server: Closing connection not taking its data");
+    CloseConnection(socket);
+  }
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -224,20 +403,34 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+  m_announcementCount++;
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  // serialized once, every client gets the same buffer
+  const std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+  std::string websocketFrame;
+
+  // sending never blocks, data a client doesn't take right away is queued for the server thread
+  CSingleLock connectionsLock(m_connectionsSection);
+  for (auto& it : m_connections)
   {
     {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
+      CSingleLock lock (it.second->m_critSection);
+      if ((it.second->GetAnnouncementFlags() & flag) == 0)
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_notificationBytes += it.second->SendAnnouncement(str, websocketFrame);
+    m_notificationCount++;
   }
 }
 
+void CTCPServer::GetAnnouncementStatistics(uint64_t &announcements, uint64_t &notifications, uint64_t &bytes) const
+{
+  announcements = m_announcementCount;
+  notifications = m_notificationCount;
+  bytes = m_notificationBytes;
+}
+
 bool CTCPServer::Initialize()
 {
   Deinitialize();
@@ -247,6 +440,22 @@ bool CTCPServer::Initialize()
   started |= InitializeBlue();
   started |= InitializeTCP();
 
+#ifdef HAS_EPOLL
+  if (started)
+  {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll file descriptor: %d", errno);
+      Deinitialize();
+      return false;
+    }
+
+    for (auto& it : m_servers)
+      WatchSocket(it);
+  }
+#endif
+
   if (started)
   {
     CServiceBroker::GetAnnouncementManager()->AddAnnouncer(this);
@@ -462,19 +671,28 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
-  }
+    CSingleLock lock(m_connectionsSection);
+    for (auto& it : m_connections)
+    {
+      it.second->Disconnect();
+      delete it.second;
+    }
 
-  m_connections.clear();
+    m_connections.clear();
+  }
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
   m_servers.clear();
 
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+    close(m_epoll);
+  m_epoll = -1;
+#endif
+
 #ifdef HAVE_LIBBLUETOOTH
   if (m_sdpd)
     sdp_close((sdp_session_t*)m_sdpd);
@@ -489,6 +707,10 @@ CTCPServer::CTCPClient::CTCPClient()
   m_new = true;
   m_announcementflags = ANNOUNCEMENT::ANNOUNCE_ALL;
   m_socket = INVALID_SOCKET;
+  m_server = nullptr;
+  m_readable = true;
+  m_writable = false;
+  m_failed = false;
   m_beginBrackets = 0;
   m_endBrackets = 0;
   m_beginChar = 0;
@@ -526,12 +748,128 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET)
+    return;
+
+  // nothing may come between the pieces of a response
+  if (!m_responses.empty())
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    if (m_responseWaiting.size() > CSocketSendQueue::MAX_QUEUED_BYTES)
+      SetFailed();
+    else
+      m_responseWaiting.append(data, size);
+    return;
+  }
+
+  if (!m_sendQueue.Send(m_socket, data, size))
+  {
+    SetFailed();
+    return;
+  }
+
+  UpdateEvents();
+}
+
+size_t CTCPServer::CTCPClient::SendAnnouncement(const std::string &json, std::string &websocketFrame)
+{
+  Send(json.c_str(), json.size());
+  return json.size();
+}
+
+void CTCPServer::CTCPClient::SendResponse(CVariant &&response)
+{
+  // a large response is serialized as fast as the client takes it, instead of being held in memory as
+  // a whole. The server thread carries on once the socket is full and continues in Flush().
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET)
+    return;
+
+  m_responses.emplace_back(std::make_shared<CVariant>(std::move(response)));
+  if (m_responses.size() > 1)
+    return;
+
+  SendResponseData();
+  UpdateEvents();
+}
+
+void CTCPServer::CTCPClient::SendResponseData()
+{
+  char piece[RESPONSE_PIECE_SIZE];
+  while (!m_failed && !m_responses.empty() && m_sendQueue.IsEmpty())
+  {
+    if (!m_responseWriter)
+      m_responseWriter = std::make_shared<CJSONVariantStreamWriter>(*m_responses.front(),
+          CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+
+    const size_t size = m_responseWriter->Read(piece, sizeof(piece));
+    if (size > 0)
+    {
+      if (!m_sendQueue.Send(m_socket, piece, size))
+        SetFailed();
+      continue;
+    }
+
+    // the response is sent, followed by what was sent meanwhile
+    m_responseWriter.reset();
+    m_responses.pop_front();
+    if (!m_responseWaiting.empty())
+    {
+      if (!m_sendQueue.Send(m_socket, m_responseWaiting.c_str(), m_responseWaiting.size()))
+        SetFailed();
+      m_responseWaiting.clear();
+    }
+  }
+}
+
+void CTCPServer::CTCPClient::SetFailed()
+{
+  m_failed = true;
+  if (m_server)
+    m_server->m_connectionsFailed = true;
+}
+
+void CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET)
+    return;
+
+  if (!m_sendQueue.Flush(m_socket))
+  {
+    SetFailed();
+    return;
+  }
+
+  SendResponseData();
+  UpdateEvents();
+}
+
+void CTCPServer::CTCPClient::UpdateEvents()
+{
+  // requests aren't read while the client has data to take, so a client sending requests
+  // without reading the responses gets only the requests of a single read answered meanwhile
+  // and neither the responses nor their data pile up
+  const bool writable = !m_sendQueue.IsEmpty();
+  const bool readable = !writable && m_responses.empty();
+  if (m_server && m_socket != INVALID_SOCKET && (readable != m_readable || writable != m_writable))
+    m_server->WatchSocketEvents(m_socket, readable, writable);
+
+  m_readable = readable;
+  m_writable = writable;
+}
+
+void CTCPServer::CTCPClient::GetEvents(bool &readable, bool &writable)
+{
+  CSingleLock lock (m_critSection);
+  readable = m_readable;
+  writable = m_writable;
+}
+
+bool CTCPServer::CTCPClient::HasFailed()
+{
+  CSingleLock lock (m_critSection);
+  return m_failed;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -597,8 +935,9 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
       }
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CVariant response;
+        if (CJSONRPC::MethodCall(m_buffer, host, this, response))
+          SendResponse(std::move(response));
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -611,6 +950,12 @@ void CTCPServer::CTCPClient::Disconnect()
   if (m_socket > 0)
   {
     CSingleLock lock (m_critSection);
+    // last attempt to get queued data out, e.g. a websocket close frame
+    m_sendQueue.Flush(m_socket);
+    m_sendQueue.Clear();
+    m_responseWriter.reset();
+    m_responses.clear();
+    m_responseWaiting.clear();
     shutdown(m_socket, SHUT_RDWR);
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
@@ -623,6 +968,14 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_socket            = client.m_socket;
   m_cliaddr           = client.m_cliaddr;
   m_addrlen           = client.m_addrlen;
+  m_server            = client.m_server;
+  m_failed            = client.m_failed;
+  m_sendQueue         = client.m_sendQueue;
+  m_responses         = client.m_responses;
+  m_responseWriter    = client.m_responseWriter;
+  m_responseWaiting   = client.m_responseWaiting;
+  m_readable          = client.m_readable;
+  m_writable          = client.m_writable;
   m_announcementflags = client.m_announcementflags;
   m_beginBrackets     = client.m_beginBrackets;
   m_endBrackets       = client.m_endBrackets;
@@ -671,6 +1024,32 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
   std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
   for (unsigned int index = 0; index < frames.size(); index++)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+
+  delete msg;
+}
+
+size_t CTCPServer::CWebSocketClient::SendAnnouncement(const std::string &json, std::string &websocketFrame)
+{
+  // server frames aren't masked, so the frame is the same for all clients and protocol versions
+  if (websocketFrame.empty())
+  {
+    CWebSocketFrame frame(WebSocketTextFrame, json.c_str(), json.size());
+    if (!frame.IsValid())
+      return 0;
+
+    websocketFrame.assign(frame.GetFrameData(), static_cast<size_t>(frame.GetFrameLength()));
+  }
+
+  CTCPClient::Send(websocketFrame.c_str(), websocketFrame.size());
+  return websocketFrame.size();
+}
+
+void CTCPServer::CWebSocketClient::SendResponse(CVariant &&response)
+{
+  // the response is sent as a single websocket message
+  std::string str;
+  if (CJSONVariantWriter::Write(response, str, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact))
+    Send(str.c_str(), str.size());
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -11,16 +11,22 @@
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
+#include "network/SocketSendQueue.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "websocket/WebSocket.h"
 
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include <sys/socket.h>
 
 #include "PlatformDefs.h"
 
+class CJSONVariantStreamWriter;
 class CVariant;
 
 namespace JSONRPC
@@ -37,6 +43,11 @@ namespace JSONRPC
     int GetCapabilities() override;
 
     void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override;
+
+    /*!
+     \brief Get the numbers of announcements handled, notifications sent to clients and bytes sent with them
+     */
+    void GetAnnouncementStatistics(uint64_t &announcements, uint64_t &notifications, uint64_t &bytes) const;
   protected:
     void Process() override;
   private:
@@ -46,6 +57,18 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    /*!
+     \brief Wait up to a second for sockets to become readable or writable
+     \return false if waiting failed, true otherwise.
+     */
+    bool WaitForEvents(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable);
+    void WatchSocket(SOCKET socket);
+    void WatchSocketEvents(SOCKET socket, bool readable, bool writable);
+    void AcceptConnection(SOCKET server);
+    void ReadConnection(SOCKET socket);
+    void CloseConnection(SOCKET socket);
+    void CloseFailedConnections();
+
     class CTCPClient : public IClient
     {
     public:
@@ -61,25 +84,70 @@ namespace JSONRPC
       bool SetAnnouncementFlags(int flags) override;
 
       virtual void Send(const char *data, unsigned int size);
+
+      /*!
+       \brief Send an announcement serialized once for all clients
+       \param json the JSON-RPC notification.
+       \param websocketFrame the notification as websocket text frame, built by the first websocket client if empty.
+       \return the number of bytes sent.
+       */
+      virtual size_t SendAnnouncement(const std::string &json, std::string &websocketFrame);
+
+      /*!
+       \brief Send the response to a request, serializing it as the client takes it
+       Responses to further requests and data sent meanwhile, e.g. announcements, wait for the response to be sent.
+       */
+      virtual void SendResponse(CVariant &&response);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
+      /*!
+       \brief Send queued data once the socket is writable again, continuing a response being sent
+       */
+      void Flush();
+      bool HasFailed();
+
+      /*!
+       \brief Get the events the server waits for on the socket
+       \param readable [out] whether further requests are read, not while the client has data to take.
+       \param writable [out] whether data is queued.
+       */
+      void GetEvents(bool &readable, bool &writable);
+
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
       SOCKET m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t m_addrlen;
+      CTCPServer *m_server;
       CCriticalSection m_critSection;
 
     protected:
       void Copy(const CTCPClient& client);
     private:
+      /*!
+       \brief Serialize responses for as long as the socket takes the data right away, m_critSection must be held
+       */
+      void SendResponseData();
+      void SetFailed();
+      /*!
+       \brief Update the events the server waits for after sending, m_critSection must be held
+       */
+      void UpdateEvents();
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      CSocketSendQueue m_sendQueue;
+      std::deque<std::shared_ptr<CVariant>> m_responses; /*!< the response being sent first, followed by those waiting */
+      std::shared_ptr<CJSONVariantStreamWriter> m_responseWriter;
+      std::string m_responseWaiting; /*!< data sent while a response is, e.g. announcements */
+      bool m_readable; /*!< the events the server waits for */
+      bool m_writable;
+      bool m_failed;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -92,6 +160,8 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      size_t SendAnnouncement(const std::string &json, std::string &websocketFrame) override;
+      void SendResponse(CVariant &&response) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
@@ -102,8 +172,14 @@ namespace JSONRPC
       CWebSocket *m_websocket;
     };
 
-    std::vector<CTCPClient*> m_connections;
+    std::map<SOCKET, CTCPClient*> m_connections;
+    CCriticalSection m_connectionsSection; /*!< guards m_connections against announcements, only Process() changes it */
+    std::atomic<bool> m_connectionsFailed;
+    std::atomic<uint64_t> m_announcementCount;
+    std::atomic<uint64_t> m_notificationCount;
+    std::atomic<uint64_t> m_notificationBytes;
     std::vector<SOCKET> m_servers;
+    int m_epoll;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -14,10 +14,14 @@
 #include <utility>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
 #endif
 
+#include "URL.h"
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -30,6 +34,7 @@
 #include "utils/log.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
+#include "utils/SystemInfo.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "XBDateTime.h"
@@ -86,6 +91,61 @@ static MHD_Response* create_response(size_t size, const void* data, int free, in
   return MHD_create_response_from_buffer(size, const_cast<void*>(data), mode);
 }
 
+static MHD_Response* create_file_response(int fd, uint64_t offset, uint64_t length)
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094600)
+  // the response takes ownership of the descriptor
+  MHD_Response* response = MHD_create_response_from_fd_at_offset64(length, fd, offset);
+  if (response == nullptr)
+    close(fd);
+
+  return response;
+#else
+  return nullptr;
+#endif
+}
+
+static MHD_Response* create_file_response(const std::string& filePath, uint64_t offset, uint64_t length)
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094600)
+  // local files are handed to libmicrohttpd as file descriptors so they can be sent with sendfile()
+  const std::string localPath = CSpecialProtocol::TranslatePath(filePath);
+  if (!CURL(localPath).GetProtocol().empty())
+    return nullptr;
+
+  int fd = open(localPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  return create_file_response(fd, offset, length);
+#else
+  return nullptr;
+#endif
+}
+
+// checks the comma separated entity tags of an If-Match or If-None-Match header
+static bool matches_etag(const std::string& header, const std::string& eTag, bool weak)
+{
+  for (auto tag : StringUtils::Split(header, ","))
+  {
+    StringUtils::Trim(tag);
+    if (tag == "*")
+      return true;
+
+    if (StringUtils::StartsWith(tag, "W/"))
+    {
+      if (!weak)
+        continue;
+      tag.erase(0, 2);
+    }
+
+    if (tag == eTag)
+      return true;
+  }
+
+  return false;
+}
+
 int CWebServer::AskForAuthentication(const HTTPRequest& request) const
 {
   struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -192,8 +252,37 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
         {
           bool cacheable = IsRequestCacheable(request);
 
+          std::string eTag;
+          if (!handler->GetETag(eTag))
+            eTag.clear();
+
+          // If-None-Match and If-Match take precedence over If-Modified-Since and If-Unmodified-Since
+          bool checkModifiedSince = true;
+          bool checkUnmodifiedSince = true;
+          bool notModified = false;
+          if (!eTag.empty())
+          {
+            std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+            std::string ifMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_MATCH);
+
+            // handle If-Match
+            if (!ifMatch.empty())
+            {
+              if (!matches_etag(ifMatch, eTag, false))
+                return SendErrorResponse(request, MHD_HTTP_PRECONDITION_FAILED, request.method);
+              checkUnmodifiedSince = false;
+            }
+
+            // handle If-None-Match (but only if the response is cacheable)
+            if (!ifNoneMatch.empty())
+            {
+              notModified = cacheable && matches_etag(ifNoneMatch, eTag, true);
+              checkModifiedSince = false;
+            }
+          }
+
           CDateTime lastModified;
-          if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
+          if (!notModified && handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
           {
             // handle If-Modified-Since or If-Unmodified-Since
             std::string ifModifiedSince = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_MODIFIED_SINCE);
@@ -202,27 +291,31 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
             CDateTime ifModifiedSinceDate;
             CDateTime ifUnmodifiedSinceDate;
             // handle If-Modified-Since (but only if the response is cacheable)
-            if (cacheable &&
+            if (checkModifiedSince && cacheable &&
               ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince) &&
               lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
-            {
-              struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
-              if (response == nullptr)
-              {
-                CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP 304 response", m_port);
-                return MHD_NO;
-              }
-
-              return FinalizeRequest(handler, MHD_HTTP_NOT_MODIFIED, response);
-            }
+              notModified = true;
             // handle If-Unmodified-Since
-            else if (ifUnmodifiedSinceDate.SetFromRFC1123DateTime(ifUnmodifiedSince) &&
+            else if (checkUnmodifiedSince &&
+              ifUnmodifiedSinceDate.SetFromRFC1123DateTime(ifUnmodifiedSince) &&
               lastModified.GetAsUTCDateTime() > ifUnmodifiedSinceDate)
               return SendErrorResponse(request, MHD_HTTP_PRECONDITION_FAILED, request.method);
           }
 
+          if (notModified)
+          {
+            struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
+            if (response == nullptr)
+            {
+              CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP 304 response", m_port);
+              return MHD_NO;
+            }
+
+            return FinalizeRequest(handler, MHD_HTTP_NOT_MODIFIED, response);
+          }
+
           // pass the requested ranges on to the request handler
-          handler->SetRequestRanged(IsRequestRanged(request, lastModified));
+          handler->SetRequestRanged(IsRequestRanged(request, lastModified, eTag));
         }
       }
       // if we got a POST request we need to take care of the POST data
@@ -323,6 +416,10 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       ret = CreateFileDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPMemoryDownloadNoFreeNoCopy:
     case HTTPMemoryDownloadNoFreeCopy:
     case HTTPMemoryDownloadFreeNoCopy:
@@ -365,6 +462,11 @@ int CWebServer::FinalizeRequest(const std::shared_ptr<IHTTPRequestHandler>& hand
   if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
     handler->AddResponseHeader(MHD_HTTP_HEADER_LAST_MODIFIED, lastModified.GetAsRFC1123DateTime());
 
+  // if the request handler has set an entity tag and it hasn't been set as a header, add it
+  std::string eTag;
+  if (handler->CanBeCached() && handler->GetETag(eTag) && !eTag.empty())
+    handler->AddResponseHeader(MHD_HTTP_HEADER_ETAG, eTag);
+
   // check if the request handler has set Cache-Control and add it if not
   if (!handler->HasResponseHeader(MHD_HTTP_HEADER_CACHE_CONTROL))
   {
@@ -457,17 +559,23 @@ bool CWebServer::IsRequestCacheable(const HTTPRequest& request) const
   return true;
 }
 
-bool CWebServer::IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified) const
+bool CWebServer::IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified, const std::string &eTag) const
 {
   // parse the Range header and store it in the request object
   CHttpRanges ranges;
   bool ranged = ranges.Parse(HTTPRequestHandlerUtils::GetRequestHeaderValue(request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_RANGE));
 
   // handle If-Range header but only if the Range header is present
-  if (ranged && lastModified.IsValid())
+  if (ranged)
   {
     std::string ifRange = HTTPRequestHandlerUtils::GetRequestHeaderValue(request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_RANGE);
-    if (!ifRange.empty() && lastModified.IsValid())
+    // If-Range contains either an entity tag which must match exactly or a date
+    if (StringUtils::StartsWith(ifRange, "\"") || StringUtils::StartsWith(ifRange, "W/"))
+    {
+      if (eTag.empty() || ifRange != eTag)
+        ranges.Clear();
+    }
+    else if (!ifRange.empty() && lastModified.IsValid())
     {
       CDateTime ifRangeDate;
       ifRangeDate.SetFromRFC1123DateTime(ifRange);
@@ -722,6 +830,11 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   const HTTPResponseDetails &responseDetails = handler->GetResponseDetails();
   HttpResponseRanges responseRanges = handler->GetResponseData();
 
+  // a file opened by the handler is sent from its descriptor, even if it has been removed in the meantime
+  const int fd = handler->TakeResponseFileDescriptor();
+  if (fd >= 0)
+    return CreateFileDescriptorDownloadResponse(handler, fd, response);
+
   std::shared_ptr<XFILE::CFile> file = std::make_shared<XFILE::CFile>();
   std::string filePath = handler->GetResponseFile();
 
@@ -814,18 +927,25 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
     // set the initial write position
     context->ranges.GetFirstPosition(context->writePosition);
 
-    // create the response object
-    response = MHD_create_response_from_callback(totalLength, 2048,
-                                                  &CWebServer::ContentReaderCallback,
-                                                  context.get(),
-                                                  &CWebServer::ContentReaderFreeCallback);
+    // a single range of a local file doesn't need to be copied through a buffer
+    if (context->rangeCountTotal == 1)
+      response = create_file_response(filePath, context->writePosition, totalLength);
+
+    // otherwise create the response object filled by ContentReaderCallback
     if (response == nullptr)
     {
-      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
-      return MHD_NO;
-    }
+      response = MHD_create_response_from_callback(totalLength, 2048,
+                                                    &CWebServer::ContentReaderCallback,
+                                                    context.get(),
+                                                    &CWebServer::ContentReaderFreeCallback);
+      if (response == nullptr)
+      {
+        CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+        return MHD_NO;
+      }
 
-    context.release(); // ownership was passed to mhd
+      context.release(); // ownership was passed to mhd
+    }
 
     // add Content-Range header
     if (ranged)
@@ -850,6 +970,127 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   return MHD_YES;
 }
 
+int CWebServer::CreateFileDescriptorDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, int fd, struct MHD_Response *&response) const
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094600)
+  const HTTPRequest &request = handler->GetRequest();
+  const HTTPResponseDetails &responseDetails = handler->GetResponseDetails();
+  const std::string filePath = handler->GetResponseFile();
+
+  struct __stat64 statBuffer;
+  if (fstat64(fd, &statBuffer) != 0)
+  {
+    CLog::Log(LOGERROR, "CWebServer[%hu]: Failed to get the size of %s", m_port, filePath.c_str());
+    close(fd);
+    return SendErrorResponse(request, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
+  }
+  const uint64_t fileLength = static_cast<uint64_t>(statBuffer.st_size);
+
+  // get the MIME type for the Content-Type header
+  std::string mimeType = responseDetails.contentType;
+  if (mimeType.empty())
+  {
+    std::string ext = URIUtils::GetExtension(filePath);
+    StringUtils::ToLower(ext);
+    mimeType = CreateMimeTypeFromExtension(ext.c_str());
+  }
+
+  if (request.method != HEAD)
+  {
+    CHttpRanges ranges;
+    if (handler->IsRequestRanged())
+    {
+      if (!request.ranges.IsEmpty())
+        ranges = request.ranges;
+      else
+        HTTPRequestHandlerUtils::GetRequestedRanges(request.connection, fileLength, ranges);
+    }
+
+    // a single range is sent from the descriptor as well, the whole file is sent instead of multiple ranges
+    uint64_t firstPosition = 0;
+    uint64_t lastPosition = fileLength - 1;
+    const bool ranged = ranges.Size() == 1;
+    if (ranged)
+    {
+      ranges.GetFirstPosition(firstPosition);
+      ranges.GetLastPosition(lastPosition);
+    }
+
+    response = create_file_response(fd, firstPosition, fileLength > 0 ? lastPosition - firstPosition + 1 : 0);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+      return MHD_NO;
+    }
+
+    if (ranged)
+    {
+      handler->SetResponseStatus(MHD_HTTP_PARTIAL_CONTENT);
+      handler->AddResponseHeader(MHD_HTTP_HEADER_CONTENT_RANGE, HttpRangeUtils::GenerateContentRangeHeaderValue(firstPosition, lastPosition, fileLength));
+    }
+  }
+  else
+  {
+    close(fd);
+    response = create_response(0, nullptr, MHD_NO, MHD_NO);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP HEAD response for %s", m_port, request.pathUrl.c_str());
+      return MHD_NO;
+    }
+
+    handler->AddResponseHeader(MHD_HTTP_HEADER_CONTENT_LENGTH, StringUtils::Format("%" PRIu64, fileLength));
+  }
+
+  // set the Content-Type header
+  if (!mimeType.empty())
+    handler->AddResponseHeader(MHD_HTTP_HEADER_CONTENT_TYPE, mimeType);
+
+  return MHD_YES;
+#else
+  // without descriptor responses the file is opened again
+#if defined(TARGET_POSIX)
+  close(fd);
+#endif
+  return CreateFileDownloadResponse(handler, response);
+#endif
+}
+
+int CWebServer::CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+  if (request.method == HEAD)
+  {
+    response = create_response(0, nullptr, MHD_NO, MHD_NO);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP HEAD response for %s", m_port, request.pathUrl.c_str());
+      return MHD_NO;
+    }
+
+    return MHD_YES;
+  }
+
+  // the handler fills the response as MHD sends it, so it has to live as long as the response
+  std::unique_ptr<std::shared_ptr<IHTTPRequestHandler>> context(new std::shared_ptr<IHTTPRequestHandler>(handler));
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 32 * 1024,
+                                                &CWebServer::StreamReaderCallback,
+                                                context.get(),
+                                                &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled by its handler", m_port, request.pathUrl.c_str());
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+
+  return MHD_YES;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const
 {
   size_t payloadSize = 0;
@@ -1034,6 +1275,27 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
   CLog::Log(LOGDEBUG, LOGWEBSERVER, "CWebServer [OUT] done");
 }
 
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+{
+  std::shared_ptr<IHTTPRequestHandler> *handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  if (handler == nullptr || *handler == nullptr)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+
+  size_t written = (*handler)->ReadResponseData(buf, max);
+  if (written == 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  CLog::Log(LOGDEBUG, LOGWEBSERVER, "CWebServer [OUT] wrote %zu bytes from %" PRIu64, written, pos);
+  return static_cast<ssize_t>(written);
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  delete static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+
+  CLog::Log(LOGDEBUG, LOGWEBSERVER, "CWebServer [OUT] done");
+}
+
 // local helper
 static void panicHandlerForMHD(void* unused, const char* file, unsigned int line, const char *reason)
 {
@@ -1106,18 +1368,45 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 
   MHD_set_panic_func(&panicHandlerForMHD, nullptr);
 
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  unsigned int threadPoolSize = 0;
+  if (advancedSettings->m_webserverThreadPool)
+  {
+    // a fixed number of threads polling all connections (with epoll where available)
+    threadPoolSize = advancedSettings->m_webserverThreadPoolSize;
+    if (threadPoolSize == 0)
+      threadPoolSize = std::max(4, 2 * CSysInfo::GetCPUCount());
+
+    flags |=
+#if (MHD_VERSION >= 0x00095207)
+      MHD_USE_INTERNAL_POLLING_THREAD | MHD_USE_AUTO;
+#else
+      MHD_USE_SELECT_INTERNALLY;
+#endif
+  }
+  else
+  {
+    // one thread per connection
+    // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
+    // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
+    flags |= MHD_USE_THREAD_PER_CONNECTION
+#if (MHD_VERSION >= 0x00095207)
+      | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
+#endif
+      ;
+  }
+
+  // the pool size must only be passed when using a pool
+  MHD_OptionItem threadPoolOptions[] = {
+    { threadPoolSize > 0 ? MHD_OPTION_THREAD_POOL_SIZE : MHD_OPTION_END, static_cast<intptr_t>(threadPoolSize), nullptr },
+    { MHD_OPTION_END, 0, nullptr }
+  };
+
   if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_SERVICES_WEBSERVERSSL) &&
       MHD_is_feature_supported(MHD_FEATURE_SSL) == MHD_YES &&
       LoadCert(m_key, m_cert))
     // SSL enabled
-    return MHD_start_daemon(flags |
-                          // one thread per connection
-                          // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-                          // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-                          MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-                          | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
+    return MHD_start_daemon(flags
                           | MHD_USE_DEBUG /* Print MHD error messages to log */
                           | MHD_USE_SSL
                           ,
@@ -1132,20 +1421,14 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
                           MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0,
                           MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize,
+                          MHD_OPTION_ARRAY, threadPoolOptions,
                           MHD_OPTION_HTTPS_MEM_KEY, m_key.c_str(),
                           MHD_OPTION_HTTPS_MEM_CERT, m_cert.c_str(),
                           MHD_OPTION_HTTPS_PRIORITIES, ciphers,
                           MHD_OPTION_END);
 
   // No SSL
-  return MHD_start_daemon(flags |
-                          // one thread per connection
-                          // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-                          // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-                          MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-                          | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
+  return MHD_start_daemon(flags
                           | MHD_USE_DEBUG /* Print MHD error messages to log */
                           ,
                           port,
@@ -1159,6 +1442,7 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
                           MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0,
                           MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize,
+                          MHD_OPTION_ARRAY, threadPoolOptions,
                           MHD_OPTION_END);
 }
 
@@ -12,16 +12,20 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+#include <inttypes.h>
+
 CHTTPFileHandler::CHTTPFileHandler()
   : IHTTPRequestHandler(),
     m_url(),
-    m_lastModified()
+    m_lastModified(),
+    m_eTag()
 { }
 
 CHTTPFileHandler::CHTTPFileHandler(const HTTPRequest &request)
   : IHTTPRequestHandler(request),
     m_url(),
-    m_lastModified()
+    m_lastModified(),
+    m_eTag()
 { }
 
 int CHTTPFileHandler::HandleRequest()
@@ -38,6 +42,15 @@ bool CHTTPFileHandler::GetLastModifiedDate(CDateTime &lastModified) const
   return true;
 }
 
+bool CHTTPFileHandler::GetETag(std::string &eTag) const
+{
+  if (m_eTag.empty())
+    return false;
+
+  eTag = m_eTag;
+  return true;
+}
+
 void CHTTPFileHandler::SetFile(const std::string& file, int responseStatus)
 {
   m_url = file;
@@ -99,4 +112,7 @@ void CHTTPFileHandler::SetLastModifiedDate(const struct __stat64 *statBuffer)
 #endif
   if (time != NULL)
     m_lastModified = *time;
+
+  // the entity tag changes whenever the file is modified or changes its size
+  m_eTag = StringUtils::Format("\"%" PRIx64 "-%" PRIx64 "\"", static_cast<uint64_t>(statBuffer->st_mtime), static_cast<uint64_t>(statBuffer->st_size));
 }
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "HTTPImageTransformationCache.h"
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#if defined(TARGET_POSIX)
+#include <fcntl.h>
+#endif
+
+using KODI::UTILITY::CDigest;
+
+CHTTPImageTransformationCache::CHTTPImageTransformationCache(const std::string &path, uint64_t maximumSize)
+  : m_path(path),
+    m_maximumSize(maximumSize)
+{ }
+
+CHTTPImageTransformationCache::~CHTTPImageTransformationCache()
+{
+  Clear();
+}
+
+bool CHTTPImageTransformationCache::Get(const std::string &key, XFILE::CFile &file)
+{
+  CSingleLock lock(m_critical);
+
+  auto image = m_images.find(key);
+  if (image == m_images.end())
+    return false;
+
+  // opened while holding the lock so that a concurrent Add() can't remove the file in between
+  if (!file.Open(image->second.file))
+    return false;
+
+  m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed, image->second.recentlyUsed);
+  return true;
+}
+
+int CHTTPImageTransformationCache::Open(const std::string &key, std::string &file)
+{
+#if defined(TARGET_POSIX)
+  CSingleLock lock(m_critical);
+
+  auto image = m_images.find(key);
+  if (image == m_images.end())
+    return -1;
+
+  // opened while holding the lock so that a concurrent Add() can't remove the file in between
+  const int fd = open(image->second.file.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed, image->second.recentlyUsed);
+  file = image->second.file;
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+bool CHTTPImageTransformationCache::Add(const std::string &key, const uint8_t *data, size_t size, std::string &file)
+{
+  if (key.empty() || data == nullptr || size == 0 || size > m_maximumSize)
+    return false;
+
+  CSingleLock lock(m_critical);
+
+  // another request might have transformed the same image in the meantime
+  auto image = m_images.find(key);
+  if (image != m_images.end())
+  {
+    file = image->second.file;
+    return true;
+  }
+
+  // get rid of images left behind by a previous run
+  if (!m_created)
+  {
+    XFILE::CDirectory::RemoveRecursive(m_path);
+    if (!XFILE::CDirectory::Create(m_path))
+    {
+      CLog::Log(LOGERROR, "CHTTPImageTransformationCache: failed to create %s", m_path.c_str());
+      return false;
+    }
+    m_created = true;
+  }
+
+  removePending();
+
+  // the file is sent directly from the local filesystem, a previous file of the same image may still be open
+  const std::string fileName = StringUtils::Format("%s-%u", CDigest::Calculate(CDigest::Type::MD5, key).c_str(), m_nextFile++);
+  const std::string cachedFile = CSpecialProtocol::TranslatePath(URIUtils::AddFileToFolder(m_path, fileName));
+  XFILE::CFile fileObj;
+  if (!fileObj.OpenForWrite(cachedFile, true))
+    return false;
+
+  bool written = fileObj.Write(data, size) == static_cast<ssize_t>(size);
+  fileObj.Close();
+  if (!written)
+  {
+    XFILE::CFile::Delete(cachedFile);
+    return false;
+  }
+
+  m_recentlyUsed.push_front(key);
+  m_images[key] = { cachedFile, size, m_recentlyUsed.begin() };
+  m_size += size;
+
+  while (m_size > m_maximumSize)
+    removeLeastRecentlyUsed();
+
+  file = cachedFile;
+  return true;
+}
+
+void CHTTPImageTransformationCache::Clear()
+{
+  CSingleLock lock(m_critical);
+
+  while (!m_recentlyUsed.empty())
+    removeLeastRecentlyUsed();
+  removePending();
+}
+
+void CHTTPImageTransformationCache::removeLeastRecentlyUsed()
+{
+  auto image = m_images.find(m_recentlyUsed.back());
+  m_recentlyUsed.pop_back();
+  if (image == m_images.end())
+    return;
+
+  // images which have been looked up may be open, they can still be read where they can be removed
+  if (!XFILE::CFile::Delete(image->second.file))
+    m_pendingRemoval.push_back(image->second.file);
+  m_size -= image->second.size;
+  m_images.erase(image);
+}
+
+void CHTTPImageTransformationCache::removePending()
+{
+  auto file = m_pendingRemoval.begin();
+  while (file != m_pendingRemoval.end())
+  {
+    if (XFILE::CFile::Delete(*file) || !XFILE::CFile::Exists(*file))
+      file = m_pendingRemoval.erase(file);
+    else
+      ++file;
+  }
+}
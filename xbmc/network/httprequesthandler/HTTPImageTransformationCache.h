@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+namespace XFILE
+{
+class CFile;
+}
+
+#include <list>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ \brief Cache of the images transformed by CHTTPImageTransformationHandler.
+
+ The transformed images are stored as files so that they can be sent like any
+ other file. Once the cache grows beyond its maximum size the least recently
+ used images are removed. Where open files can't be removed, their removal is
+ retried later.
+ */
+class CHTTPImageTransformationCache
+{
+public:
+  explicit CHTTPImageTransformationCache(const std::string &path = "special://temp/webserver/", uint64_t maximumSize = 64 * 1024 * 1024);
+  ~CHTTPImageTransformationCache();
+
+  /*!
+   \brief Looks up a transformed image and opens it.
+   \details The image is opened before it can be removed to make room for other images, so it can be read
+   even if that happens before it is sent.
+   \param key Key identifying the source image and its transformation
+   \param file Opened cached image
+   \return True if the image is cached and could be opened, otherwise false.
+   */
+  bool Get(const std::string &key, XFILE::CFile &file);
+
+  /*!
+   \brief Looks up a transformed image and opens it to be sent from its file descriptor.
+   \details Like Get() the image is opened before it can be removed. This is only supported on POSIX
+   systems, elsewhere the image has to be read with Get().
+   \param key Key identifying the source image and its transformation
+   \param file Path of the cached image
+   \return Descriptor of the opened image, to be closed by the caller, or -1 if it isn't cached or couldn't be opened.
+   */
+  int Open(const std::string &key, std::string &file);
+
+  /*!
+   \brief Stores a transformed image.
+   \param key Key identifying the source image and its transformation
+   \param data Transformed image
+   \param size Size of the transformed image
+   \param file Path of the cached image
+   \return True if the image has been stored, otherwise false.
+   */
+  bool Add(const std::string &key, const uint8_t *data, size_t size, std::string &file);
+
+  /*!
+   \brief Removes all cached images.
+   */
+  void Clear();
+
+private:
+  struct CachedImage
+  {
+    std::string file;
+    uint64_t size;
+    std::list<std::string>::iterator recentlyUsed;
+  };
+
+  void removeLeastRecentlyUsed();
+  void removePending();
+
+  CCriticalSection m_critical;
+  std::string m_path;
+  uint64_t m_maximumSize;
+  uint64_t m_size = 0;
+  bool m_created = false;
+  std::unordered_map<std::string, CachedImage> m_images;
+  std::list<std::string> m_recentlyUsed; //!< keys, most recently used first
+  std::vector<std::string> m_pendingRemoval; //!< files of removed images which were still open
+  unsigned int m_nextFile = 0;
+};
@@ -10,15 +10,22 @@
 
 #include "TextureCacheJob.h"
 #include "URL.h"
+#include "filesystem/File.h"
 #include "filesystem/ImageFile.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "utils/Digest.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+#include <inttypes.h>
 #include <map>
 
+#if defined(TARGET_POSIX)
+#include <unistd.h>
+#endif
+
 #define TRANSFORMATION_OPTION_WIDTH             "width"
 #define TRANSFORMATION_OPTION_HEIGHT            "height"
 #define TRANSFORMATION_OPTION_SCALING_ALGORITHM "scaling_algorithm"
@@ -27,15 +34,19 @@ static const std::string ImageBasePath = "/image/";
 
 CHTTPImageTransformationHandler::CHTTPImageTransformationHandler()
   : m_url(),
+    m_imagePath(),
     m_lastModified(),
+    m_cache(std::make_shared<CHTTPImageTransformationCache>()),
     m_buffer(NULL),
     m_responseData()
 { }
 
-CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPRequest &request)
+CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPRequest &request, const std::shared_ptr<CHTTPImageTransformationCache> &cache)
   : IHTTPRequestHandler(request),
     m_url(),
+    m_imagePath(),
     m_lastModified(),
+    m_cache(cache),
     m_buffer(NULL),
     m_responseData()
 {
@@ -59,6 +70,30 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
   m_response.type = HTTPMemoryDownloadNoFreeCopy;
   m_response.status = MHD_HTTP_OK;
 
+  // get the transformation options
+  std::map<std::string, std::string> options;
+  HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
+
+  std::vector<std::string> urlOptions;
+  std::map<std::string, std::string>::const_iterator option = options.find(TRANSFORMATION_OPTION_WIDTH);
+  if (option != options.end())
+    urlOptions.push_back(TRANSFORMATION_OPTION_WIDTH "=" + option->second);
+
+  option = options.find(TRANSFORMATION_OPTION_HEIGHT);
+  if (option != options.end())
+    urlOptions.push_back(TRANSFORMATION_OPTION_HEIGHT "=" + option->second);
+
+  option = options.find(TRANSFORMATION_OPTION_SCALING_ALGORITHM);
+  if (option != options.end())
+    urlOptions.push_back(TRANSFORMATION_OPTION_SCALING_ALGORITHM "=" + option->second);
+
+  m_imagePath = m_url;
+  if (!urlOptions.empty())
+  {
+    m_imagePath += "?";
+    m_imagePath += StringUtils::Join(urlOptions, "&");
+  }
+
   // determine the content type
   std::string ext = URIUtils::GetExtension(pathToUrl.GetHostName());
   StringUtils::ToLower(ext);
@@ -66,9 +101,10 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
 
   //! @todo determine the maximum age
 
-  // determine the last modified date
+  // determine the last modified date (of the original image if it hasn't been cached yet)
   struct __stat64 statBuffer;
-  if (imageFile.Stat(pathToUrl, &statBuffer) != 0)
+  if (imageFile.Stat(pathToUrl, &statBuffer) != 0 &&
+      XFILE::CFile::Stat(pathToUrl.GetHostName(), &statBuffer) != 0)
     return;
 
   struct tm *time;
@@ -82,13 +118,23 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
     return;
 
   m_lastModified = *time;
+
+  // the same transformation of the same version of an image always results in the same data
+  m_cacheKey = StringUtils::Format("%s|%" PRIu64 "|%" PRIu64, m_imagePath.c_str(),
+                                   static_cast<uint64_t>(statBuffer.st_mtime), static_cast<uint64_t>(statBuffer.st_size));
+  m_eTag = "\"" + KODI::UTILITY::CDigest::Calculate(KODI::UTILITY::CDigest::Type::MD5, m_cacheKey) + "\"";
 }
 
 CHTTPImageTransformationHandler::~CHTTPImageTransformationHandler()
 {
   m_responseData.clear();
-  delete m_buffer;
+  delete[] m_buffer;
   m_buffer = NULL;
+
+#if defined(TARGET_POSIX)
+  if (m_responseFileDescriptor >= 0)
+    close(m_responseFileDescriptor);
+#endif
 }
 
 bool CHTTPImageTransformationHandler::CanHandleRequest(const HTTPRequest &request) const
@@ -119,38 +165,59 @@ int CHTTPImageTransformationHandler::HandleRequest()
     return MHD_YES;
   }
 
-  // get the transformation options
-  std::map<std::string, std::string> options;
-  HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
-
-  std::vector<std::string> urlOptions;
-  std::map<std::string, std::string>::const_iterator option = options.find(TRANSFORMATION_OPTION_WIDTH);
-  if (option != options.end())
-    urlOptions.push_back(TRANSFORMATION_OPTION_WIDTH "=" + option->second);
-
-  option = options.find(TRANSFORMATION_OPTION_HEIGHT);
-  if (option != options.end())
-    urlOptions.push_back(TRANSFORMATION_OPTION_HEIGHT "=" + option->second);
-
-  option = options.find(TRANSFORMATION_OPTION_SCALING_ALGORITHM);
-  if (option != options.end())
-    urlOptions.push_back(TRANSFORMATION_OPTION_SCALING_ALGORITHM "=" + option->second);
-
-  std::string imagePath = m_url;
-  if (!urlOptions.empty())
+  // send the previously transformed image straight from the cache where possible
+  if (!m_cacheKey.empty())
   {
-    imagePath += "?";
-    imagePath += StringUtils::Join(urlOptions, "&");
+    m_responseFileDescriptor = m_cache->Open(m_cacheKey, m_responseFile);
+    if (m_responseFileDescriptor >= 0)
+    {
+      m_response.type = HTTPFileDownload;
+      return MHD_YES;
+    }
   }
 
-  // resize the image into the local buffer
-  size_t bufferSize;
-  if (!CTextureCacheJob::ResizeTexture(imagePath, m_buffer, bufferSize))
+  // otherwise read it from the cache
+  size_t bufferSize = 0;
+  XFILE::CFile cachedFile;
+  if (!m_cacheKey.empty() && m_cache->Get(m_cacheKey, cachedFile))
   {
-    m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
-    m_response.type = HTTPError;
+    const int64_t length = cachedFile.GetLength();
+    if (length > 0)
+    {
+      m_buffer = new uint8_t[static_cast<size_t>(length)];
+      while (bufferSize < static_cast<size_t>(length))
+      {
+        const ssize_t read = cachedFile.Read(m_buffer + bufferSize, static_cast<size_t>(length) - bufferSize);
+        if (read <= 0)
+          break;
+        bufferSize += read;
+      }
+    }
+    cachedFile.Close();
+
+    if (bufferSize != static_cast<size_t>(length))
+    {
+      delete[] m_buffer;
+      m_buffer = NULL;
+      bufferSize = 0;
+    }
+  }
 
-    return MHD_YES;
+  // resize the image into the local buffer unless it has been read from the cache
+  if (bufferSize == 0)
+  {
+    if (!CTextureCacheJob::ResizeTexture(m_imagePath, m_buffer, bufferSize))
+    {
+      m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
+      m_response.type = HTTPError;
+
+      return MHD_YES;
+    }
+
+    // remember the transformed image for subsequent requests
+    std::string cachedPath;
+    if (!m_cacheKey.empty())
+      m_cache->Add(m_cacheKey, m_buffer, bufferSize, cachedPath);
   }
 
   // store the size of the image
@@ -169,6 +236,13 @@ int CHTTPImageTransformationHandler::HandleRequest()
   return MHD_YES;
 }
 
+int CHTTPImageTransformationHandler::TakeResponseFileDescriptor()
+{
+  const int fd = m_responseFileDescriptor;
+  m_responseFileDescriptor = -1;
+  return fd;
+}
+
 bool CHTTPImageTransformationHandler::GetLastModifiedDate(CDateTime &lastModified) const
 {
   if (!m_lastModified.IsValid())
@@ -177,3 +251,12 @@ bool CHTTPImageTransformationHandler::GetLastModifiedDate(CDateTime &lastModifie
   lastModified = m_lastModified;
   return true;
 }
+
+bool CHTTPImageTransformationHandler::GetETag(std::string &eTag) const
+{
+  if (m_eTag.empty())
+    return false;
+
+  eTag = m_eTag;
+  return true;
+}
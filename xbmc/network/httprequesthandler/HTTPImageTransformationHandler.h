@@ -9,8 +9,10 @@
 #pragma once
 
 #include "XBDateTime.h"
+#include "network/httprequesthandler/HTTPImageTransformationCache.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -20,7 +22,7 @@ public:
   CHTTPImageTransformationHandler();
   ~CHTTPImageTransformationHandler() override;
 
-  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPImageTransformationHandler(request); }
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPImageTransformationHandler(request, m_cache); }
   bool CanHandleRequest(const HTTPRequest &request)const  override;
 
   int HandleRequest() override;
@@ -28,19 +30,32 @@ public:
   bool CanHandleRanges() const override { return true; }
   bool CanBeCached() const override { return true; }
   bool GetLastModifiedDate(CDateTime &lastModified) const override;
+  bool GetETag(std::string &eTag) const override;
 
   HttpResponseRanges GetResponseData() const override { return m_responseData; }
+  std::string GetResponseFile() const override { return m_responseFile; }
+  int TakeResponseFileDescriptor() override;
 
   // priority must be higher than the one of CHTTPImageHandler
   int GetPriority() const override { return 6; }
 
 protected:
-  explicit CHTTPImageTransformationHandler(const HTTPRequest &request);
+  CHTTPImageTransformationHandler(const HTTPRequest &request, const std::shared_ptr<CHTTPImageTransformationCache> &cache);
 
 private:
   std::string m_url;
+  std::string m_imagePath;
   CDateTime m_lastModified;
 
+  // identifies the source image (including its modification) and the transformation
+  std::string m_cacheKey;
+  std::string m_eTag;
+  std::shared_ptr<CHTTPImageTransformationCache> m_cache;
+
   uint8_t* m_buffer;
   HttpResponseRanges m_responseData;
+
+  // previously transformed image sent from the cache
+  std::string m_responseFile;
+  int m_responseFileDescriptor = -1;
 };
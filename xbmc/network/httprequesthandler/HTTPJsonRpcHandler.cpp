@@ -18,9 +18,21 @@
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+
+#include <algorithm>
+#include <string.h>
 
 #define MAX_HTTP_POST_SIZE 65536
 
+CHTTPJsonRpcHandler::CHTTPJsonRpcHandler(const HTTPRequest &request)
+  : IHTTPRequestHandler(request)
+{ }
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler() = default;
+
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request) const
 {
   return (request.pathUrl.compare("/jsonrpc") == 0);
@@ -71,25 +83,24 @@ int CHTTPJsonRpcHandler::HandleRequest()
       jsonpCallback = argument->second;
   }
 
+  bool compact = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact;
+  bool hasResponse = true;
   if (isRequest)
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
+    // notifications get an empty response
+    hasResponse = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client, m_responseVariant);
 
     if (!jsonpCallback.empty())
-      m_responseData = jsonpCallback + "(" + m_responseData + ");";
+    {
+      m_responseData = jsonpCallback + "(";
+      m_responseSuffix = ");";
+    }
   }
   else if (jsonpCallback.empty())
   {
     // get the whole output of JSONRPC.Introspect
-    CVariant result;
-    JSONRPC::CJSONServiceDescription::Print(result, &m_transportLayer, &client);
-    if (!CJSONVariantWriter::Write(result, m_responseData, false))
-    {
-      m_response.type = HTTPError;
-      m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
-
-      return MHD_YES;
-    }
+    JSONRPC::CJSONServiceDescription::Print(m_responseVariant, &m_transportLayer, &client);
+    compact = false;
   }
   else
   {
@@ -101,22 +112,40 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   m_requestData.clear();
 
-  m_responseRange.SetData(m_responseData.c_str(), m_responseData.size());
+  // the response is serialized while it is sent, large library results are never held as a whole in memory
+  if (hasResponse)
+    m_responseWriter.reset(new CJSONVariantStreamWriter(m_responseVariant, compact));
 
-  m_response.type = HTTPMemoryDownloadNoFreeCopy;
+  m_response.type = HTTPStreamDownload;
   m_response.status = MHD_HTTP_OK;
   m_response.contentType = "application/json";
-  m_response.totalLength = m_responseData.size();
+  m_response.totalLength = 0;
 
   return MHD_YES;
 }
 
-HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
+size_t CHTTPJsonRpcHandler::ReadResponseData(char *buffer, size_t size)
 {
-  HttpResponseRanges ranges;
-  ranges.push_back(m_responseRange);
+  // the start of the JSONP callback, the response and the end of the JSONP callback
+  if (m_responseData.empty())
+  {
+    if (m_responseWriter != nullptr)
+    {
+      size_t written = m_responseWriter->Read(buffer, size);
+      if (written > 0)
+        return written;
+
+      m_responseWriter.reset();
+    }
+
+    m_responseData.swap(m_responseSuffix);
+  }
+
+  size_t written = std::min(size, m_responseData.size());
+  memcpy(buffer, m_responseData.c_str(), written);
+  m_responseData.erase(0, written);
 
-  return ranges;
+  return written;
 }
 
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
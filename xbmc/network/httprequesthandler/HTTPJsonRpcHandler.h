@@ -11,14 +11,18 @@
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
+#include "utils/Variant.h"
 
+#include <memory>
 #include <string>
 
+class CJSONVariantStreamWriter;
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
   CHTTPJsonRpcHandler() = default;
-  ~CHTTPJsonRpcHandler() override = default;
+  ~CHTTPJsonRpcHandler() override;
 
   // implementations of IHTTPRequestHandler
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPJsonRpcHandler(request); }
@@ -26,21 +30,21 @@ public:
 
   int HandleRequest() override;
 
-  HttpResponseRanges GetResponseData() const override;
+  size_t ReadResponseData(char *buffer, size_t size) override;
 
   int GetPriority() const override { return 5; }
 
 protected:
-  explicit CHTTPJsonRpcHandler(const HTTPRequest &request)
-    : IHTTPRequestHandler(request)
-  { }
+  explicit CHTTPJsonRpcHandler(const HTTPRequest &request);
 
   bool appendPostData(const char *data, size_t size) override;
 
 private:
   std::string m_requestData;
-  std::string m_responseData;
-  CHttpResponseRange m_responseRange;
+  CVariant m_responseVariant;
+  std::unique_ptr<CJSONVariantStreamWriter> m_responseWriter;
+  std::string m_responseData; /*!< pending data around the serialized response, i.e. the JSONP callback */
+  std::string m_responseSuffix;
 
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
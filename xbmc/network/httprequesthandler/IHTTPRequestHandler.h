@@ -54,7 +54,9 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length filled piece by piece by the handler
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -140,6 +142,13 @@ public:
   */
   virtual bool GetLastModifiedDate(CDateTime &lastModified) const { return false; }
 
+  /*!
+  * \brief Returns the strong entity tag (including the quotes) of the response data.
+  *
+  * \details This is only used if the response can be cached.
+  */
+  virtual bool GetETag(std::string &eTag) const { return false; }
+
   /*!
    * \brief Returns the ranges with raw data belonging to the response.
    *
@@ -161,6 +170,27 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Returns the descriptor of the local response file if the handler already opened it.
+  *
+  * \details This is only used if the response type is HTTPFileDownload. The file is then sent from
+  * the descriptor, even if it has been removed in the meantime, and the caller takes ownership of it.
+  *
+  * \return File descriptor opened with open() or -1 to open the file returned by GetResponseFile().
+  */
+  virtual int TakeResponseFileDescriptor() { return -1; }
+
+  /*!
+  * \brief Writes the next piece of the response data.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload.
+  *
+  * \param buffer Buffer to write the response data to
+  * \param size Size of the buffer
+  * \return Number of bytes written, 0 once all of the response data has been written.
+  */
+  virtual size_t ReadResponseData(char *buffer, size_t size) { return 0; }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
@@ -0,0 +1,219 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "interfaces/AnnouncementManager.h"
+#include "network/TCPServer.h"
+#include "test/TestBasicEnvironment.h"
+#include "test/TestUtils.h"
+#include "utils/Variant.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#if !defined(TARGET_WINDOWS)
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace JSONRPC;
+
+namespace
+{
+// a port nothing listens on right now, picked by the system
+int GetFreePort()
+{
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0)
+    return 0;
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t size = sizeof(addr);
+  int port = 0;
+  if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+      getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &size) == 0)
+    port = ntohs(addr.sin_port);
+  close(sock);
+  return port;
+}
+
+// a client counting the test notifications it receives
+struct CBenchmarkClient
+{
+  ~CBenchmarkClient()
+  {
+    if (socket >= 0)
+      close(socket);
+  }
+
+  bool Connect(int port)
+  {
+    socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (socket < 0)
+      return false;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return connect(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+  }
+
+  void Read()
+  {
+    static const std::string method = "\"Other.OnTest\"";
+    char buffer[4096];
+    ssize_t result;
+    while ((result = recv(socket, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+    {
+      received += result;
+      data.append(buffer, result);
+      for (size_t pos = data.find(method); pos != std::string::npos; pos = data.find(method, pos + method.size()))
+        notifications++;
+      data.erase(0, data.size() > method.size() ? data.size() - method.size() + 1 : 0);
+    }
+  }
+
+  int socket = -1;
+  std::string data;
+  size_t received = 0;
+  unsigned int notifications = 0;
+};
+
+// reads until every client got the given number of notifications, returns false on timeout
+bool WaitForNotifications(std::vector<std::unique_ptr<CBenchmarkClient>>& clients, unsigned int notifications, int seconds = 30)
+{
+  const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+  size_t done = 0;
+  while (done < clients.size())
+  {
+    if (std::chrono::steady_clock::now() > timeout)
+      return false;
+    done = 0;
+    for (auto& client : clients)
+    {
+      if (client->notifications < notifications)
+        client->Read();
+      if (client->notifications >= notifications)
+        done++;
+    }
+  }
+  return true;
+}
+}
+
+TEST(BenchmarkTCPServer, ManyClients)
+{
+  // the clients and the server's ends of their connections share our descriptors
+  rlimit limit;
+  getrlimit(RLIMIT_NOFILE, &limit);
+  const size_t count = std::min<size_t>(4000, (limit.rlim_cur - 128) / 2);
+
+  auto announcementManager = std::make_shared<ANNOUNCEMENT::CAnnouncementManager>();
+  CServiceBroker::RegisterAnnouncementManager(announcementManager);
+  announcementManager->Start();
+
+  const int port = GetFreePort();
+  ASSERT_NE(0, port);
+  ASSERT_TRUE(CTCPServer::StartServer(port, false));
+
+  // the server listens with a short backlog, give it time to accept
+  const auto connectBegin = std::chrono::steady_clock::now();
+  std::vector<std::unique_ptr<CBenchmarkClient>> clients;
+  for (size_t i = 0; i < count; i++)
+  {
+    clients.emplace_back(new CBenchmarkClient());
+    ASSERT_TRUE(clients.back()->Connect(port)) << "client " << i;
+    if (i % 8 == 7)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // announced until all of them were accepted, the notifications of the clients accepted earlier are dropped
+  CVariant data;
+  data["item"]["title"] = "Title";
+  data["item"]["type"] = "song";
+  data["player"]["playerid"] = 0;
+  bool accepted = false;
+  for (int attempt = 0; attempt < 30 && !accepted; attempt++)
+  {
+    announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTest", data);
+    accepted = WaitForNotifications(clients, 1, 1);
+  }
+  ASSERT_TRUE(accepted);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (auto& client : clients)
+  {
+    client->Read();
+    client->notifications = 0;
+  }
+  unsigned int announcements = 0;
+  const auto connected = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - connectBegin);
+
+  // an announcement the size of a player notification, until every client got it
+  const unsigned int rounds = 100;
+  const auto begin = std::chrono::steady_clock::now();
+  for (unsigned int round = 0; round < rounds; round++)
+  {
+    announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTest", data);
+    announcements++;
+    ASSERT_TRUE(WaitForNotifications(clients, announcements)) << "round " << round;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  // a burst of announcements, sent as fast as they're made
+  const unsigned int burst = 100;
+  const auto burstBegin = std::chrono::steady_clock::now();
+  for (unsigned int round = 0; round < burst; round++)
+  {
+    data["player"]["playerid"] = round;
+    announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTest", data);
+  }
+  announcements += burst;
+  ASSERT_TRUE(WaitForNotifications(clients, announcements));
+  const auto burstElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - burstBegin);
+
+  clients.clear();
+  CTCPServer::StopServer(true);
+  announcementManager->Deinitialize();
+  CServiceBroker::UnregisterAnnouncementManager();
+
+  RecordProperty("clients", std::to_string(count));
+  RecordProperty("connectMilliseconds", std::to_string(connected.count()));
+  RecordProperty("microsecondsPerAnnouncement", std::to_string(elapsed.count() / rounds));
+  RecordProperty("burstMicrosecondsPerAnnouncement", std::to_string(burstElapsed.count() / burst));
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  CXBMCTestUtils::Instance().ParseArgs(argc, argv);
+
+  if (!testing::AddGlobalTestEnvironment(new TestBasicEnvironment()))
+  {
+    fprintf(stderr, "Unable to add basic test environment.\n");
+    exit(EXIT_FAILURE);
+  }
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,283 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "network/EventClient.h"
+#include "network/EventPacket.h"
+#include "network/Socket.h"
+
+#if !defined(TARGET_WINDOWS)
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace EVENTCLIENT;
+using namespace EVENTPACKET;
+using namespace SOCKETS;
+
+namespace
+{
+// builds the datagrams an EventClient sends
+class CPacketGenerator
+{
+public:
+  CPacketGenerator() : m_socket(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) {}
+  ~CPacketGenerator()
+  {
+    if (m_socket >= 0)
+      close(m_socket);
+  }
+
+  static std::string Packet(PacketType type, const std::string& payload,
+                            unsigned int sequence = 1, unsigned int packets = 1)
+  {
+    std::string packet(HEADER_SIZE, '\0');
+    memcpy(&packet[0], HEADER_SIG, HEADER_SIG_LENGTH);
+    packet[4] = 2;
+    packet[5] = 0;
+    uint16_t value16 = htons(type);
+    memcpy(&packet[6], &value16, 2);
+    uint32_t value32 = htonl(sequence);
+    memcpy(&packet[8], &value32, 4);
+    value32 = htonl(packets);
+    memcpy(&packet[12], &value32, 4);
+    value16 = htons(static_cast<uint16_t>(payload.size()));
+    memcpy(&packet[16], &value16, 2);
+    return packet + payload;
+  }
+
+  static std::string Button(unsigned short code, unsigned short flags, unsigned short amount)
+  {
+    std::string payload;
+    AppendUInt16(payload, code);
+    AppendUInt16(payload, flags);
+    AppendUInt16(payload, amount);
+    payload.append("XG", 3);
+    return Packet(PT_BUTTON, payload);
+  }
+
+  static std::string Mouse(unsigned short x, unsigned short y)
+  {
+    std::string payload(1, static_cast<char>(PTM_ABSOLUTE));
+    AppendUInt16(payload, x);
+    AppendUInt16(payload, y);
+    return Packet(PT_MOUSE, payload);
+  }
+
+  static CEventPacket* Parse(const std::string& packet)
+  {
+    return new CEventPacket(static_cast<int>(packet.size()), packet.data());
+  }
+
+  bool Send(int port, const std::string& packet)
+  {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return sendto(m_socket, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr*>(&addr),
+                  sizeof(addr)) == static_cast<ssize_t>(packet.size());
+  }
+
+private:
+  static void AppendUInt16(std::string& payload, unsigned short value)
+  {
+    uint16_t networkValue = htons(value);
+    payload.append(reinterpret_cast<const char*>(&networkValue), 2);
+  }
+
+  int m_socket;
+};
+
+// binds to a free port picked by the system, returns the port or 0
+int BindAnyPort(CPosixUDPSocket& socket)
+{
+  if (!socket.Bind(true, 0))
+    return 0;
+
+  sockaddr_in addr = {};
+  socklen_t size = sizeof(addr);
+  if (getsockname(socket.Socket(), reinterpret_cast<sockaddr*>(&addr), &size) != 0)
+    return 0;
+  return ntohs(addr.sin_port);
+}
+
+const unsigned short AXIS_FLAGS = PTB_DOWN | PTB_USE_AMOUNT | PTB_AXIS;
+}
+
+TEST(TestEventServer, AxisAndMouseUpdatesAreCoalesced)
+{
+  CEventClient client;
+  for (unsigned short i = 1; i <= 10; i++)
+  {
+    ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(1, AXIS_FLAGS, i * 1000))));
+    ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Mouse(i, i))));
+  }
+  // a different axis is kept
+  ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(2, AXIS_FLAGS | PTB_QUEUE, 500))));
+
+  EXPECT_EQ(18u, client.ProcessEvents());
+
+  std::string map;
+  bool isAxis = false;
+  bool isJoystick = false;
+  float amount = 0.0f;
+  EXPECT_EQ(1u, client.GetButtonCode(map, isAxis, amount, isJoystick));
+  EXPECT_TRUE(isAxis);
+  EXPECT_FLOAT_EQ(10000 / 65535.0f * 2.0f - 1.0f, amount);
+
+  CQueueLatency latency = client.TakeQueueLatency();
+  EXPECT_EQ(1u, latency.count);
+  EXPECT_EQ(0u, client.TakeQueueLatency().count);
+}
+
+TEST(TestEventServer, ButtonPressesAreNotCoalesced)
+{
+  CEventClient client;
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(2, PTB_DOWN | PTB_QUEUE, 0))));
+    ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(2, PTB_UP | PTB_QUEUE, 0))));
+  }
+  // the release of an axis must not be dropped either
+  ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(1, AXIS_FLAGS, 1000))));
+  ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(1, PTB_UP | PTB_USE_AMOUNT | PTB_AXIS, 0))));
+  ASSERT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Button(1, AXIS_FLAGS, 2000))));
+
+  EXPECT_EQ(0u, client.ProcessEvents());
+}
+
+TEST(TestEventServer, SplitMessagesAreAssembled)
+{
+  const std::string payload = std::string(1, static_cast<char>(AT_EXEC_BUILTIN)) + "Notification(Title,Message)";
+  const std::string parts[] = { payload.substr(0, 5), payload.substr(5, 10), payload.substr(15) + '\0' };
+
+  CEventClient client;
+  EXPECT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Packet(PT_ACTION, parts[2], 3, 3))));
+  EXPECT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Packet(PT_ACTION, parts[0], 1, 3))));
+  EXPECT_FALSE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Packet(PT_ACTION, parts[1], 4, 3))));
+  EXPECT_TRUE(client.AddPacket(CPacketGenerator::Parse(CPacketGenerator::Packet(PT_ACTION, parts[1], 2, 3))));
+  client.ProcessEvents();
+
+  CEventAction action;
+  ASSERT_TRUE(client.GetNextAction(action));
+  EXPECT_EQ(AT_EXEC_BUILTIN, action.actionType);
+  EXPECT_EQ("Notification(Title,Message)", action.actionName);
+  EXPECT_FALSE(client.GetNextAction(action));
+}
+
+TEST(TestEventServer, DatagramsAreReadInBatches)
+{
+  CPosixUDPSocket socket;
+  const int port = BindAnyPort(socket);
+  ASSERT_NE(0, port);
+
+  CPacketGenerator generator;
+  for (unsigned short i = 0; i < 20; i++)
+    ASSERT_TRUE(generator.Send(port, CPacketGenerator::Button(i, AXIS_FLAGS, i)));
+
+  CAddress addrs[32];
+  int sizes[32];
+  std::vector<unsigned char> buffers(32 * PACKET_SIZE);
+  int received = 0;
+  while (received < 20)
+  {
+    int packets = socket.ReadBatch(addrs, sizes, 32, PACKET_SIZE, buffers.data());
+    ASSERT_GT(packets, 0);
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+    // everything has been queued before
+    EXPECT_EQ(20, packets);
+#endif
+    for (int i = 0; i < packets; i++, received++)
+    {
+      CEventPacket packet(sizes[i], buffers.data() + i * PACKET_SIZE);
+      ASSERT_TRUE(packet.IsValid());
+      const unsigned char* payload = static_cast<const unsigned char*>(packet.Payload());
+      EXPECT_EQ(received, (payload[0] << 8) | payload[1]);
+      EXPECT_STREQ("127.0.0.1", addrs[i].Address());
+    }
+  }
+  socket.Close();
+}
+
+TEST(TestEventServer, PacketsPerSecond)
+{
+  CPosixUDPSocket socket;
+  const int port = BindAnyPort(socket);
+  ASSERT_NE(0, port);
+  CPacketGenerator generator;
+
+  const int burst = 32;
+  const int bursts = 500;
+  CAddress addrs[burst];
+  int sizes[burst];
+  std::vector<unsigned char> buffers(burst * PACKET_SIZE);
+
+  // a remote sending bursts of axis updates, the server either handles one
+  // datagram at a time or everything that has arrived at once
+  auto packetsPerSecond = [&](bool batched, unsigned int& coalesced) {
+    CEventClient client;
+    std::chrono::steady_clock::duration time(0);
+    for (int i = 0; i < bursts; i++)
+    {
+      for (int j = 0; j < burst; j++)
+        EXPECT_TRUE(generator.Send(port, CPacketGenerator::Button(1, AXIS_FLAGS, j)));
+
+      const auto begin = std::chrono::steady_clock::now();
+      for (int received = 0; received < burst;)
+      {
+        int packets = 1;
+        if (batched)
+          packets = socket.ReadBatch(addrs, sizes, burst, PACKET_SIZE, buffers.data());
+        else
+          sizes[0] = socket.Read(addrs[0], PACKET_SIZE, buffers.data());
+        if (packets < 0 || sizes[0] < 0)
+          return 0;
+        for (int k = 0; k < packets; k++)
+        {
+          client.AddPacket(new CEventPacket(sizes[k], buffers.data() + k * PACKET_SIZE));
+          if (!batched)
+            coalesced += client.ProcessEvents();
+        }
+        if (batched)
+          coalesced += client.ProcessEvents();
+        received += packets;
+      }
+      time += std::chrono::steady_clock::now() - begin;
+
+      std::string map;
+      bool isAxis, isJoystick;
+      float amount;
+      EXPECT_EQ(1u, client.GetButtonCode(map, isAxis, amount, isJoystick));
+    }
+    EXPECT_EQ(static_cast<unsigned int>(bursts), client.TakeQueueLatency().count);
+    return static_cast<int>(burst * bursts / std::chrono::duration<double>(time).count());
+  };
+
+  unsigned int singleCoalesced = 0;
+  unsigned int batchedCoalesced = 0;
+  const int single = packetsPerSecond(false, singleCoalesced);
+  const int batched = packetsPerSecond(true, batchedCoalesced);
+  socket.Close();
+
+  EXPECT_EQ(0u, singleCoalesced);
+  EXPECT_GT(batchedCoalesced, 0u);
+  RecordProperty("single", single);
+  RecordProperty("batched", batched);
+  RecordProperty("batched.coalesced", static_cast<int>(batchedCoalesced));
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "network/httprequesthandler/HTTPImageTransformationCache.h"
+
+#include <string>
+#include <vector>
+
+#if !defined(TARGET_WINDOWS)
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string CachePath = "special://temp/imagetransformationcachetest/";
+}
+
+TEST(TestHTTPImageTransformationCache, GetAndAdd)
+{
+  CHTTPImageTransformationCache cache(CachePath, 1024);
+
+  XFILE::CFile file;
+  EXPECT_FALSE(cache.Get("image|16", file));
+
+  const std::vector<uint8_t> data(100, 'a');
+  std::string path;
+  ASSERT_TRUE(cache.Add("image|16", data.data(), data.size(), path));
+  EXPECT_TRUE(XFILE::CFile::Exists(path));
+
+  ASSERT_TRUE(cache.Get("image|16", file));
+  EXPECT_EQ(static_cast<int64_t>(data.size()), file.GetLength());
+  file.Close();
+
+  cache.Clear();
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+  EXPECT_FALSE(cache.Get("image|16", file));
+  XFILE::CDirectory::RemoveRecursive(CachePath);
+}
+
+#if !defined(TARGET_WINDOWS)
+TEST(TestHTTPImageTransformationCache, RemovedImageCanBeRead)
+{
+  CHTTPImageTransformationCache cache(CachePath, 1024);
+
+  const std::vector<uint8_t> first(600, 'a');
+  std::string path;
+  ASSERT_TRUE(cache.Add("image|16", first.data(), first.size(), path));
+
+  XFILE::CFile file;
+  ASSERT_TRUE(cache.Get("image|16", file));
+
+  // another request adds an image which takes the place of the looked up one
+  const std::vector<uint8_t> second(600, 'b');
+  std::string otherPath;
+  ASSERT_TRUE(cache.Add("image|32", second.data(), second.size(), otherPath));
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+
+  std::vector<uint8_t> read(first.size());
+  EXPECT_EQ(static_cast<ssize_t>(first.size()), file.Read(read.data(), read.size()));
+  EXPECT_EQ(first, read);
+  file.Close();
+
+  cache.Clear();
+  XFILE::CDirectory::RemoveRecursive(CachePath);
+}
+
+TEST(TestHTTPImageTransformationCache, RemovedImageCanBeSentFromItsDescriptor)
+{
+  CHTTPImageTransformationCache cache(CachePath, 1024);
+
+  const std::vector<uint8_t> first(600, 'a');
+  std::string path;
+  ASSERT_TRUE(cache.Add("image|16", first.data(), first.size(), path));
+
+  std::string openedPath;
+  const int fd = cache.Open("image|16", openedPath);
+  ASSERT_GE(fd, 0);
+  EXPECT_EQ(path, openedPath);
+
+  // the webserver sends the image after another request took its place
+  const std::vector<uint8_t> second(600, 'b');
+  std::string otherPath;
+  ASSERT_TRUE(cache.Add("image|32", second.data(), second.size(), otherPath));
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+  EXPECT_EQ(-1, cache.Open("image|16", openedPath));
+
+  std::vector<uint8_t> read(first.size());
+  EXPECT_EQ(static_cast<ssize_t>(first.size()), pread(fd, read.data(), read.size(), 0));
+  EXPECT_EQ(first, read);
+  close(fd);
+
+  cache.Clear();
+  XFILE::CDirectory::RemoveRecursive(CachePath);
+}
+#endif
+
+TEST(TestHTTPImageTransformationCache, AddedAgainToAnotherFile)
+{
+  CHTTPImageTransformationCache cache(CachePath, 1024);
+
+  const std::vector<uint8_t> data(600, 'a');
+  std::string path;
+  ASSERT_TRUE(cache.Add("image|16", data.data(), data.size(), path));
+  XFILE::CFile file;
+  ASSERT_TRUE(cache.Get("image|16", file));
+
+  // the removed image may still be open, where it can't be removed yet its file isn't overwritten
+  std::string otherPath;
+  ASSERT_TRUE(cache.Add("image|32", data.data(), data.size(), otherPath));
+  std::string newPath;
+  ASSERT_TRUE(cache.Add("image|16", data.data(), data.size(), newPath));
+  EXPECT_NE(path, newPath);
+  file.Close();
+
+  // and once it's closed it's gone
+  cache.Clear();
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+  EXPECT_FALSE(XFILE::CFile::Exists(newPath));
+  XFILE::CDirectory::RemoveRecursive(CachePath);
+}
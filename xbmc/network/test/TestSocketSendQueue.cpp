@@ -0,0 +1,191 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "network/SocketSendQueue.h"
+
+#if !defined(TARGET_WINDOWS)
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// a connected pair of non-blocking sockets, the first one is written to
+class CSocketPair
+{
+public:
+  CSocketPair()
+  {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, m_sockets) != 0)
+    {
+      m_sockets[0] = m_sockets[1] = -1;
+      return;
+    }
+
+    for (int socket : m_sockets)
+      fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK);
+  }
+
+  ~CSocketPair()
+  {
+    for (int socket : m_sockets)
+    {
+      if (socket >= 0)
+        close(socket);
+    }
+  }
+
+  bool IsValid() const { return m_sockets[0] >= 0; }
+  int Writer() const { return m_sockets[0]; }
+
+  size_t Read()
+  {
+    char buffer[65536];
+    size_t total = 0;
+    ssize_t result;
+    while ((result = recv(m_sockets[1], buffer, sizeof(buffer), 0)) > 0)
+      total += result;
+    return total;
+  }
+
+private:
+  int m_sockets[2];
+};
+}
+
+TEST(TestSocketSendQueue, SendImmediately)
+{
+  CSocketPair pair;
+  ASSERT_TRUE(pair.IsValid());
+
+  CSocketSendQueue queue;
+  const std::string data = "{\"jsonrpc\":\"2.0\",\"method\":\"Player.OnPlay\"}";
+  EXPECT_TRUE(queue.Send(pair.Writer(), data.c_str(), data.size()));
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(data.size(), pair.Read());
+}
+
+TEST(TestSocketSendQueue, StalledReader)
+{
+  CSocketPair pair;
+  ASSERT_TRUE(pair.IsValid());
+
+  // the reader doesn't read, the sender must not block
+  CSocketSendQueue queue;
+  const std::string data(1024 * 1024, 'x');
+  size_t sent = 0;
+  while (queue.Send(pair.Writer(), data.c_str(), data.size()))
+  {
+    sent += data.size();
+    ASSERT_LT(sent, 2 * CSocketSendQueue::MAX_QUEUED_BYTES);
+  }
+  EXPECT_GT(queue.GetQueuedBytes(), CSocketSendQueue::MAX_QUEUED_BYTES);
+
+  // once the reader catches up everything arrives
+  size_t received = 0;
+  while (!queue.IsEmpty())
+  {
+    received += pair.Read();
+    EXPECT_TRUE(queue.Flush(pair.Writer()));
+  }
+  received += pair.Read();
+  EXPECT_EQ(sent, received);
+}
+
+TEST(TestSocketSendQueue, ClosedPeer)
+{
+  CSocketSendQueue queue;
+  int writer;
+  {
+    CSocketPair pair;
+    ASSERT_TRUE(pair.IsValid());
+    writer = dup(pair.Writer());
+  }
+
+  const std::string data = "data";
+  EXPECT_FALSE(queue.Send(writer, data.c_str(), data.size()));
+  close(writer);
+}
+
+TEST(TestSocketSendQueue, Broadcast)
+{
+  // an announcement to a few thousand clients, a tenth of them not reading
+  rlimit limit;
+  getrlimit(RLIMIT_NOFILE, &limit);
+  const size_t clients = std::min<size_t>(5000, (limit.rlim_cur - 64) / 2);
+
+  std::vector<CSocketPair> pairs(clients);
+  std::vector<CSocketSendQueue> queues(clients);
+  std::vector<size_t> received(clients, 0);
+  const std::string data(4096, 'x');
+  const int announcements = 100;
+
+  std::chrono::microseconds elapsed(0);
+  size_t refused = 0;
+  for (int announcement = 0; announcement < announcements; announcement++)
+  {
+    const auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < clients; i++)
+    {
+      if (pairs[i].IsValid() && !queues[i].Send(pairs[i].Writer(), data.c_str(), data.size()))
+        refused++;
+    }
+    elapsed += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+    for (size_t i = 0; i < clients; i++)
+    {
+      if (i % 10 != 0)
+        received[i] += pairs[i].Read();
+    }
+  }
+
+  // the readers got everything right away, the data the others didn't take is queued
+  EXPECT_EQ(0u, refused);
+  size_t queued = 0;
+  for (size_t i = 0; i < clients; i++)
+  {
+    if (!pairs[i].IsValid())
+      continue;
+    queued += queues[i].GetQueuedBytes();
+    if (i % 10 != 0)
+    {
+      EXPECT_TRUE(queues[i].IsEmpty()) << "client " << i;
+      EXPECT_EQ(announcements * data.size(), received[i]) << "client " << i;
+    }
+  }
+  EXPECT_GT(queued, 0u);
+
+  RecordProperty("clients", static_cast<int>(clients));
+  RecordProperty("microsecondsPerAnnouncement", static_cast<int>(elapsed.count() / announcements));
+  RecordProperty("queuedBytes", static_cast<int>(queued));
+
+  // once the others catch up they got everything as well
+  for (size_t i = 0; i < clients; i += 10)
+  {
+    if (!pairs[i].IsValid())
+      continue;
+    while (!queues[i].IsEmpty())
+    {
+      received[i] += pairs[i].Read();
+      ASSERT_TRUE(queues[i].Flush(pairs[i].Writer()));
+    }
+    received[i] += pairs[i].Read();
+    EXPECT_EQ(announcements * data.size(), received[i]) << "client " << i;
+  }
+}
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "interfaces/AnnouncementManager.h"
+#include "network/SocketSendQueue.h"
+#include "network/TCPServer.h"
+#include "utils/Variant.h"
+
+#if !defined(TARGET_WINDOWS)
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace JSONRPC;
+
+namespace
+{
+// a port nothing listens on right now, picked by the system
+int GetFreePort()
+{
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0)
+    return 0;
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t size = sizeof(addr);
+  int port = 0;
+  if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+      getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &size) == 0)
+    port = ntohs(addr.sin_port);
+  close(sock);
+  return port;
+}
+
+// a JSON-RPC client counting the test notifications it receives
+class CTestClient
+{
+public:
+  ~CTestClient()
+  {
+    if (m_socket >= 0)
+      close(m_socket);
+  }
+
+  // a small receive buffer makes the server queue data the client doesn't read
+  bool Connect(int port, int receiveBuffer = 0)
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+    if (receiveBuffer > 0)
+      setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return connect(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+  }
+
+  // reads whatever arrived without blocking, returns the number of bytes
+  size_t Read()
+  {
+    static const std::string method = "\"Other.OnTest\"";
+    char buffer[65536];
+    size_t total = 0;
+    while (!m_closed)
+    {
+      const ssize_t result = recv(m_socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+      if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        break;
+      if (result <= 0)
+      {
+        m_closed = true;
+        break;
+      }
+      total += result;
+
+      // the method of a notification may be split between reads
+      m_data.append(buffer, result);
+      for (size_t pos = m_data.find(method); pos != std::string::npos; pos = m_data.find(method, pos + method.size()))
+        m_notifications++;
+      m_data.erase(0, m_data.size() > method.size() ? m_data.size() - method.size() + 1 : 0);
+    }
+    m_received += total;
+    return total;
+  }
+
+  size_t GetReceived() const { return m_received; }
+  unsigned int GetNotifications() const { return m_notifications; }
+  bool IsClosed() const { return m_closed; }
+
+private:
+  int m_socket = -1;
+  std::string m_data;
+  size_t m_received = 0;
+  unsigned int m_notifications = 0;
+  bool m_closed = false;
+};
+
+class TestTCPServer : public ::testing::Test
+{
+protected:
+  TestTCPServer()
+  {
+    m_announcementManager = std::make_shared<ANNOUNCEMENT::CAnnouncementManager>();
+    CServiceBroker::RegisterAnnouncementManager(m_announcementManager);
+    m_announcementManager->Start();
+    m_port = GetFreePort();
+  }
+
+  ~TestTCPServer() override
+  {
+    CTCPServer::StopServer(true);
+    m_announcementManager->Deinitialize();
+    CServiceBroker::UnregisterAnnouncementManager();
+  }
+
+  // announces until every client got something, so the server accepted them all
+  bool WaitForConnections(std::vector<std::unique_ptr<CTestClient>>& clients)
+  {
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < timeout)
+    {
+      m_announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnConnect");
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+      bool connected = true;
+      for (auto& client : clients)
+      {
+        client->Read();
+        connected &= client->GetReceived() > 0;
+      }
+      if (connected)
+        return true;
+    }
+    return false;
+  }
+
+  std::shared_ptr<ANNOUNCEMENT::CAnnouncementManager> m_announcementManager;
+  int m_port;
+};
+}
+
+TEST_F(TestTCPServer, StalledClientIsDropped)
+{
+  ASSERT_NE(0, m_port);
+  ASSERT_TRUE(CTCPServer::StartServer(m_port, false));
+  ASSERT_TRUE(CTCPServer::IsRunning());
+
+  const size_t readers = 8;
+  std::vector<std::unique_ptr<CTestClient>> clients;
+  for (size_t i = 0; i < readers; i++)
+  {
+    clients.emplace_back(new CTestClient());
+    ASSERT_TRUE(clients.back()->Connect(m_port));
+  }
+  clients.emplace_back(new CTestClient());
+  CTestClient& stalled = *clients.back();
+  ASSERT_TRUE(stalled.Connect(m_port, 4096));
+  ASSERT_TRUE(WaitForConnections(clients));
+
+  // notifications larger than the socket buffers, the server thread flushes the rest as the readers take it
+  const unsigned int announcements = 160;
+  const size_t payloadSize = 256 * 1024;
+  CVariant data;
+  data["payload"] = std::string(payloadSize, 'x');
+  for (unsigned int announcement = 0; announcement < announcements; announcement++)
+  {
+    data["id"] = announcement;
+    m_announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTest", data);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    for (size_t i = 0; i < readers; i++)
+    {
+      while (clients[i]->GetNotifications() <= announcement && !clients[i]->IsClosed() &&
+             std::chrono::steady_clock::now() < timeout)
+      {
+        if (clients[i]->Read() == 0)
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      ASSERT_EQ(announcement + 1, clients[i]->GetNotifications()) << "client " << i;
+    }
+  }
+
+  // the stalled client got more than the server queues for a client, it's closed once it caught up
+  const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!stalled.IsClosed() && std::chrono::steady_clock::now() < timeout)
+  {
+    if (stalled.Read() == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(stalled.IsClosed());
+  EXPECT_LT(stalled.GetNotifications(), announcements);
+  EXPECT_LT(stalled.GetReceived(), announcements * payloadSize);
+  EXPECT_GT(announcements * payloadSize, 2 * CSocketSendQueue::MAX_QUEUED_BYTES);
+
+  // the readers are still served
+  m_announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTest", data);
+  for (size_t i = 0; i < readers; i++)
+  {
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (clients[i]->GetNotifications() <= announcements && std::chrono::steady_clock::now() < timeout)
+    {
+      if (clients[i]->Read() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(clients[i]->IsClosed());
+    EXPECT_EQ(announcements + 1, clients[i]->GetNotifications()) << "client " << i;
+  }
+}
+
+TEST_F(TestTCPServer, ClientsConnectAndDisconnect)
+{
+  ASSERT_NE(0, m_port);
+  ASSERT_TRUE(CTCPServer::StartServer(m_port, false));
+
+  std::vector<std::unique_ptr<CTestClient>> clients;
+  for (int i = 0; i < 4; i++)
+  {
+    clients.emplace_back(new CTestClient());
+    ASSERT_TRUE(clients.back()->Connect(m_port));
+  }
+  ASSERT_TRUE(WaitForConnections(clients));
+
+  // a client going away doesn't affect the others
+  clients.erase(clients.begin());
+  CVariant data;
+  data["id"] = 1;
+  m_announcementManager->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTest", data);
+  for (auto& client : clients)
+  {
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client->GetNotifications() == 0 && std::chrono::steady_clock::now() < timeout)
+    {
+      if (client->Read() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(1u, client->GetNotifications());
+  }
+}
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "interfaces/AnnouncementManager.h"
+#include "music/tags/MusicInfoTag.h"
+#include "network/upnp/UPnPBrowseCache.h"
+#include "network/upnp/UPnPInternal.h"
+#include "network/upnp/UPnPServer.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Platinum/Source/Platinum/Platinum.h>
+#include <gtest/gtest.h>
+
+using namespace UPNP;
+
+namespace
+{
+std::unique_ptr<CFileItemList> CreateSongs(int count)
+{
+  std::unique_ptr<CFileItemList> items(new CFileItemList("musicdb://songs/"));
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("musicdb://songs/%d.mp3", i), false));
+    MUSIC_INFO::CMusicInfoTag* tag = item->GetMusicInfoTag();
+    tag->SetURL(StringUtils::Format("/music/artist %d/album %d/%d.mp3", i / 100, i / 10, i));
+    tag->SetTitle(StringUtils::Format("Song %d", i));
+    tag->SetArtist(StringUtils::Format("Artist %d", i / 100));
+    tag->SetAlbum(StringUtils::Format("Album %d", i / 10));
+    tag->SetTrackNumber(i % 10 + 1);
+    tag->SetDuration(180 + i % 120);
+    tag->SetLoaded();
+    items->Add(item);
+  }
+  return items;
+}
+
+const NPT_UInt32 PAGE_SIZE = 10; // items a control point browses at once
+
+// a server whose library containers hold generated songs
+class CTestUPnPServer : public UPNP::CUPnPServer
+{
+public:
+  CTestUPnPServer() : UPNP::CUPnPServer("test") {}
+
+  void SetSongs(int songs) { m_songs = songs; }
+  int GetRetrieved() const { return m_retrieved; }
+  int GetPaged() const { return m_paged; }
+
+protected:
+  void GetChildren(const NPT_String& parent_id, CFileItemList& items) override
+  {
+    m_retrieved++;
+    std::unique_ptr<CFileItemList> songs = CreateSongs(m_songs);
+    items.Copy(*songs);
+    items.SetPath(std::string(parent_id));
+  }
+
+  // only the songs container is paged, like the database returns everything for a page past the end
+  bool GetChildrenPage(const NPT_String& parent_id, NPT_UInt32 start, NPT_UInt32 count, CFileItemList& items) override
+  {
+    if (parent_id != "musicdb://songs/")
+      return false;
+
+    m_paged++;
+    std::unique_ptr<CFileItemList> songs = CreateSongs(m_songs);
+    items.SetPath(std::string(parent_id));
+    items.SetProperty("total", m_songs);
+    for (int i = 0; i < songs->Size(); i++)
+    {
+      if (start >= static_cast<NPT_UInt32>(songs->Size()) || (i >= static_cast<int>(start) && i < static_cast<int>(start + count)))
+        items.Add(songs->Get(i));
+    }
+    return true;
+  }
+
+private:
+  int m_songs = 100;
+  int m_retrieved = 0;
+  int m_paged = 0;
+};
+
+class TestUPnPServerBrowse : public testing::Test
+{
+protected:
+  TestUPnPServerBrowse()
+  {
+    CServiceBroker::RegisterAnnouncementManager(std::make_shared<ANNOUNCEMENT::CAnnouncementManager>());
+    // set when the server is started, the default of the settings
+    UPNP::CUPnPServer::m_MaxReturnedItems = 200;
+    m_server.reset(new CTestUPnPServer());
+    m_server->SetupServices();
+  }
+
+  ~TestUPnPServerBrowse() override
+  {
+    m_server.reset();
+    CServiceBroker::UnregisterAnnouncementManager();
+  }
+
+  // browses a page of a container like a control point does
+  NPT_UInt32 Browse(const char* container, NPT_UInt32 start, NPT_String* didl = nullptr, NPT_UInt32* total = nullptr)
+  {
+    PLT_Service* service = nullptr;
+    if (NPT_FAILED(m_server->FindServiceById("urn:upnp-org:serviceId:ContentDirectory", service)))
+      return 0;
+    PLT_ActionDesc* desc = service->FindActionDesc("Browse");
+    if (desc == nullptr)
+      return 0;
+
+    PLT_ActionReference action(new PLT_Action(*desc));
+    NPT_HttpRequest request("http://127.0.0.1/", NPT_HTTP_METHOD_POST);
+    request.GetHeaders().SetHeader(NPT_HTTP_HEADER_USER_AGENT, "test control point");
+    PLT_HttpRequestContext context(request);
+    if (NPT_FAILED(m_server->OnBrowseDirectChildren(action, container, "*", start, PAGE_SIZE, "", context)))
+      return 0;
+
+    NPT_UInt32 returned = 0;
+    action->GetArgumentValue("NumberReturned", returned);
+    if (didl)
+      action->GetArgumentValue("Result", *didl);
+    if (total)
+      action->GetArgumentValue("TotalMatches", *total);
+    return returned;
+  }
+
+  std::unique_ptr<CTestUPnPServer> m_server;
+};
+}
+
+TEST(TestUPnPBrowseCache, ObjectsAreBuiltOncePerVariant)
+{
+  CUPnPBrowseCache cache;
+  auto container = cache.Add("musicdb://songs/", CreateSongs(10));
+  ASSERT_TRUE(container);
+  EXPECT_EQ(container, cache.Get("musicdb://songs/"));
+
+  int built = 0;
+  CUPnPBrowseCache::DidlBuilder builder = [&built](const CFileItemPtr& item, NPT_String& didl) {
+    built++;
+    didl = item->GetPath().c_str();
+    return NPT_SUCCESS;
+  };
+
+  NPT_String first;
+  NPT_String second;
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(i, "client", builder, first));
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(i, "client", builder, second));
+  EXPECT_EQ(10, built);
+  EXPECT_STREQ(first, second);
+
+  NPT_String other;
+  EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(0, "other client", builder, other));
+  EXPECT_EQ(11, built);
+  EXPECT_STREQ("musicdb://songs/0.mp3", other);
+}
+
+TEST(TestUPnPBrowseCache, HiddenObjectsStayHidden)
+{
+  CUPnPBrowseCache cache;
+  auto container = cache.Add("musicdb://songs/", CreateSongs(1));
+
+  int built = 0;
+  CUPnPBrowseCache::DidlBuilder builder = [&built](const CFileItemPtr& item, NPT_String& didl) {
+    built++;
+    return NPT_ERROR_NO_SUCH_ITEM;
+  };
+
+  NPT_String didl;
+  EXPECT_EQ(NPT_ERROR_NO_SUCH_ITEM, container->AppendDidl(0, "", builder, didl));
+  EXPECT_EQ(NPT_ERROR_NO_SUCH_ITEM, container->AppendDidl(0, "", builder, didl));
+  EXPECT_EQ(1, built);
+  EXPECT_TRUE(didl.IsEmpty());
+}
+
+TEST(TestUPnPBrowseCache, FailuresAreRetried)
+{
+  CUPnPBrowseCache cache;
+  auto container = cache.Add("musicdb://songs/", CreateSongs(1));
+
+  int built = 0;
+  CUPnPBrowseCache::DidlBuilder builder = [&built](const CFileItemPtr& item, NPT_String& didl) {
+    return ++built == 1 ? NPT_FAILURE : NPT_SUCCESS;
+  };
+
+  NPT_String didl;
+  EXPECT_EQ(NPT_FAILURE, container->AppendDidl(0, "", builder, didl));
+  EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(0, "", builder, didl));
+  EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(0, "", builder, didl));
+  EXPECT_EQ(2, built);
+}
+
+TEST(TestUPnPBrowseCache, ObjectsOfTooManyVariantsAreNotKept)
+{
+  CUPnPBrowseCache cache;
+  auto container = cache.Add("musicdb://songs/", CreateSongs(1));
+  const size_t size = container->GetSize();
+
+  int built = 0;
+  CUPnPBrowseCache::DidlBuilder builder = [&built](const CFileItemPtr& item, NPT_String& didl) {
+    built++;
+    didl = item->GetPath().c_str();
+    return NPT_SUCCESS;
+  };
+
+  const int variants = CUPnPBrowseCache::CContainer::MAXIMUM_VARIANTS + 2;
+  for (int variant = 0; variant < variants; variant++)
+  {
+    NPT_String didl;
+    EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(0, std::to_string(variant), builder, didl));
+    EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(0, std::to_string(variant), builder, didl));
+    EXPECT_STREQ("musicdb://songs/0.mp3musicdb://songs/0.mp3", didl);
+  }
+  EXPECT_EQ(variants + 2, built);
+
+  // the objects and their DIDL-Lite count towards the size of the container
+  EXPECT_GT(container->GetSize(), size);
+}
+
+TEST(TestUPnPBrowseCache, ContainersTooBigAreNotCached)
+{
+  CUPnPBrowseCache cache(4, 64 * 1024);
+  auto container = cache.Add("musicdb://songs/", CreateSongs(1000));
+  ASSERT_TRUE(container);
+  EXPECT_EQ(1000, container->GetItems().Size());
+  EXPECT_GT(container->GetSize(), 64u * 1024);
+  EXPECT_FALSE(cache.Get("musicdb://songs/"));
+
+  cache.Add("musicdb://albums/", CreateSongs(1));
+  EXPECT_TRUE(cache.Get("musicdb://albums/"));
+}
+
+TEST(TestUPnPBrowseCache, ContainersAreEvictedWhenTheCacheIsFull)
+{
+  const size_t size = CUPnPBrowseCache::CContainer(CreateSongs(10), SIZE_MAX).GetSize();
+
+  // two containers of the items fit, without any objects built
+  CUPnPBrowseCache cache(4, 2 * size + size / 2);
+  cache.Add("musicdb://artists/", CreateSongs(10));
+  cache.Add("musicdb://albums/", CreateSongs(10));
+  EXPECT_TRUE(cache.Get("musicdb://artists/"));
+  EXPECT_TRUE(cache.Get("musicdb://albums/"));
+
+  cache.Add("musicdb://songs/", CreateSongs(10));
+  EXPECT_FALSE(cache.Get("musicdb://artists/"));
+  EXPECT_TRUE(cache.Get("musicdb://albums/"));
+
+  // the most recently used container grows as its objects are built
+  auto container = cache.Get("musicdb://songs/");
+  CUPnPBrowseCache::DidlBuilder builder = [](const CFileItemPtr& item, NPT_String& didl) {
+    didl = NPT_String('x', 2048);
+    return NPT_SUCCESS;
+  };
+  NPT_String didl;
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(NPT_SUCCESS, container->AppendDidl(i, "", builder, didl));
+  ASSERT_GT(container->GetSize() + size, 2 * size + size / 2);
+  EXPECT_TRUE(cache.Get("musicdb://songs/"));
+  EXPECT_FALSE(cache.Get("musicdb://albums/"));
+}
+
+TEST(TestUPnPBrowseCache, LeastRecentlyUsedContainersAreEvicted)
+{
+  CUPnPBrowseCache cache(2);
+  cache.Add("musicdb://artists/", CreateSongs(1));
+  cache.Add("musicdb://albums/", CreateSongs(1));
+  EXPECT_TRUE(cache.Get("musicdb://artists/"));
+
+  cache.Add("musicdb://songs/", CreateSongs(1));
+  EXPECT_TRUE(cache.Get("musicdb://artists/"));
+  EXPECT_FALSE(cache.Get("musicdb://albums/"));
+  EXPECT_TRUE(cache.Get("musicdb://songs/"));
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Get("musicdb://artists/"));
+  EXPECT_FALSE(cache.Get("musicdb://songs/"));
+}
+
+TEST_F(TestUPnPServerBrowse, LibraryChangesClearTheCache)
+{
+  EXPECT_EQ(10u, Browse("musicdb://genres/", 0));
+  EXPECT_EQ(10u, Browse("musicdb://genres/", 10));
+  EXPECT_EQ(1, m_server->GetRetrieved());
+
+  // any library change, even of an item that can't be looked up anymore
+  CVariant data;
+  data["type"] = "album";
+  data["id"] = 1;
+  m_server->Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnRemove", data);
+  EXPECT_EQ(10u, Browse("musicdb://genres/", 0));
+  EXPECT_EQ(2, m_server->GetRetrieved());
+
+  data["type"] = "season";
+  m_server->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", data);
+  EXPECT_EQ(10u, Browse("musicdb://genres/", 0));
+  EXPECT_EQ(3, m_server->GetRetrieved());
+
+  // other announcements keep the cache
+  m_server->Announce(ANNOUNCEMENT::Player, "xbmc", "OnPlay", data);
+  EXPECT_EQ(10u, Browse("musicdb://genres/", 0));
+  EXPECT_EQ(3, m_server->GetRetrieved());
+}
+
+TEST_F(TestUPnPServerBrowse, SongsArePagedInTheDatabase)
+{
+  NPT_String didl;
+  NPT_UInt32 total = 0;
+  EXPECT_EQ(10u, Browse("musicdb://songs/", 20, &didl, &total));
+  EXPECT_EQ(100u, total);
+  EXPECT_NE(-1, didl.Find(">Song 20<"));
+  EXPECT_NE(-1, didl.Find(">Song 29<"));
+  EXPECT_EQ(-1, didl.Find(">Song 30<"));
+
+  EXPECT_EQ(5u, Browse("musicdb://songs/", 95, nullptr, &total));
+  EXPECT_EQ(100u, total);
+
+  EXPECT_EQ(0u, Browse("musicdb://songs/", 100, nullptr, &total));
+  EXPECT_EQ(100u, total);
+
+  // every page is retrieved on its own, nothing is kept
+  EXPECT_EQ(3, m_server->GetPaged());
+  EXPECT_EQ(0, m_server->GetRetrieved());
+}
+
+TEST_F(TestUPnPServerBrowse, BrowseLatency)
+{
+  const int pages = 10;
+  const int songs = 2000;
+  m_server->SetSongs(songs);
+
+  // a control point paging through a container, with the library changing before
+  // every page so that each one retrieves the whole container like before
+  CVariant data;
+  data["type"] = "album";
+  data["id"] = 1;
+  auto uncachedPage = [&](int page, NPT_String& didl) {
+    m_server->Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnUpdate", data);
+    return Browse("musicdb://genres/", page * PAGE_SIZE, &didl);
+  };
+  auto cachedPage = [&](int page, NPT_String& didl) {
+    return Browse("musicdb://genres/", page * PAGE_SIZE, &didl);
+  };
+
+  auto averageLatency = [&](const std::function<NPT_UInt32(int, NPT_String&)>& browse, std::vector<NPT_String>& results) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (int page = 0; page < pages; page++)
+    {
+      NPT_String didl;
+      EXPECT_EQ(PAGE_SIZE, browse(page, didl));
+      results.push_back(didl);
+    }
+    const auto time = std::chrono::steady_clock::now() - begin;
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(time).count() / pages);
+  };
+
+  std::vector<NPT_String> uncachedResults;
+  std::vector<NPT_String> firstResults;
+  std::vector<NPT_String> secondResults;
+  const int uncached = averageLatency(uncachedPage, uncachedResults);
+  m_server->Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnUpdate", data);
+  const int first = averageLatency(cachedPage, firstResults);
+  const int second = averageLatency(cachedPage, secondResults);
+
+  for (int page = 0; page < pages; page++)
+  {
+    EXPECT_STREQ(uncachedResults[page], firstResults[page]);
+    EXPECT_STREQ(uncachedResults[page], secondResults[page]);
+  }
+  EXPECT_EQ(pages + 1, m_server->GetRetrieved());
+
+  RecordProperty("songs", songs);
+  RecordProperty("uncached.page_us", uncached);
+  RecordProperty("first.page_us", first);
+  RecordProperty("second.page_us", second);
+}
@@ -19,16 +19,27 @@
 #include "filesystem/File.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "network/WebServer.h"
+#include "network/httprequesthandler/HTTPImageTransformationHandler.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/MediaSourceSettings.h"
+#include "settings/SettingsComponent.h"
 #include "test/TestUtils.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
 #include <random>
+#include <thread>
+#include <vector>
 
 using namespace XFILE;
 
@@ -40,6 +51,7 @@ using namespace XFILE;
 #define TEST_FILES_DATA_RANGES  "range1;range2;range3"
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
+#define TEST_FILES_IMAGE        TEST_FILES_DATA ".png"
 
 class TestWebServer : public testing::Test
 {
@@ -69,6 +81,7 @@ protected:
     webserver.Start(webserverPort, "", "");
     webserver.RegisterRequestHandler(&m_jsonRpcHandler);
     webserver.RegisterRequestHandler(&m_vfsHandler);
+    webserver.RegisterRequestHandler(&m_imageTransformationHandler);
   }
 
   void TearDown() override
@@ -76,6 +89,7 @@ protected:
     if (webserver.IsStarted())
       webserver.Stop();
 
+    webserver.UnregisterRequestHandler(&m_imageTransformationHandler);
     webserver.UnregisterRequestHandler(&m_vfsHandler);
     webserver.UnregisterRequestHandler(&m_jsonRpcHandler);
 
@@ -121,6 +135,15 @@ protected:
     return GetUrl(path);
   }
 
+  std::string GetUrlOfTransformedTestImage(unsigned int width)
+  {
+    std::string path = URIUtils::AddFileToFolder(sourcePath, TEST_FILES_IMAGE);
+    path = "image://" + CURL::Encode(path) + "/";
+    path = URIUtils::AddFileToFolder("image", CURL::Encode(path));
+
+    return GetUrl(path) + StringUtils::Format("?width=%u", width);
+  }
+
   bool GetLastModifiedOfTestFile(const std::string& testFile, CDateTime& lastModified)
   {
     CFile file;
@@ -339,9 +362,87 @@ protected:
     return StringUtils::Format("bytes=%u-%u", start, end);
   }
 
+  static int GetThreadCount()
+  {
+#if defined(TARGET_LINUX)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+      if (StringUtils::StartsWith(line, "Threads:"))
+        return atoi(line.c_str() + 8);
+    }
+#endif
+    return -1;
+  }
+
+  // restarts the webserver in the given mode and lets several clients alternate between
+  // JSON-RPC requests and file downloads, recording throughput, latency and thread count
+  void RunLoad(bool threadPool, unsigned int clients, unsigned int requestsPerClient)
+  {
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    const bool oldThreadPool = advancedSettings->m_webserverThreadPool;
+    webserver.Stop();
+    advancedSettings->m_webserverThreadPool = threadPool;
+    ASSERT_TRUE(webserver.Start(webserverPort, "", ""));
+
+    const std::string jsonRpcUrl = GetUrl(TEST_URL_JSONRPC "?request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 1 }"));
+    const std::string fileUrl = GetUrlOfTestFile(TEST_FILES_HTML);
+
+    std::mutex latenciesMutex;
+    std::vector<double> latencies;
+    std::atomic<unsigned int> failed(0);
+    std::atomic<bool> running(true);
+    int maxThreads = GetThreadCount();
+
+    std::thread sampler([&running, &maxThreads]() {
+      while (running)
+      {
+        maxThreads = std::max(maxThreads, GetThreadCount());
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+    });
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int client = 0; client < clients; ++client)
+    {
+      threads.emplace_back([&, client]() {
+        std::vector<double> clientLatencies;
+        for (unsigned int request = 0; request < requestsPerClient; ++request)
+        {
+          const auto requestBegin = std::chrono::steady_clock::now();
+          std::string result;
+          CCurlFile curl;
+          if (!curl.Get((client + request) % 2 == 0 ? jsonRpcUrl : fileUrl, result))
+            ++failed;
+          clientLatencies.emplace_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - requestBegin).count());
+        }
+
+        std::unique_lock<std::mutex> lock(latenciesMutex);
+        latencies.insert(latencies.end(), clientLatencies.begin(), clientLatencies.end());
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    running = false;
+    sampler.join();
+    advancedSettings->m_webserverThreadPool = oldThreadPool;
+
+    EXPECT_EQ(0u, failed);
+    ASSERT_EQ(clients * requestsPerClient, latencies.size());
+    std::sort(latencies.begin(), latencies.end());
+    RecordProperty("requestsPerSecond", static_cast<int>(latencies.size() / seconds));
+    RecordProperty("p99Microseconds", static_cast<int>(latencies[latencies.size() * 99 / 100] * 1000));
+    RecordProperty("maxThreads", maxThreads);
+  }
+
   CWebServer webserver;
   CHTTPJsonRpcHandler m_jsonRpcHandler;
   CHTTPVfsHandler m_vfsHandler;
+  CHTTPImageTransformationHandler m_imageTransformationHandler;
   std::string baseUrl;
   std::string sourcePath;
   uint16_t webserverPort;
@@ -406,6 +507,32 @@ TEST_F(TestWebServer, CanReadDataOverJsonRpcWithHttpGet)
   JSONRPC::CJSONRPC::Cleanup();
 }
 
+TEST_F(TestWebServer, CanReadDataOverJsonRpcWithJsonp)
+{
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrl(TEST_URL_JSONRPC "?jsonp=callback&request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 }")), result));
+
+  // the streamed response is wrapped into the callback
+  ASSERT_TRUE(StringUtils::StartsWith(result, "callback("));
+  ASSERT_TRUE(StringUtils::EndsWith(result, ");"));
+
+  CVariant resultObj;
+  ASSERT_TRUE(CJSONVariantParser::Parse(result.substr(9, result.size() - 11), resultObj));
+  EXPECT_TRUE(resultObj.isObject());
+  EXPECT_TRUE(resultObj.isMember("result"));
+
+  // notifications get an empty response
+  ASSERT_TRUE(curl.Get(GetUrl(TEST_URL_JSONRPC "?request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\" }")), result));
+  EXPECT_TRUE(result.empty());
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+}
+
 TEST_F(TestWebServer, CannotModifyOverJsonRpcWithHttpGet)
 {
   // initialized JSON-RPC
@@ -696,6 +823,85 @@ TEST_F(TestWebServer, CanGetCachedFileWithNewerIfUnmodifiedSince)
   CheckRangesTestFileResponse(curl);
 }
 
+TEST_F(TestWebServer, CanGetFileWithETag)
+{
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+
+  // the entity tag is a quoted string
+  std::string eTag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_GT(eTag.size(), 2U);
+  EXPECT_EQ('"', eTag.front());
+  EXPECT_EQ('"', eTag.back());
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithMatchingIfNoneMatch)
+{
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  std::string eTag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(eTag.empty());
+
+  // get the file with the entity tag of the previous response
+  result.clear();
+  CCurlFile curlCached;
+  curlCached.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curlCached.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, eTag);
+  curlCached.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result);
+  EXPECT_TRUE(result.empty());
+
+  const CHttpHeader& httpHeader = curlCached.GetHttpHeader();
+  EXPECT_NE(std::string::npos, httpHeader.GetProtoLine().find(StringUtils::Format(" %d ", MHD_HTTP_NOT_MODIFIED)));
+  EXPECT_STREQ(eTag.c_str(), httpHeader.GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithOtherIfNoneMatch)
+{
+  // get the file with an entity tag which doesn't match
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\"");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curl);
+}
+
+TEST_F(TestWebServer, CanGetCachedFileWithMatchingIfMatch)
+{
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  std::string eTag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(eTag.empty());
+
+  // get the file with the entity tag of the previous response
+  result.clear();
+  CCurlFile curlMatch;
+  curlMatch.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curlMatch.SetRequestHeader(MHD_HTTP_HEADER_IF_MATCH, eTag);
+  ASSERT_TRUE(curlMatch.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curlMatch);
+}
+
+TEST_F(TestWebServer, CanNotGetCachedFileWithOtherIfMatch)
+{
+  // get the file with an entity tag which doesn't match
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  curl.SetRequestHeader(MHD_HTTP_HEADER_IF_MATCH, "\"other\"");
+  ASSERT_FALSE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+}
+
 TEST_F(TestWebServer, CanGetRangedFileRange0_)
 {
   const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
@@ -897,3 +1103,97 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
 }
+
+TEST_F(TestWebServer, LoadThreadPerConnection)
+{
+  RunLoad(false, 32, 50);
+}
+
+TEST_F(TestWebServer, LoadThreadPool)
+{
+  RunLoad(true, 32, 50);
+}
+
+TEST_F(TestWebServer, CanGetTransformedImage)
+{
+  // the first request transforms the image
+  std::string transformed;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(16), transformed));
+  ASSERT_FALSE(transformed.empty());
+  EXPECT_STREQ("image/png", curl.GetHttpHeader().GetMimeType().c_str());
+  std::string eTag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(eTag.empty());
+
+  // the second request is served from the cache
+  std::string cached;
+  CCurlFile curlCached;
+  ASSERT_TRUE(curlCached.Get(GetUrlOfTransformedTestImage(16), cached));
+  EXPECT_EQ(transformed, cached);
+  EXPECT_STREQ(eTag.c_str(), curlCached.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+
+  // a different transformation results in a different entity tag
+  std::string other;
+  CCurlFile curlOther;
+  ASSERT_TRUE(curlOther.Get(GetUrlOfTransformedTestImage(8), other));
+  EXPECT_STRNE(eTag.c_str(), curlOther.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+}
+
+TEST_F(TestWebServer, CanGetRangeOfCachedTransformedImage)
+{
+  std::string transformed;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(24), transformed));
+  ASSERT_GT(transformed.size(), 16u);
+
+  // the cached image is sent from its file, a range of it as well
+  std::string result;
+  CCurlFile curlRanged;
+  curlRanged.SetRequestHeader(MHD_HTTP_HEADER_RANGE, GenerateRangeHeaderValue(4, 15));
+  ASSERT_TRUE(curlRanged.Get(GetUrlOfTransformedTestImage(24), result));
+  EXPECT_EQ(transformed.substr(4, 12), result);
+  EXPECT_STREQ(HttpRangeUtils::GenerateContentRangeHeaderValue(4, 15, transformed.size()).c_str(),
+               curlRanged.GetHttpHeader().GetValue(MHD_HTTP_HEADER_CONTENT_RANGE).c_str());
+  EXPECT_STREQ("image/png", curlRanged.GetHttpHeader().GetMimeType().c_str());
+}
+
+TEST_F(TestWebServer, LoadTransformedImages)
+{
+  const unsigned int clients = 8;
+  const unsigned int imagesPerClient = 16;
+
+  // every client requests its own set of sizes so the first round has to transform every image
+  // and the second one is served from the cache
+  auto requestsPerSecond = [&](std::vector<std::string>& results) {
+    std::atomic<unsigned int> failed(0);
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int client = 0; client < clients; ++client)
+    {
+      threads.emplace_back([&, client]() {
+        for (unsigned int image = 0; image < imagesPerClient; ++image)
+        {
+          const unsigned int index = client * imagesPerClient + image;
+          CCurlFile curl;
+          if (!curl.Get(GetUrlOfTransformedTestImage(8 + index), results[index]))
+            ++failed;
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    EXPECT_EQ(0u, failed);
+    return static_cast<int>(clients * imagesPerClient / seconds);
+  };
+
+  std::vector<std::string> transformed(clients * imagesPerClient);
+  const int transformedRequestsPerSecond = requestsPerSecond(transformed);
+  std::vector<std::string> cached(clients * imagesPerClient);
+  const int cachedRequestsPerSecond = requestsPerSecond(cached);
+
+  EXPECT_EQ(transformed, cached);
+  RecordProperty("transformedRequestsPerSecond", transformedRequestsPerSecond);
+  RecordProperty("cachedRequestsPerSecond", cachedRequestsPerSecond);
+}
@@ -0,0 +1,207 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "UPnPBrowseCache.h"
+
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
+#include "threads/SingleLock.h"
+#include "video/VideoInfoTag.h"
+
+#include <algorithm>
+
+namespace UPNP
+{
+
+/*----------------------------------------------------------------------
+|   GetItemSize
++---------------------------------------------------------------------*/
+static size_t
+GetItemSize(const CFileItem& item)
+{
+    // the strings of the tags and the art aren't worth walking for an estimate
+    size_t size = sizeof(CFileItemPtr) + sizeof(CFileItem) +
+                  item.GetPath().capacity() + item.GetLabel().capacity();
+    if (item.HasMusicInfoTag())
+        size += sizeof(MUSIC_INFO::CMusicInfoTag);
+    if (item.HasVideoInfoTag())
+        size += sizeof(CVideoInfoTag);
+    if (item.HasPictureInfoTag())
+        size += sizeof(CPictureInfoTag);
+    return size;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::CContainer::CContainer
++---------------------------------------------------------------------*/
+CUPnPBrowseCache::CContainer::CContainer(std::unique_ptr<CFileItemList> items, size_t maximumSize) :
+    m_Items(std::move(items)),
+    m_Size(sizeof(CFileItemList)),
+    m_MaximumSize(maximumSize)
+{
+    for (int i = 0; i < m_Items->Size(); ++i)
+        m_Size += GetItemSize(*m_Items->Get(i));
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::CContainer::GetSize
++---------------------------------------------------------------------*/
+size_t
+CUPnPBrowseCache::CContainer::GetSize() const
+{
+    CSingleLock lock(m_Critical);
+    return m_Size;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::CContainer::AppendDidl
++---------------------------------------------------------------------*/
+NPT_Result
+CUPnPBrowseCache::CContainer::AppendDidl(int                index,
+                                         const std::string& variant,
+                                         const DidlBuilder& builder,
+                                         NPT_String&        didl)
+{
+    // building an object updates the item so it must not be built twice at once
+    CSingleLock lock(m_Critical);
+
+    auto objects = m_Objects.find(variant);
+    if (objects == m_Objects.end()) {
+        // every variant has an object for each item, whether it's built or not
+        const size_t size = m_Items->Size() * sizeof(Object);
+        if (m_Objects.size() < MAXIMUM_VARIANTS && m_Size + size <= m_MaximumSize) {
+            objects = m_Objects.emplace(variant, std::vector<Object>(m_Items->Size())).first;
+            m_Size += size;
+        }
+    }
+
+    // objects of variants that didn't fit are built every time
+    Object* object = nullptr;
+    if (objects != m_Objects.end()) {
+        object = &objects->second[index];
+        if (object->built) {
+            if (NPT_SUCCEEDED(object->result))
+                AppendString(didl, object->didl);
+            return object->result;
+        }
+    }
+
+    NPT_String tmp;
+    NPT_Result result = builder(m_Items->Get(index), tmp);
+    if (NPT_SUCCEEDED(result))
+        AppendString(didl, tmp);
+
+    // keep the object unless the container has grown too big, other errors may be temporary
+    if (object && (NPT_SUCCEEDED(result) || result == NPT_ERROR_NO_SUCH_ITEM) &&
+        m_Size + tmp.GetLength() <= m_MaximumSize) {
+        m_Size += tmp.GetLength();
+        object->built = true;
+        object->result = result;
+        object->didl = tmp;
+    }
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::CUPnPBrowseCache
++---------------------------------------------------------------------*/
+CUPnPBrowseCache::CUPnPBrowseCache(size_t maximumContainers, size_t maximumSize) :
+    m_MaximumContainers(maximumContainers),
+    m_MaximumSize(maximumSize)
+{
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::Get
++---------------------------------------------------------------------*/
+std::shared_ptr<CUPnPBrowseCache::CContainer>
+CUPnPBrowseCache::Get(const std::string& id)
+{
+    CSingleLock lock(m_Critical);
+
+    for (auto container = m_Containers.begin(); container != m_Containers.end(); ++container) {
+        if (container->first == id) {
+            m_Containers.splice(m_Containers.begin(), m_Containers, container);
+
+            // the containers grew as their objects were built
+            Shrink();
+            return m_Containers.front().second;
+        }
+    }
+
+    return nullptr;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::Add
++---------------------------------------------------------------------*/
+std::shared_ptr<CUPnPBrowseCache::CContainer>
+CUPnPBrowseCache::Add(const std::string& id, std::unique_ptr<CFileItemList> items)
+{
+    // a container may take the whole cache, the others are evicted as it grows
+    std::shared_ptr<CContainer> container = std::make_shared<CContainer>(std::move(items), m_MaximumSize);
+    if (container->GetSize() > m_MaximumSize)
+        return container;
+
+    CSingleLock lock(m_Critical);
+
+    // another request might have retrieved the same container in the meantime
+    m_Containers.remove_if([&id](const std::pair<std::string, std::shared_ptr<CContainer> >& cached) {
+        return cached.first == id;
+    });
+
+    // containers still used by a response are only released afterwards
+    m_Containers.emplace_front(id, container);
+    Shrink();
+
+    return container;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::Shrink
++---------------------------------------------------------------------*/
+void
+CUPnPBrowseCache::Shrink()
+{
+    size_t size = 0;
+    for (const auto& container : m_Containers)
+        size += container.second->GetSize();
+
+    // the most recently used container always fits
+    while (m_Containers.size() > 1 &&
+           (m_Containers.size() > m_MaximumContainers || size > m_MaximumSize)) {
+        size -= std::min(size, m_Containers.back().second->GetSize());
+        m_Containers.pop_back();
+    }
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::Clear
++---------------------------------------------------------------------*/
+void
+CUPnPBrowseCache::Clear()
+{
+    CSingleLock lock(m_Critical);
+    m_Containers.clear();
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPBrowseCache::AppendString
++---------------------------------------------------------------------*/
+void
+CUPnPBrowseCache::AppendString(NPT_String& didl, const NPT_String& tmp)
+{
+    // Neptunes string growing is dead slow for small additions
+    if (didl.GetCapacity() < tmp.GetLength() + didl.GetLength()) {
+        didl.Reserve((tmp.GetLength() + didl.GetLength())*2);
+    }
+    didl += tmp;
+}
+
+} /* namespace UPNP */
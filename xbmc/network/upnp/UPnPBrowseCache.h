@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Neptune/Source/Core/NptResults.h>
+#include <Neptune/Source/Core/NptStrings.h>
+
+namespace UPNP
+{
+
+/*!
+ \brief Cache of the children of browsed containers and of the DIDL-Lite
+ built for them.
+
+ A control point paging through a container only has the items of the
+ container retrieved once and every object built once. The items, the objects
+ of every variant and their DIDL-Lite all count towards the size of the cache,
+ containers too big for it are only used for the response they were retrieved
+ for. The cache has to be cleared whenever the library changes.
+ */
+class CUPnPBrowseCache
+{
+public:
+    /*!
+     \brief Builds the DIDL-Lite of an item.
+     \return NPT_ERROR_NO_SUCH_ITEM if the item must be hidden from the client
+     */
+    typedef std::function<NPT_Result(const CFileItemPtr& item, NPT_String& didl)> DidlBuilder;
+
+    class CContainer
+    {
+    public:
+        //! variants of a container whose objects are kept, objects of others are built every time
+        static const size_t MAXIMUM_VARIANTS = 4;
+
+        CContainer(std::unique_ptr<CFileItemList> items, size_t maximumSize);
+
+        const CFileItemList& GetItems() const { return *m_Items; }
+
+        /*!
+         \brief Returns the memory the items, objects and DIDL-Lite of the container take at least.
+         */
+        size_t GetSize() const;
+
+        /*!
+         \brief Appends the DIDL-Lite of an item, building it if it isn't cached yet.
+         \param index Index of the item in the container
+         \param variant Everything besides the item the DIDL-Lite depends on (filter, client, ...)
+         \param builder Builds the DIDL-Lite of the item
+         \param didl DIDL-Lite to append to
+         \return NPT_ERROR_NO_SUCH_ITEM if the item must be hidden from the client
+         */
+        NPT_Result AppendDidl(int                index,
+                              const std::string& variant,
+                              const DidlBuilder& builder,
+                              NPT_String&        didl);
+
+    private:
+        struct Object
+        {
+            bool       built = false;
+            NPT_Result result = NPT_SUCCESS;
+            NPT_String didl;
+        };
+
+        mutable CCriticalSection m_Critical;
+        std::unique_ptr<CFileItemList> m_Items;
+        std::map<std::string, std::vector<Object> > m_Objects;
+        size_t m_Size;
+        size_t m_MaximumSize;
+    };
+
+    explicit CUPnPBrowseCache(size_t maximumContainers = 4, size_t maximumSize = 16 * 1024 * 1024);
+
+    /*!
+     \brief Returns the cached container with the given id or nullptr.
+     */
+    std::shared_ptr<CContainer> Get(const std::string& id);
+
+    /*!
+     \brief Caches the given children of a container.
+     \return The container, not cached if it's too big for the cache
+     */
+    std::shared_ptr<CContainer> Add(const std::string& id, std::unique_ptr<CFileItemList> items);
+
+    /*!
+     \brief Removes all cached containers.
+     */
+    void Clear();
+
+    /*!
+     \brief Appends to a DIDL-Lite string, growing it geometrically.
+     */
+    static void AppendString(NPT_String& didl, const NPT_String& tmp);
+
+private:
+    void Shrink();
+
+    CCriticalSection m_Critical;
+    std::list<std::pair<std::string, std::shared_ptr<CContainer> > > m_Containers; // most recently used first
+    size_t m_MaximumContainers;
+    size_t m_MaximumSize;
+};
+
+} /* namespace UPNP */
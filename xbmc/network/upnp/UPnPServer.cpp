@@ -120,6 +120,9 @@ CUPnPServer::SetupServices()
 void
 CUPnPServer::OnScanCompleted(int type)
 {
+    // a library change can show in any of the library containers
+    m_BrowseCache.Clear();
+
     if (type == AudioLibrary) {
         for (const char* const audio_container : audio_containers)
             UpdateContainer(audio_container);
@@ -431,6 +434,11 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
         }
     }
     else {
+        // whatever the item is, and even if it can't be looked up anymore, the library
+        // changed and any of the cached library containers may show it
+        if (flag == VideoLibrary || flag == AudioLibrary)
+            m_BrowseCache.Clear();
+
         // handle both updates & removals
         if (!data["item"].isNull()) {
             item_id = (int)data["item"]["id"].asInteger();
@@ -633,8 +641,7 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
                                     const char*                   sort_criteria,
                                     const PLT_HttpRequestContext& context)
 {
-    CFileItemList items;
-    NPT_String    parent_id = TranslateWMPObjectId(object_id);
+    NPT_String parent_id = TranslateWMPObjectId(object_id);
 
     CLog::Log(LOGINFO, "UPnP: Received Browse DirectChildren request for object '%s', with sort criteria %s", object_id, sort_criteria);
 
@@ -643,6 +650,62 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
         return NPT_FAILURE;
     }
 
+    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
+    // we want the engine to determine the best parent id, not necessarily the one
+    // passed
+    NPT_String action_name = action->GetActionDesc().GetName();
+    const char* response_parent_id = (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars();
+
+    // the songs, albums and artists of the library are too many to keep around,
+    // only the requested page of them is retrieved from the database
+    NPT_UInt32 page_count = (requested_count == 0)?m_MaxReturnedItems:std::min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
+    CFileItemList page;
+    if (GetChildrenPage(parent_id, starting_index, page_count, page)) {
+        int total = page.GetProperty("total").isNull() ? page.Size() : (int)page.GetProperty("total").asInteger();
+        // the database returns every item if the page starts past them
+        if (starting_index >= (NPT_UInt32)total)
+            page.ClearItems();
+
+        return BuildResponse(action, page, filter, 0, requested_count, sort_criteria, context,
+                             response_parent_id, nullptr, total);
+    }
+
+    // other library containers are kept until the library changes, so paging through
+    // them doesn't retrieve all of their items again for every page
+    std::string container_id((const char*)parent_id);
+    bool cacheable = URIUtils::IsMusicDb(container_id) || URIUtils::IsVideoDb(container_id) ||
+                     StringUtils::StartsWithNoCase(container_id, "library://video/");
+    std::shared_ptr<CUPnPBrowseCache::CContainer> container;
+    if (cacheable)
+        container = m_BrowseCache.Get(container_id);
+
+    std::unique_ptr<CFileItemList> items;
+    if (!container) {
+        items.reset(new CFileItemList);
+        GetChildren(parent_id, *items);
+
+        if (cacheable)
+            container = m_BrowseCache.Add(container_id, std::move(items));
+    }
+
+    return BuildResponse(
+        action,
+        container ? container->GetItems() : *items,
+        filter,
+        starting_index,
+        requested_count,
+        sort_criteria,
+        context,
+        response_parent_id,
+        container);
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetChildren
++---------------------------------------------------------------------*/
+void
+CUPnPServer::GetChildren(const NPT_String& parent_id, CFileItemList& items)
+{
     items.SetPath(std::string(parent_id));
 
     // guard against loading while saving to the same cache file
@@ -706,19 +769,61 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
       }
     }
 
-    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
-    // we want the engine to determine the best parent id, not necessarily the one
-    // passed
-    NPT_String action_name = action->GetActionDesc().GetName();
-    return BuildResponse(
-        action,
-        items,
-        filter,
-        starting_index,
-        requested_count,
-        sort_criteria,
-        context,
-        (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars());
+    // this isn't pretty but needed to properly hide the addons node from clients
+    if (StringUtils::StartsWith(items.GetPath(), "library")) {
+        for (int i=0; i<items.Size(); i++) {
+            if (StringUtils::StartsWith(items[i]->GetPath(), "addons") ||
+                StringUtils::EndsWith(items[i]->GetPath(), "/addons.xml/"))
+                items.Remove(i);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetChildrenPage
++---------------------------------------------------------------------*/
+bool
+CUPnPServer::GetChildrenPage(const NPT_String& parent_id, NPT_UInt32 start, NPT_UInt32 count, CFileItemList& items)
+{
+    std::string path((const char*)parent_id);
+    if (!URIUtils::IsMusicDb(path))
+        return false;
+
+    MUSICDATABASEDIRECTORY::NODE_TYPE type = CMusicDatabaseDirectory::GetDirectoryChildType(path);
+    if (type != MUSICDATABASEDIRECTORY::NODE_TYPE_SONG &&
+        type != MUSICDATABASEDIRECTORY::NODE_TYPE_ALBUM &&
+        type != MUSICDATABASEDIRECTORY::NODE_TYPE_ARTIST)
+        return false;
+
+    CMusicDatabase database;
+    if (!database.Open())
+        return false;
+
+    // pages are sorted the way the whole container is
+    items.SetPath(path);
+    SortDescription sorting;
+    CGUIViewState* viewState = CGUIViewState::GetViewState(-1, items);
+    if (viewState) {
+        sorting = viewState->GetSortMethod();
+        delete viewState;
+    }
+    sorting.limitStart = start;
+    sorting.limitEnd = start + count;
+
+    bool result;
+    if (type == MUSICDATABASEDIRECTORY::NODE_TYPE_SONG) {
+        result = database.GetSongsNav(path, items, -1, -1, -1, sorting);
+    } else if (type == MUSICDATABASEDIRECTORY::NODE_TYPE_ALBUM) {
+        result = database.GetAlbumsNav(path, items, -1, -1, CDatabase::Filter(), sorting);
+    } else {
+        bool albumArtistsOnly = !CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MUSICLIBRARY_SHOWCOMPILATIONARTISTS);
+        result = database.GetArtistsNav(path, items, albumArtistsOnly, -1, -1, -1, CDatabase::Filter(), sorting);
+    }
+
+    // still answered, just without any children
+    if (!result)
+        items.Clear();
+    return true;
 }
 
 /*----------------------------------------------------------------------
@@ -726,13 +831,15 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
 +---------------------------------------------------------------------*/
 NPT_Result
 CUPnPServer::BuildResponse(PLT_ActionReference&          action,
-                           CFileItemList&                items,
+                           const CFileItemList&          items,
                            const char*                   filter,
                            NPT_UInt32                    starting_index,
                            NPT_UInt32                    requested_count,
                            const char*                   sort_criteria,
                            const PLT_HttpRequestContext& context,
-                           const char*                   parent_id /* = NULL */)
+                           const char*                   parent_id /* = NULL */,
+                           const std::shared_ptr<CUPnPBrowseCache::CContainer>& container /* = nullptr */,
+                           int                           total_matches /* = -1 */)
 {
     NPT_COMPILER_UNUSED(sort_criteria);
 
@@ -741,31 +848,48 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
         starting_index,
         requested_count);
 
-    // we will reuse this ThumbLoader for all items
+    // we will reuse this ThumbLoader for all items, it's only needed
+    // if some of the objects haven't been built before
     NPT_Reference<CThumbLoader> thumb_loader;
+    bool thumb_loader_started = false;
 
-    if (URIUtils::IsVideoDb(items.GetPath()) ||
-        StringUtils::StartsWithNoCase(items.GetPath(), "library://video/") ||
-        StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/video/")) {
-
-        thumb_loader = NPT_Reference<CThumbLoader>(new CVideoThumbLoader());
-    }
-    else if (URIUtils::IsMusicDb(items.GetPath()) ||
-        StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/music/")) {
+    CUPnPBrowseCache::DidlBuilder builder = [&](const CFileItemPtr& item, NPT_String& didl) -> NPT_Result {
+        if (!thumb_loader_started) {
+            thumb_loader_started = true;
+            if (URIUtils::IsVideoDb(items.GetPath()) ||
+                StringUtils::StartsWithNoCase(items.GetPath(), "library://video/") ||
+                StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/video/")) {
 
-        thumb_loader = NPT_Reference<CThumbLoader>(new CMusicThumbLoader());
-    }
-    if (!thumb_loader.IsNull()) {
-        thumb_loader->OnLoaderStart();
-    }
+                thumb_loader = NPT_Reference<CThumbLoader>(new CVideoThumbLoader());
+            }
+            else if (URIUtils::IsMusicDb(items.GetPath()) ||
+                StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/music/")) {
 
-    // this isn't pretty but needed to properly hide the addons node from clients
-    if (StringUtils::StartsWith(items.GetPath(), "library")) {
-        for (int i=0; i<items.Size(); i++) {
-            if (StringUtils::StartsWith(items[i]->GetPath(), "addons") ||
-                StringUtils::EndsWith(items[i]->GetPath(), "/addons.xml/"))
-                items.Remove(i);
+                thumb_loader = NPT_Reference<CThumbLoader>(new CMusicThumbLoader());
+            }
+            if (!thumb_loader.IsNull()) {
+                thumb_loader->OnLoaderStart();
+            }
         }
+
+        PLT_MediaObjectReference object(Build(item, true, context, thumb_loader, parent_id));
+        if (object.IsNull())
+            return NPT_ERROR_NO_SUCH_ITEM;
+
+        return PLT_Didl::ToDidl(*object.AsPointer(), filter, didl);
+    };
+
+    // the DIDL-Lite of an object depends on the filter, the parent and the client
+    std::string variant;
+    if (container) {
+        const NPT_String* user_agent = context.GetRequest().GetHeaders().GetHeaderValue(NPT_HTTP_HEADER_USER_AGENT);
+        const NPT_String* server = context.GetRequest().GetHeaders().GetHeaderValue(NPT_HTTP_HEADER_SERVER);
+        variant = StringUtils::Format("%s\n%s\n%s\n%s\n%s",
+                                      filter ? filter : "",
+                                      parent_id ? parent_id : "",
+                                      (const char*)context.GetLocalAddress().ToString(),
+                                      user_agent ? (const char*)*user_agent : "",
+                                      server ? (const char*)*server : "");
     }
 
     // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
@@ -774,25 +898,25 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     NPT_UInt32 stop_index = std::min((unsigned long)(starting_index + max_count), (unsigned long)items.Size()); // don't return more than we can
 
     NPT_Cardinal count = 0;
-    NPT_Cardinal total = items.Size();
+    NPT_Cardinal total = (total_matches < 0) ? items.Size() : total_matches;
     NPT_String didl = didl_header;
-    PLT_MediaObjectReference object;
     for (unsigned long i=starting_index; i<stop_index; ++i) {
-        object = Build(items[i], true, context, thumb_loader, parent_id);
-        if (object.IsNull()) {
+        NPT_Result result;
+        if (container) {
+            result = container->AppendDidl(i, variant, builder, didl);
+        } else {
+            NPT_String tmp;
+            result = builder(items[i], tmp);
+            if (NPT_SUCCEEDED(result))
+                CUPnPBrowseCache::AppendString(didl, tmp);
+        }
+
+        if (result == NPT_ERROR_NO_SUCH_ITEM) {
             // don't tell the client this item ever existed
             --total;
             continue;
         }
-
-        NPT_String tmp;
-        NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
-
-        // Neptunes string growing is dead slow for small additions
-        if (didl.GetCapacity() < tmp.GetLength() + didl.GetLength()) {
-            didl.Reserve((tmp.GetLength() + didl.GetLength())*2);
-        }
-        didl += tmp;
+        NPT_CHECK(result);
         ++count;
     }
 
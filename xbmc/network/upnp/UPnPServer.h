@@ -9,8 +9,10 @@
 #pragma once
 
 #include "FileItem.h"
+#include "UPnPBrowseCache.h"
 #include "interfaces/IAnnouncer.h"
 
+#include <memory>
 #include <utility>
 
 #include <Platinum/Source/Devices/MediaConnect/PltMediaConnect.h>
@@ -94,6 +96,17 @@ public:
        It's a way to store subtitle uri generated when building didl, to use later in http response*/
     NPT_Result AddSubtitleUriForSecResponse(NPT_String movie_md5, NPT_String subtitle_uri);
 
+protected:
+    virtual void GetChildren(const NPT_String& parent_id, CFileItemList& items);
+
+    /*!
+     \brief Retrieves a page of the songs, albums or artists of the music library from the database.
+     \param start Index of the first child of the page
+     \param count Number of children in the page
+     \param items The children of the page, their "total" property is the number of children of the container
+     \return false if the container isn't one of songs, albums or artists
+     */
+    virtual bool GetChildrenPage(const NPT_String& parent_id, NPT_UInt32 start, NPT_UInt32 count, CFileItemList& items);
 
 private:
     void OnScanCompleted(int type);
@@ -106,13 +119,15 @@ private:
                            NPT_Reference<CThumbLoader>&  thumbLoader,
                            const char*                   parent_id = NULL);
     NPT_Result BuildResponse(PLT_ActionReference&          action,
-                             CFileItemList&                items,
+                             const CFileItemList&          items,
                              const char*                   filter,
                              NPT_UInt32                    starting_index,
                              NPT_UInt32                    requested_count,
                              const char*                   sort_criteria,
                              const PLT_HttpRequestContext& context,
-                             const char*                   parent_id /* = NULL */);
+                             const char*                   parent_id /* = NULL */,
+                             const std::shared_ptr<CUPnPBrowseCache::CContainer>& container = nullptr,
+                             int                           total_matches = -1);
 
     // class methods
     static bool SortItems(CFileItemList& items, const char* sort_criteria);
@@ -125,6 +140,7 @@ private:
     }
 
     NPT_Mutex m_CacheMutex;
+    CUPnPBrowseCache m_BrowseCache;
 
     NPT_Mutex m_FileMutex;
     NPT_Map<NPT_String, NPT_String> m_FileMap;
@@ -22,6 +22,7 @@
 #include "GUIDialogPictureInfo.h"
 #include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -40,6 +41,7 @@
 #ifdef TARGET_POSIX
 #include "platform/posix/XTimeUtils.h"
 #endif
+#include <algorithm>
 #include <random>
 
 using namespace XFILE;
@@ -70,6 +72,7 @@ CBackgroundPicLoader::CBackgroundPicLoader()
   , m_maxWidth{0}
   , m_maxHeight{0}
   , m_isLoading{false}
+  , m_preloader{static_cast<size_t>(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_slideshowDecodeCache) * 1024 * 1024}
   , m_pCallback{nullptr}
 {
 }
@@ -97,7 +100,9 @@ void CBackgroundPicLoader::Process()
       if (m_pCallback)
       {
         unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
+        CBaseTexture* texture = m_preloader.Take(m_strFileName, m_maxWidth, m_maxHeight);
+        if (!texture)
+          texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
         totalTime += XbmcThreads::SystemClockMillis() - start;
         count++;
         // tell our parent
@@ -223,6 +228,9 @@ void CGUIWindowSlideShow::Reset()
   m_iCurrentPic = 0;
   m_iDirection = 1;
   m_iLastFailedNextSlide = -1;
+  m_iPrefetchSlide = -1;
+  m_iPrefetchDirection = 0;
+  m_iReloadSlide = -1;
   m_slides.clear();
   AnnouncePlaylistClear();
   m_Resolution = CServiceBroker::GetWinSystem()->GetGfxContext().GetVideoResolution();
@@ -250,6 +258,7 @@ void CGUIWindowSlideShow::OnDeinitWindow(int nextWindowID)
       CLog::Log(LOGDEBUG,"Stopping BackgroundLoader thread");
       m_pBackgroundLoader->StopThread();
       m_pBackgroundLoader.reset();
+      m_iPrefetchSlide = -1;
     }
     // and close the images.
     m_Image[0].Close();
@@ -390,6 +399,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
   {
     m_pBackgroundLoader.reset(new CBackgroundPicLoader());
     m_pBackgroundLoader->Create(this);
+    m_iPrefetchSlide = -1;
   }
 
   bool bSlideShow = m_bSlideShow && !m_bPause && !m_bPlayingVideo;
@@ -462,6 +472,14 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     return;
   }
 
+  // decode the pictures around the current one ahead of time, dropping the others
+  if (m_iCurrentSlide != m_iPrefetchSlide || m_iDirection != m_iPrefetchDirection)
+  {
+    int maxWidth, maxHeight;
+    GetDecodeSize(m_iCurrentSlide, res, maxWidth, maxHeight);
+    Prefetch(maxWidth, maxHeight);
+  }
+
   if (!m_Image[m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading())
   { // load first image
     CFileItemPtr item = m_slides.at(m_iCurrentSlide);
@@ -475,16 +493,37 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
 
       // load using the background loader
       int maxWidth, maxHeight;
-
-      GetCheckedSize((float)res.iWidth * m_fZoom,
-        (float)res.iHeight * m_fZoom,
-        maxWidth, maxHeight);
+      if (m_fZoom > 1.0f)
+        GetCheckedSize((float)res.iWidth * m_fZoom,
+          (float)res.iHeight * m_fZoom,
+          maxWidth, maxHeight);
+      else
+        GetDecodeSize(m_iCurrentSlide, res, maxWidth, maxHeight);
       m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, maxWidth, maxHeight);
       m_iLastFailedNextSlide = -1;
       m_bLoadNextPic = false;
     }
   }
 
+  // pictures are decoded at the size they're shown at, but zooming in and panning across
+  // panoramas need all the detail there is
+  if (m_Image[m_iCurrentPic].IsLoaded() && !m_Image[m_iCurrentPic].FullSize() &&
+      (m_fZoom > 1.0f || m_Image[m_iCurrentPic].DisplayEffect() == CSlideShowPic::EFFECT_PANORAMA) &&
+      m_iReloadSlide != m_iCurrentSlide && !m_pBackgroundLoader->IsLoading())
+  {
+    CFileItemPtr item = m_slides.at(m_iCurrentSlide);
+    std::string picturePath = GetPicturePath(item.get());
+    if (!picturePath.empty())
+    {
+      CLog::Log(LOGDEBUG, "Reloading the current image %d at full size: %s", m_iCurrentSlide, item->GetPath().c_str());
+      const float maxSize = static_cast<float>(CServiceBroker::GetRenderSystem()->GetMaxTextureSize());
+      int maxWidth, maxHeight;
+      GetCheckedSize(maxSize, maxSize, maxWidth, maxHeight);
+      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, maxWidth, maxHeight);
+    }
+    m_iReloadSlide = m_iCurrentSlide;
+  }
+
   // check if we should discard an already loaded next slide
   if (m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() != m_iNextSlide)
     m_Image[1 - m_iCurrentPic].Close();
@@ -501,10 +540,9 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
       else
         CLog::Log(LOGDEBUG, "Loading the next image %d: %s", m_iNextSlide, item->GetPath().c_str());
 
+      // the next image is shown unzoomed, and was likely decoded ahead at that size
       int maxWidth, maxHeight;
-      GetCheckedSize((float)res.iWidth * m_fZoom,
-                     (float)res.iHeight * m_fZoom,
-                     maxWidth, maxHeight);
+      GetDecodeSize(m_iNextSlide, res, maxWidth, maxHeight);
       m_pBackgroundLoader->LoadPic(1 - m_iCurrentPic, m_iNextSlide, picturePath, maxWidth, maxHeight);
     }
   }
@@ -599,6 +637,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
       }
       m_iCurrentSlide = m_iNextSlide;
       m_iNextSlide    = GetNextSlide();
+      m_iReloadSlide  = -1;
 
       bPlayVideo = m_slides.at(m_iCurrentSlide)->IsVideo() && m_iVideoSlide != m_iCurrentSlide;
     }
@@ -1145,6 +1184,14 @@ void CGUIWindowSlideShow::OnLoadPic(int iPic, int iSlideNumber, const std::strin
       delete pTexture;
       return;
     }
+    if (iSlideNumber == m_iReloadSlide && m_Image[iPic].IsLoaded() && m_Image[iPic].SlideNumber() == iSlideNumber)
+    { // the full size version of the picture being shown
+      CLog::Log(LOGDEBUG, "Finished reloading slot %d, %d: %s", iPic, iSlideNumber, m_slides.at(iSlideNumber)->GetPath().c_str());
+      m_Image[iPic].UpdateTexture(pTexture);
+      m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
+      MarkDirtyRegion();
+      return;
+    }
     CLog::Log(LOGDEBUG, "Finished background loading slot %d, %d: %s", iPic, iSlideNumber, m_slides.at(iSlideNumber)->GetPath().c_str());
     m_Image[iPic].SetTexture(iSlideNumber, pTexture, GetDisplayEffect(iSlideNumber));
     m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
@@ -1295,8 +1342,45 @@ void CGUIWindowSlideShow::AddItems(const std::string &strPath, path_set *recursi
 
 void CGUIWindowSlideShow::GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight)
 {
-  maxWidth = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
-  maxHeight = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
+  // decode no larger than shown, JPEGs are downscaled while decoding
+  const int maxTextureSize = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
+  maxWidth = std::min(static_cast<int>(width), maxTextureSize);
+  maxHeight = std::min(static_cast<int>(height), maxTextureSize);
+}
+
+void CGUIWindowSlideShow::GetDecodeSize(int slide, const RESOLUTION_INFO &res, int &maxWidth, int &maxHeight)
+{
+  // the zoom and float effects may be picked, which show the picture a little larger than
+  // the screen, and panoramas fill the screen with their shorter side, so the picture may
+  // be as large as the longer side of the screen in either direction
+  if (GetDisplayEffect(slide) == CSlideShowPic::EFFECT_RANDOM)
+  {
+    const int stayTime = CServiceBroker::GetSettingsComponent()->GetSettings()->GetInt(CSettings::SETTING_SLIDESHOW_STAYTIME);
+    const float scale = CSlideShowPic::GetMaxEffectScale(CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS(), stayTime);
+    const float size = std::max(res.iWidth, res.iHeight) * scale;
+    GetCheckedSize(size, size, maxWidth, maxHeight);
+  }
+  else
+    GetCheckedSize((float)res.iWidth, (float)res.iHeight, maxWidth, maxHeight);
+}
+
+void CGUIWindowSlideShow::Prefetch(int maxWidth, int maxHeight)
+{
+  m_iPrefetchSlide = m_iCurrentSlide;
+  m_iPrefetchDirection = m_iDirection;
+
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  std::vector<std::string> paths;
+  for (int slide : CSlideShowPreloader::GetNeighbours(m_iCurrentSlide, m_slides.size(), m_iDirection,
+                                                      advancedSettings->m_slideshowLookAhead,
+                                                      advancedSettings->m_slideshowLookBehind))
+  {
+    // video thumbs are looked up when needed, so only pictures are decoded ahead
+    const CFileItemPtr item = m_slides.at(slide);
+    if (!item->IsVideo() && !item->HasProperty("unplayable"))
+      paths.push_back(item->GetPath());
+  }
+  m_pBackgroundLoader->Prefetch(paths, maxWidth, maxHeight);
 }
 
 std::string CGUIWindowSlideShow::GetPicturePath(CFileItem *item)
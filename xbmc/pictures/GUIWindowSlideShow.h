@@ -9,6 +9,7 @@
 #pragma once
 
 #include "SlideShowPicture.h"
+#include "SlideShowPreloader.h"
 #include "guilib/GUIDialog.h"
 #include "threads/Event.h"
 #include "threads/Thread.h"
@@ -33,6 +34,7 @@ public:
   bool IsLoading() { return m_isLoading;};
   int SlideNumber() const { return m_iSlideNumber; }
   int Pic() const { return m_iPic; }
+  void Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight) { m_preloader.Prefetch(paths, maxWidth, maxHeight); }
 
 private:
   void Process() override;
@@ -44,6 +46,7 @@ private:
 
   CEvent m_loadPic;
   bool m_isLoading;
+  CSlideShowPreloader m_preloader; ///< decodes the pictures around the current one ahead of time
 
   CGUIWindowSlideShow *m_pCallback;
 };
@@ -111,6 +114,8 @@ private:
   void ZoomRelative(float fZoom, bool immediate = false);
   void Move(float fX, float fY);
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
+  void GetDecodeSize(int slide, const RESOLUTION_INFO &res, int &maxWidth, int &maxHeight);
+  void Prefetch(int maxWidth, int maxHeight);
   std::string GetPicturePath(CFileItem *item);
   int  GetNextSlide();
 
@@ -146,6 +151,9 @@ private:
   std::unique_ptr<CBackgroundPicLoader> m_pBackgroundLoader;
   int m_iLastFailedNextSlide;
   bool m_bLoadNextPic;
+  int m_iPrefetchSlide; ///< slide the pictures around it were last prefetched for
+  int m_iPrefetchDirection;
+  int m_iReloadSlide; ///< slide whose picture was reloaded at full size
   RESOLUTION m_Resolution;
   CPoint m_firstGesturePoint;
 };
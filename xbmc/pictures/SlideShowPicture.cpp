@@ -99,6 +99,17 @@ bool CSlideShowPic::DisplayEffectNeedChange(DISPLAY_EFFECT newDispEffect) const
   return true;
 }
 
+float CSlideShowPic::GetMaxEffectScale(float fps, int stayTime)
+{
+  // both grow with the frames a picture is shown for, including its transitions
+  const float fadeTime = std::min(0.2f * stayTime, 3.0f);
+  const float frames = fps * (stayTime + 2 * fadeTime);
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const float zoomScale = 1.0f + 0.0001f * advancedSettings->m_slideshowZoomAmount * frames;
+  const float floatScale = 1.0f + 0.0001f * advancedSettings->m_slideshowPanAmount * frames;
+  return std::max(zoomScale, floatScale);
+}
+
 void CSlideShowPic::SetTexture(int iSlideNumber, CBaseTexture* pTexture, DISPLAY_EFFECT dispEffect, TRANSITION_EFFECT transEffect)
 {
   CSingleLock lock(m_textureAccess);
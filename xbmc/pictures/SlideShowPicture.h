@@ -46,6 +46,12 @@ public:
   void Reset(DISPLAY_EFFECT dispEffect = EFFECT_RANDOM, TRANSITION_EFFECT transEffect = FADEIN_FADEOUT);
   DISPLAY_EFFECT DisplayEffect() const { return m_displayEffect; }
   bool DisplayEffectNeedChange(DISPLAY_EFFECT newDispEffect) const;
+
+  /*! \brief Get the largest scale the zoom and float effects show a picture at, relative to the screen
+   \param fps the frame rate the slideshow is rendered at.
+   \param stayTime the seconds a picture is shown.
+   */
+  static float GetMaxEffectScale(float fps, int stayTime);
   bool IsStarted() const { return m_iCounter > 0; }
   bool IsFinished() const { return m_bIsFinished;};
   bool DrawNextImage() const { return m_bDrawNextImage;};
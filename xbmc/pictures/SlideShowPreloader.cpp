@@ -0,0 +1,286 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SlideShowPreloader.h"
+
+#include "guilib/Texture.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <utility>
+
+struct CSlideShowPreloader::State
+{
+  struct Picture
+  {
+    std::string path;
+    int maxWidth;
+    int maxHeight;
+    unsigned int rank; ///< position in the list of wanted pictures, lower is more wanted
+    unsigned int jobID;
+    bool started;
+    bool decoded;
+    CBaseTexture *texture;
+  };
+
+  std::list<Picture>::iterator Find(const std::string &path, int maxWidth, int maxHeight)
+  {
+    return std::find_if(pictures.begin(), pictures.end(), [&](const Picture &picture) {
+      return picture.path == path && picture.maxWidth == maxWidth && picture.maxHeight == maxHeight;
+    });
+  }
+
+  void Drop(std::list<Picture>::iterator picture)
+  {
+    if (!picture->decoded)
+      CJobManager::GetInstance().CancelJob(picture->jobID);
+    delete picture->texture;
+    pictures.erase(picture);
+  }
+
+  static size_t GetBytes(int maxWidth, int maxHeight)
+  {
+    return static_cast<size_t>(std::max(maxWidth, 1)) * std::max(maxHeight, 1) * 4;
+  }
+
+  static size_t GetBytes(const Picture &picture)
+  {
+    if (!picture.decoded)
+      return GetBytes(picture.maxWidth, picture.maxHeight);
+    return picture.texture ? static_cast<size_t>(picture.texture->GetPitch()) * picture.texture->GetRows() : 0;
+  }
+
+  size_t GetBytes() const
+  {
+    size_t bytes = 0;
+    for (const auto& picture : pictures)
+      bytes += GetBytes(picture);
+    return bytes;
+  }
+
+  /*! \brief Start decoding the wanted pictures that fit under the cap, nearest first
+   */
+  void Admit(const std::shared_ptr<State> &self);
+
+  CCriticalSection section;
+  CEvent decoded; ///< set whenever a picture has been decoded
+  std::list<Picture> pictures;
+  std::deque<std::pair<std::string, unsigned int>> waiting; ///< wanted pictures not decoding yet, and their rank
+  int maxWidth = 0;
+  int maxHeight = 0;
+  size_t maxBytes = 0;
+  Decoder decoder;
+};
+
+class CSlideShowPreloader::CDecodeJob : public CJob
+{
+public:
+  CDecodeJob(const std::shared_ptr<State> &state, const std::string &path, int maxWidth, int maxHeight)
+    : m_state(state), m_path(path), m_maxWidth(maxWidth), m_maxHeight(maxHeight)
+  {
+  }
+
+  const char* GetType() const override { return "slideshowdecode"; }
+
+  bool DoWork() override
+  {
+    {
+      CSingleLock lock(m_state->section);
+      auto picture = m_state->Find(m_path, m_maxWidth, m_maxHeight);
+      if (picture == m_state->pictures.end() || picture->started)
+        return false; // dropped, or taken to be decoded by the slideshow itself
+      picture->started = true;
+    }
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    CBaseTexture *texture = m_state->decoder(m_path, m_maxWidth, m_maxHeight);
+    CLog::Log(LOGDEBUG, "CSlideShowPreloader: decoded %s in %u ms", m_path.c_str(), XbmcThreads::SystemClockMillis() - start);
+
+    CSingleLock lock(m_state->section);
+    auto picture = m_state->Find(m_path, m_maxWidth, m_maxHeight);
+    if (picture == m_state->pictures.end() || picture->decoded)
+    { // dropped while we were decoding it
+      delete texture;
+      return false;
+    }
+    picture->decoded = true;
+    picture->texture = texture;
+
+    // the decoded picture is usually smaller than reserved for, unless it doesn't fit
+    // even after dropping the decoded pictures that are less wanted
+    const unsigned int rank = picture->rank;
+    while (m_state->GetBytes() > m_state->maxBytes)
+    {
+      auto leastWanted = m_state->pictures.end();
+      for (auto other = m_state->pictures.begin(); other != m_state->pictures.end(); ++other)
+      {
+        if (other->decoded && other->texture && other->rank >= rank &&
+            (leastWanted == m_state->pictures.end() || other->rank > leastWanted->rank))
+          leastWanted = other;
+      }
+      if (leastWanted == m_state->pictures.end())
+        break;
+      if (leastWanted != picture)
+      {
+        CLog::Log(LOGDEBUG, "CSlideShowPreloader: dropping %s to make room", leastWanted->path.c_str());
+        m_state->Drop(leastWanted);
+        continue;
+      }
+      CLog::Log(LOGDEBUG, "CSlideShowPreloader: %s doesn't fit, it is decoded again when shown", m_path.c_str());
+      delete picture->texture;
+      picture->texture = nullptr;
+    }
+
+    m_state->Admit(m_state);
+    m_state->decoded.Set();
+    return picture->texture != nullptr;
+  }
+
+private:
+  std::shared_ptr<State> m_state;
+  std::string m_path;
+  int m_maxWidth;
+  int m_maxHeight;
+};
+
+void CSlideShowPreloader::State::Admit(const std::shared_ptr<State> &self)
+{
+  // jobs of the same priority run in the order they were added, so the nearest come first
+  size_t bytes = GetBytes();
+  const size_t pictureBytes = GetBytes(maxWidth, maxHeight);
+  while (!waiting.empty() && bytes + pictureBytes <= maxBytes)
+  {
+    const std::string path = waiting.front().first;
+    const unsigned int rank = waiting.front().second;
+    waiting.pop_front();
+    unsigned int jobID = CJobManager::GetInstance().AddJob(new CDecodeJob(self, path, maxWidth, maxHeight), nullptr, CJob::PRIORITY_LOW);
+    pictures.push_back({ path, maxWidth, maxHeight, rank, jobID, false, false, nullptr });
+    bytes += pictureBytes;
+  }
+}
+
+CSlideShowPreloader::CSlideShowPreloader(size_t maxBytes, Decoder decoder /* = nullptr */)
+  : m_state(std::make_shared<State>())
+{
+  m_state->maxBytes = maxBytes;
+  m_state->decoder = decoder ? std::move(decoder) : [](const std::string &path, int maxWidth, int maxHeight) {
+    return CTexture::LoadFromFile(path, maxWidth, maxHeight);
+  };
+}
+
+CSlideShowPreloader::~CSlideShowPreloader()
+{
+  Clear();
+}
+
+void CSlideShowPreloader::Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_state->section);
+  m_state->maxWidth = maxWidth;
+  m_state->maxHeight = maxHeight;
+  m_state->waiting.clear();
+
+  for (auto picture = m_state->pictures.begin(); picture != m_state->pictures.end();)
+  {
+    auto next = std::next(picture);
+    const auto wanted = std::find(paths.begin(), paths.end(), picture->path);
+    if (picture->maxWidth != maxWidth || picture->maxHeight != maxHeight || wanted == paths.end())
+      m_state->Drop(picture);
+    else
+      picture->rank = static_cast<unsigned int>(std::distance(paths.begin(), wanted));
+    picture = next;
+  }
+
+  for (unsigned int rank = 0; rank < paths.size(); rank++)
+  {
+    if (m_state->Find(paths[rank], maxWidth, maxHeight) == m_state->pictures.end())
+      m_state->waiting.push_back(std::make_pair(paths[rank], rank));
+  }
+  m_state->Admit(m_state);
+}
+
+CBaseTexture* CSlideShowPreloader::Take(const std::string &path, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_state->section);
+  while (true)
+  {
+    auto picture = m_state->Find(path, maxWidth, maxHeight);
+    if (picture == m_state->pictures.end())
+      return nullptr;
+
+    if (picture->decoded)
+    {
+      CBaseTexture *texture = picture->texture;
+      m_state->pictures.erase(picture);
+      m_state->Admit(m_state);
+      return texture;
+    }
+
+    if (!picture->started)
+    { // no worker got to it yet, so don't wait for one
+      m_state->Drop(picture);
+      m_state->Admit(m_state);
+      const Decoder decoder = m_state->decoder;
+      lock.Leave();
+      return decoder(path, maxWidth, maxHeight);
+    }
+
+    // still decoding, which is quicker than starting over
+    CSingleExit exit(m_state->section);
+    m_state->decoded.WaitMSec(100);
+  }
+}
+
+void CSlideShowPreloader::Clear()
+{
+  CSingleLock lock(m_state->section);
+  m_state->waiting.clear();
+  while (!m_state->pictures.empty())
+    m_state->Drop(m_state->pictures.begin());
+}
+
+size_t CSlideShowPreloader::GetBytes() const
+{
+  CSingleLock lock(m_state->section);
+  return m_state->GetBytes();
+}
+
+std::vector<int> CSlideShowPreloader::GetNeighbours(int current, int count, int direction, unsigned int ahead, unsigned int behind)
+{
+  std::vector<int> neighbours;
+  if (count <= 1)
+    return neighbours;
+
+  const int step = direction >= 0 ? 1 : -1;
+  const int distance = static_cast<int>(std::max(ahead, behind));
+  for (int i = 1; i <= distance; i++)
+  {
+    if (i <= static_cast<int>(ahead))
+      neighbours.push_back(((current + step * i) % count + count) % count);
+    if (i <= static_cast<int>(behind))
+      neighbours.push_back(((current - step * i) % count + count) % count);
+  }
+
+  // small slideshows wrap around to the current slide and to slides we already have
+  std::vector<int> unique;
+  for (int slide : neighbours)
+  {
+    if (slide != current && std::find(unique.begin(), unique.end(), slide) == unique.end())
+      unique.push_back(slide);
+  }
+  return unique;
+}
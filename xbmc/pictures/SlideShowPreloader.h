@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+class CBaseTexture;
+
+/*!
+ \brief Decodes the pictures around the current slide ahead of time.
+
+ The neighbours of the current slide are decoded in parallel on the job manager, at the
+ size they are shown at, so browsing through large photos doesn't have to wait for each
+ decode. Pictures that are no longer wanted, e.g. after the direction changed, are dropped
+ and their decoding is cancelled. The memory taken by decoded pictures is capped.
+
+ \sa CBackgroundPicLoader
+ */
+class CSlideShowPreloader
+{
+public:
+  typedef std::function<CBaseTexture*(const std::string &path, int maxWidth, int maxHeight)> Decoder;
+
+  /*!
+   \param maxBytes the most memory the decoded pictures may take.
+   \param decoder decodes a picture, CTexture::LoadFromFile if not given.
+   */
+  explicit CSlideShowPreloader(size_t maxBytes, Decoder decoder = nullptr);
+  ~CSlideShowPreloader();
+
+  /*! \brief Decode the given pictures, dropping all others
+   Pictures being decoded are counted at the size they're decoded at, and decoded ones at the
+   size they turned out to be. Pictures that don't fit under the memory cap wait for memory
+   to be freed, and the least wanted decoded pictures are dropped for more wanted ones.
+   \param paths the pictures to decode, most wanted first.
+   \param maxWidth the largest width to decode at.
+   \param maxHeight the largest height to decode at.
+   */
+  void Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight);
+
+  /*! \brief Take a decoded picture
+   Waits for a picture that is being decoded. A picture whose decoding hasn't started yet,
+   e.g. because all workers are busy, is decoded right away by the caller instead.
+   \param path the picture to take.
+   \param maxWidth the largest width it was decoded at.
+   \param maxHeight the largest height it was decoded at.
+   \return the picture, which the caller owns. nullptr if it wasn't prefetched at this size or failed to decode.
+   */
+  CBaseTexture* Take(const std::string &path, int maxWidth, int maxHeight);
+
+  /*! \brief Drop all pictures, cancelling their decoding
+   */
+  void Clear();
+
+  /*! \brief The memory taken by decoded pictures and reserved for pictures being decoded
+   */
+  size_t GetBytes() const;
+
+  /*! \brief Get the slides to prefetch around the current one, nearest first
+   Slides ahead come before slides behind at the same distance.
+   \param current the current slide.
+   \param count the number of slides, the slideshow wraps around.
+   \param direction the direction of the slideshow, 1 for forward, -1 for backward.
+   \param ahead the number of slides to prefetch in the direction of the slideshow.
+   \param behind the number of slides to prefetch in the opposite direction.
+   \return the slides to prefetch, excluding the current one.
+   */
+  static std::vector<int> GetNeighbours(int current, int count, int direction, unsigned int ahead, unsigned int behind);
+
+private:
+  CSlideShowPreloader(const CSlideShowPreloader&) = delete;
+  CSlideShowPreloader& operator=(const CSlideShowPreloader&) = delete;
+
+  struct State;
+  class CDecodeJob;
+
+  std::shared_ptr<State> m_state; ///< shared with the decode jobs, which may outlive us
+};
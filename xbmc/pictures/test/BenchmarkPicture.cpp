@@ -0,0 +1,132 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+#include "pictures/Picture.h"
+#include "test/TestBasicEnvironment.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// a photo like image, smooth gradients with some detail
+std::vector<uint32_t> CreateImage(unsigned int width, unsigned int height, unsigned int seed)
+{
+  std::vector<uint32_t> pixels(width * height);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      const uint32_t r = (x * 255 / width + seed * 40) & 0xff;
+      const uint32_t g = (y * 255 / height) & 0xff;
+      const uint32_t b = ((x / 16 + y / 16) % 2) ? 0xc0 : 0x40;
+      pixels[y * width + x] = 0xff000000 | (r << 16) | (g << 8) | b;
+    }
+  }
+  return pixels;
+}
+
+// what CTextureCacheJob does for an image that isn't cached yet
+bool CacheImage(const std::string& file, unsigned int loadWidth, unsigned int loadHeight, const std::string& dest)
+{
+  XFILE::CFile imageFile;
+  XUTILS::auto_buffer buffer;
+  if (imageFile.LoadFile(file, buffer) <= 0)
+    return false;
+
+  CFFmpegImage image("image/jpeg");
+  if (!image.LoadImageFromMemory(reinterpret_cast<unsigned char*>(buffer.get()), buffer.size(), loadWidth, loadHeight))
+    return false;
+
+  std::vector<uint32_t> pixels(image.Width() * image.Height());
+  if (!image.Decode(reinterpret_cast<unsigned char*>(pixels.data()), image.Width(), image.Height(),
+                    image.Width() * 4, XB_FMT_A8R8G8B8))
+    return false;
+
+  uint32_t width = 0;
+  uint32_t height = 0;
+  return CPicture::CacheTexture(reinterpret_cast<uint8_t*>(pixels.data()), image.Width(), image.Height(),
+                                image.Width() * 4, 0, width, height, dest);
+}
+}
+
+TEST(BenchmarkPicture, CacheFolder)
+{
+  const unsigned int images = 8;
+  const unsigned int width = 4000;
+  const unsigned int height = 3000;
+
+  const std::string folder = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "picturebenchmark/");
+  XFILE::CDirectory::RemoveRecursive(folder);
+  ASSERT_TRUE(XFILE::CDirectory::Create(folder));
+
+  // a folder of camera sized photos
+  std::vector<std::string> files;
+  for (unsigned int i = 0; i < images; i++)
+  {
+    std::vector<uint32_t> pixels = CreateImage(width, height, i);
+    uint8_t* jpeg = nullptr;
+    size_t size = 0;
+    ASSERT_TRUE(CPicture::GetThumbnailFromSurface(reinterpret_cast<const unsigned char*>(pixels.data()),
+                                                  width, height, width * 4, "photo.jpg", jpeg, size));
+    files.push_back(URIUtils::AddFileToFolder(folder, StringUtils::Format("photo%u.jpg", i)));
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(files.back(), true));
+    EXPECT_EQ(static_cast<ssize_t>(size), file.Write(jpeg, size));
+    file.Close();
+    delete[] jpeg;
+  }
+
+  // decoding at full size like before, and downscaled while decoding to the size that is cached
+  auto cacheFolder = [&](unsigned int loadWidth, unsigned int loadHeight, const std::string& suffix) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (const auto& file : files)
+    {
+      const std::string dest = URIUtils::ReplaceExtension(file, suffix);
+      EXPECT_TRUE(CacheImage(file, loadWidth, loadHeight, dest));
+      EXPECT_TRUE(XFILE::CFile::Exists(dest));
+    }
+    const auto time = std::chrono::steady_clock::now() - begin;
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(time).count() / images);
+  };
+
+  const int full = cacheFolder(0, 0, "-full.jpg");
+  const int lowres = cacheFolder(1280, 720, "-lowres.jpg");
+
+  XFILE::CDirectory::RemoveRecursive(folder);
+
+  RecordProperty("images", static_cast<int>(images));
+  RecordProperty("full.image_ms", full);
+  RecordProperty("lowres.image_ms", lowres);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  CXBMCTestUtils::Instance().ParseArgs(argc, argv);
+
+  if (!testing::AddGlobalTestEnvironment(new TestBasicEnvironment()))
+  {
+    fprintf(stderr, "Unable to add basic test environment.\n");
+    exit(EXIT_FAILURE);
+  }
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+#include "pictures/Picture.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+uint32_t* CreatePixels(unsigned int width, unsigned int height)
+{
+  uint32_t* pixels = new uint32_t[width * height];
+  for (unsigned int i = 0; i < width * height; i++)
+    pixels[i] = i;
+  return pixels;
+}
+
+// a photo like image, smooth gradients with some detail
+std::vector<uint32_t> CreateImage(unsigned int width, unsigned int height, unsigned int seed)
+{
+  std::vector<uint32_t> pixels(width * height);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      const uint32_t r = (x * 255 / width + seed * 40) & 0xff;
+      const uint32_t g = (y * 255 / height) & 0xff;
+      const uint32_t b = ((x / 16 + y / 16) % 2) ? 0xc0 : 0x40;
+      pixels[y * width + x] = 0xff000000 | (r << 16) | (g << 8) | b;
+    }
+  }
+  return pixels;
+}
+
+// what CTextureCacheJob does for an image that isn't cached yet
+bool CacheImage(const std::string& file, unsigned int loadWidth, unsigned int loadHeight, const std::string& dest)
+{
+  XFILE::CFile imageFile;
+  XUTILS::auto_buffer buffer;
+  if (imageFile.LoadFile(file, buffer) <= 0)
+    return false;
+
+  CFFmpegImage image("image/jpeg");
+  if (!image.LoadImageFromMemory(reinterpret_cast<unsigned char*>(buffer.get()), buffer.size(), loadWidth, loadHeight))
+    return false;
+
+  std::vector<uint32_t> pixels(image.Width() * image.Height());
+  if (!image.Decode(reinterpret_cast<unsigned char*>(pixels.data()), image.Width(), image.Height(),
+                    image.Width() * 4, XB_FMT_A8R8G8B8))
+    return false;
+
+  uint32_t width = 0;
+  uint32_t height = 0;
+  return CPicture::CacheTexture(reinterpret_cast<uint8_t*>(pixels.data()), image.Width(), image.Height(),
+                                image.Width() * 4, 0, width, height, dest);
+}
+}
+
+TEST(TestPicture, OrientateImage)
+{
+  // where each orientation takes the pixel at x, y of the result from
+  typedef std::function<unsigned int(unsigned int x, unsigned int y, unsigned int width, unsigned int height)> Source;
+  const std::vector<std::pair<int, Source>> orientations = {
+    { 1, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return y * w + (w - 1 - x); } },
+    { 2, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return (h - 1 - y) * w + (w - 1 - x); } },
+    { 3, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return (h - 1 - y) * w + x; } },
+    { 4, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return x * w + y; } },
+    { 5, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return (h - 1 - x) * w + y; } },
+    { 6, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return (h - 1 - x) * w + (w - 1 - y); } },
+    { 7, [](unsigned int x, unsigned int y, unsigned int w, unsigned int h) { return x * w + (w - 1 - y); } },
+  };
+
+  // sizes that are no multiple of the tiles the transpose works in
+  const std::vector<std::pair<unsigned int, unsigned int>> sizes = { { 37, 70 }, { 70, 37 }, { 1, 5 }, { 64, 64 } };
+
+  for (const auto& orientation : orientations)
+  {
+    for (const auto& size : sizes)
+    {
+      unsigned int width = size.first;
+      unsigned int height = size.second;
+      uint32_t* pixels = CreatePixels(width, height);
+      ASSERT_TRUE(CPicture::OrientateImage(pixels, width, height, orientation.first));
+
+      const bool swapped = orientation.first >= 4;
+      EXPECT_EQ(swapped ? size.second : size.first, width);
+      EXPECT_EQ(swapped ? size.first : size.second, height);
+      for (unsigned int y = 0; y < height; y++)
+      {
+        for (unsigned int x = 0; x < width; x++)
+        {
+          ASSERT_EQ(orientation.second(x, y, size.first, size.second), pixels[y * width + x])
+              << "orientation " << orientation.first << " at " << x << "," << y
+              << " of " << size.first << "x" << size.second;
+        }
+      }
+      delete[] pixels;
+    }
+  }
+}
+
+TEST(TestPicture, CacheImage)
+{
+  const unsigned int width = 640;
+  const unsigned int height = 480;
+
+  const std::string folder = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "picturetest/");
+  XFILE::CDirectory::RemoveRecursive(folder);
+  ASSERT_TRUE(XFILE::CDirectory::Create(folder));
+
+  std::vector<uint32_t> pixels = CreateImage(width, height, 0);
+  uint8_t* jpeg = nullptr;
+  size_t size = 0;
+  ASSERT_TRUE(CPicture::GetThumbnailFromSurface(reinterpret_cast<const unsigned char*>(pixels.data()),
+                                                width, height, width * 4, "photo.jpg", jpeg, size));
+  const std::string file = URIUtils::AddFileToFolder(folder, "photo.jpg");
+  XFILE::CFile output;
+  ASSERT_TRUE(output.OpenForWrite(file, true));
+  EXPECT_EQ(static_cast<ssize_t>(size), output.Write(jpeg, size));
+  output.Close();
+  delete[] jpeg;
+
+  // decoded whole and downscaled while decoding
+  const std::string full = URIUtils::ReplaceExtension(file, "-full.jpg");
+  EXPECT_TRUE(CacheImage(file, 0, 0, full));
+  EXPECT_TRUE(XFILE::CFile::Exists(full));
+  const std::string lowres = URIUtils::ReplaceExtension(file, "-lowres.jpg");
+  EXPECT_TRUE(CacheImage(file, 320, 240, lowres));
+  EXPECT_TRUE(XFILE::CFile::Exists(lowres));
+
+  XFILE::CDirectory::RemoveRecursive(folder);
+}
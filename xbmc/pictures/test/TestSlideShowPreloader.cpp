@@ -0,0 +1,245 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "guilib/Texture.h"
+#include "pictures/SlideShowPicture.h"
+#include "pictures/SlideShowPreloader.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "test/MtTestUtils.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+TEST(TestSlideShowPreloader, GetNeighbours)
+{
+  EXPECT_EQ(std::vector<int>({ 6, 4, 7 }), CSlideShowPreloader::GetNeighbours(5, 10, 1, 2, 1));
+  EXPECT_EQ(std::vector<int>({ 4, 6, 3 }), CSlideShowPreloader::GetNeighbours(5, 10, -1, 2, 1));
+  EXPECT_EQ(std::vector<int>({ 6 }), CSlideShowPreloader::GetNeighbours(5, 10, 1, 1, 0));
+  EXPECT_TRUE(CSlideShowPreloader::GetNeighbours(5, 10, 1, 0, 0).empty());
+}
+
+TEST(TestSlideShowPreloader, GetNeighboursWrapsAround)
+{
+  EXPECT_EQ(std::vector<int>({ 0, 8, 1 }), CSlideShowPreloader::GetNeighbours(9, 10, 1, 2, 1));
+  EXPECT_EQ(std::vector<int>({ 9, 1, 8 }), CSlideShowPreloader::GetNeighbours(0, 10, -1, 2, 1));
+
+  // small slideshows don't prefetch the same slide twice, nor the current one
+  EXPECT_EQ(std::vector<int>({ 1, 2 }), CSlideShowPreloader::GetNeighbours(0, 3, 1, 3, 3));
+  EXPECT_TRUE(CSlideShowPreloader::GetNeighbours(0, 1, 1, 2, 1).empty());
+}
+
+namespace
+{
+class CTestTexture : public CBaseTexture
+{
+public:
+  CTestTexture(unsigned int width, unsigned int height) : CBaseTexture(width, height) {}
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+// decodes to pictures of a given size, keeping track of what was decoded where
+struct CTestDecoder
+{
+  CBaseTexture* Decode(const std::string &path, int maxWidth, int maxHeight)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    decoded.push_back(path);
+    threads[path] = std::this_thread::get_id();
+    started.notify_all();
+    blocked.wait(lock, [&]() { return blocking.find(path) == blocking.end(); });
+    const auto size = sizes.find(path);
+    if (size != sizes.end())
+      return new CTestTexture(size->second.first, size->second.second);
+    return new CTestTexture(width, height);
+  }
+
+  CSlideShowPreloader::Decoder Get()
+  {
+    return [this](const std::string &path, int maxWidth, int maxHeight) { return Decode(path, maxWidth, maxHeight); };
+  }
+
+  size_t Count()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return decoded.size();
+  }
+
+  void Unblock(const std::string &path)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    blocking.erase(path);
+    blocked.notify_all();
+  }
+
+  std::mutex mutex;
+  std::condition_variable started;
+  std::condition_variable blocked;
+  std::vector<std::string> decoded;
+  std::map<std::string, std::thread::id> threads;
+  std::map<std::string, std::pair<unsigned int, unsigned int>> sizes;
+  std::set<std::string> blocking;
+  unsigned int width = 64;
+  unsigned int height = 32;
+};
+
+const int MAX_WIDTH = 64;
+const int MAX_HEIGHT = 64;
+const size_t PICTURE_BYTES = MAX_WIDTH * MAX_HEIGHT * 4;
+
+std::vector<std::string> CreatePaths(int count)
+{
+  std::vector<std::string> paths;
+  for (int i = 0; i < count; i++)
+    paths.push_back(StringUtils::Format("picture%d.jpg", i));
+  return paths;
+}
+}
+
+TEST(TestSlideShowPreloader, MemoryCap)
+{
+  // room for 3 pictures at the size they're decoded at, which turn out half that
+  CTestDecoder decoder;
+  CSlideShowPreloader preloader(3 * PICTURE_BYTES, decoder.Get());
+  const std::vector<std::string> paths = CreatePaths(10);
+  preloader.Prefetch(paths, MAX_WIDTH, MAX_HEIGHT);
+
+  // so 5 of them fit, the nearest
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return decoder.Count() == 5 && preloader.GetBytes() == 5 * PICTURE_BYTES / 2; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(5u, decoder.Count());
+  EXPECT_LE(preloader.GetBytes(), 3 * PICTURE_BYTES);
+  std::vector<std::string> decoded = decoder.decoded;
+  std::sort(decoded.begin(), decoded.end());
+  EXPECT_EQ(std::vector<std::string>(paths.begin(), paths.begin() + 5), decoded);
+
+  // taking one makes room for the next
+  std::unique_ptr<CBaseTexture> texture(preloader.Take(paths[0], MAX_WIDTH, MAX_HEIGHT));
+  EXPECT_NE(nullptr, texture);
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return decoder.Count() == 6; }));
+  EXPECT_EQ(paths[5], decoder.decoded.back());
+
+  // and pictures decoded at another size are of no use
+  EXPECT_EQ(nullptr, preloader.Take(paths[1], MAX_WIDTH * 2, MAX_HEIGHT * 2));
+}
+
+TEST(TestSlideShowPreloader, LeastWantedMakeRoom)
+{
+  CTestDecoder decoder;
+  CSlideShowPreloader preloader(2 * PICTURE_BYTES, decoder.Get());
+
+  // the nearest picture turns out twice as large as asked for, after the other one is decoded
+  decoder.sizes["near.jpg"] = std::make_pair(MAX_WIDTH, MAX_HEIGHT * 2);
+  decoder.blocking.insert("near.jpg");
+  preloader.Prefetch({ "near.jpg", "far.jpg" }, MAX_WIDTH, MAX_HEIGHT);
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return preloader.GetBytes() == PICTURE_BYTES + PICTURE_BYTES / 2; }));
+  decoder.Unblock("near.jpg");
+
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return preloader.GetBytes() == 2 * PICTURE_BYTES; }));
+  EXPECT_EQ(nullptr, preloader.Take("far.jpg", MAX_WIDTH, MAX_HEIGHT));
+  std::unique_ptr<CBaseTexture> texture(preloader.Take("near.jpg", MAX_WIDTH, MAX_HEIGHT));
+  ASSERT_NE(nullptr, texture);
+  EXPECT_EQ(static_cast<unsigned int>(MAX_HEIGHT * 2), texture->GetHeight());
+}
+
+TEST(TestSlideShowPreloader, TakeDecodesWhenNotStarted)
+{
+  // keep all workers busy, so the decode job stays queued
+  std::atomic<int> busy{0};
+  std::atomic<bool> release{false};
+  const unsigned int workers = CJobManager::GetMaxWorkers(CJob::PRIORITY_LOW);
+  for (unsigned int i = 0; i < workers; i++)
+  {
+    CJobManager::GetInstance().Submit([&busy, &release]() {
+      busy++;
+      while (!release)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      busy--;
+    });
+  }
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return busy == static_cast<int>(workers); }));
+
+  CTestDecoder decoder;
+  CSlideShowPreloader preloader(3 * PICTURE_BYTES, decoder.Get());
+  preloader.Prefetch({ "picture.jpg" }, MAX_WIDTH, MAX_HEIGHT);
+  std::unique_ptr<CBaseTexture> texture(preloader.Take("picture.jpg", MAX_WIDTH, MAX_HEIGHT));
+  EXPECT_NE(nullptr, texture);
+  EXPECT_EQ(std::this_thread::get_id(), decoder.threads["picture.jpg"]);
+
+  // the queued job was cancelled
+  release = true;
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return busy == 0; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(1u, decoder.Count());
+  EXPECT_EQ(0u, preloader.GetBytes());
+}
+
+TEST(TestSlideShowPreloader, TakeWaitsWhenStarted)
+{
+  CTestDecoder decoder;
+  decoder.blocking.insert("picture.jpg");
+  CSlideShowPreloader preloader(3 * PICTURE_BYTES, decoder.Get());
+  preloader.Prefetch({ "picture.jpg" }, MAX_WIDTH, MAX_HEIGHT);
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return decoder.Count() == 1; }));
+
+  auto taken = std::async(std::launch::async, [&]() { return preloader.Take("picture.jpg", MAX_WIDTH, MAX_HEIGHT); });
+  EXPECT_EQ(std::future_status::timeout, taken.wait_for(std::chrono::milliseconds(50)));
+  decoder.Unblock("picture.jpg");
+  std::unique_ptr<CBaseTexture> texture(taken.get());
+  EXPECT_NE(nullptr, texture);
+  EXPECT_NE(std::this_thread::get_id(), decoder.threads["picture.jpg"]);
+  EXPECT_EQ(1u, decoder.Count());
+}
+
+TEST(TestSlideShowPreloader, RandomEffectSize)
+{
+  // the random effect on a 1080p screen, showing each picture for 5 seconds at 60 fps
+  const float scale = CSlideShowPic::GetMaxEffectScale(60.0f, 5);
+  EXPECT_GT(scale, 1.0f);
+  EXPECT_LT(scale, 1.5f);
+  const int size = static_cast<int>(1920 * scale);
+
+  // 4000x3000 photos decoded into the box are still as large as the zoom shows them
+  CTestDecoder decoder;
+  decoder.width = size;
+  decoder.height = size * 3 / 4;
+  EXPECT_GE(decoder.height, 1080 * scale);
+
+  // and the neighbours prefetched by default fit the default decode cache
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const size_t maxBytes = static_cast<size_t>(advancedSettings->m_slideshowDecodeCache) * 1024 * 1024;
+  const std::vector<std::string> paths = CreatePaths(advancedSettings->m_slideshowLookAhead + advancedSettings->m_slideshowLookBehind);
+  CSlideShowPreloader preloader(maxBytes, decoder.Get());
+  preloader.Prefetch(paths, size, size);
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return decoder.Count() == paths.size(); }));
+  ASSERT_TRUE(ConditionPoll::poll([&]() { return preloader.GetBytes() == paths.size() * size * (size * 3 / 4) * 4; }));
+  EXPECT_LE(preloader.GetBytes(), maxBytes);
+
+  // a box of the largest texture size wouldn't have prefetched any of them
+  CTestDecoder maxTextureDecoder;
+  CSlideShowPreloader maxTexturePreloader(maxBytes, maxTextureDecoder.Get());
+  maxTexturePreloader.Prefetch(paths, 16384, 16384);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(0u, maxTextureDecoder.Count());
+  EXPECT_EQ(0u, maxTexturePreloader.GetBytes());
+}
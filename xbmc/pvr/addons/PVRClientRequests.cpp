@@ -0,0 +1,170 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRClientRequests.h"
+
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+#include <algorithm>
+
+using namespace PVR;
+
+CPVRClientRequests::CPVRClientRequests(unsigned int iMaxRunningPerClient, const Executor& executor)
+: m_iMaxRunningPerClient(std::max(iMaxRunningPerClient, 1u)),
+  m_executor(executor)
+{
+  if (!m_executor)
+  {
+    // callers may wait for the requests, so they must not queue behind other jobs
+    m_executor = [](const std::function<void()>& job) {
+      CJobManager::GetInstance().Submit(std::function<void()>(job), CJob::PRIORITY_DEDICATED);
+    };
+  }
+}
+
+CPVRClientRequests::~CPVRClientRequests()
+{
+  CSingleLock lock(m_critSection);
+  while (m_iPending > 0)
+    m_condition.wait(lock);
+}
+
+std::shared_future<PVR_ERROR> CPVRClientRequests::Submit(int iClientId, const std::string& strKey, const RequestFunction& function)
+{
+  std::shared_ptr<void> target;
+  return Submit(iClientId, strKey, function, target);
+}
+
+std::shared_future<PVR_ERROR> CPVRClientRequests::Submit(int iClientId, const std::string& strKey, const RequestFunction& function, std::shared_ptr<void>& target)
+{
+  std::vector<std::shared_ptr<Request>> startRequests;
+  std::shared_ptr<Request> request;
+  bool bCoalesced = false;
+  {
+    CSingleLock lock(m_critSection);
+    request = Queue(iClientId, strKey, function, target, false, bCoalesced, startRequests);
+  }
+
+  RunInBackground(iClientId, startRequests);
+  target = request->target;
+  return request->result;
+}
+
+PVR_ERROR CPVRClientRequests::Execute(int iClientId, const std::string& strKey, const RequestFunction& function)
+{
+  std::shared_ptr<void> target;
+  return Execute(iClientId, strKey, function, target);
+}
+
+PVR_ERROR CPVRClientRequests::Execute(int iClientId, const std::string& strKey, const RequestFunction& function, std::shared_ptr<void>& target)
+{
+  std::vector<std::shared_ptr<Request>> startRequests;
+  std::shared_ptr<Request> request;
+  bool bCoalesced = false;
+  {
+    CSingleLock lock(m_critSection);
+    request = Queue(iClientId, strKey, function, target, true, bCoalesced, startRequests);
+  }
+  target = request->target;
+
+  RunInBackground(iClientId, startRequests);
+
+  if (!bCoalesced)
+  {
+    {
+      CSingleLock lock(m_critSection);
+      while (!request->bStarted)
+        m_condition.wait(lock);
+    }
+    Run(iClientId, request);
+  }
+
+  return request->result.get();
+}
+
+unsigned int CPVRClientRequests::GetCoalescedCount() const
+{
+  CSingleLock lock(m_critSection);
+  return m_iCoalesced;
+}
+
+std::shared_ptr<CPVRClientRequests::Request> CPVRClientRequests::Queue(int iClientId,
+                                                                       const std::string& strKey,
+                                                                       const RequestFunction& function,
+                                                                       const std::shared_ptr<void>& target,
+                                                                       bool bInline,
+                                                                       bool& bCoalesced,
+                                                                       std::vector<std::shared_ptr<Request>>& startRequests)
+{
+  ClientQueue& queue = m_clients[iClientId];
+
+  const auto it = std::find_if(queue.queued.begin(), queue.queued.end(),
+                               [&strKey](const std::shared_ptr<Request>& request) { return request->strKey == strKey; });
+  if (it != queue.queued.end())
+  {
+    ++m_iCoalesced;
+    bCoalesced = true;
+    return *it;
+  }
+
+  std::shared_ptr<Request> request = std::make_shared<Request>();
+  request->strKey = strKey;
+  request->function = function;
+  request->target = target;
+  request->result = request->promise.get_future().share();
+  request->bInline = bInline;
+  queue.queued.emplace_back(request);
+  ++m_iPending;
+
+  StartQueued(queue, startRequests);
+  return request;
+}
+
+void CPVRClientRequests::StartQueued(ClientQueue& queue, std::vector<std::shared_ptr<Request>>& startRequests)
+{
+  bool bNotify = false;
+  while (queue.iRunning < m_iMaxRunningPerClient && !queue.queued.empty())
+  {
+    const std::shared_ptr<Request> request = queue.queued.front();
+    queue.queued.pop_front();
+    request->bStarted = true;
+    ++queue.iRunning;
+
+    if (request->bInline)
+      bNotify = true;
+    else
+      startRequests.emplace_back(request);
+  }
+
+  if (bNotify)
+    m_condition.notifyAll();
+}
+
+void CPVRClientRequests::RunInBackground(int iClientId, const std::vector<std::shared_ptr<Request>>& requests)
+{
+  for (const auto& request : requests)
+    m_executor([this, iClientId, request]() { Run(iClientId, request); });
+}
+
+void CPVRClientRequests::Run(int iClientId, const std::shared_ptr<Request>& request)
+{
+  request->promise.set_value(request->function());
+
+  std::vector<std::shared_ptr<Request>> startRequests;
+  {
+    CSingleLock lock(m_critSection);
+    ClientQueue& queue = m_clients[iClientId];
+    --queue.iRunning;
+    --m_iPending;
+    StartQueued(queue, startRequests);
+    m_condition.notifyAll();
+  }
+
+  RunInBackground(iClientId, startRequests);
+}
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PVR
+{
+  /*!
+   * @brief Queue of the requests to the PVR clients.
+   *
+   * At most a given number of requests run per client at the same time, further requests wait for their turn.
+   * A request identical to one still waiting for its turn (same client and key) is not queued again, the caller
+   * gets the result of the waiting request instead. Requests already running are never joined, as the data they
+   * return might already be outdated for a caller arriving late.
+   *
+   * A request transferring data writes it to a target of its own, which every caller it answers gets and copies
+   * the data from. Keys must thus identify the data asked for, not the caller.
+   *
+   * Synchronous requests wait for their turn, so they must not be made while holding a lock that the callbacks
+   * of a running request need.
+   */
+  class CPVRClientRequests
+  {
+  public:
+    typedef std::function<PVR_ERROR()> RequestFunction;
+    typedef std::function<void(const std::function<void()>&)> Executor;
+
+    /*!
+     * @brief Create a new request queue.
+     * @param iMaxRunningPerClient The maximum number of requests running per client at the same time.
+     * @param executor Runs background requests. Defaults to the job manager.
+     */
+    explicit CPVRClientRequests(unsigned int iMaxRunningPerClient, const Executor& executor = Executor());
+
+    /*!
+     * @brief Destroy the queue, waiting for all queued and running requests to finish.
+     */
+    ~CPVRClientRequests();
+
+    /*!
+     * @brief Run a request in the background.
+     * @param iClientId The id of the client.
+     * @param strKey Identifies the request. Requests with the same key must have the same effect.
+     * @param function The request.
+     * @return The result of the request.
+     */
+    std::shared_future<PVR_ERROR> Submit(int iClientId, const std::string& strKey, const RequestFunction& function);
+
+    /*!
+     * @brief Run a request transferring data in the background.
+     * @param iClientId The id of the client.
+     * @param strKey Identifies the data asked for.
+     * @param target [in,out] The target for the data. Replaced by the target of the waiting request answering this one.
+     * @param function The request, writing the data to the given target.
+     * @return The result of the request. The target must not be read before the result is ready.
+     */
+    template<typename T>
+    std::shared_future<PVR_ERROR> Submit(int iClientId, const std::string& strKey, std::shared_ptr<T>& target,
+                                         const std::function<PVR_ERROR(T& target)>& function)
+    {
+      const std::shared_ptr<T> newTarget(target);
+      std::shared_ptr<void> requestTarget(target);
+      const std::shared_future<PVR_ERROR> result =
+          Submit(iClientId, strKey, [newTarget, function]() { return function(*newTarget); }, requestTarget);
+      target = std::static_pointer_cast<T>(requestTarget);
+      return result;
+    }
+
+    /*!
+     * @brief Run a request on the calling thread, once it is the request's turn. Callbacks of the client thus see
+     * the locks held by the caller, like with a direct call.
+     * @param iClientId The id of the client.
+     * @param strKey Identifies the request. Requests with the same key must have the same effect.
+     * @param function The request.
+     * @return The result of the request.
+     */
+    PVR_ERROR Execute(int iClientId, const std::string& strKey, const RequestFunction& function);
+
+    /*!
+     * @brief Run a request transferring data on the calling thread, once it is the request's turn.
+     * @param iClientId The id of the client.
+     * @param strKey Identifies the data asked for.
+     * @param target [in,out] The target for the data. Replaced by the target of the waiting request answering this one.
+     * @param function The request, writing the data to the given target.
+     * @return The result of the request.
+     */
+    template<typename T>
+    PVR_ERROR Execute(int iClientId, const std::string& strKey, std::shared_ptr<T>& target,
+                      const std::function<PVR_ERROR(T& target)>& function)
+    {
+      const std::shared_ptr<T> newTarget(target);
+      std::shared_ptr<void> requestTarget(target);
+      const PVR_ERROR error =
+          Execute(iClientId, strKey, [newTarget, function]() { return function(*newTarget); }, requestTarget);
+      target = std::static_pointer_cast<T>(requestTarget);
+      return error;
+    }
+
+    /*!
+     * @brief Get the number of requests that were answered by an identical request.
+     * @return The number of requests.
+     */
+    unsigned int GetCoalescedCount() const;
+
+  private:
+    CPVRClientRequests(const CPVRClientRequests&) = delete;
+    CPVRClientRequests& operator=(const CPVRClientRequests&) = delete;
+
+    struct Request
+    {
+      std::string strKey;
+      RequestFunction function;
+      std::shared_ptr<void> target; /*!< the data of the request, shared with the callers it answers */
+      std::promise<PVR_ERROR> promise;
+      std::shared_future<PVR_ERROR> result;
+      bool bInline = false; /*!< true if the submitting thread runs the request */
+      bool bStarted = false;
+    };
+
+    struct ClientQueue
+    {
+      unsigned int iRunning = 0;
+      std::deque<std::shared_ptr<Request>> queued;
+    };
+
+    std::shared_future<PVR_ERROR> Submit(int iClientId, const std::string& strKey, const RequestFunction& function, std::shared_ptr<void>& target);
+    PVR_ERROR Execute(int iClientId, const std::string& strKey, const RequestFunction& function, std::shared_ptr<void>& target);
+    std::shared_ptr<Request> Queue(int iClientId, const std::string& strKey, const RequestFunction& function, const std::shared_ptr<void>& target, bool bInline, bool& bCoalesced, std::vector<std::shared_ptr<Request>>& startRequests);
+    void StartQueued(ClientQueue& queue, std::vector<std::shared_ptr<Request>>& startRequests);
+    void RunInBackground(int iClientId, const std::vector<std::shared_ptr<Request>>& requests);
+    void Run(int iClientId, const std::shared_ptr<Request>& request);
+
+    const unsigned int m_iMaxRunningPerClient;
+    Executor m_executor;
+    std::map<int, ClientQueue> m_clients;
+    unsigned int m_iCoalesced = 0;
+    unsigned int m_iPending = 0; /*!< the number of queued and running requests */
+    mutable CCriticalSection m_critSection;
+    XbmcThreads::ConditionVariable m_condition;
+  };
+}
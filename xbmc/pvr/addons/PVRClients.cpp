@@ -14,10 +14,14 @@
 #include "messaging/ApplicationMessenger.h"
 #include "pvr/PVRJobs.h"
 #include "pvr/PVRManager.h"
+#include "pvr/addons/PVRClientRequests.h"
 #include "pvr/channels/PVRChannelGroupInternal.h"
+#include "pvr/timers/PVRTimers.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,9 +42,13 @@ namespace
     return iClientId;
   }
 
+  // requests beyond this wait for their turn, and identical waiting requests are sent only once
+  const unsigned int MAX_RUNNING_REQUESTS_PER_CLIENT = 2;
+
 } // unnamed namespace
 
 CPVRClients::CPVRClients(void)
+: m_requests(new CPVRClientRequests(MAX_RUNNING_REQUESTS_PER_CLIENT))
 {
   CServiceBroker::GetAddonMgr().RegisterAddonMgrCallback(ADDON_PVRDLL, this);
   CServiceBroker::GetAddonMgr().Events().Subscribe(this, &CPVRClients::OnAddonEvent);
@@ -51,6 +59,9 @@ CPVRClients::~CPVRClients(void)
   CServiceBroker::GetAddonMgr().Events().Unsubscribe(this);
   CServiceBroker::GetAddonMgr().UnregisterAddonMgrCallback(ADDON_PVRDLL);
 
+  // wait for the requests still running in the background
+  m_requests.reset();
+
   for (const auto& client : m_clientMap)
   {
     client.second->Destroy();
@@ -461,9 +472,43 @@ std::vector<SBackend> CPVRClients::GetBackendProperties() const
 
 bool CPVRClients::GetTimers(CPVRTimersContainer* timers, std::vector<int>& failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [timers](const std::shared_ptr<CPVRClient>& client) {
-    return client->GetTimers(timers);
-  }, failedClients) == PVR_ERROR_NO_ERROR;
+  PVR_ERROR lastError = PVR_ERROR_NO_ERROR;
+
+  CPVRClientMap clients;
+  GetCreatedClients(clients, failedClients);
+
+  // all clients are asked at the same time, each into a container of its own request
+  std::vector<std::pair<int, std::shared_ptr<CPVRTimersContainer>>> targets;
+  std::vector<std::shared_future<PVR_ERROR>> results;
+  for (const auto& clientEntry : clients)
+  {
+    const std::shared_ptr<CPVRClient> client = clientEntry.second;
+    std::shared_ptr<CPVRTimersContainer> target = std::make_shared<CPVRTimersContainer>();
+    results.emplace_back(m_requests->Submit<CPVRTimersContainer>(clientEntry.first, __FUNCTION__, target,
+                                                                 [client](CPVRTimersContainer& clientTimers) {
+      return client->GetTimers(&clientTimers);
+    }));
+    targets.emplace_back(clientEntry.first, target);
+  }
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const int iClientId = targets[i].first;
+    PVR_ERROR currentError = results[i].get();
+    if (LogClientError(__FUNCTION__, clients[iClientId], currentError))
+    {
+      lastError = currentError;
+      failedClients.emplace_back(iClientId);
+    }
+
+    for (const auto& tagsEntry : targets[i].second->GetTags())
+    {
+      for (const auto& timer : tagsEntry.second)
+        timers->UpdateFromClient(timer);
+    }
+  }
+
+  return lastError == PVR_ERROR_NO_ERROR;
 }
 
 PVR_ERROR CPVRClients::GetTimerTypes(CPVRTimerTypes& results) const
@@ -498,6 +543,20 @@ PVR_ERROR CPVRClients::SetEPGTimeFrame(int iDays)
   });
 }
 
+PVR_ERROR CPVRClients::GetEPGForChannel(int iClientId, int iChannelUid, std::shared_ptr<CPVREpg>& epg, time_t start, time_t end)
+{
+  std::shared_ptr<CPVRClient> client;
+  if (!GetClient(iClientId, client))
+    return PVR_ERROR_SERVER_ERROR;
+
+  return m_requests->Execute<CPVREpg>(iClientId,
+                                      StringUtils::Format("%s:%d:%lld:%lld", __FUNCTION__, iChannelUid,
+                                                          static_cast<long long>(start), static_cast<long long>(end)),
+                                      epg, [client, iChannelUid, start, end](CPVREpg& requestEpg) {
+    return client->GetEPGForChannel(iChannelUid, &requestEpg, start, end);
+  });
+}
+
 PVR_ERROR CPVRClients::GetChannels(CPVRChannelGroupInternal* group, std::vector<int>& failedClients)
 {
   return ForCreatedClients(__FUNCTION__, [group](const std::shared_ptr<CPVRClient>& client) {
@@ -663,14 +722,22 @@ PVR_ERROR CPVRClients::ForCreatedClients(const char* strFunctionName, PVRClientF
   {
     PVR_ERROR currentError = function(clientEntry.second);
 
-    if (currentError != PVR_ERROR_NO_ERROR && currentError != PVR_ERROR_NOT_IMPLEMENTED)
+    if (LogClientError(strFunctionName, clientEntry.second, currentError))
     {
-      CLog::LogFunction(LOGERROR, strFunctionName,
-                        "PVR client '%s' returned an error: %s",
-                        clientEntry.second->GetFriendlyName().c_str(), CPVRClient::ToString(currentError));
       lastError = currentError;
       failedClients.emplace_back(clientEntry.first);
     }
   }
   return lastError;
 }
+
+bool CPVRClients::LogClientError(const char* strFunctionName, const std::shared_ptr<CPVRClient>& client, PVR_ERROR error)
+{
+  if (error == PVR_ERROR_NO_ERROR || error == PVR_ERROR_NOT_IMPLEMENTED)
+    return false;
+
+  CLog::LogFunction(LOGERROR, strFunctionName,
+                    "PVR client '%s' returned an error: %s",
+                    client->GetFriendlyName().c_str(), CPVRClient::ToString(error));
+  return true;
+}
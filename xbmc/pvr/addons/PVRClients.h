@@ -13,6 +13,7 @@
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "threads/CriticalSection.h"
 
+#include <ctime>
 #include <functional>
 #include <map>
 #include <memory>
@@ -29,6 +30,7 @@ namespace PVR
   class CPVRChannelGroupInternal;
   class CPVRChannelGroup;
   class CPVRChannelGroups;
+  class CPVRClientRequests;
   class CPVREpg;
   class CPVRRecordings;
   class CPVRTimersContainer;
@@ -178,7 +180,7 @@ namespace PVR
     //@{
 
     /*!
-     * @brief Get all timers from all created clients
+     * @brief Get all timers from all created clients, asking all clients at the same time. An identical request still waiting for its turn is answered together with this one.
      * @param timers Store the timers in this container.
      * @param failedClients in case of errors will contain the ids of the clients for which the timers could not be obtained.
      * @return true on success for all clients, false in case of error for at least one client.
@@ -225,6 +227,18 @@ namespace PVR
      */
     PVR_ERROR SetEPGTimeFrame(int iDays);
 
+    /*!
+     * @brief Request an EPG table for a channel from a client. An identical request still waiting for its turn is answered together with this one.
+     * @param iClientId The id of the client.
+     * @param iChannelUid The UID of the channel to get the EPG table for.
+     * @param epg [in,out] An empty table to write the data to. Replaced by the table of the waiting request answering this one,
+     * which other callers may read as well.
+     * @param start The start time to use.
+     * @param end The end time to use.
+     * @return PVR_ERROR_NO_ERROR if the table has been fetched successfully.
+     */
+    PVR_ERROR GetEPGForChannel(int iClientId, int iChannelUid, std::shared_ptr<CPVREpg>& epg, time_t start, time_t end);
+
     //@}
 
     /*! @name Channel methods */
@@ -352,7 +366,17 @@ namespace PVR
      */
     PVR_ERROR ForCreatedClients(const char* strFunctionName, PVRClientFunction function, std::vector<int>& failedClients) const;
 
+    /*!
+     * @brief Log the error returned by a client for a wrapped call.
+     * @param strFunctionName The function name.
+     * @param client The client.
+     * @param error The error.
+     * @return True if the error is an actual failure, false otherwise.
+     */
+    static bool LogClientError(const char* strFunctionName, const std::shared_ptr<CPVRClient>& client, PVR_ERROR error);
+
     mutable CCriticalSection m_critSection;
     CPVRClientMap m_clientMap;
+    std::unique_ptr<CPVRClientRequests> m_requests;
   };
 }
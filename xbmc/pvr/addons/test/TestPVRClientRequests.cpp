@@ -0,0 +1,249 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "pvr/addons/PVRClientRequests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+// in-process stand-in for a pvr backend, answering each request after a fixed latency
+class CFakePVRBackend
+{
+public:
+  explicit CFakePVRBackend(int iLatencyMs) : m_iLatencyMs(iLatencyMs) {}
+
+  PVR_ERROR GetTimers()
+  {
+    const int iRunning = ++m_iRunning;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_iMaxRunning = std::max(m_iMaxRunning, iRunning);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_iLatencyMs));
+    ++m_iCalls;
+    --m_iRunning;
+    return PVR_ERROR_NO_ERROR;
+  }
+
+  int GetCalls() const { return m_iCalls; }
+  int GetMaxRunning() const { return m_iMaxRunning; }
+
+private:
+  const int m_iLatencyMs;
+  std::atomic<int> m_iCalls{0};
+  std::atomic<int> m_iRunning{0};
+  int m_iMaxRunning = 0;
+  std::mutex m_mutex;
+};
+
+// runs background requests on threads joined by the test
+class CThreadExecutor
+{
+public:
+  ~CThreadExecutor() { Join(); }
+
+  CPVRClientRequests::Executor Get()
+  {
+    return [this](const std::function<void()>& job) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_threads.emplace_back(job);
+    };
+  }
+
+  void Join()
+  {
+    while (true)
+    {
+      std::vector<std::thread> threads;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        threads.swap(m_threads);
+      }
+      if (threads.empty())
+        return;
+
+      for (auto& thread : threads)
+        thread.join();
+    }
+  }
+
+private:
+  std::mutex m_mutex;
+  std::vector<std::thread> m_threads;
+};
+}
+
+TEST(TestPVRClientRequests, Execute)
+{
+  CFakePVRBackend backend(0);
+  CPVRClientRequests requests(2);
+  EXPECT_EQ(PVR_ERROR_NO_ERROR, requests.Execute(1, "GetTimers", [&backend]() { return backend.GetTimers(); }));
+  EXPECT_EQ(PVR_ERROR_SERVER_ERROR, requests.Execute(1, "GetTimers", []() { return PVR_ERROR_SERVER_ERROR; }));
+  EXPECT_EQ(1, backend.GetCalls());
+  EXPECT_EQ(0u, requests.GetCoalescedCount());
+}
+
+TEST(TestPVRClientRequests, ConcurrencyLimit)
+{
+  CFakePVRBackend backend(20);
+  CThreadExecutor executor;
+  {
+    CPVRClientRequests requests(2, executor.Get());
+    std::vector<std::shared_future<PVR_ERROR>> results;
+    for (int i = 0; i < 6; ++i)
+      results.emplace_back(requests.Submit(1, "GetTimers:" + std::to_string(i), [&backend]() { return backend.GetTimers(); }));
+
+    for (const auto& result : results)
+      EXPECT_EQ(PVR_ERROR_NO_ERROR, result.get());
+  }
+  executor.Join();
+
+  EXPECT_EQ(6, backend.GetCalls());
+  EXPECT_EQ(2, backend.GetMaxRunning());
+}
+
+TEST(TestPVRClientRequests, ClientsRunInParallel)
+{
+  CFakePVRBackend backend1(50);
+  CFakePVRBackend backend2(50);
+  CThreadExecutor executor;
+
+  const auto begin = std::chrono::steady_clock::now();
+  {
+    CPVRClientRequests requests(1, executor.Get());
+    auto result1 = requests.Submit(1, "GetTimers", [&backend1]() { return backend1.GetTimers(); });
+    auto result2 = requests.Submit(2, "GetTimers", [&backend2]() { return backend2.GetTimers(); });
+    result1.get();
+    result2.get();
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+  executor.Join();
+
+  EXPECT_LT(elapsed.count(), 100);
+  RecordProperty("milliseconds", static_cast<int>(elapsed.count()));
+}
+
+TEST(TestPVRClientRequests, CoalesceQueued)
+{
+  // a busy backend and ten windows asking for the same data while it is busy
+  CFakePVRBackend backend(30);
+  CThreadExecutor executor;
+  {
+    CPVRClientRequests requests(1, executor.Get());
+    auto running = requests.Submit(1, "GetTimers:0", [&backend]() { return backend.GetTimers(); });
+
+    std::vector<std::shared_future<PVR_ERROR>> results;
+    for (int i = 0; i < 10; ++i)
+      results.emplace_back(requests.Submit(1, "GetTimers:1", [&backend]() { return backend.GetTimers(); }));
+
+    // an inline request joins the queued one as well
+    EXPECT_EQ(PVR_ERROR_NO_ERROR, requests.Execute(1, "GetTimers:1", [&backend]() { return backend.GetTimers(); }));
+    for (const auto& result : results)
+      EXPECT_EQ(PVR_ERROR_NO_ERROR, result.get());
+    running.get();
+
+    EXPECT_EQ(10u, requests.GetCoalescedCount());
+  }
+  executor.Join();
+
+  EXPECT_EQ(2, backend.GetCalls());
+}
+
+TEST(TestPVRClientRequests, CoalescedCallersGetTheData)
+{
+  CFakePVRBackend backend(30);
+  CThreadExecutor executor;
+  {
+    CPVRClientRequests requests(1, executor.Get());
+    auto running = requests.Submit(1, "GetTimers", [&backend]() { return backend.GetTimers(); });
+
+    // each caller brings a target of its own, the waiting request writes to the first one
+    std::vector<std::shared_ptr<std::vector<int>>> targets;
+    std::vector<std::shared_future<PVR_ERROR>> results;
+    for (int i = 0; i < 3; ++i)
+    {
+      std::shared_ptr<std::vector<int>> target = std::make_shared<std::vector<int>>();
+      results.emplace_back(requests.Submit<std::vector<int>>(1, "GetEPGForChannel:7", target, [&backend, i](std::vector<int>& tags) {
+        tags.push_back(i);
+        return backend.GetTimers();
+      }));
+      targets.emplace_back(target);
+    }
+
+    std::shared_ptr<std::vector<int>> inlineTarget = std::make_shared<std::vector<int>>();
+    EXPECT_EQ(PVR_ERROR_NO_ERROR, requests.Execute<std::vector<int>>(1, "GetEPGForChannel:7", inlineTarget, [](std::vector<int>& tags) {
+      tags.push_back(-1);
+      return PVR_ERROR_NO_ERROR;
+    }));
+    targets.emplace_back(inlineTarget);
+
+    for (const auto& result : results)
+      EXPECT_EQ(PVR_ERROR_NO_ERROR, result.get());
+    running.get();
+
+    for (const auto& target : targets)
+    {
+      EXPECT_EQ(targets.front(), target);
+      EXPECT_EQ(std::vector<int>({0}), *target);
+    }
+  }
+  executor.Join();
+
+  EXPECT_EQ(2, backend.GetCalls());
+}
+
+TEST(TestPVRClientRequests, RunningRequestsAreNotJoined)
+{
+  CFakePVRBackend backend(30);
+  CThreadExecutor executor;
+  {
+    CPVRClientRequests requests(1, executor.Get());
+    auto first = requests.Submit(1, "GetTimers", [&backend]() { return backend.GetTimers(); });
+    auto second = requests.Submit(1, "GetTimers", [&backend]() { return backend.GetTimers(); });
+    first.get();
+    second.get();
+    EXPECT_EQ(0u, requests.GetCoalescedCount());
+  }
+  executor.Join();
+
+  EXPECT_EQ(2, backend.GetCalls());
+}
+
+TEST(TestPVRClientRequests, ExecuteWaitsForTurn)
+{
+  CFakePVRBackend backend(20);
+  CThreadExecutor executor;
+  {
+    CPVRClientRequests requests(1, executor.Get());
+    auto background = requests.Submit(1, "GetRecordings", [&backend]() { return backend.GetTimers(); });
+
+    // the calling thread runs its own request, after the background request is done
+    const std::thread::id caller = std::this_thread::get_id();
+    std::thread::id runner;
+    EXPECT_EQ(PVR_ERROR_NO_ERROR, requests.Execute(1, "GetTimers", [&]() {
+      runner = std::this_thread::get_id();
+      return backend.GetTimers();
+    }));
+    EXPECT_EQ(caller, runner);
+    EXPECT_EQ(std::future_status::ready, background.wait_for(std::chrono::milliseconds(0)));
+  }
+  executor.Join();
+
+  EXPECT_EQ(1, backend.GetMaxRunning());
+}
@@ -12,26 +12,41 @@
 #include "addons/PVRClient.h"
 #include "guilib/LocalizeStrings.h"
 #include "pvr/PVRManager.h"
+#include "pvr/addons/PVRClients.h"
 #include "pvr/epg/EpgChannelData.h"
 #include "pvr/epg/EpgDatabase.h"
 #include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgSearchFilter.h"
+#include "pvr/epg/EpgTagIndex.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/TextIndex.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
 
 using namespace PVR;
 
+namespace
+{
+// plots are long, so their index is only kept while it takes no more than ~64 KiB of ids per EPG
+const size_t MAX_PLOT_INDEX_IDS = 16 * 1024;
+}
+
 CPVREpg::CPVREpg(int iEpgID, const std::string& strName, const std::string& strScraperName)
 : m_bChanged(false),
   m_iEpgID(iEpgID),
   m_strName(strName),
   m_strScraperName(strScraperName),
+  m_index(new CPVREpgTagIndex),
+  m_textIndex(new CTextIndex),
+  m_plotIndex(new CTextIndex),
   m_channelData(new CPVREpgChannelData)
 {
 }
@@ -41,6 +56,9 @@ CPVREpg::CPVREpg(int iEpgID, const std::string& strName, const std::string& strS
   m_iEpgID(iEpgID),
   m_strName(strName),
   m_strScraperName(strScraperName),
+  m_index(new CPVREpgTagIndex),
+  m_textIndex(new CTextIndex),
+  m_plotIndex(new CTextIndex),
   m_channelData(channelData)
 {
 }
@@ -72,6 +90,7 @@ void CPVREpg::Clear(void)
 {
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_bIndexValid = false;
 }
 
 void CPVREpg::Cleanup(int iPastDays)
@@ -91,6 +110,7 @@ void CPVREpg::Cleanup(const CDateTime& time)
         m_nowActiveStart.SetValid(false);
 
       it = m_tags.erase(it);
+      m_bIndexValid = false;
     }
     else
     {
@@ -109,26 +129,24 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = tru
       return it->second;
   }
 
-  if (bUpdateIfNeeded)
+  if (bUpdateIfNeeded && !m_tags.empty())
   {
-    std::shared_ptr<CPVREpgInfoTag> lastActiveTag;
+    const CPVREpgTagIndex& index = GetIndex();
+    time_t now;
+    index.GetTag(0)->GetCurrentPlayingTime().GetAsTime(now);
 
-    /* one of the first items will always match if the list is sorted */
-    for (const auto& tag : m_tags)
+    const int iActive = index.FindActive(now);
+    if (iActive != CPVREpgTagIndex::INVALID_POS)
     {
-      if (tag.second->IsActive())
-      {
-        m_nowActiveStart = tag.first;
-        return tag.second;
-      }
-      else if (tag.second->WasActive())
-        lastActiveTag = tag.second;
+      m_nowActiveStart = index.GetTag(iActive)->StartAsUTC();
+      return index.GetTag(iActive);
     }
 
     /* there might be a gap between the last and next event. return the last if found and it ended not more than 5 minutes ago */
-    if (lastActiveTag &&
-        lastActiveTag->EndAsUTC() + CDateTimeSpan(0, 0, 5, 0) >= CDateTime::GetUTCDateTime())
-      return lastActiveTag;
+    const int iLastActive = index.FindLastEnded(now);
+    if (iLastActive != CPVREpgTagIndex::INVALID_POS &&
+        index.GetTag(iLastActive)->EndAsUTC() + CDateTimeSpan(0, 0, 5, 0) >= CDateTime::GetUTCDateTime())
+      return index.GetTag(iLastActive);
   }
 
   return std::shared_ptr<CPVREpgInfoTag>();
@@ -144,13 +162,19 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagNext() const
     if (it != m_tags.end() && ++it != m_tags.end())
       return it->second;
   }
-  else if (m_tags.size() > 0)
+  else
   {
     /* return the first event that is in the future */
-    for (const auto& tag : m_tags)
+    CSingleLock lock(m_critSection);
+    if (!m_tags.empty())
     {
-      if (tag.second->IsUpcoming())
-        return tag.second;
+      const CPVREpgTagIndex& index = GetIndex();
+      time_t now;
+      index.GetTag(0)->GetCurrentPlayingTime().GetAsTime(now);
+
+      const int iUpcoming = index.FindFirstUpcoming(now);
+      if (iUpcoming != CPVREpgTagIndex::INVALID_POS)
+        return index.GetTag(iUpcoming);
     }
   }
 
@@ -170,13 +194,19 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagPrevious() const
       return it->second;
     }
   }
-  else if (m_tags.size() > 0)
+  else
   {
     /* return the first event that is in the past */
-    for (auto it = m_tags.rbegin(); it != m_tags.rend(); ++it)
+    CSingleLock lock(m_critSection);
+    if (!m_tags.empty())
     {
-      if (it->second->WasActive())
-        return it->second;
+      const CPVREpgTagIndex& index = GetIndex();
+      time_t now;
+      index.GetTag(0)->GetCurrentPlayingTime().GetAsTime(now);
+
+      const int iPrevious = index.FindLastEnded(now);
+      if (iPrevious != CPVREpgTagIndex::INVALID_POS)
+        return index.GetTag(iPrevious);
     }
   }
 
@@ -217,13 +247,17 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagBetween(const CDateTime& beginTim
   std::shared_ptr<CPVREpgInfoTag> tag;
 
   CSingleLock lock(m_critSection);
-  for (const auto& epgTag : m_tags)
+  if (!m_tags.empty())
   {
-    if (epgTag.second->StartAsUTC() >= beginTime && epgTag.second->EndAsUTC() <= endTime)
-    {
-      tag = epgTag.second;
-      break;
-    }
+    time_t begin;
+    beginTime.GetAsTime(begin);
+    time_t end;
+    endTime.GetAsTime(end);
+
+    const CPVREpgTagIndex& index = GetIndex();
+    const int iPos = index.FindFirstBetween(begin, end);
+    if (iPos != CPVREpgTagIndex::INVALID_POS)
+      tag = index.GetTag(iPos);
   }
 
   if (!tag && bUpdateFromClient)
@@ -241,6 +275,7 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagBetween(const CDateTime& beginTim
     if (tag)
     {
       m_tags.insert(std::make_pair(tag->StartAsUTC(), tag));
+      m_bIndexValid = false;
       UpdateEntry(tag, CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_EPG_STOREEPGINDATABASE));
     }
   }
@@ -265,6 +300,7 @@ void CPVREpg::AddEntry(const CPVREpgInfoTag& tag)
   newTag->Update(tag);
   newTag->SetChannelData(m_channelData);
   newTag->SetEpgID(m_iEpgID);
+  m_bIndexValid = false;
 }
 
 bool CPVREpg::Load(const std::shared_ptr<CPVREpgDatabase>& database)
@@ -351,11 +387,13 @@ bool CPVREpg::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& tag, bool bUpda
     bNewTag = true;
   }
 
-  infoTag->Update(*tag, bNewTag);
+  const bool bChanged = infoTag->Update(*tag, bNewTag);
   infoTag->SetChannelData(m_channelData);
   infoTag->SetEpgID(m_iEpgID);
+  m_bIndexValid = false;
 
-  if (bUpdateDatabase)
+  // guide refreshes mostly bring tags we have already, only write the ones that changed
+  if (bUpdateDatabase && (bChanged || bNewTag))
     m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
 
   return true;
@@ -391,10 +429,9 @@ bool CPVREpg::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& tag, EPG_EVENT_
       const CDateTime cleanupTime(CDateTime::GetUTCDateTime() - CDateTimeSpan(iPastDays, 0, 0, 0));
       if (it->second->EndAsUTC() < cleanupTime)
       {
-        if (bUpdateDatabase)
-          m_deletedTags.insert(std::make_pair(it->second->UniqueBroadcastID(), it->second));
-
+        // no need to delete it from the database, expired tags are deleted by end time when cleaning up
         m_tags.erase(it);
+        m_bIndexValid = false;
       }
       else
       {
@@ -473,6 +510,114 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpg::GetTags() const
   return tags;
 }
 
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpg::GetTags(const CPVREpgSearchFilter& filter) const
+{
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+
+  time_t begin;
+  filter.GetStartDateTime().GetAsUTCDateTime().GetAsTime(begin);
+  time_t end;
+  filter.GetEndDateTime().GetAsUTCDateTime().GetAsTime(end);
+
+  CSingleLock lock(m_critSection);
+  const CPVREpgTagIndex& index = GetIndex();
+
+  std::vector<int> candidates;
+  bool bNarrowed = GetTextIndex().GetCandidates(filter.GetTextSearch(), candidates);
+  if (bNarrowed && filter.ShouldSearchInDescription())
+  {
+    // a tag may match by its title or by its plot, plots too large to index have to be searched in all tags
+    const CTextIndex* plotIndex = GetPlotIndex();
+    std::vector<int> plotCandidates;
+    if (plotIndex && plotIndex->GetCandidates(filter.GetTextSearch(), plotCandidates))
+    {
+      std::vector<int> titleCandidates;
+      titleCandidates.swap(candidates);
+      std::set_union(titleCandidates.begin(), titleCandidates.end(), plotCandidates.begin(), plotCandidates.end(),
+                     std::back_inserter(candidates));
+    }
+    else
+      bNarrowed = false;
+  }
+
+  if (bNarrowed)
+  {
+    for (int iPos : candidates)
+    {
+      if (index.IsBetween(iPos, begin, end))
+        tags.emplace_back(index.GetTag(iPos));
+    }
+  }
+  else
+  {
+    index.GetTagsBetween(begin, end, tags);
+  }
+
+  return tags;
+}
+
+const CPVREpgTagIndex& CPVREpg::GetIndex() const
+{
+  if (!m_bIndexValid)
+  {
+    m_index->Clear();
+    m_index->Reserve(m_tags.size());
+    for (const auto& tag : m_tags)
+    {
+      time_t start;
+      tag.second->StartAsUTC().GetAsTime(start);
+      time_t end;
+      tag.second->EndAsUTC().GetAsTime(end);
+      m_index->Add(start, end, tag.second);
+    }
+    m_bIndexValid = true;
+    m_bTextIndexValid = false;
+    m_bPlotIndexValid = false;
+  }
+
+  return *m_index;
+}
+
+const CTextIndex& CPVREpg::GetTextIndex() const
+{
+  const CPVREpgTagIndex& index = GetIndex();
+  if (!m_bTextIndexValid)
+  {
+    m_textIndex->Clear();
+    for (int iPos = 0; iPos < index.Size(); ++iPos)
+    {
+      m_textIndex->Add(iPos, index.GetTag(iPos)->Title());
+      m_textIndex->Add(iPos, index.GetTag(iPos)->PlotOutline());
+    }
+    m_bTextIndexValid = true;
+  }
+
+  return *m_textIndex;
+}
+
+const CTextIndex* CPVREpg::GetPlotIndex() const
+{
+  const CPVREpgTagIndex& index = GetIndex();
+  if (!m_bPlotIndexValid)
+  {
+    m_plotIndex->Clear();
+    m_bPlotIndexTooLarge = false;
+    for (int iPos = 0; iPos < index.Size(); ++iPos)
+    {
+      m_plotIndex->Add(iPos, index.GetTag(iPos)->Plot());
+      if (m_plotIndex->GetIdCount() > MAX_PLOT_INDEX_IDS)
+      {
+        m_plotIndex->Clear();
+        m_bPlotIndexTooLarge = true;
+        break;
+      }
+    }
+    m_bPlotIndexValid = true;
+  }
+
+  return m_bPlotIndexTooLarge ? nullptr : m_plotIndex.get();
+}
+
 bool CPVREpg::Persist(const std::shared_ptr<CPVREpgDatabase>& database)
 {
   if (!database)
@@ -496,11 +641,18 @@ bool CPVREpg::Persist(const std::shared_ptr<CPVREpgDatabase>& database)
       }
     }
 
+    // queued with the other writes of this table, so they are committed in one transaction
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+    tags.reserve(m_deletedTags.size());
     for (const auto& tag : m_deletedTags)
-      database->Delete(*tag.second);
+      tags.emplace_back(tag.second);
+    database->QueueDeleteQueries(tags);
 
+    tags.clear();
+    tags.reserve(m_changedTags.size());
     for (const auto& tag : m_changedTags)
-      tag.second->Persist(database, false);
+      tags.emplace_back(tag.second);
+    database->QueuePersistQueries(tags);
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, m_lastScanTime, true);
@@ -549,6 +701,7 @@ CDateTime CPVREpg::GetLastDate(void) const
 bool CPVREpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
 {
   bool bReturn = true;
+  m_bIndexValid = false;
   std::shared_ptr<CPVREpgInfoTag> previousTag, currentTag;
 
   for (auto it = m_tags.begin(); it != m_tags.end(); it != m_tags.end() ? it++ : it)
@@ -622,7 +775,12 @@ bool CPVREpg::UpdateFromScraper(time_t start, time_t end, bool bForceUpdate)
       {
         CLog::LogFC(LOGDEBUG, LOGEPG, "Updating EPG for channel '%s' from client '%i'",
                     m_channelData->ChannelName().c_str(), m_channelData->ClientId());
-        return (client->GetEPGForChannel(m_channelData->UniqueClientChannelId(), this, start, end) == PVR_ERROR_NO_ERROR);
+        // the client's data may be shared with identical requests, so it is copied from a table of its own
+        std::shared_ptr<CPVREpg> clientEpg = std::make_shared<CPVREpg>(m_iEpgID, m_strName, m_strScraperName, m_channelData);
+        if (CServiceBroker::GetPVRManager().Clients()->GetEPGForChannel(m_channelData->ClientId(), m_channelData->UniqueClientChannelId(), clientEpg, start, end) != PVR_ERROR_NO_ERROR)
+          return false;
+
+        return UpdateEntries(*clientEpg, false);
       }
     }
     else
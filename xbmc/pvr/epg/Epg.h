@@ -18,6 +18,8 @@
 #include <string>
 #include <vector>
 
+class CTextIndex;
+
 namespace PVR
 {
   enum class PVREvent;
@@ -25,6 +27,8 @@ namespace PVR
   class CPVREpgChannelData;
   class CPVREpgDatabase;
   class CPVREpgInfoTag;
+  class CPVREpgSearchFilter;
+  class CPVREpgTagIndex;
 
   class CPVREpg
   {
@@ -201,6 +205,14 @@ namespace PVR
      */
     std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags() const;
 
+    /*!
+     * @brief Get the events that may match the given search filter. Only the time range and the search term are used
+     * to narrow down the events, the caller has to check the events found against the filter.
+     * @param filter The search filter.
+     * @return The events.
+     */
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CPVREpgSearchFilter& filter) const;
+
     /*!
      * @brief Persist this table in the given database
      * @param database The database.
@@ -302,6 +314,26 @@ namespace PVR
      */
     void Cleanup(int iPastDays);
 
+    /*!
+     * @brief Get the time index of the tags, rebuilding it if the tags changed. Must be called with the lock held.
+     * @return The index.
+     */
+    const CPVREpgTagIndex& GetIndex() const;
+
+    /*!
+     * @brief Get the word index of the titles and plot outlines of the tags, keyed by the positions in the time index,
+     * rebuilding it if the tags changed. Must be called with the lock held.
+     * @return The index.
+     */
+    const CTextIndex& GetTextIndex() const;
+
+    /*!
+     * @brief Get the word index of the plots of the tags, keyed by the positions in the time index, rebuilding it if
+     * the tags changed. Must be called with the lock held.
+     * @return The index, nullptr if the plots have too many words to index.
+     */
+    const CTextIndex* GetPlotIndex() const;
+
     std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>> m_tags;
     std::map<int, std::shared_ptr<CPVREpgInfoTag>>       m_changedTags;
     std::map<int, std::shared_ptr<CPVREpgInfoTag>>       m_deletedTags;
@@ -313,6 +345,13 @@ namespace PVR
     std::string                         m_strName;         /*!< the name of this table */
     std::string                         m_strScraperName;  /*!< the name of the scraper to use */
     mutable CDateTime                   m_nowActiveStart;  /*!< the start time of the tag that is currently active */
+    std::unique_ptr<CPVREpgTagIndex>    m_index;           /*!< time index of m_tags */
+    mutable bool                        m_bIndexValid = false; /*!< false if m_tags changed since m_index was built */
+    std::unique_ptr<CTextIndex>         m_textIndex;       /*!< word index of the titles in m_index, built on the first search */
+    mutable bool                        m_bTextIndexValid = false; /*!< false if m_index changed since m_textIndex was built */
+    std::unique_ptr<CTextIndex>         m_plotIndex;       /*!< word index of the plots in m_index, built on the first search in descriptions */
+    mutable bool                        m_bPlotIndexValid = false; /*!< false if m_index changed since m_plotIndex was built */
+    mutable bool                        m_bPlotIndexTooLarge = false; /*!< true if the plots had too many words for m_plotIndex */
     CDateTime                           m_lastScanTime;    /*!< the last time the EPG has been updated */
     mutable CCriticalSection            m_critSection;     /*!< critical section for changes in this table */
     bool                                m_bUpdateLastScanTime = false;
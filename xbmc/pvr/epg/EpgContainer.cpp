@@ -505,6 +505,20 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgContainer::GetAllTags() cons
   return allTags;
 }
 
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgContainer::GetTags(const CPVREpgSearchFilter& filter) const
+{
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+
+  CSingleLock lock(m_critSection);
+  for (const auto& epgEntry : m_epgIdToEpgMap)
+  {
+    const std::vector<std::shared_ptr<CPVREpgInfoTag>> epgTags = epgEntry.second->GetTags(filter);
+    tags.insert(tags.end(), epgTags.begin(), epgTags.end());
+  }
+
+  return tags;
+}
+
 void CPVREpgContainer::InsertFromDB(const std::shared_ptr<CPVREpg>& newEpg)
 {
   // table might already have been created when pvr channels were loaded
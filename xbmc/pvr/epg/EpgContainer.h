@@ -31,6 +31,7 @@ namespace PVR
   class CPVREpgChannelData;
   class CPVREpgDatabase;
   class CPVREpgInfoTag;
+  class CPVREpgSearchFilter;
 
   enum class PVREvent;
 
@@ -152,6 +153,13 @@ namespace PVR
      */
     std::vector<std::shared_ptr<CPVREpgInfoTag>> GetAllTags() const;
 
+    /*!
+     * @brief Get the EPG tags that may match the given search filter. The caller has to check the tags against the filter.
+     * @param filter The search filter.
+     * @return The tags.
+     */
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CPVREpgSearchFilter& filter) const;
+
     /*!
      * @brief Check whether data should be persisted to the EPG database.
      * @return True if data should be persisted to the EPG database, false otherwise.
@@ -25,6 +25,9 @@
 using namespace dbiplus;
 using namespace PVR;
 
+const size_t CPVREpgDatabase::MAX_ROWS_PER_QUERY;
+const size_t CPVREpgDatabase::MAX_QUERY_LENGTH;
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
@@ -354,61 +357,58 @@ int CPVREpgDatabase::Persist(const CPVREpg& epg, bool bQueueWrite /* = false */)
   return iReturn;
 }
 
-int CPVREpgDatabase::Persist(const CPVREpgInfoTag& tag, bool bSingleUpdate /* = true */)
+namespace
 {
-  int iReturn(-1);
-
-  if (tag.EpgID() <= 0)
-  {
-    CLog::LogF(LOGERROR, "Tag '%s' does not have a valid table", tag.Title().c_str());
-    return iReturn;
-  }
+const std::string EPGTAGS_COLUMNS = "idEpg, iStartTime, "
+    "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
+    "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
+    "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid";
+}
 
+std::string CPVREpgDatabase::PrepareTagValues(const CPVREpgInfoTag& tag, bool bWithDatabaseId) const
+{
   time_t iStartTime, iEndTime, iFirstAired;
   tag.StartAsUTC().GetAsTime(iStartTime);
   tag.EndAsUTC().GetAsTime(iEndTime);
   tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
 
-  int iBroadcastId = tag.DatabaseID();
-  std::string strQuery;
-
   /* Only store the genre string when needed */
   std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING || tag.GenreSubType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
 
-  CSingleLock lock(m_critSection);
+  std::string strValues = PrepareSQL("(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, '%s', %i",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
+      tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), false /* unused */,
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
+      tag.UniqueBroadcastID());
+
+  if (bWithDatabaseId)
+    strValues += PrepareSQL(", %i", tag.DatabaseID());
+
+  strValues += ")";
+  return strValues;
+}
 
-  if (iBroadcastId < 0)
+int CPVREpgDatabase::Persist(const CPVREpgInfoTag& tag, bool bSingleUpdate /* = true */)
+{
+  int iReturn(-1);
+
+  if (tag.EpgID() <= 0)
   {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, '%s', %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
-        tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), false /* unused */,
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
-        tag.UniqueBroadcastID());
+    CLog::LogF(LOGERROR, "Tag '%s' does not have a valid table", tag.Title().c_str());
+    return iReturn;
   }
+
+  CSingleLock lock(m_critSection);
+
+  std::string strQuery;
+  if (tag.DatabaseID() < 0)
+    strQuery = "REPLACE INTO epgtags (" + EPGTAGS_COLUMNS + ") VALUES " + PrepareTagValues(tag, false) + ";";
   else
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
-        tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), false /* unused */,
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
+    strQuery = "REPLACE INTO epgtags (" + EPGTAGS_COLUMNS + ", idBroadcast) VALUES " + PrepareTagValues(tag, true) + ";";
 
   if (bSingleUpdate)
   {
@@ -424,6 +424,82 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag& tag, bool bSingleUpdate /* =
   return iReturn;
 }
 
+bool CPVREpgDatabase::QueuePersistQueries(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+{
+  // tags that were persisted before keep their database id, all others get a new one
+  std::vector<std::string> newRows;
+  std::vector<std::string> existingRows;
+
+  CSingleLock lock(m_critSection);
+  for (const auto& tag : tags)
+  {
+    if (tag->EpgID() <= 0)
+    {
+      CLog::LogF(LOGERROR, "Tag '%s' does not have a valid table", tag->Title().c_str());
+      continue;
+    }
+
+    if (tag->DatabaseID() < 0)
+      newRows.emplace_back(PrepareTagValues(*tag, false));
+    else
+      existingRows.emplace_back(PrepareTagValues(*tag, true));
+  }
+
+  bool bReturn = true;
+  for (const auto& strQuery : CombineQueries("REPLACE INTO epgtags (" + EPGTAGS_COLUMNS + ") VALUES ", newRows, ";"))
+    bReturn &= QueueInsertQuery(strQuery);
+  for (const auto& strQuery : CombineQueries("REPLACE INTO epgtags (" + EPGTAGS_COLUMNS + ", idBroadcast) VALUES ", existingRows, ";"))
+    bReturn &= QueueInsertQuery(strQuery);
+
+  return bReturn;
+}
+
+bool CPVREpgDatabase::QueueDeleteQueries(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+{
+  std::vector<std::string> ids;
+  for (const auto& tag : tags)
+  {
+    /* tag without a database ID was not persisted */
+    if (tag->DatabaseID() > 0)
+      ids.emplace_back(std::to_string(tag->DatabaseID()));
+  }
+
+  CSingleLock lock(m_critSection);
+  bool bReturn = true;
+  for (const auto& strQuery : CombineQueries("DELETE FROM epgtags WHERE idBroadcast IN (", ids, ");"))
+    bReturn &= QueueInsertQuery(strQuery);
+
+  return bReturn;
+}
+
+std::vector<std::string> CPVREpgDatabase::CombineQueries(const std::string& strPrefix, const std::vector<std::string>& rows, const std::string& strSuffix)
+{
+  std::vector<std::string> queries;
+  std::string strQuery;
+  size_t iRows = 0;
+  for (const auto& row : rows)
+  {
+    if (iRows > 0 && (iRows == MAX_ROWS_PER_QUERY || strQuery.size() + row.size() > MAX_QUERY_LENGTH))
+    {
+      queries.emplace_back(strQuery + strSuffix);
+      iRows = 0;
+    }
+
+    if (iRows == 0)
+      strQuery = strPrefix;
+    else
+      strQuery += ", ";
+
+    strQuery += row;
+    iRows++;
+  }
+
+  if (iRows > 0)
+    queries.emplace_back(strQuery + strSuffix);
+
+  return queries;
+}
+
 int CPVREpgDatabase::GetLastEPGId(void)
 {
   CSingleLock lock(m_critSection);
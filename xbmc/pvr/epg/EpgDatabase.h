@@ -12,6 +12,7 @@
 #include "threads/CriticalSection.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class CDateTime;
@@ -145,6 +146,32 @@ namespace PVR
      */
     int Persist(const CPVREpgInfoTag& tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Queue the queries persisting the given tags. Several tags are written per query.
+     * @param tags The tags to persist.
+     * @return True if the queries were queued, false otherwise.
+     */
+    bool QueuePersistQueries(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags);
+
+    /*!
+     * @brief Queue the queries deleting the given tags. Several tags are deleted per query.
+     * @param tags The tags to delete. Tags that were not persisted are ignored.
+     * @return True if the queries were queued, false otherwise.
+     */
+    bool QueueDeleteQueries(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags);
+
+    /*!
+     * @brief Combine rows to as few queries as possible.
+     * @param strPrefix The start of each query, e.g. "REPLACE INTO table (a, b) VALUES ".
+     * @param rows The rows, separated by a comma in the queries.
+     * @param strSuffix The end of each query, e.g. ";".
+     * @return The queries, holding at most MAX_ROWS_PER_QUERY rows and about MAX_QUERY_LENGTH characters each.
+     */
+    static std::vector<std::string> CombineQueries(const std::string& strPrefix, const std::vector<std::string>& rows, const std::string& strSuffix);
+
+    static const size_t MAX_ROWS_PER_QUERY = 100;
+    static const size_t MAX_QUERY_LENGTH = 500000;
+
     /*!
      * @return Last EPG id in the database
      */
@@ -171,6 +198,14 @@ namespace PVR
 
     int GetMinSchemaVersion() const override { return 4; }
 
+    /*!
+     * @brief Get the values of a tag to write to the epgtags table.
+     * @param tag The tag.
+     * @param bWithDatabaseId True to include the database id of the tag.
+     * @return The values, in parentheses.
+     */
+    std::string PrepareTagValues(const CPVREpgInfoTag& tag, bool bWithDatabaseId) const;
+
     CCriticalSection m_critSection;
   };
 }
@@ -35,6 +35,7 @@ CPVREpgSearchFilter::CPVREpgSearchFilter(bool bRadio)
 void CPVREpgSearchFilter::Reset()
 {
   m_strSearchTerm.clear();
+  m_textSearch.reset();
   m_bIsCaseSensitive         = false;
   m_bSearchInDescription     = false;
   m_iGenreType               = EPG_SEARCH_UNSET;
@@ -106,6 +107,15 @@ void CPVREpgSearchFilter::SetSearchPhrase(const std::string& strSearchPhrase)
   m_strSearchTerm = "\"";
   m_strSearchTerm.append(strSearchPhrase);
   m_strSearchTerm.append("\"");
+  m_textSearch.reset();
+}
+
+const CTextSearch& CPVREpgSearchFilter::GetTextSearch() const
+{
+  if (!m_textSearch)
+    m_textSearch = std::make_shared<CTextSearch>(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
+
+  return *m_textSearch;
 }
 
 bool CPVREpgSearchFilter::MatchSearchTerm(const std::shared_ptr<CPVREpgInfoTag>& tag) const
@@ -114,7 +124,7 @@ bool CPVREpgSearchFilter::MatchSearchTerm(const std::shared_ptr<CPVREpgInfoTag>&
 
   if (!m_strSearchTerm.empty())
   {
-    CTextSearch search(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
+    const CTextSearch& search = GetTextSearch();
     bReturn = !CServiceBroker::GetPVRManager().IsParentalLocked(tag);
     if (bReturn)
       bReturn = search.Search(tag->Title()) ||
@@ -15,6 +15,8 @@
 #include <string>
 #include <vector>
 
+class CTextSearch;
+
 namespace PVR
 {
   #define EPG_SEARCH_UNSET (-1)
@@ -59,11 +61,17 @@ namespace PVR
     bool IsRadio() const { return m_bIsRadio; }
 
     const std::string& GetSearchTerm() const { return m_strSearchTerm; }
-    void SetSearchTerm(const std::string& strSearchTerm) { m_strSearchTerm = strSearchTerm; }
+    void SetSearchTerm(const std::string& strSearchTerm) { m_strSearchTerm = strSearchTerm; m_textSearch.reset(); }
     void SetSearchPhrase(const std::string& strSearchPhrase);
 
+    /*!
+     * @brief Get the parsed search term.
+     * @return The search.
+     */
+    const CTextSearch& GetTextSearch() const;
+
     bool IsCaseSensitive() const { return m_bIsCaseSensitive; }
-    void SetCaseSensitive(bool bIsCaseSensitive) { m_bIsCaseSensitive = bIsCaseSensitive; }
+    void SetCaseSensitive(bool bIsCaseSensitive) { m_bIsCaseSensitive = bIsCaseSensitive; m_textSearch.reset(); }
 
     bool ShouldSearchInDescription() const { return m_bSearchInDescription; }
     void SetSearchInDescription(bool bSearchInDescription) {m_bSearchInDescription = bSearchInDescription; }
@@ -124,6 +132,7 @@ namespace PVR
     bool MatchRecordings(const std::shared_ptr<CPVREpgInfoTag>& tag) const;
 
     std::string   m_strSearchTerm;            /*!< The term to search for */
+    mutable std::shared_ptr<CTextSearch> m_textSearch; /*!< The parsed search term, created on first use */
     bool          m_bIsCaseSensitive;         /*!< Do a case sensitive search */
     bool          m_bSearchInDescription;     /*!< Search for strSearchTerm in the description too */
     int           m_iGenreType;               /*!< The genre type for an entry */
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "EpgTagIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace PVR;
+
+const int CPVREpgTagIndex::INVALID_POS;
+
+void CPVREpgTagIndex::Clear()
+{
+  m_starts.clear();
+  m_ends.clear();
+  m_maxEnds.clear();
+  m_tags.clear();
+}
+
+void CPVREpgTagIndex::Reserve(size_t iSize)
+{
+  m_starts.reserve(iSize);
+  m_ends.reserve(iSize);
+  m_maxEnds.reserve(iSize);
+  m_tags.reserve(iSize);
+}
+
+void CPVREpgTagIndex::Add(time_t start, time_t end, const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  m_starts.emplace_back(start);
+  m_ends.emplace_back(end);
+  m_maxEnds.emplace_back(m_maxEnds.empty() ? end : std::max(m_maxEnds.back(), end));
+  m_tags.emplace_back(tag);
+}
+
+int CPVREpgTagIndex::FindActive(time_t time) const
+{
+  // tags starting after the given time can't be active. walk back from the last tag starting
+  // before, as long as an earlier tag still ends after the given time (overlapping tags).
+  const auto it = std::upper_bound(m_starts.begin(), m_starts.end(), time);
+  int iActive = INVALID_POS;
+  for (int i = static_cast<int>(std::distance(m_starts.begin(), it)) - 1; i >= 0 && m_maxEnds[i] > time; --i)
+  {
+    if (m_ends[i] > time)
+      iActive = i;
+  }
+  return iActive;
+}
+
+int CPVREpgTagIndex::FindLastEnded(time_t time) const
+{
+  const auto it = std::upper_bound(m_starts.begin(), m_starts.end(), time);
+  for (int i = static_cast<int>(std::distance(m_starts.begin(), it)) - 1; i >= 0; --i)
+  {
+    if (m_ends[i] < time)
+      return i;
+  }
+  return INVALID_POS;
+}
+
+int CPVREpgTagIndex::FindFirstUpcoming(time_t time) const
+{
+  const auto it = std::upper_bound(m_starts.begin(), m_starts.end(), time);
+  if (it == m_starts.end())
+    return INVALID_POS;
+
+  return static_cast<int>(std::distance(m_starts.begin(), it));
+}
+
+int CPVREpgTagIndex::FindFirstBetween(time_t begin, time_t end) const
+{
+  const auto it = std::lower_bound(m_starts.begin(), m_starts.end(), begin);
+  for (int i = static_cast<int>(std::distance(m_starts.begin(), it)); i < Size() && m_starts[i] <= end; ++i)
+  {
+    if (m_ends[i] <= end)
+      return i;
+  }
+  return INVALID_POS;
+}
+
+void CPVREpgTagIndex::GetTagsBetween(time_t begin, time_t end, std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags) const
+{
+  const auto it = std::lower_bound(m_starts.begin(), m_starts.end(), begin);
+  for (int i = static_cast<int>(std::distance(m_starts.begin(), it)); i < Size() && m_starts[i] <= end; ++i)
+  {
+    if (m_ends[i] <= end)
+      tags.emplace_back(m_tags[i]);
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2012-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <ctime>
+#include <memory>
+#include <vector>
+
+namespace PVR
+{
+  class CPVREpgInfoTag;
+
+  /*!
+   * @brief Time index over the tags of an EPG.
+   *
+   * Start and end times are kept in sorted arrays next to the tags, so the tag at a given
+   * time and the tags within a time range are found with a binary search rather than by
+   * walking all tags. The index is a snapshot; it has to be rebuilt when the tags change.
+   */
+  class CPVREpgTagIndex
+  {
+  public:
+    static const int INVALID_POS = -1;
+
+    /*!
+     * @brief Remove all tags from the index.
+     */
+    void Clear();
+
+    /*!
+     * @brief Reserve memory for the given number of tags.
+     * @param iSize The number of tags.
+     */
+    void Reserve(size_t iSize);
+
+    /*!
+     * @brief Add a tag. Tags must be added in the order of their start times.
+     * @param start The start time of the tag.
+     * @param end The end time of the tag.
+     * @param tag The tag.
+     */
+    void Add(time_t start, time_t end, const std::shared_ptr<CPVREpgInfoTag>& tag);
+
+    bool IsEmpty() const { return m_starts.empty(); }
+    int Size() const { return static_cast<int>(m_starts.size()); }
+    const std::shared_ptr<CPVREpgInfoTag>& GetTag(int iPos) const { return m_tags[iPos]; }
+
+    /*!
+     * @brief Check whether a tag starts and ends within the given times.
+     * @param iPos The position of the tag.
+     * @param begin The earliest start time of the tag.
+     * @param end The latest end time of the tag.
+     * @return True if the tag is within that time, false otherwise.
+     */
+    bool IsBetween(int iPos, time_t begin, time_t end) const { return m_starts[iPos] >= begin && m_ends[iPos] <= end; }
+
+    /*!
+     * @brief Find the first tag active at the given time.
+     * @param time The time.
+     * @return The position of the tag or INVALID_POS if no tag is active at that time.
+     */
+    int FindActive(time_t time) const;
+
+    /*!
+     * @brief Find the last tag that ended before the given time.
+     * @param time The time.
+     * @return The position of the tag or INVALID_POS if no tag ended before that time.
+     */
+    int FindLastEnded(time_t time) const;
+
+    /*!
+     * @brief Find the first tag starting after the given time.
+     * @param time The time.
+     * @return The position of the tag or INVALID_POS if no tag starts after that time.
+     */
+    int FindFirstUpcoming(time_t time) const;
+
+    /*!
+     * @brief Find the first tag starting and ending within the given times.
+     * @param begin The earliest start time of the tag.
+     * @param end The latest end time of the tag.
+     * @return The position of the tag or INVALID_POS if no tag is within that time.
+     */
+    int FindFirstBetween(time_t begin, time_t end) const;
+
+    /*!
+     * @brief Get all tags starting and ending within the given times.
+     * @param begin The earliest start time of the tags.
+     * @param end The latest end time of the tags.
+     * @param tags The tags to append the tags found to.
+     */
+    void GetTagsBetween(time_t begin, time_t end, std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags) const;
+
+  private:
+    std::vector<time_t> m_starts;
+    std::vector<time_t> m_ends;
+    std::vector<time_t> m_maxEnds; // the latest end time of the tags up to this one
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> m_tags;
+  };
+}
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestBasicEnvironment.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const time_t GUIDE_START = 1600000000;
+
+// an hour long tag of the EPG's channel, as a client add-on provides it
+std::shared_ptr<CPVREpgInfoTag> CreateTag(const CPVREpg& epg, int hour, const std::string& title)
+{
+  const std::shared_ptr<CPVREpgChannelData> channelData = epg.GetChannelData();
+  const std::string plot = "The plot of " + title + ", long enough to be a real one. " + std::string(200, 'x');
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = hour + 1;
+  data.iUniqueChannelId = static_cast<unsigned int>(channelData->UniqueClientChannelId());
+  data.strTitle = title.c_str();
+  data.strPlot = plot.c_str();
+  data.startTime = GUIDE_START + hour * 3600;
+  data.endTime = data.startTime + 3600;
+  data.iGenreType = EPG_EVENT_CONTENTMASK_MOVIEDRAMA;
+  return std::make_shared<CPVREpgInfoTag>(data, channelData->ClientId(), channelData, epg.EpgID());
+}
+}
+
+TEST(BenchmarkEpgDatabase, PersistSyntheticGuide)
+{
+  XFILE::CFile::Delete("special://temp/BenchmarkEpg.db");
+
+  DatabaseSettings settings;
+  settings.type = "sqlite3";
+  settings.name = "BenchmarkEpg";
+  settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+  const std::shared_ptr<CPVREpgDatabase> database = std::make_shared<CPVREpgDatabase>();
+  ASSERT_TRUE(database->Connect("BenchmarkEpg", settings, true));
+
+  // 1000 channels with 14 days of hourly programmes, refreshed twice by their add-on:
+  // once bringing the same guide and once with one programme a day changed
+  const int channels = 1000;
+  const int hours = 14 * 24;
+  std::chrono::steady_clock::duration initial{};
+  std::chrono::steady_clock::duration unchanged{};
+  std::chrono::steady_clock::duration changed{};
+  for (int channel = 1; channel <= channels; ++channel)
+  {
+    CPVREpg epg(channel, "Channel " + std::to_string(channel), "client");
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int hour = 0; hour < hours; ++hour)
+      epg.UpdateEntry(CreateTag(epg, hour, "Programme " + std::to_string(hour)), true);
+    ASSERT_TRUE(epg.Persist(database));
+    initial += std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    for (int hour = 0; hour < hours; ++hour)
+      epg.UpdateEntry(CreateTag(epg, hour, "Programme " + std::to_string(hour)), true);
+    ASSERT_FALSE(epg.NeedsSave());
+    ASSERT_TRUE(epg.Persist(database));
+    unchanged += std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    for (int hour = 0; hour < hours; ++hour)
+      epg.UpdateEntry(CreateTag(epg, hour, "Programme " + std::to_string(hour) + (hour % 24 == 0 ? " (changed)" : "")), true);
+    ASSERT_TRUE(epg.Persist(database));
+    changed += std::chrono::steady_clock::now() - begin;
+
+    if (channel == channels)
+      EXPECT_EQ(static_cast<size_t>(hours), database->Get(epg).size());
+  }
+
+  database->Close();
+  XFILE::CFile::Delete("special://temp/BenchmarkEpg.db");
+
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  RecordProperty("tags", channels * hours);
+  RecordProperty("initialMilliseconds", static_cast<int>(duration_cast<milliseconds>(initial).count()));
+  RecordProperty("unchangedMilliseconds", static_cast<int>(duration_cast<milliseconds>(unchanged).count()));
+  RecordProperty("changedMilliseconds", static_cast<int>(duration_cast<milliseconds>(changed).count()));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  CXBMCTestUtils::Instance().ParseArgs(argc, argv);
+
+  if (!testing::AddGlobalTestEnvironment(new TestBasicEnvironment()))
+  {
+    fprintf(stderr, "Unable to add basic test environment.\n");
+    exit(EXIT_FAILURE);
+  }
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,191 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "settings/AdvancedSettings.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const time_t GUIDE_START = 1600000000;
+
+// an hour long tag of the EPG's channel, as a client add-on provides it
+std::shared_ptr<CPVREpgInfoTag> CreateTag(const CPVREpg& epg, int hour, const char* title)
+{
+  const std::shared_ptr<CPVREpgChannelData> channelData = epg.GetChannelData();
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = hour + 1;
+  data.iUniqueChannelId = static_cast<unsigned int>(channelData->UniqueClientChannelId());
+  data.strTitle = title;
+  data.startTime = GUIDE_START + hour * 3600;
+  data.endTime = data.startTime + 3600;
+  data.iGenreType = EPG_EVENT_CONTENTMASK_MOVIEDRAMA;
+  return std::make_shared<CPVREpgInfoTag>(data, channelData->ClientId(), channelData, epg.EpgID());
+}
+
+// an EPG database with the real schema in the temp folder
+class TestEpgDatabasePersist : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    XFILE::CFile::Delete("special://temp/TestEpg.db");
+
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.name = "TestEpg";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    m_database = std::make_shared<CPVREpgDatabase>();
+    ASSERT_TRUE(m_database->Connect("TestEpg", settings, true));
+  }
+
+  void TearDown() override
+  {
+    m_database->Close();
+    XFILE::CFile::Delete("special://temp/TestEpg.db");
+  }
+
+  // the persisted tags of an EPG by start time
+  std::map<time_t, std::shared_ptr<CPVREpgInfoTag>> GetTags(const CPVREpg& epg)
+  {
+    std::map<time_t, std::shared_ptr<CPVREpgInfoTag>> tags;
+    for (const auto& tag : m_database->Get(epg))
+    {
+      time_t start;
+      tag->StartAsUTC().GetAsTime(start);
+      tags[start] = tag;
+    }
+    return tags;
+  }
+
+  std::shared_ptr<CPVREpgDatabase> m_database;
+};
+}
+
+TEST(TestEpgDatabase, CombineQueries)
+{
+  const std::vector<std::string> rows = {"1", "2", "3"};
+  const auto queries = CPVREpgDatabase::CombineQueries("DELETE FROM epgtags WHERE idBroadcast IN (", rows, ");");
+  ASSERT_EQ(1u, queries.size());
+  EXPECT_EQ("DELETE FROM epgtags WHERE idBroadcast IN (1, 2, 3);", queries[0]);
+
+  EXPECT_TRUE(CPVREpgDatabase::CombineQueries("DELETE FROM epgtags WHERE idBroadcast IN (", {}, ");").empty());
+}
+
+TEST(TestEpgDatabase, CombineQueriesLimits)
+{
+  // at most MAX_ROWS_PER_QUERY rows per query
+  const std::vector<std::string> rows(CPVREpgDatabase::MAX_ROWS_PER_QUERY * 2 + 1, "(1)");
+  auto queries = CPVREpgDatabase::CombineQueries("INSERT INTO t (a) VALUES ", rows, ";");
+  EXPECT_EQ(3u, queries.size());
+  EXPECT_EQ("INSERT INTO t (a) VALUES (1);", queries[2]);
+
+  // long rows start a new query rather than growing it beyond MAX_QUERY_LENGTH
+  const std::vector<std::string> longRows(3, "('" + std::string(CPVREpgDatabase::MAX_QUERY_LENGTH / 2, 'x') + "')");
+  queries = CPVREpgDatabase::CombineQueries("INSERT INTO t (a) VALUES ", longRows, ";");
+  EXPECT_EQ(3u, queries.size());
+}
+
+TEST_F(TestEpgDatabasePersist, WritesOnlyChangedTags)
+{
+  CPVREpg epg(1, "Channel", "client");
+  for (int hour = 0; hour < 48; ++hour)
+    ASSERT_TRUE(epg.UpdateEntry(CreateTag(epg, hour, "Programme"), true));
+  ASSERT_TRUE(epg.UpdateEntry(CreateTag(epg, 48, "It's quoted"), true));
+  ASSERT_TRUE(epg.NeedsSave());
+  ASSERT_TRUE(epg.Persist(m_database));
+
+  const std::map<time_t, std::shared_ptr<CPVREpgInfoTag>> persisted = GetTags(epg);
+  ASSERT_EQ(49u, persisted.size());
+  EXPECT_EQ("It's quoted", persisted.rbegin()->second->Title());
+  EXPECT_EQ(49u, persisted.rbegin()->second->UniqueBroadcastID());
+
+  // a refresh bringing the same tags writes nothing, a rewritten tag would get a new database id
+  for (int hour = 0; hour < 48; ++hour)
+    ASSERT_TRUE(epg.UpdateEntry(CreateTag(epg, hour, "Programme"), true));
+  EXPECT_FALSE(epg.NeedsSave());
+  ASSERT_TRUE(epg.Persist(m_database));
+
+  std::map<time_t, std::shared_ptr<CPVREpgInfoTag>> refreshed = GetTags(epg);
+  ASSERT_EQ(persisted.size(), refreshed.size());
+  for (const auto& tag : persisted)
+    EXPECT_EQ(tag.second->DatabaseID(), refreshed[tag.first]->DatabaseID());
+
+  // only the changed tag is written
+  ASSERT_TRUE(epg.UpdateEntry(CreateTag(epg, 5, "Changed"), true));
+  EXPECT_TRUE(epg.NeedsSave());
+  ASSERT_TRUE(epg.Persist(m_database));
+
+  refreshed = GetTags(epg);
+  ASSERT_EQ(persisted.size(), refreshed.size());
+  for (const auto& tag : persisted)
+  {
+    if (tag.first == GUIDE_START + 5 * 3600)
+    {
+      EXPECT_NE(tag.second->DatabaseID(), refreshed[tag.first]->DatabaseID());
+      EXPECT_EQ("Changed", refreshed[tag.first]->Title());
+    }
+    else
+    {
+      EXPECT_EQ(tag.second->DatabaseID(), refreshed[tag.first]->DatabaseID());
+      EXPECT_EQ(tag.second->Title(), refreshed[tag.first]->Title());
+    }
+  }
+}
+
+TEST_F(TestEpgDatabasePersist, WritesAndDeletesSeveralTagsPerQuery)
+{
+  // more tags than fit into one query
+  CPVREpg epg(2, "Channel", "client");
+  const int count = static_cast<int>(CPVREpgDatabase::MAX_ROWS_PER_QUERY) * 2 + 1;
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (int hour = 0; hour < count; ++hour)
+    tags.emplace_back(CreateTag(epg, hour, "Programme"));
+  ASSERT_TRUE(m_database->QueuePersistQueries(tags));
+  ASSERT_TRUE(m_database->CommitInsertQueries());
+
+  // tags loaded from the database are written back with their database id
+  ASSERT_TRUE(epg.Load(m_database));
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> loaded = epg.GetTags();
+  ASSERT_EQ(static_cast<size_t>(count), loaded.size());
+  for (const auto& tag : loaded)
+    ASSERT_GT(tag->DatabaseID(), 0);
+  ASSERT_TRUE(m_database->QueuePersistQueries(loaded));
+  ASSERT_TRUE(m_database->CommitInsertQueries());
+  const std::map<time_t, std::shared_ptr<CPVREpgInfoTag>> rewritten = GetTags(epg);
+  ASSERT_EQ(static_cast<size_t>(count), rewritten.size());
+  for (const auto& tag : loaded)
+  {
+    time_t start;
+    tag->StartAsUTC().GetAsTime(start);
+    EXPECT_EQ(tag->DatabaseID(), rewritten.at(start)->DatabaseID());
+  }
+
+  // every other tag deleted
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> deleted;
+  for (size_t i = 0; i < loaded.size(); i += 2)
+    deleted.emplace_back(loaded[i]);
+  ASSERT_TRUE(m_database->QueueDeleteQueries(deleted));
+  ASSERT_TRUE(m_database->CommitInsertQueries());
+  EXPECT_EQ(loaded.size() - deleted.size(), GetTags(epg).size());
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "pvr/epg/EpgTagIndex.h"
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+// tags at 0-10, 10-20, a gap, 30-40 and 40-50
+CPVREpgTagIndex MakeIndex()
+{
+  CPVREpgTagIndex index;
+  index.Add(0, 10, nullptr);
+  index.Add(10, 20, nullptr);
+  index.Add(30, 40, nullptr);
+  index.Add(40, 50, nullptr);
+  return index;
+}
+}
+
+TEST(TestEpgTagIndex, FindActive)
+{
+  const CPVREpgTagIndex index = MakeIndex();
+  EXPECT_EQ(0, index.FindActive(0));
+  EXPECT_EQ(0, index.FindActive(9));
+  EXPECT_EQ(1, index.FindActive(10));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindActive(25));
+  EXPECT_EQ(3, index.FindActive(49));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindActive(50));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindActive(-1));
+}
+
+TEST(TestEpgTagIndex, FindActiveOverlapping)
+{
+  // the first tag in order wins, like walking all tags did
+  CPVREpgTagIndex index;
+  index.Add(0, 100, nullptr);
+  index.Add(10, 20, nullptr);
+  index.Add(30, 40, nullptr);
+  EXPECT_EQ(0, index.FindActive(35));
+  EXPECT_EQ(0, index.FindActive(99));
+}
+
+TEST(TestEpgTagIndex, FindLastEndedAndUpcoming)
+{
+  const CPVREpgTagIndex index = MakeIndex();
+  EXPECT_EQ(1, index.FindLastEnded(25));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindLastEnded(5));
+  EXPECT_EQ(3, index.FindLastEnded(60));
+
+  EXPECT_EQ(2, index.FindFirstUpcoming(25));
+  EXPECT_EQ(0, index.FindFirstUpcoming(-1));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindFirstUpcoming(40));
+}
+
+TEST(TestEpgTagIndex, Between)
+{
+  const CPVREpgTagIndex index = MakeIndex();
+  EXPECT_EQ(1, index.FindFirstBetween(5, 45));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindFirstBetween(12, 28));
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  index.GetTagsBetween(5, 45, tags);
+  EXPECT_EQ(2u, tags.size());
+  index.GetTagsBetween(0, 50, tags);
+  EXPECT_EQ(6u, tags.size());
+}
+
+TEST(TestEpgTagIndex, Empty)
+{
+  CPVREpgTagIndex index = MakeIndex();
+  index.Clear();
+  EXPECT_TRUE(index.IsEmpty());
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindActive(5));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindLastEnded(5));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindFirstUpcoming(5));
+  EXPECT_EQ(CPVREpgTagIndex::INVALID_POS, index.FindFirstBetween(0, 50));
+}
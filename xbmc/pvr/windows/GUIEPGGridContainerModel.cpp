@@ -16,9 +16,11 @@
 #include "pvr/epg/Epg.h"
 #include "pvr/epg/EpgChannelData.h"
 #include "pvr/epg/EpgInfoTag.h"
+#include "threads/SingleLock.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <vector>
@@ -27,6 +29,39 @@ using namespace PVR;
 
 static const unsigned int GRID_START_PADDING = 30; // minutes
 
+namespace
+{
+// the first block starting at or after the given number of seconds since grid start
+int GetBlockAtOrAfter(int seconds)
+{
+  const int blockSeconds = CGUIEPGGridContainerModel::MINSPERBLOCK * 60;
+  if (seconds <= 0)
+    return -(-seconds / blockSeconds);
+  return (seconds + blockSeconds - 1) / blockSeconds;
+}
+
+int GetSecondsSince(const CDateTime& start, const CDateTime& datetime)
+{
+  if (start > datetime)
+    return -1 * (start - datetime).GetSecondsTotal();
+  return (datetime - start).GetSecondsTotal();
+}
+}
+
+CGUIEPGGridContainerModel::CGUIEPGGridContainerModel(const CGUIEPGGridContainerModel& other)
+  : m_gridStart(other.m_gridStart),
+    m_gridEnd(other.m_gridEnd),
+    m_programmeItems(other.m_programmeItems),
+    m_channelItems(other.m_channelItems),
+    m_rulerItems(other.m_rulerItems),
+    m_epgItemsPtr(other.m_epgItemsPtr),
+    m_blocks(other.m_blocks),
+    m_blockSize(other.m_blockSize)
+{
+  CSingleLock lock(other.m_critSection);
+  m_channelGrids = other.m_channelGrids;
+}
+
 void CGUIEPGGridContainerModel::SetInvalid()
 {
   for (const auto& programme : m_programmeItems)
@@ -148,7 +183,6 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
 
   ////////////////////////////////////////////////////////////////////////
   // Create epg grid
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
   const CDateTimeSpan gridDuration(m_gridEnd - m_gridStart);
   m_blocks = (gridDuration.GetDays() * 24 * 60 + gridDuration.GetHours() * 60 + gridDuration.GetMinutes()) / MINSPERBLOCK;
   if (m_blocks >= MAXBLOCKS)
@@ -156,113 +190,121 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   else if (m_blocks < iBlocksPerPage)
     m_blocks = iBlocksPerPage;
 
-  m_gridIndex.reserve(m_channelItems.size());
-  const std::vector<GridItem> blocks(m_blocks);
+  // the grid items of a channel are created when it's first shown
+  m_blockSize = fBlockSize;
+  m_channelGrids.resize(m_channelItems.size());
+}
 
-  for (size_t channel = 0; channel < m_channelItems.size(); ++channel)
+std::vector<CGUIEPGGridContainerModel::GridRun> CGUIEPGGridContainerModel::LayoutProgrammes(const std::vector<ProgrammeSpan>& programmes, int iBlockCount)
+{
+  std::vector<GridRun> runs;
+  int nextBlock = 0;
+  for (size_t i = 0; i < programmes.size() && nextBlock < iBlockCount; ++i)
   {
-    m_gridIndex.emplace_back(blocks);
-
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[channel].start;
-    unsigned long lastIdx = m_epgItemsPtr[channel].stop;
-    int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    int itemSize          = 1; // size of the programme in blocks
-    int savedBlock        = 0;
-    CFileItemPtr item;
-    std::shared_ptr<CPVREpgInfoTag> tag;
-
-    for (int block = 0; block < m_blocks; ++block)
-    {
-      while (progIdx <= lastIdx)
-      {
-        item = m_programmeItems[progIdx];
-        tag = item->GetEPGInfoTag();
+    // Note: Start block of an event is start-time-based calculated block + 1,
+    //       unless start times matches exactly the begin of a block.
+    //       Overlapping events start after the event before them.
+    const int firstBlock = std::max(GetBlockAtOrAfter(programmes[i].start), nextBlock);
+    const int lastBlock = std::min(GetBlockAtOrAfter(programmes[i].end) - 1, iBlockCount - 1);
+    if (firstBlock > lastBlock)
+      continue;
 
-        // Note: Start block of an event is start-time-based calculated block + 1,
-        //       unless start times matches exactly the begin of a block.
+    if (firstBlock > nextBlock)
+      runs.push_back({nextBlock, INVALID_INDEX});
 
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break;
+    runs.push_back({firstBlock, static_cast<int>(i)});
+    nextBlock = lastBlock + 1;
+  }
 
-        if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[channel][block].item = item;
-          m_gridIndex[channel][block].progIndex = progIdx;
-          break;
-        }
+  if (nextBlock < iBlockCount)
+    runs.push_back({nextBlock, INVALID_INDEX});
 
-        progIdx++;
-      }
+  return runs;
+}
 
-      gridCursor += blockDuration;
+CGUIEPGGridContainerModel::ChannelGrid& CGUIEPGGridContainerModel::GetChannelGrid(int iChannel) const
+{
+  CSingleLock lock(m_critSection);
 
-      if (block == 0)
-        continue;
+  ChannelGrid& grid = m_channelGrids[iChannel];
+  if (grid.created)
+    return grid;
 
-      const CFileItemPtr prevItem(m_gridIndex[channel][block - 1].item);
-      const CFileItemPtr currItem(m_gridIndex[channel][block].item);
+  const long firstIdx = m_epgItemsPtr[iChannel].start;
+  const long lastIdx = m_epgItemsPtr[iChannel].stop;
+  const int iEpgId = m_programmeItems[firstIdx]->GetEPGInfoTag()->EpgID();
 
-      if (block == m_blocks - 1 || prevItem != currItem)
-      {
-        // special handling for last block.
-        int blockDelta = -1;
-        int sizeDelta = 0;
-        if (block == m_blocks - 1 && prevItem == currItem)
-        {
-          itemSize++;
-          blockDelta = 0;
-          sizeDelta = 1;
-        }
-
-        if (prevItem)
-        {
-          m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
-        }
-        else
-        {
-          const std::shared_ptr<CFileItem> gapItem = CreateGapItem(channel);
-          for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
-          {
-            m_gridIndex[channel][i].item = gapItem;
-          }
-        }
-
-        float fItemWidth = itemSize * fBlockSize;
-        m_gridIndex[channel][savedBlock].originWidth = fItemWidth;
-        m_gridIndex[channel][savedBlock].width = fItemWidth;
-
-        itemSize = 1;
-        savedBlock = block;
-
-        // special handling for last block.
-        if (block == m_blocks - 1 && prevItem != currItem)
-        {
-          if (currItem)
-          {
-            m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
-          }
-          else
-          {
-            m_gridIndex[channel][block].item = CreateGapItem(channel);
-          }
-
-          m_gridIndex[channel][savedBlock].originWidth = fBlockSize; // size always 1 block here
-          m_gridIndex[channel][savedBlock].width = fBlockSize;
-        }
-      }
-      else
-      {
-        itemSize++;
-      }
+  std::vector<ProgrammeSpan> programmes;
+  for (long progIdx = firstIdx; progIdx <= lastIdx; ++progIdx)
+  {
+    const std::shared_ptr<CPVREpgInfoTag> tag = m_programmeItems[progIdx]->GetEPGInfoTag();
+    if (tag->EpgID() != iEpgId || m_gridEnd <= tag->StartAsUTC())
+      break;
+
+    programmes.push_back({GetSecondsSince(m_gridStart, tag->StartAsUTC()), GetSecondsSince(m_gridStart, tag->EndAsUTC())});
+  }
+
+  const std::vector<GridRun> runs = LayoutProgrammes(programmes, m_blocks);
+  grid.blocks.reserve(runs.size());
+  grid.items.reserve(runs.size());
+  for (size_t i = 0; i < runs.size(); ++i)
+  {
+    const int nextBlock = i + 1 < runs.size() ? runs[i + 1].block : m_blocks;
+
+    GridItem gridItem;
+    if (runs[i].programme == INVALID_INDEX)
+    {
+      gridItem.item = CreateGapItem(iChannel);
+    }
+    else
+    {
+      gridItem.progIndex = firstIdx + runs[i].programme;
+      gridItem.item = m_programmeItems[gridItem.progIndex];
+      gridItem.item->SetProperty("GenreType", gridItem.item->GetEPGInfoTag()->GenreType());
     }
+    gridItem.originWidth = (nextBlock - runs[i].block) * m_blockSize;
+    gridItem.width = gridItem.originWidth;
+
+    grid.blocks.emplace_back(runs[i].block);
+    grid.items.emplace_back(gridItem);
   }
+
+  grid.created = true;
+  return grid;
 }
 
-void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int& newChannelIndex, int& newBlockIndex) const
+GridItem& CGUIEPGGridContainerModel::GetGridItemAt(int iChannel, int iBlock) const
+{
+  ChannelGrid& grid = GetChannelGrid(iChannel);
+  const auto it = std::upper_bound(grid.blocks.begin(), grid.blocks.end(), iBlock);
+  return grid.items[std::distance(grid.blocks.begin(), it) - 1];
+}
+
+bool CGUIEPGGridContainerModel::IsFirstBlock(int iChannel, int iBlock) const
+{
+  const ChannelGrid& grid = GetChannelGrid(iChannel);
+  return std::binary_search(grid.blocks.begin(), grid.blocks.end(), iBlock);
+}
+
+float CGUIEPGGridContainerModel::GetGridItemWidth(int iChannel, int iBlock) const
+{
+  // only the first block of an item has a width
+  return IsFirstBlock(iChannel, iBlock) ? GetGridItemAt(iChannel, iBlock).width : 0.0f;
+}
+
+float CGUIEPGGridContainerModel::GetGridItemOriginWidth(int iChannel, int iBlock) const
+{
+  return IsFirstBlock(iChannel, iBlock) ? GetGridItemAt(iChannel, iBlock).originWidth : 0.0f;
+}
+
+void CGUIEPGGridContainerModel::SetGridItemWidth(int iChannel, int iBlock, float fWidth)
 {
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  if (IsFirstBlock(iChannel, iBlock))
+    GetGridItemAt(iChannel, iBlock).width = fWidth;
+}
 
+void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int& newChannelIndex, int& newBlockIndex) const
+{
   newChannelIndex = INVALID_INDEX;
   newBlockIndex = INVALID_INDEX;
 
@@ -278,35 +320,18 @@ void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigne
     iCurrentChannel++;
   }
 
-  if (newChannelIndex != INVALID_INDEX)
+  if (newChannelIndex != INVALID_INDEX && broadcastUid > 0)
   {
     // find the block
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[newChannelIndex].start;
-    unsigned long lastIdx = m_epgItemsPtr[newChannelIndex].stop;
-    int iEpgId = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    std::shared_ptr<CPVREpgInfoTag> tag;
-    for (int block = 0; block < m_blocks; ++block)
+    const ChannelGrid& grid = GetChannelGrid(newChannelIndex);
+    for (size_t i = 0; i < grid.items.size(); ++i)
     {
-      while (progIdx <= lastIdx)
+      if (grid.items[i].progIndex != INVALID_INDEX &&
+          grid.items[i].item->GetEPGInfoTag()->UniqueBroadcastID() == broadcastUid)
       {
-        tag = m_programmeItems[progIdx]->GetEPGInfoTag();
-
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break; // next block
-
-        if (gridCursor < tag->EndAsUTC())
-        {
-          if (broadcastUid > 0 && tag->UniqueBroadcastID() == broadcastUid)
-          {
-            newBlockIndex = block + eventOffset;
-            return; // done.
-          }
-          break; // next block
-        }
-        progIdx++;
+        newBlockIndex = grid.blocks[i] + eventOffset;
+        return; // done.
       }
-      gridCursor += blockDuration;
     }
   }
 }
@@ -343,39 +368,19 @@ void CGUIEPGGridContainerModel::FreeProgrammeMemory(int channel, int keepStart,
 {
   if (keepStart < keepEnd)
   {
-    // remove before keepStart and after keepEnd
-    if (keepStart > 0 && keepStart < m_blocks)
-    {
-      // if item exist and block is not part of visible item
-      std::shared_ptr<CGUIListItem> last = m_gridIndex[channel][keepStart].item;
-      for (int i = keepStart - 1; i > 0; --i)
-      {
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
-        {
-          m_gridIndex[channel][i].item->FreeMemory();
-          // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
-          // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
-          // to avoid calling FreeMemory() multiple times on item that occupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
-        }
-      }
-    }
+    CSingleLock lock(m_critSection);
 
-    if (keepEnd > 0 && keepEnd < m_blocks)
+    // nothing to free if the channel wasn't shown yet
+    const ChannelGrid& grid = m_channelGrids[channel];
+    if (!grid.created)
+      return;
+
+    // remove items before keepStart and after keepEnd, keeping partially visible ones
+    for (size_t i = 0; i < grid.items.size(); ++i)
     {
-      std::shared_ptr<CGUIListItem> last = m_gridIndex[channel][keepEnd].item;
-      for (int i = keepEnd + 1; i < m_blocks; ++i)
-      {
-        // if item exist and block is not part of visible item
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
-        {
-          m_gridIndex[channel][i].item->FreeMemory();
-          // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
-          // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
-          // to avoid calling FreeMemory() multiple times on item that occupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
-        }
-      }
+      const int lastBlock = (i + 1 < grid.blocks.size() ? grid.blocks[i + 1] : m_blocks) - 1;
+      if (lastBlock < keepStart || grid.blocks[i] > keepEnd)
+        grid.items[i].item->FreeMemory();
     }
   }
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "XBDateTime.h"
+#include "threads/CriticalSection.h"
 
 #include <memory>
 #include <vector>
@@ -35,6 +36,7 @@ namespace PVR
     static const int MAXBLOCKS = 33 * 24 * 60 / MINSPERBLOCK; //! 33 days of 5 minute blocks (31 days for upcoming data + 1 day for past data + 1 day for fillers)
 
     CGUIEPGGridContainerModel() = default;
+    CGUIEPGGridContainerModel(const CGUIEPGGridContainerModel& other);
     virtual ~CGUIEPGGridContainerModel() = default;
 
     void Initialize(const std::unique_ptr<CFileItemList>& items, const CDateTime& gridStart, const CDateTime& gridEnd, int iRulerUnit, int iBlocksPerPage, float fBlockSize);
@@ -59,13 +61,13 @@ namespace PVR
     int RulerItemsSize() const { return static_cast<int>(m_rulerItems.size()); }
 
     int GetBlockCount() const { return m_blocks; }
-    bool HasGridItems() const { return !m_gridIndex.empty(); }
-    GridItem* GetGridItemPtr(int iChannel, int iBlock) { return& m_gridIndex[iChannel][iBlock]; }
-    std::shared_ptr<CFileItem> GetGridItem(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].item; }
-    float GetGridItemWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].width; }
-    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].originWidth; }
-    int GetGridItemIndex(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].progIndex; }
-    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { m_gridIndex[iChannel][iBlock].width = fWidth; }
+    bool HasGridItems() const { return !m_channelGrids.empty(); }
+    GridItem* GetGridItemPtr(int iChannel, int iBlock) { return &GetGridItemAt(iChannel, iBlock); }
+    std::shared_ptr<CFileItem> GetGridItem(int iChannel, int iBlock) const { return GetGridItemAt(iChannel, iBlock).item; }
+    float GetGridItemWidth(int iChannel, int iBlock) const;
+    float GetGridItemOriginWidth(int iChannel, int iBlock) const;
+    int GetGridItemIndex(int iChannel, int iBlock) const { return GetGridItemAt(iChannel, iBlock).progIndex; }
+    void SetGridItemWidth(int iChannel, int iBlock, float fWidth);
 
     bool IsZeroGridDuration() const { return (m_gridEnd - m_gridStart) == CDateTimeSpan(0, 0, 0, 0); }
     const CDateTime& GetGridStart() const { return m_gridStart; }
@@ -80,10 +82,43 @@ namespace PVR
     int GetFirstEventBlock(const std::shared_ptr<CPVREpgInfoTag>& event) const;
     int GetLastEventBlock(const std::shared_ptr<CPVREpgInfoTag>& event) const;
 
+    struct ProgrammeSpan
+    {
+      int start; // seconds since grid start
+      int end; // seconds since grid start
+    };
+
+    struct GridRun
+    {
+      int block; // first block of the run
+      int programme; // index of the programme, INVALID_INDEX for a gap
+    };
+
+    /*!
+     * @brief Lay out programmes over the blocks of the grid.
+     * @param programmes The programmes of a channel, ordered by start time.
+     * @param iBlockCount The number of blocks of the grid.
+     * @return The runs of blocks showing the same programme or gap, covering all blocks.
+     */
+    static std::vector<GridRun> LayoutProgrammes(const std::vector<ProgrammeSpan>& programmes, int iBlockCount);
+
   private:
     void FreeItemsMemory();
     std::shared_ptr<CFileItem> CreateGapItem(int iChannel) const;
 
+    // The grid items of a channel, one per run of blocks. Created when the channel is first
+    // shown and kept until the model is destroyed, as the container holds pointers to them.
+    struct ChannelGrid
+    {
+      bool created = false;
+      std::vector<int> blocks; // first block of each item
+      std::vector<GridItem> items;
+    };
+
+    ChannelGrid& GetChannelGrid(int iChannel) const;
+    GridItem& GetGridItemAt(int iChannel, int iBlock) const;
+    bool IsFirstBlock(int iChannel, int iBlock) const;
+
     struct ItemsPtr
     {
       long start;
@@ -97,8 +132,10 @@ namespace PVR
     std::vector<std::shared_ptr<CFileItem>> m_channelItems;
     std::vector<std::shared_ptr<CFileItem>> m_rulerItems;
     std::vector<ItemsPtr> m_epgItemsPtr;
-    std::vector<std::vector<GridItem> > m_gridIndex;
+    mutable std::vector<ChannelGrid> m_channelGrids;
+    mutable CCriticalSection m_critSection;
 
     int m_blocks = 0;
+    float m_blockSize = 0.0f;
   };
 }
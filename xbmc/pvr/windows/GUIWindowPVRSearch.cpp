@@ -61,7 +61,8 @@ namespace
 
   void AsyncSearchAction::Run()
   {
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> results = CServiceBroker::GetPVRManager().EpgContainer().GetAllTags();
+    // only look at the tags the epg indexes can't rule out, the filter checks the rest
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> results = CServiceBroker::GetPVRManager().EpgContainer().GetTags(*m_filter);
     for (auto it = results.begin(); it != results.end();)
     {
       it = results.erase(std::remove_if(results.begin(),
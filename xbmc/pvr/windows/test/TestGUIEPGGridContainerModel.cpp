@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "pvr/windows/GUIEPGGridContainerModel.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const int BLOCK = CGUIEPGGridContainerModel::MINSPERBLOCK * 60; // seconds
+const int GAP = CGUIEPGGridContainerModel::INVALID_INDEX;
+}
+
+TEST(TestGUIEPGGridContainerModel, LayoutProgrammes)
+{
+  // programmes ending and starting at block boundaries, with a gap between them
+  const auto runs = CGUIEPGGridContainerModel::LayoutProgrammes({{0, 2 * BLOCK}, {4 * BLOCK, 6 * BLOCK}}, 8);
+  ASSERT_EQ(4u, runs.size());
+  EXPECT_EQ(0, runs[0].block);
+  EXPECT_EQ(0, runs[0].programme);
+  EXPECT_EQ(2, runs[1].block);
+  EXPECT_EQ(GAP, runs[1].programme);
+  EXPECT_EQ(4, runs[2].block);
+  EXPECT_EQ(1, runs[2].programme);
+  EXPECT_EQ(6, runs[3].block);
+  EXPECT_EQ(GAP, runs[3].programme);
+}
+
+TEST(TestGUIEPGGridContainerModel, LayoutProgrammesOffBlockBoundaries)
+{
+  // programmes start at the first block starting within them
+  const auto runs = CGUIEPGGridContainerModel::LayoutProgrammes({{-BLOCK / 2, BLOCK / 2}, {BLOCK / 2, 3 * BLOCK + 1}}, 3);
+  ASSERT_EQ(2u, runs.size());
+  EXPECT_EQ(0, runs[0].block);
+  EXPECT_EQ(0, runs[0].programme);
+  EXPECT_EQ(1, runs[1].block);
+  EXPECT_EQ(1, runs[1].programme);
+}
+
+TEST(TestGUIEPGGridContainerModel, LayoutProgrammesOverlapping)
+{
+  // overlapping programmes start after the programme before them, hidden ones are skipped
+  const auto runs = CGUIEPGGridContainerModel::LayoutProgrammes({{0, 4 * BLOCK}, {BLOCK, 2 * BLOCK}, {3 * BLOCK, 6 * BLOCK}}, 6);
+  ASSERT_EQ(2u, runs.size());
+  EXPECT_EQ(0, runs[0].block);
+  EXPECT_EQ(0, runs[0].programme);
+  EXPECT_EQ(4, runs[1].block);
+  EXPECT_EQ(2, runs[1].programme);
+}
+
+TEST(TestGUIEPGGridContainerModel, LayoutProgrammesEmpty)
+{
+  const auto runs = CGUIEPGGridContainerModel::LayoutProgrammes({}, 10);
+  ASSERT_EQ(1u, runs.size());
+  EXPECT_EQ(0, runs[0].block);
+  EXPECT_EQ(GAP, runs[0].programme);
+}
+
+TEST(TestGUIEPGGridContainerModel, LayoutSyntheticGuide)
+{
+  // 1000 channels with 14 days of programmes lasting 25 to 90 minutes
+  const int channels = 1000;
+  const int blocks = 14 * 24 * 60 / CGUIEPGGridContainerModel::MINSPERBLOCK;
+  std::vector<std::vector<CGUIEPGGridContainerModel::ProgrammeSpan>> guide(channels);
+  for (int channel = 0; channel < channels; ++channel)
+  {
+    int start = -channel * 60;
+    for (int i = 0; start < blocks * BLOCK; ++i)
+    {
+      const int end = start + (25 + (channel + i) * 13 % 66) * 60;
+      guide[channel].push_back({start, end});
+      start = end;
+    }
+  }
+
+  size_t items = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (const auto& programmes : guide)
+  {
+    const auto runs = CGUIEPGGridContainerModel::LayoutProgrammes(programmes, blocks);
+    ASSERT_FALSE(runs.empty());
+    EXPECT_EQ(0, runs.front().block);
+    for (size_t i = 1; i < runs.size(); ++i)
+      ASSERT_LT(runs[i - 1].block, runs[i].block);
+    EXPECT_LT(runs.back().block, blocks);
+    items += runs.size();
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+
+  // one item per programme rather than one per channel and block
+  EXPECT_LT(items, static_cast<size_t>(channels) * blocks / 4);
+  RecordProperty("items", static_cast<int>(items));
+  RecordProperty("milliseconds", static_cast<int>(elapsed.count()));
+}
@@ -673,6 +673,14 @@ void CRenderSystemGL::InitialiseShaders()
     m_pShader[SM_MULTI_BLENDCOLOR].reset();
     CLog::Log(LOGERROR, "GUI Shader gl_shader_frag_multi_blendcolor.glsl - compile and link failed");
   }
+
+  m_pShader[SM_FONTS_SDF].reset(new CGLShader("gl_shader_frag_fonts_sdf.glsl", defines));
+  if (!m_pShader[SM_FONTS_SDF]->CompileAndLink())
+  {
+    m_pShader[SM_FONTS_SDF]->Free();
+    m_pShader[SM_FONTS_SDF].reset();
+    CLog::Log(LOGERROR, "GUI Shader gl_shader_frag_fonts_sdf.glsl - compile and link failed");
+  }
 }
 
 void CRenderSystemGL::ReleaseShaders()
@@ -704,6 +712,10 @@ void CRenderSystemGL::ReleaseShaders()
   if (m_pShader[SM_MULTI_BLENDCOLOR])
     m_pShader[SM_MULTI_BLENDCOLOR]->Free();
   m_pShader[SM_MULTI_BLENDCOLOR].reset();
+
+  if (m_pShader[SM_FONTS_SDF])
+    m_pShader[SM_FONTS_SDF]->Free();
+  m_pShader[SM_FONTS_SDF].reset();
 }
 
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
@@ -719,6 +731,11 @@ void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
   }
 }
 
+bool CRenderSystemGL::IsShaderValid(ESHADERMETHOD method) const
+{
+  return m_pShader[method] != nullptr;
+}
+
 void CRenderSystemGL::DisableShader()
 {
   if (m_pShader[m_method])
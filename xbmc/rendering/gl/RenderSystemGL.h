@@ -26,6 +26,7 @@ enum ESHADERMETHOD
   SM_FONTS,
   SM_TEXTURE_NOBLEND,
   SM_MULTI_BLENDCOLOR,
+  SM_FONTS_SDF,
   SM_MAX
 };
 
@@ -76,6 +77,7 @@ public:
   // shaders
   void EnableShader(ESHADERMETHOD method);
   void DisableShader();
+  bool IsShaderValid(ESHADERMETHOD method) const;
   GLint ShaderGetPos();
   GLint ShaderGetCol();
   GLint ShaderGetCoord0();
@@ -189,6 +189,9 @@ void CAdvancedSettings::Initialize()
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
   m_slideshowBlackBarCompensation = 20.0f;
+  m_slideshowLookAhead = 2;
+  m_slideshowLookBehind = 1;
+  m_slideshowDecodeCache = 128;
 
   m_songInfoDuration = 10;
 
@@ -275,6 +278,7 @@ void CAdvancedSettings::Initialize()
 
   m_fanartRes = 1080;
   m_imageRes = 720;
+  m_imageListRes = 360;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
 
   m_sambaclienttimeout = 30;
@@ -410,11 +414,16 @@ void CAdvancedSettings::Initialize()
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  m_webserverThreadPool = false;
+  m_webserverThreadPoolSize = 0;
+
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
+  m_guiDirtyRegionTileSize = 64;
+  m_guiFontSDF = false;
   m_guiSmartRedraw = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
@@ -836,6 +845,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "panamount", m_slideshowPanAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "zoomamount", m_slideshowZoomAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "blackbarcompensation", m_slideshowBlackBarCompensation, 0.0f, 50.0f);
+    XMLUtils::GetUInt(pElement, "lookahead", m_slideshowLookAhead, 0, 10);
+    XMLUtils::GetUInt(pElement, "lookbehind", m_slideshowLookBehind, 0, 10);
+    XMLUtils::GetUInt(pElement, "decodecache", m_slideshowDecodeCache, 0, 4096);
   }
 
   pElement = pRootElement->FirstChildElement("network");
@@ -862,6 +874,13 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "threadpool", m_webserverThreadPool);
+    XMLUtils::GetUInt(pElement, "threadpoolsize", m_webserverThreadPoolSize, 0, 256);
+  }
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -1071,6 +1090,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
   XMLUtils::GetUInt(pRootElement, "fanartres", m_fanartRes, 0, 9999);
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 9999);
+  XMLUtils::GetUInt(pRootElement, "imagelistres", m_imageListRes, 0, 9999);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
@@ -1230,6 +1250,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
+    XMLUtils::GetInt(pElement, "dirtyregiontilesize", m_guiDirtyRegionTileSize, 8, 1024);
+    XMLUtils::GetBoolean(pElement, "fontsdf", m_guiFontSDF);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
   }
 
@@ -189,6 +189,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
     float m_slideshowPanAmount;
+    unsigned int m_slideshowLookAhead;  ///< \brief number of pictures decoded ahead of the current one
+    unsigned int m_slideshowLookBehind; ///< \brief number of pictures decoded behind the current one
+    unsigned int m_slideshowDecodeCache; ///< \brief the most memory pictures decoded ahead may take, in MiB
 
     int m_songInfoDuration;
     int m_logLevel;
@@ -231,6 +234,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
+    unsigned int m_imageListRes; ///< \brief the resolution of the list-size variant of cached images (assumes 16x9), 0 for none
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
 
     int m_sambaclienttimeout;
@@ -341,6 +345,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
+    int  m_guiDirtyRegionTileSize;
+    bool m_guiFontSDF;
     bool m_guiSmartRedraw;
     unsigned int m_addonPackageFolderSize;
 
@@ -351,6 +357,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    bool m_webserverThreadPool; ///< serve all connections from a pool of threads rather than a thread per connection
+    unsigned int m_webserverThreadPoolSize; ///< number of pool threads, 0 to derive it from the number of CPUs
+
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
     void ParseSettingsFile(const std::string &file);
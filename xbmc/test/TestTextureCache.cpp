@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureCache.h"
+#include "TextureCacheJob.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+#include "pictures/Picture.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// decode a cached image the way the GUI loads it, returning the time it took in microseconds
+int DecodeCachedImage(const std::string &path, unsigned int &width, unsigned int &height)
+{
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(path, buffer) <= 0)
+    return -1;
+
+  const auto begin = std::chrono::steady_clock::now();
+  CFFmpegImage image("image/jpeg");
+  if (!image.LoadImageFromMemory(reinterpret_cast<unsigned char*>(buffer.get()), buffer.size(), 0, 0))
+    return -1;
+  width = image.Width();
+  height = image.Height();
+  std::vector<uint32_t> pixels(width * height);
+  if (!image.Decode(reinterpret_cast<unsigned char*>(pixels.data()), width, height, width * 4, XB_FMT_A8R8G8B8))
+    return -1;
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+}
+}
+
+TEST(TestTextureCache, GetListFile)
+{
+  EXPECT_EQ("a/a1b2c3d4-list.jpg", CTextureCache::GetListFile("a/a1b2c3d4.jpg"));
+  EXPECT_EQ("0/0f0f0f0f-list.png", CTextureCache::GetListFile("0/0f0f0f0f.png"));
+}
+
+TEST(TestTextureCache, GetListVariantSize)
+{
+  unsigned int width = 0, height = 0;
+  EXPECT_TRUE(CTextureCacheJob::GetListVariantSize(1920, 1080, 360, width, height));
+  EXPECT_EQ(640u, width);
+  EXPECT_EQ(360u, height);
+  EXPECT_TRUE(CTextureCacheJob::GetListVariantSize(1000, 1500, 360, width, height));
+
+  // not worth it for images that are no more than twice the pixels, or when disabled
+  EXPECT_FALSE(CTextureCacheJob::GetListVariantSize(800, 450, 360, width, height));
+  EXPECT_FALSE(CTextureCacheJob::GetListVariantSize(500, 500, 360, width, height));
+  EXPECT_FALSE(CTextureCacheJob::GetListVariantSize(1920, 1080, 0, width, height));
+  EXPECT_FALSE(CTextureCacheJob::GetListVariantSize(0, 0, 360, width, height));
+}
+
+TEST(TestTextureCache, ListVariantFootprint)
+{
+  // fanart as it is cached, a gradient with some detail so it doesn't compress to nothing
+  const unsigned int width = 1920, height = 1080;
+  std::vector<uint32_t> pixels(width * height);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+      pixels[y * width + x] = 0xff000000 | ((x * 255 / width) << 16) | ((y * 255 / height) << 8) | ((x ^ y) & 0x3f);
+  }
+
+  const std::string full = CSpecialProtocol::TranslatePath("special://temp/fanart.jpg");
+  const std::string list = CSpecialProtocol::TranslatePath("special://temp/" + CTextureCache::GetListFile("fanart.jpg"));
+  unsigned int fullWidth = width, fullHeight = height;
+  ASSERT_TRUE(CPicture::CacheTexture(reinterpret_cast<uint8_t*>(pixels.data()), width, height, width * 4, 0,
+                                     fullWidth, fullHeight, full));
+  unsigned int listWidth, listHeight;
+  ASSERT_TRUE(CTextureCacheJob::GetListVariantSize(fullWidth, fullHeight, 360, listWidth, listHeight));
+  ASSERT_TRUE(CPicture::CacheTexture(reinterpret_cast<uint8_t*>(pixels.data()), width, height, width * 4, 0,
+                                     listWidth, listHeight, list));
+
+  struct __stat64 fullStat, listStat;
+  ASSERT_EQ(0, XFILE::CFile::Stat(full, &fullStat));
+  ASSERT_EQ(0, XFILE::CFile::Stat(list, &listStat));
+  EXPECT_LT(listStat.st_size, fullStat.st_size);
+
+  // the decode time of a few loads of each, as a list scrolling past would
+  const int loads = 10;
+  int fullTime = 0, listTime = 0;
+  for (int i = 0; i < loads; i++)
+  {
+    unsigned int decodedWidth, decodedHeight;
+    fullTime += DecodeCachedImage(full, decodedWidth, decodedHeight);
+    EXPECT_EQ(fullWidth, decodedWidth);
+    listTime += DecodeCachedImage(list, decodedWidth, decodedHeight);
+    EXPECT_EQ(listWidth, decodedWidth);
+    EXPECT_EQ(listHeight, decodedHeight);
+  }
+
+  XFILE::CFile::Delete(full);
+  XFILE::CFile::Delete(list);
+
+  RecordProperty("full.bytes", static_cast<int>(fullStat.st_size));
+  RecordProperty("list.bytes", static_cast<int>(listStat.st_size));
+  RecordProperty("full.decode_us", fullTime / loads);
+  RecordProperty("list.decode_us", listTime / loads);
+}
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureCacheIndex.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CTextureDetails MakeDetails(int id)
+{
+  CTextureDetails details;
+  details.id = id;
+  details.file = "a/" + std::to_string(id) + ".jpg";
+  details.width = 1920;
+  details.height = 1080;
+  return details;
+}
+
+const CTextureCacheIndex::Clock::time_point never = CTextureCacheIndex::Clock::time_point::max();
+}
+
+TEST(TestTextureCacheIndex, GetAndPut)
+{
+  CTextureCacheIndex index(16);
+  const auto now = CTextureCacheIndex::Clock::now();
+  CTextureDetails details;
+
+  EXPECT_FALSE(index.Get("http://example.com/fanart.jpg", details, now));
+  index.Put("http://example.com/fanart.jpg", MakeDetails(1), never);
+  ASSERT_TRUE(index.Get("http://example.com/fanart.jpg", details, now));
+  EXPECT_EQ(MakeDetails(1), details);
+  EXPECT_EQ(1080u, details.height);
+
+  EXPECT_EQ(1u, index.GetHits());
+  EXPECT_EQ(1u, index.GetMisses());
+}
+
+TEST(TestTextureCacheIndex, Expires)
+{
+  CTextureCacheIndex index(16);
+  const auto now = CTextureCacheIndex::Clock::now();
+  CTextureDetails details;
+
+  index.Put("poster.jpg", MakeDetails(1), now + std::chrono::hours(1));
+  EXPECT_TRUE(index.Get("poster.jpg", details, now));
+  EXPECT_FALSE(index.Get("poster.jpg", details, now + std::chrono::hours(2)));
+  EXPECT_EQ(0u, index.GetSize());
+}
+
+TEST(TestTextureCacheIndex, LeastRecentlyUsedIsDropped)
+{
+  CTextureCacheIndex index(2);
+  const auto now = CTextureCacheIndex::Clock::now();
+  CTextureDetails details;
+
+  index.Put("1.jpg", MakeDetails(1), never);
+  index.Put("2.jpg", MakeDetails(2), never);
+  EXPECT_TRUE(index.Get("1.jpg", details, now));
+  index.Put("3.jpg", MakeDetails(3), never);
+
+  EXPECT_EQ(2u, index.GetSize());
+  EXPECT_TRUE(index.Get("1.jpg", details, now));
+  EXPECT_FALSE(index.Get("2.jpg", details, now));
+  EXPECT_TRUE(index.Get("3.jpg", details, now));
+}
+
+TEST(TestTextureCacheIndex, Erase)
+{
+  CTextureCacheIndex index(16);
+  const auto now = CTextureCacheIndex::Clock::now();
+  CTextureDetails details;
+
+  index.Put("1.jpg", MakeDetails(1), never);
+  index.Put("2.jpg", MakeDetails(2), never);
+  index.Put("3.jpg", MakeDetails(3), never);
+
+  index.Erase("1.jpg");
+  EXPECT_FALSE(index.Get("1.jpg", details, now));
+  index.Erase(2);
+  EXPECT_FALSE(index.Get("2.jpg", details, now));
+  EXPECT_TRUE(index.Get("3.jpg", details, now));
+
+  // replacing keeps a single entry
+  index.Put("3.jpg", MakeDetails(4), never);
+  EXPECT_EQ(1u, index.GetSize());
+  ASSERT_TRUE(index.Get("3.jpg", details, now));
+  EXPECT_EQ(4, details.id);
+
+  index.Clear();
+  EXPECT_EQ(0u, index.GetSize());
+}
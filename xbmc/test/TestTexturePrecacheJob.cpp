@@ -0,0 +1,178 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TexturePrecacheJob.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+TEST(TestTexturePrecacheJob, GroupByHost)
+{
+  const std::vector<std::string> urls = {
+    "http://image.tmdb.org/t/p/original/poster.jpg",
+    "https://assets.fanart.tv/fanart/movies/clearlogo.png",
+    "http://image.tmdb.org/t/p/original/fanart.jpg",
+    "http://image.tmdb.org/t/p/original/poster.jpg",
+    "",
+    "smb://server/movies/Movie (2019)/poster.jpg",
+    "/home/user/movies/Movie (2019)/fanart.jpg",
+  };
+
+  auto hosts = CTexturePrecacheJob::GroupByHost(urls);
+  ASSERT_EQ(4u, hosts.size());
+
+  // duplicates are dropped, the order within a host is kept
+  ASSERT_EQ(2u, hosts["image.tmdb.org"].size());
+  EXPECT_EQ("http://image.tmdb.org/t/p/original/poster.jpg", hosts["image.tmdb.org"][0]);
+  EXPECT_EQ("http://image.tmdb.org/t/p/original/fanart.jpg", hosts["image.tmdb.org"][1]);
+  EXPECT_EQ(1u, hosts["assets.fanart.tv"].size());
+  EXPECT_EQ(1u, hosts["server"].size());
+  EXPECT_EQ(1u, hosts[""].size());
+}
+
+TEST(TestTexturePrecacheJob, GroupEmbeddedByFile)
+{
+  const std::vector<std::string> urls = {
+    "image://video@smb%3a%2f%2fserver%2fmovies%2fmovie.mkv/",
+    "image://music@%2fhome%2fuser%2fmusic%2fsong.flac/",
+  };
+
+  auto hosts = CTexturePrecacheJob::GroupByHost(urls);
+  ASSERT_EQ(2u, hosts.size());
+  EXPECT_EQ(urls[0], hosts["server"].front());
+  EXPECT_EQ(urls[1], hosts[""].front());
+}
+
+namespace
+{
+// fetches that take a while, keeping track of how many run at once
+struct CFetchRecorder
+{
+  CTexturePrecacher::Result Fetch(const std::string& url)
+  {
+    const std::string host = url.substr(0, url.find('/'));
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      fetched.push_back(url);
+      running++;
+      perHost[host]++;
+      maxRunning = std::max(maxRunning, running);
+      maxPerHost = std::max(maxPerHost, perHost[host]);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::unique_lock<std::mutex> lock(mutex);
+    running--;
+    perHost[host]--;
+    return url.find("missing") != std::string::npos ? CTexturePrecacher::Result::FAILED
+                                                     : CTexturePrecacher::Result::CACHED;
+  }
+
+  std::mutex mutex;
+  std::vector<std::string> fetched;
+  std::map<std::string, unsigned int> perHost;
+  unsigned int running = 0;
+  unsigned int maxRunning = 0;
+  unsigned int maxPerHost = 0;
+};
+
+std::map<std::string, std::deque<std::string>> CreateHosts()
+{
+  std::map<std::string, std::deque<std::string>> hosts;
+  for (int i = 0; i < 8; i++)
+    hosts["slow"].push_back(StringUtils::Format("slow/%d.jpg", i));
+  for (int i = 0; i < 3; i++)
+    hosts["other"].push_back(StringUtils::Format("other/%d.jpg", i));
+  hosts["single"].push_back("single/missing.jpg");
+  return hosts;
+}
+}
+
+TEST(TestTexturePrecacheJob, FetchesEveryImage)
+{
+  CFetchRecorder recorder;
+  std::atomic<int> finished{0};
+  CTexturePrecacher precacher(CreateHosts(), [&recorder](const std::string& url) { return recorder.Fetch(url); }, 1, 2);
+  precacher.SetFinishedCallback([&finished]() { finished++; });
+  precacher.Start();
+
+  ASSERT_TRUE(precacher.WaitFinished(10000));
+  EXPECT_TRUE(precacher.IsFinished());
+  EXPECT_EQ(1, finished);
+  EXPECT_EQ(12u, precacher.GetDone());
+  EXPECT_EQ(11u, precacher.GetCached());
+  EXPECT_EQ(1u, precacher.GetFailed());
+
+  std::unique_lock<std::mutex> lock(recorder.mutex);
+  std::vector<std::string> fetched = recorder.fetched;
+  std::sort(fetched.begin(), fetched.end());
+  EXPECT_EQ(fetched.end(), std::unique(fetched.begin(), fetched.end()));
+  EXPECT_EQ(12u, fetched.size());
+  EXPECT_LE(recorder.maxRunning, 2u);
+  EXPECT_EQ(1u, recorder.maxPerHost);
+
+  // hosts take turns, the image of the last host isn't stuck behind all of the first
+  const auto single = std::find(recorder.fetched.begin(), recorder.fetched.end(), "single/missing.jpg");
+  EXPECT_LT(std::distance(recorder.fetched.begin(), single), 4);
+}
+
+TEST(TestTexturePrecacheJob, NothingToFetch)
+{
+  std::atomic<int> finished{0};
+  CTexturePrecacher precacher({}, [](const std::string& url) { return CTexturePrecacher::Result::FAILED; });
+  precacher.SetFinishedCallback([&finished]() { finished++; });
+  precacher.Start();
+
+  EXPECT_TRUE(precacher.WaitFinished(0));
+  EXPECT_TRUE(precacher.IsFinished());
+  EXPECT_EQ(1, finished);
+}
+
+TEST(TestTexturePrecacheJob, WaitsWhilePaused)
+{
+  CFetchRecorder recorder;
+  CJobManager::GetInstance().PauseJobs();
+  CTexturePrecacher precacher(CreateHosts(), [&recorder](const std::string& url) { return recorder.Fetch(url); });
+  precacher.Start();
+
+  // the fetches are queued at PRIORITY_LOW_PAUSABLE, none of them start
+  EXPECT_FALSE(precacher.WaitFinished(200));
+  EXPECT_EQ(0u, precacher.GetDone());
+
+  CJobManager::GetInstance().UnPauseJobs();
+  ASSERT_TRUE(precacher.WaitFinished(10000));
+  EXPECT_EQ(12u, precacher.GetDone());
+  std::unique_lock<std::mutex> lock(recorder.mutex);
+  EXPECT_LE(recorder.maxRunning, CJobManager::GetMaxWorkers(CJob::PRIORITY_LOW_PAUSABLE));
+  EXPECT_LE(recorder.maxPerHost, CTexturePrecacher::MAX_PER_HOST);
+}
+
+TEST(TestTexturePrecacheJob, CancelStopsFetching)
+{
+  CFetchRecorder recorder;
+  std::atomic<int> finished{0};
+  {
+    CTexturePrecacher precacher(CreateHosts(), [&recorder](const std::string& url) { return recorder.Fetch(url); }, 1, 1);
+    precacher.SetFinishedCallback([&finished]() { finished++; });
+    precacher.Start();
+    precacher.Cancel();
+    EXPECT_FALSE(precacher.IsFinished());
+  }
+
+  // at most the fetch that was running when cancelled carries on
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  std::unique_lock<std::mutex> lock(recorder.mutex);
+  EXPECT_LE(recorder.fetched.size(), 1u);
+  EXPECT_EQ(0, finished);
+}
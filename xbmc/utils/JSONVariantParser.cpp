@@ -14,6 +14,7 @@ class CJSONVariantParserHandler
 {
 public:
   explicit CJSONVariantParserHandler(CVariant& parsedObject);
+  ~CJSONVariantParserHandler();
 
   bool Null();
   bool Bool(bool b);
@@ -40,7 +41,7 @@ private:
     return true;
   }
 
-  void PushObject(CVariant variant);
+  void PushObject(CVariant&& variant);
   void PopObject();
 
   CVariant& m_parsedObject;
@@ -63,9 +64,16 @@ CJSONVariantParserHandler::CJSONVariantParserHandler(CVariant& parsedObject)
     m_status(PARSE_STATUS::Variable)
 { }
 
+CJSONVariantParserHandler::~CJSONVariantParserHandler()
+{
+  // the root of an invalid document is left behind
+  if (!m_parse.empty())
+    delete m_parse[0];
+}
+
 bool CJSONVariantParserHandler::Null()
 {
-  PushObject(CVariant::ConstNullVariant);
+  PushObject(CVariant(CVariant::VariantTypeConstNull));
   PopObject();
 
   return true;
@@ -120,7 +128,7 @@ bool CJSONVariantParserHandler::StartObject()
 
 bool CJSONVariantParserHandler::Key(const char* str, rapidjson::SizeType length, bool copy)
 {
-  m_key = std::string(str, 0, length);
+  m_key.assign(str, length);
 
   return true;
 }
@@ -146,25 +154,30 @@ bool CJSONVariantParserHandler::EndArray(rapidjson::SizeType elementCount)
   return true;
 }
 
-void CJSONVariantParserHandler::PushObject(CVariant variant)
+void CJSONVariantParserHandler::PushObject(CVariant&& variant)
 {
+  // values are moved into place, keeping the strings and containers parsed
+  const bool isObject = variant.isObject();
+  const bool isArray = variant.isArray();
+
   if (m_status == PARSE_STATUS::Object)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    CVariant& member = (*m_parse[m_parse.size() - 1])[m_key];
+    member = std::move(variant);
+    m_parse.push_back(&member);
   }
   else if (m_status == PARSE_STATUS::Array)
   {
     CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
+    temp->push_back(std::move(variant));
     m_parse.push_back(&(*temp)[temp->size() - 1]);
   }
   else if (m_parse.empty())
-    m_parse.push_back(new CVariant(variant));
+    m_parse.push_back(new CVariant(std::move(variant)));
 
-  if (variant.isObject())
+  if (isObject)
     m_status = PARSE_STATUS::Object;
-  else if (variant.isArray())
+  else if (isArray)
     m_status = PARSE_STATUS::Array;
   else
     m_status = PARSE_STATUS::Variable;
@@ -187,7 +200,7 @@ void CJSONVariantParserHandler::PopObject()
   }
   else
   {
-    m_parsedObject = *variant;
+    m_parsedObject = std::move(*variant);
     delete variant;
 
     m_status = PARSE_STATUS::Variable;
@@ -14,6 +14,12 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#define STREAM_PIECE_SIZE 65536
+
 template<class TWriter>
 bool InternalWrite(TWriter& writer, const CVariant &value)
 {
@@ -90,3 +96,177 @@ bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool
   output = stringBuffer.GetString();
   return true;
 }
+
+bool CJSONVariantWriter::Write(const CVariant &value, const std::function<bool(const char *data, size_t size)> &output, bool compact)
+{
+  CJSONVariantStreamWriter stream(value, compact);
+  std::vector<char> buffer(STREAM_PIECE_SIZE);
+
+  size_t size;
+  while ((size = stream.Read(buffer.data(), buffer.size())) > 0)
+  {
+    if (!output(buffer.data(), size))
+      return false;
+  }
+
+  return stream.IsComplete();
+}
+
+namespace
+{
+// rapidjson output stream appending to the pending data of a stream writer
+class CStringOutput
+{
+public:
+  typedef char Ch;
+
+  explicit CStringOutput(std::string &buffer) : m_buffer(buffer) { }
+
+  void Put(char c) { m_buffer.push_back(c); }
+  void Flush() { }
+
+private:
+  std::string &m_buffer;
+};
+}
+
+class CJSONVariantStreamWriter::IWriter
+{
+public:
+  virtual ~IWriter() = default;
+
+  // writes the next value, key or bracket, returns false on failure or once everything is written
+  virtual bool Step() = 0;
+  virtual bool IsComplete() const = 0;
+};
+
+template<class TWriter>
+class CJSONVariantStreamWriter::CWriter : public CJSONVariantStreamWriter::IWriter
+{
+public:
+  CWriter(const CVariant &value, std::string &buffer)
+    : m_output(buffer),
+      m_writer(m_output)
+  {
+    m_stack.emplace_back(&value);
+  }
+
+  TWriter& GetWriter() { return m_writer; }
+
+  bool Step() override
+  {
+    if (m_stack.empty())
+      return false;
+
+    Level &level = m_stack.back();
+    const CVariant &value = *level.value;
+    switch (value.type())
+    {
+    case CVariant::VariantTypeArray:
+      if (!level.started)
+      {
+        level.started = true;
+        level.itArray = value.begin_array();
+        return m_writer.StartArray();
+      }
+
+      if (level.itArray != value.end_array())
+      {
+        const CVariant *item = &*level.itArray++;
+        m_stack.emplace_back(item);
+        return true;
+      }
+
+      m_stack.pop_back();
+      return m_writer.EndArray(value.size());
+
+    case CVariant::VariantTypeObject:
+      if (!level.started)
+      {
+        level.started = true;
+        level.itMap = value.begin_map();
+        return m_writer.StartObject();
+      }
+
+      if (level.itMap != value.end_map())
+      {
+        const auto it = level.itMap++;
+        if (!m_writer.Key(it->first.c_str()))
+          return false;
+
+        m_stack.emplace_back(&it->second);
+        return true;
+      }
+
+      m_stack.pop_back();
+      return m_writer.EndObject(value.size());
+
+    default:
+      m_stack.pop_back();
+      return InternalWrite(m_writer, value);
+    }
+  }
+
+  bool IsComplete() const override
+  {
+    return m_stack.empty() && m_writer.IsComplete();
+  }
+
+private:
+  struct Level
+  {
+    explicit Level(const CVariant *variant) : value(variant) { }
+
+    const CVariant *value;
+    bool started = false;
+    CVariant::const_iterator_array itArray;
+    CVariant::const_iterator_map itMap;
+  };
+
+  CStringOutput m_output;
+  TWriter m_writer;
+  std::vector<Level> m_stack;
+};
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(const CVariant &value, bool compact)
+{
+  if (compact)
+    m_writer.reset(new CWriter<rapidjson::Writer<CStringOutput>>(value, m_buffer));
+  else
+  {
+    auto writer = new CWriter<rapidjson::PrettyWriter<CStringOutput>>(value, m_buffer);
+    writer->GetWriter().SetIndent('\t', 1);
+    m_writer.reset(writer);
+  }
+}
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter() = default;
+
+size_t CJSONVariantStreamWriter::Read(char *buffer, size_t size)
+{
+  while (m_buffer.size() - m_offset < size && m_writer->Step())
+    ;
+
+  size_t length = std::min(size, m_buffer.size() - m_offset);
+  memcpy(buffer, m_buffer.data() + m_offset, length);
+  m_offset += length;
+
+  // drop what has been read, without moving the rest around on every read
+  if (m_offset == m_buffer.size())
+  {
+    m_buffer.clear();
+    m_offset = 0;
+  }
+  else if (m_offset > size)
+  {
+    m_buffer.erase(0, m_offset);
+    m_offset = 0;
+  }
+
+  return length;
+}
+
+bool CJSONVariantStreamWriter::IsComplete() const
+{
+  return m_buffer.empty() && m_writer->IsComplete();
+}
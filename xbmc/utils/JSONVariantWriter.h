@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 
 class CVariant;
@@ -18,4 +20,51 @@ public:
   CJSONVariantWriter() = delete;
 
   static bool Write(const CVariant &value, std::string& output, bool compact);
+
+  /*!
+   \brief Write a variant as JSON piece by piece
+   \param value the variant.
+   \param output gets the JSON in pieces of at most a few kilobytes. Returns false to stop writing.
+   \param compact whether to leave out whitespace.
+   \return true if the whole JSON was written, false otherwise.
+   */
+  static bool Write(const CVariant &value, const std::function<bool(const char *data, size_t size)> &output, bool compact);
+};
+
+/*!
+ \brief Serializes a variant to JSON on demand
+
+ Only the piece of JSON asked for is held in memory, so a large variant can be written straight to
+ a socket or a HTTP response without building the whole JSON first. The variant must not change
+ until the JSON is written completely.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  CJSONVariantStreamWriter(const CVariant &value, bool compact);
+  ~CJSONVariantStreamWriter();
+
+  /*!
+   \brief Get the next piece of JSON
+   \param buffer the buffer to write to.
+   \param size the size of the buffer.
+   \return the number of bytes written, 0 once all of the JSON has been read or writing failed.
+   */
+  size_t Read(char *buffer, size_t size);
+
+  /*!
+   \brief Whether all of the JSON has been written and read
+   */
+  bool IsComplete() const;
+
+private:
+  CJSONVariantStreamWriter(const CJSONVariantStreamWriter&) = delete;
+  CJSONVariantStreamWriter& operator=(const CJSONVariantStreamWriter&) = delete;
+
+  class IWriter;
+  template<class TWriter> class CWriter;
+
+  std::string m_buffer;
+  size_t m_offset = 0;
+  std::unique_ptr<IWriter> m_writer;
 };
@@ -11,6 +11,7 @@
 #include <functional>
 #include <stdexcept>
 #include "threads/SingleLock.h"
+#include "utils/TimelineProfiler.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
 #include "platform/posix/XTimeUtils.h"
@@ -300,6 +301,9 @@ void CJobManager::UnPauseJobs()
 {
   CSingleLock lock(m_section);
   m_pauseJobs = false;
+  // workers that found nothing to do while paused are asleep
+  if (!m_jobQueue[CJob::PRIORITY_LOW_PAUSABLE].empty())
+    StartWorkers(CJob::PRIORITY_LOW_PAUSABLE);
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
@@ -389,6 +393,7 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
     lock.Leave();
     try
     {
+      CTimelineScope timelineScope("job", item.m_job->GetType());
       if (item.m_callback)
         item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
     }
@@ -302,6 +302,12 @@ public:
    */
   void UnPauseJobs();
 
+  /*!
+   \brief The number of jobs with a specific priority processed at once
+   \param priority the priority of the jobs
+   */
+  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+
   /*!
    \brief Checks to see if any jobs with specific priority are currently processing.
    \param priority to search for
@@ -354,7 +360,6 @@ private:
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
   unsigned int m_jobCounter;
 
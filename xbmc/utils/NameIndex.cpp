@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "NameIndex.h"
+
+#include "StringUtils.h"
+#include "threads/SingleLock.h"
+
+unsigned int CNameIndex::BeginLoad() const
+{
+  CSingleLock lock(m_section);
+  return m_changes;
+}
+
+bool CNameIndex::Load(const std::string &database, unsigned int token, const std::vector<std::pair<int, std::string>> &names)
+{
+  CSingleLock lock(m_section);
+  // an item added while the names were read may be missing from them
+  if (token != m_changes)
+    return false;
+
+  m_names.clear();
+  m_index.Clear();
+  for (const auto& name : names)
+  {
+    m_names[name.first] = name.second;
+    m_index.Add(name.first, name.second);
+  }
+  m_database = database;
+  return true;
+}
+
+bool CNameIndex::IsLoaded(const std::string &database) const
+{
+  CSingleLock lock(m_section);
+  return !m_database.empty() && m_database == database;
+}
+
+void CNameIndex::Set(const std::string &database, int id, const std::string &name)
+{
+  CSingleLock lock(m_section);
+  ++m_changes;
+  if (m_database.empty() || m_database != database)
+    return;
+
+  auto it = m_names.find(id);
+  if (it != m_names.end())
+  {
+    if (it->second == name)
+      return;
+    m_index.Remove(id, it->second);
+    it->second = name;
+  }
+  else
+    m_names.emplace(id, name);
+  m_index.Add(id, name);
+}
+
+void CNameIndex::Remove(const std::string &database, int id)
+{
+  CSingleLock lock(m_section);
+  ++m_changes;
+  if (m_database.empty() || m_database != database)
+    return;
+
+  auto it = m_names.find(id);
+  if (it == m_names.end())
+    return;
+
+  m_index.Remove(id, it->second);
+  m_names.erase(it);
+}
+
+void CNameIndex::Invalidate()
+{
+  CSingleLock lock(m_section);
+  ++m_changes;
+  m_database.clear();
+  m_names.clear();
+  m_index.Clear();
+}
+
+bool CNameIndex::Find(const std::string &database, const std::string &term, std::vector<int> &ids, size_t maxIds /* = 0 */) const
+{
+  ids.clear();
+
+  CSingleLock lock(m_section);
+  if (m_database.empty() || m_database != database)
+    return false;
+
+  std::vector<int> candidates;
+  if (!m_index.GetCandidates(term, candidates, maxIds))
+    return false;
+
+  std::string lowerTerm(term);
+  StringUtils::ToLower(lowerTerm);
+  for (int id : candidates)
+  {
+    std::string name(m_names.at(id));
+    StringUtils::ToLower(name);
+    if (name.find(lowerTerm) != std::string::npos)
+      ids.emplace_back(id);
+  }
+  return true;
+}
+
+size_t CNameIndex::GetSize() const
+{
+  CSingleLock lock(m_section);
+  return m_names.size();
+}
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "utils/TextIndex.h"
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*!
+ \brief Word index of the names of library items, e.g. the titles of all songs.
+
+ The names are loaded from a database on the first search and kept up to date by the
+ database as it adds, changes and removes items, so searching doesn't have to scan the
+ whole table. An index loaded from another database, e.g. that of another profile, is
+ not used. Items the index finds still have to be looked up in the database, which makes
+ an index that still holds items that were removed harmless.
+ */
+class CNameIndex
+{
+public:
+  /*! \brief Start loading the names from a database
+   \return the token to pass to Load, which drops the names if the index changed meanwhile.
+   */
+  unsigned int BeginLoad() const;
+
+  /*! \brief Replace the names in the index
+   \param database the database the names are from.
+   \param token the token BeginLoad returned before the names were read.
+   \param names the ids and names of all items.
+   \return true if the names were taken, false if the index changed since BeginLoad.
+   */
+  bool Load(const std::string &database, unsigned int token, const std::vector<std::pair<int, std::string>> &names);
+
+  /*! \brief Whether the names of the given database were loaded
+   */
+  bool IsLoaded(const std::string &database) const;
+
+  /*! \brief Add an item or change its name, ignored if the names of the database aren't loaded
+   */
+  void Set(const std::string &database, int id, const std::string &name);
+
+  /*! \brief Remove an item, ignored if the names of the database aren't loaded
+   */
+  void Remove(const std::string &database, int id);
+
+  /*! \brief Drop all names after changes too large to apply one by one, they are loaded again on the next search
+   */
+  void Invalidate();
+
+  /*! \brief Find the items whose name contains the given term, ignoring case
+   \param database the database to search.
+   \param term the term to look for.
+   \param ids [out] the ids of the items found, in increasing order.
+   \param maxIds the most items worth finding, 0 for no limit.
+   \return false if the names of the database aren't loaded, the term has nothing to look up or
+           more than maxIds items may contain it.
+   */
+  bool Find(const std::string &database, const std::string &term, std::vector<int> &ids, size_t maxIds = 0) const;
+
+  size_t GetSize() const;
+
+private:
+  mutable CCriticalSection m_section;
+  unsigned int m_changes = 0;
+  std::string m_database; ///< the database the names were loaded from, empty if not loaded
+  std::unordered_map<int, std::string> m_names;
+  CTextIndex m_index;
+};
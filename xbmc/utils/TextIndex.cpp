@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextIndex.h"
+
+#include "StringUtils.h"
+#include "TextSearch.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+std::vector<int> Intersect(const std::vector<int> &a, const std::vector<int> &b)
+{
+  std::vector<int> result;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+  return result;
+}
+
+std::vector<int> Unite(const std::vector<int> &a, const std::vector<int> &b)
+{
+  std::vector<int> result;
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+  return result;
+}
+}
+
+void CTextIndex::Clear()
+{
+  m_words.clear();
+  m_idCount = 0;
+}
+
+void CTextIndex::Add(int id, const std::string &text)
+{
+  std::string lowerText(text);
+  StringUtils::ToLower(lowerText);
+
+  for (const auto& word : StringUtils::Split(lowerText, " "))
+  {
+    if (word.empty())
+      continue;
+
+    // texts are mostly added in increasing order, which only appends
+    std::vector<int> &ids = m_words[word];
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id)
+    {
+      ids.insert(it, id);
+      ++m_idCount;
+    }
+  }
+}
+
+void CTextIndex::Remove(int id, const std::string &text)
+{
+  std::string lowerText(text);
+  StringUtils::ToLower(lowerText);
+
+  for (const auto& word : StringUtils::Split(lowerText, " "))
+  {
+    auto words = m_words.find(word);
+    if (words == m_words.end())
+      continue;
+
+    std::vector<int> &ids = words->second;
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id)
+      continue;
+
+    ids.erase(it);
+    --m_idCount;
+    if (ids.empty())
+      m_words.erase(words);
+  }
+}
+
+bool CTextIndex::GetCandidates(const std::string &term, std::vector<int> &ids, size_t maxIds /* = 0 */) const
+{
+  std::string lowerTerm(term);
+  StringUtils::ToLower(lowerTerm);
+
+  std::vector<std::string> parts = StringUtils::Split(lowerTerm, " ");
+  parts.erase(std::remove(parts.begin(), parts.end(), ""), parts.end());
+
+  ids.clear();
+  if (parts.empty())
+    return false;
+
+  for (size_t i = 0; i < parts.size(); ++i)
+  {
+    if (i > 0 && ids.empty())
+      break;
+
+    // a part of a term without spaces can only be found within a single word, the ids of all
+    // words containing it are collected and merged at once, a short part may be in most words
+    std::vector<int> partIds;
+    for (const auto& word : m_words)
+    {
+      if (word.first.find(parts[i]) == std::string::npos)
+        continue;
+
+      // all texts of the word contain a term of a single part
+      if (maxIds > 0 && parts.size() == 1 && word.second.size() > maxIds)
+      {
+        ids.clear();
+        return false;
+      }
+      partIds.insert(partIds.end(), word.second.begin(), word.second.end());
+    }
+    std::sort(partIds.begin(), partIds.end());
+    partIds.erase(std::unique(partIds.begin(), partIds.end()), partIds.end());
+
+    if (i > 0)
+      ids = Intersect(ids, partIds);
+    else
+      ids.swap(partIds);
+  }
+
+  if (maxIds > 0 && ids.size() > maxIds)
+  {
+    ids.clear();
+    return false;
+  }
+  return true;
+}
+
+bool CTextIndex::GetCandidates(const CTextSearch &search, std::vector<int> &ids) const
+{
+  // a text matches if it contains all AND terms and, if there are any, one of the OR terms
+  bool bNarrowed = false;
+  for (const auto& term : search.GetAndTerms())
+  {
+    std::vector<int> termIds;
+    if (!GetCandidates(term, termIds))
+      continue;
+
+    ids = bNarrowed ? Intersect(ids, termIds) : termIds;
+    bNarrowed = true;
+  }
+
+  if (!search.GetOrTerms().empty())
+  {
+    std::vector<int> orIds;
+    bool bOrNarrowed = true;
+    for (const auto& term : search.GetOrTerms())
+    {
+      std::vector<int> termIds;
+      if (!GetCandidates(term, termIds))
+      {
+        bOrNarrowed = false;
+        break;
+      }
+      orIds = Unite(orIds, termIds);
+    }
+
+    if (bOrNarrowed)
+    {
+      ids = bNarrowed ? Intersect(ids, orIds) : orIds;
+      bNarrowed = true;
+    }
+  }
+
+  return bNarrowed;
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class CTextSearch;
+
+/*!
+ \brief Word index narrowing down which texts a CTextSearch can match.
+
+ Texts are split into words at whitespace, and each distinct word keeps the ids of the texts
+ it occurs in. A search term can only be found in a text if each of its words is part of a word
+ of the text, so looking up the few distinct words containing the term gives all texts that may
+ match. The texts found still have to be checked with CTextSearch, which makes the index exact.
+ */
+class CTextIndex
+{
+public:
+  /*! \brief Remove all texts from the index
+   */
+  void Clear();
+
+  /*! \brief Add a text to the index
+   \param id the id of the text, a text may be added in several parts with the same id.
+   \param text the text.
+   */
+  void Add(int id, const std::string &text);
+
+  /*! \brief Remove a text from the index
+   \param id the id of the text.
+   \param text the text as it was added, all its parts if it was added in several.
+   */
+  void Remove(int id, const std::string &text);
+
+  /*! \brief Get the texts that may contain the given term
+   \param term the term to look for.
+   \param ids [out] the ids of the texts that may contain the term, in increasing order.
+   \param maxIds the most texts worth narrowing down to, 0 for no limit.
+   \return false if the term has no words to look up, i.e. every text may contain it, or if
+           more than maxIds texts may contain it. Looking up stops as soon as that is known.
+   */
+  bool GetCandidates(const std::string &term, std::vector<int> &ids, size_t maxIds = 0) const;
+
+  /*! \brief Get the texts that may match the given search
+   \param search the search.
+   \param ids [out] the ids of the texts that may match, in increasing order.
+   \return false if the search can't be narrowed down, i.e. every text may match it.
+   */
+  bool GetCandidates(const CTextSearch &search, std::vector<int> &ids) const;
+
+  size_t GetWordCount() const { return m_words.size(); }
+
+  /*! \brief The number of ids kept for all words, which is what the index mostly takes memory for
+   */
+  size_t GetIdCount() const { return m_idCount; }
+
+private:
+  std::unordered_map<std::string, std::vector<int>> m_words;
+  size_t m_idCount = 0;
+};
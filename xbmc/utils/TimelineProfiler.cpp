@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TimelineProfiler.h"
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <chrono>
+
+namespace
+{
+struct ThreadRing
+{
+  std::shared_ptr<void> ring;
+  unsigned int generation = 0;
+};
+
+thread_local ThreadRing threadRing;
+}
+
+const size_t CTimelineProfiler::RING_SIZE;
+const unsigned int CTimelineProfiler::SAMPLE_INTERVAL;
+std::atomic<bool> CTimelineProfiler::m_running{false};
+std::atomic<unsigned int> CTimelineProfiler::m_frame{0};
+
+CTimelineProfiler &CTimelineProfiler::GetInstance()
+{
+  static CTimelineProfiler instance;
+  return instance;
+}
+
+void CTimelineProfiler::Start()
+{
+  CSingleLock lock(m_critSection);
+  m_running = false;
+  // threads still holding a ring of the previous run will notice the new
+  // generation and register a new ring on their next span
+  m_rings.clear();
+  ++m_generation;
+  m_frame = 0;
+  m_running = true;
+  CLog::Log(LOGINFO, "CTimelineProfiler: started recording");
+}
+
+void CTimelineProfiler::Stop()
+{
+  m_running = false;
+  CLog::Log(LOGINFO, "CTimelineProfiler: stopped recording");
+}
+
+int64_t CTimelineProfiler::Now()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CTimelineProfiler::AddSpan(const char *category, const char *name, int64_t start, int64_t end)
+{
+  if (!IsRunning())
+    return;
+
+  CRing *ring = GetRing();
+  if (ring)
+    ring->Add({ category, name, start, end - start });
+}
+
+void CTimelineProfiler::AddInstant(const char *category, const char *name)
+{
+  if (!IsRunning())
+    return;
+
+  CRing *ring = GetRing();
+  if (ring)
+    ring->Add({ category, name, Now(), -1 });
+}
+
+CTimelineProfiler::CRing *CTimelineProfiler::GetRing()
+{
+  const unsigned int generation = m_generation.load(std::memory_order_acquire);
+  if (!threadRing.ring || threadRing.generation != generation)
+  {
+    // first span of this thread in this run - the only time we take the lock
+    auto ring = std::make_shared<CRing>(CThread::GetCurrentThreadNativeId());
+    CSingleLock lock(m_critSection);
+    if (generation != m_generation)
+      return nullptr;
+    m_rings.push_back(ring);
+    threadRing.ring = ring;
+    threadRing.generation = generation;
+  }
+  return static_cast<CRing*>(threadRing.ring.get());
+}
+
+void CTimelineProfiler::CRing::Copy(std::vector<Span> &spans) const
+{
+  const uint64_t written = m_written.load(std::memory_order_acquire);
+  uint64_t first = 0;
+  if (written > RING_SIZE)
+  {
+    // the oldest spans may be overwritten while we copy them if the thread is
+    // still recording, so leave those out
+    first = written - RING_SIZE + RING_SIZE / 16;
+  }
+
+  for (uint64_t i = first; i < written; ++i)
+    spans.push_back(m_spans[i % RING_SIZE]);
+}
+
+void CTimelineProfiler::GetChromeTrace(CVariant &trace) const
+{
+  trace = CVariant(CVariant::VariantTypeObject);
+  trace["displayTimeUnit"] = "ms";
+  trace["traceEvents"] = CVariant(CVariant::VariantTypeArray);
+  CVariant &events = trace["traceEvents"];
+
+  std::vector<std::shared_ptr<CRing>> rings;
+  {
+    CSingleLock lock(m_critSection);
+    rings = m_rings;
+  }
+
+  std::vector<Span> spans;
+  for (const auto& ring : rings)
+  {
+    spans.clear();
+    ring->Copy(spans);
+
+    for (const auto& span : spans)
+    {
+      CVariant event(CVariant::VariantTypeObject);
+      event["name"] = span.name;
+      event["cat"] = span.category;
+      event["pid"] = 1;
+      event["tid"] = ring->GetThreadId();
+      event["ts"] = span.start;
+      if (span.duration >= 0)
+      {
+        event["ph"] = "X";
+        event["dur"] = span.duration;
+      }
+      else
+      {
+        event["ph"] = "i";
+        event["s"] = "t";
+      }
+      events.push_back(std::move(event));
+    }
+  }
+}
+
+bool CTimelineProfiler::SaveChromeTrace(const std::string &path) const
+{
+  CVariant trace;
+  GetChromeTrace(trace);
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(trace, json, true))
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CTimelineProfiler: failed to write timeline to %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CTimelineProfiler: wrote %u events to %s",
+            static_cast<unsigned int>(trace["traceEvents"].size()), path.c_str());
+  return true;
+}
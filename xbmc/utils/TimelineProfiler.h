@@ -0,0 +1,173 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Records a timeline of what the application does per frame.
+
+ Spans are recorded into a fixed size ring buffer per thread, so recording is lock
+ free and doesn't allocate. Once a ring is full the oldest spans are overwritten.
+ The recorded timeline can be exported in the Chrome trace event format, which can
+ be loaded into chrome://tracing or https://ui.perfetto.dev.
+
+ Category and name of a span are not copied and must be string literals.
+
+ Code running many times per frame, like the evaluation of info labels and bools,
+ would fill the rings within a few frames. Its spans are only recorded on one frame
+ out of SAMPLE_INTERVAL, see IsSampling().
+
+ \sa CTimelineScope
+ */
+class CTimelineProfiler
+{
+public:
+  static CTimelineProfiler &GetInstance();
+
+  static bool IsRunning() { return m_running.load(std::memory_order_relaxed); }
+
+  /*! \brief Whether spans of code running many times per frame are recorded for the current frame
+   */
+  static bool IsSampling()
+  {
+    return IsRunning() && m_frame.load(std::memory_order_relaxed) % SAMPLE_INTERVAL == 0;
+  }
+
+  /*! \brief Called by the application once a frame was rendered
+   */
+  static void NextFrame() { m_frame.fetch_add(1, std::memory_order_relaxed); }
+
+  /*! \brief Drop everything recorded so far and start recording.
+   */
+  void Start();
+
+  /*! \brief Stop recording. The recorded spans are kept until the next Start().
+   */
+  void Stop();
+
+  /*! \brief Record a span.
+   \param category the category of the span, e.g. "gui".
+   \param name the name of the span.
+   \param start start of the span as returned by Now().
+   \param end end of the span as returned by Now().
+   */
+  void AddSpan(const char *category, const char *name, int64_t start, int64_t end);
+
+  /*! \brief Record an event without duration.
+   \sa AddSpan
+   */
+  void AddInstant(const char *category, const char *name);
+
+  /*! \brief Current time in microseconds, as used for spans
+   */
+  static int64_t Now();
+
+  /*! \brief Get the recorded timeline as a Chrome trace event object
+   \param[out] trace object with a "traceEvents" array holding all recorded spans.
+   */
+  void GetChromeTrace(CVariant &trace) const;
+
+  /*! \brief Write the recorded timeline as Chrome trace event JSON
+   \param path the file to write to.
+   \return true on success, false otherwise.
+   */
+  bool SaveChromeTrace(const std::string &path) const;
+
+  static const size_t RING_SIZE = 8192;
+  static const unsigned int SAMPLE_INTERVAL = 30;
+
+private:
+  CTimelineProfiler() = default;
+  CTimelineProfiler(const CTimelineProfiler&) = delete;
+  CTimelineProfiler& operator=(const CTimelineProfiler&) = delete;
+
+  struct Span
+  {
+    const char *category;
+    const char *name;
+    int64_t start;
+    int64_t duration;
+  };
+
+  class CRing
+  {
+  public:
+    explicit CRing(uint64_t threadId) : m_threadId(threadId), m_spans(RING_SIZE) {}
+
+    void Add(const Span &span)
+    {
+      const uint64_t written = m_written.load(std::memory_order_relaxed);
+      m_spans[written % RING_SIZE] = span;
+      m_written.store(written + 1, std::memory_order_release);
+    }
+
+    void Copy(std::vector<Span> &spans) const;
+    uint64_t GetThreadId() const { return m_threadId; }
+
+  private:
+    const uint64_t m_threadId;
+    std::vector<Span> m_spans;
+    std::atomic<uint64_t> m_written{0};
+  };
+
+  CRing *GetRing();
+
+  static std::atomic<bool> m_running;
+  static std::atomic<unsigned int> m_frame;
+  std::atomic<unsigned int> m_generation{0};
+
+  mutable CCriticalSection m_critSection;
+  std::vector<std::shared_ptr<CRing>> m_rings;
+};
+
+/*!
+ \brief Records a span on the timeline for the lifetime of the object.
+
+ A sampled scope is only recorded on the frames CTimelineProfiler::IsSampling().
+
+ \code
+ void CGUIWindowManager::Process(unsigned int currentTime)
+ {
+   CTimelineScope scope("gui", "CGUIWindowManager::Process");
+   ...
+ }
+ \endcode
+ */
+class CTimelineScope
+{
+public:
+  CTimelineScope(const char *category, const char *name, bool sampled = false)
+    : m_category(category), m_name(name),
+      m_start((sampled ? CTimelineProfiler::IsSampling() : CTimelineProfiler::IsRunning()) ? CTimelineProfiler::Now() : -1)
+  {
+  }
+
+  ~CTimelineScope()
+  {
+    if (m_start >= 0 && CTimelineProfiler::IsRunning())
+      CTimelineProfiler::GetInstance().AddSpan(m_category, m_name, m_start, CTimelineProfiler::Now());
+  }
+
+  CTimelineScope(const CTimelineScope&) = delete;
+  CTimelineScope& operator=(const CTimelineScope&) = delete;
+
+private:
+  const char *m_category;
+  const char *m_name;
+  int64_t m_start;
+};
@@ -8,6 +8,7 @@
 
 #include "Variant.h"
 
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 #include <utility>
@@ -28,6 +29,27 @@
 #endif // TARGET_WINDOWS
 #endif // strtoll
 
+namespace
+{
+struct MemberKeyLess
+{
+  template<typename TMember>
+  bool operator()(const TMember &member, const std::string &key) const
+  {
+    return member.first < key;
+  }
+};
+
+template<typename TMap>
+typename TMap::iterator FindMember(TMap &map, const std::string &key)
+{
+  auto it = std::lower_bound(map.begin(), map.end(), key, MemberKeyLess());
+  if (it != map.end() && it->first == key)
+    return it;
+  return map.end();
+}
+}
+
 std::string trimRight(const std::string &str)
 {
   std::string tmp = str;
@@ -121,6 +143,8 @@ CVariant::CVariant()
 {
 }
 
+const size_t CVariant::SMALL_STRING_SIZE;
+const unsigned char CVariant::HEAP_STRING;
 CVariant CVariant::ConstNullVariant = CVariant::VariantTypeConstNull;
 CVariant::VariantArray CVariant::EMPTY_ARRAY;
 CVariant::VariantMap CVariant::EMPTY_MAP;
@@ -144,7 +168,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      SetString("", 0);
       break;
     case VariantTypeWideString:
       m_data.wstring = new std::wstring();
@@ -208,25 +232,25 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  SetString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  SetString(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  SetString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::string &&str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  SetString(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
@@ -266,8 +290,9 @@ CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
   m_type = VariantTypeObject;
   m_data.map = new VariantMap;
+  m_data.map->reserve(strMap.size());
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); ++it)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    m_data.map->emplace_back(it->first, CVariant(it->second));
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
@@ -282,7 +307,7 @@ CVariant::CVariant(const CVariant &variant)
   *this = variant;
 }
 
-CVariant::CVariant(CVariant&& rhs)
+CVariant::CVariant(CVariant&& rhs) noexcept
 {
   //Set this so that operator= don't try and run cleanup
   //when we're not initialized.
@@ -301,8 +326,11 @@ void CVariant::cleanup()
   switch (m_type)
   {
   case VariantTypeString:
-    delete m_data.string;
-    m_data.string = nullptr;
+    if (IsHeapString())
+    {
+      delete m_data.string;
+      m_data.string = nullptr;
+    }
     break;
 
   case VariantTypeWideString:
@@ -391,7 +419,7 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(asString(), fallback);
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -417,7 +445,7 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(asString(), fallback);
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -443,7 +471,7 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(asString(), fallback);
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -464,7 +492,7 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(asString(), fallback);
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -487,9 +515,13 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+    {
+      const size_t length = StringLength();
+      if (length == 0 || (length == 1 && StringData()[0] == '0') ||
+          (length == 5 && memcmp(StringData(), "false", 5) == 0))
         return false;
       return true;
+    }
     case VariantTypeWideString:
       if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
         return false;
@@ -506,7 +538,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return std::string(StringData(), StringLength());
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -552,7 +584,12 @@ CVariant &CVariant::operator[](const std::string &key)
   }
 
   if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
+  {
+    auto it = std::lower_bound(m_data.map->begin(), m_data.map->end(), key, MemberKeyLess());
+    if (it == m_data.map->end() || it->first != key)
+      it = m_data.map->emplace(it, key, CVariant());
+    return it->second;
+  }
   else
     return ConstNullVariant;
 }
@@ -560,7 +597,7 @@ CVariant &CVariant::operator[](const std::string &key)
 const CVariant &CVariant::operator[](const std::string &key) const
 {
   VariantMap::const_iterator it;
-  if (m_type == VariantTypeObject && (it = m_data.map->find(key)) != m_data.map->end())
+  if (m_type == VariantTypeObject && (it = FindMember(*m_data.map, key)) != m_data.map->end())
     return it->second;
   else
     return ConstNullVariant;
@@ -606,7 +643,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    SetString(rhs.StringData(), rhs.StringLength());
     break;
   case VariantTypeWideString:
     m_data.wstring = new std::wstring(*rhs.m_data.wstring);
@@ -624,7 +661,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   return *this;
 }
 
-CVariant& CVariant::operator=(CVariant&& rhs)
+CVariant& CVariant::operator=(CVariant&& rhs) noexcept
 {
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
@@ -638,7 +675,7 @@ CVariant& CVariant::operator=(CVariant&& rhs)
 
   //Should be enough to just set m_type here
   //but better safe than sorry, could probably lead to coverity warnings
-  if (rhs.m_type == VariantTypeString)
+  if (rhs.m_type == VariantTypeString && rhs.IsHeapString())
     rhs.m_data.string = nullptr;
   else if (rhs.m_type == VariantTypeWideString)
     rhs.m_data.wstring = nullptr;
@@ -667,7 +704,8 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return StringLength() == rhs.StringLength() &&
+             memcmp(StringData(), rhs.StringData(), StringLength()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -719,7 +757,7 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return StringData();
   else
     return NULL;
 }
@@ -807,7 +845,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return StringLength();
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -821,7 +859,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return StringLength() == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -837,7 +875,12 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    if (IsHeapString())
+      m_data.string->clear();
+    else
+      SetString("", 0);
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
@@ -850,7 +893,20 @@ void CVariant::erase(const std::string &key)
     m_data.map = new VariantMap;
   }
   else if (m_type == VariantTypeObject)
-    m_data.map->erase(key);
+  {
+    auto it = FindMember(*m_data.map, key);
+    if (it == m_data.map->end())
+      return;
+
+    // swap the member to the end rather than moving the others onto it, moving onto
+    // a member holding a copy of ConstNullVariant would leave that member unchanged
+    for (auto next = it + 1; next != m_data.map->end(); ++it, ++next)
+    {
+      it->first.swap(next->first);
+      it->second.swap(next->second);
+    }
+    m_data.map->pop_back();
+  }
 }
 
 void CVariant::erase(unsigned int position)
@@ -868,7 +924,50 @@ void CVariant::erase(unsigned int position)
 bool CVariant::isMember(const std::string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+    return FindMember(*m_data.map, key) != m_data.map->end();
 
   return false;
 }
+
+void CVariant::SetString(const char *str, size_t length)
+{
+  if (length < SMALL_STRING_SIZE)
+  {
+    memcpy(m_data.smallString, str, length);
+    m_data.smallString[length] = '\0';
+    m_data.smallString[SMALL_STRING_SIZE - 1] = static_cast<char>(SMALL_STRING_SIZE - 1 - length);
+  }
+  else
+  {
+    m_data.string = new std::string(str, length);
+    m_data.smallString[SMALL_STRING_SIZE - 1] = static_cast<char>(HEAP_STRING);
+  }
+}
+
+void CVariant::SetString(std::string &&str)
+{
+  if (str.size() < SMALL_STRING_SIZE)
+    SetString(str.c_str(), str.size());
+  else
+  {
+    m_data.string = new std::string(std::move(str));
+    m_data.smallString[SMALL_STRING_SIZE - 1] = static_cast<char>(HEAP_STRING);
+  }
+}
+
+bool CVariant::IsHeapString() const
+{
+  return static_cast<unsigned char>(m_data.smallString[SMALL_STRING_SIZE - 1]) == HEAP_STRING;
+}
+
+const char *CVariant::StringData() const
+{
+  return IsHeapString() ? m_data.string->c_str() : m_data.smallString;
+}
+
+size_t CVariant::StringLength() const
+{
+  if (IsHeapString())
+    return m_data.string->size();
+  return SMALL_STRING_SIZE - 1 - static_cast<unsigned char>(m_data.smallString[SMALL_STRING_SIZE - 1]);
+}
@@ -64,7 +64,7 @@ public:
   CVariant(const std::map<std::string, std::string> &strMap);
   CVariant(const std::map<std::string, CVariant> &variantMap);
   CVariant(const CVariant &variant);
-  CVariant(CVariant &&rhs);
+  CVariant(CVariant &&rhs) noexcept;
   ~CVariant();
 
 
@@ -98,7 +98,7 @@ public:
   const CVariant &operator[](unsigned int position) const;
 
   CVariant &operator=(const CVariant &rhs);
-  CVariant &operator=(CVariant &&rhs);
+  CVariant &operator=(CVariant &&rhs) noexcept;
   bool operator==(const CVariant &rhs) const;
   bool operator!=(const CVariant &rhs) const { return !(*this == rhs); }
 
@@ -113,7 +113,12 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+  /*!
+   Objects are a vector of members sorted by key, most have just a few members and
+   are looked up by binary search without a heap allocation per member.
+   References to members are invalidated by adding or erasing members of the same object.
+   */
+  typedef std::vector<std::pair<std::string, CVariant>> VariantMap;
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -144,6 +149,20 @@ public:
 
 private:
   void cleanup();
+  void SetString(const char *str, size_t length);
+  void SetString(std::string &&str);
+  bool IsHeapString() const;
+  const char *StringData() const;
+  size_t StringLength() const;
+
+  /*!
+   Strings of up to SMALL_STRING_SIZE - 1 characters are stored in smallString, the last byte
+   holding the number of unused characters so it doubles as terminating zero for the longest ones.
+   Longer strings are allocated and marked with HEAP_STRING in the last byte.
+   */
+  static const size_t SMALL_STRING_SIZE = 16;
+  static const unsigned char HEAP_STRING = 0xFF;
+
   union VariantUnion
   {
     int64_t integer;
@@ -151,6 +170,7 @@ private:
     bool boolean;
     double dvalue;
     std::string *string;
+    char smallString[SMALL_STRING_SIZE];
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
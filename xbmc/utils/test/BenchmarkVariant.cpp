@@ -0,0 +1,237 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+/*
+ * Built as an executable of its own, as counting the heap allocations and the memory in use means
+ * replacing the global operator new, which mustn't affect the other tests.
+ */
+
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::atomic<size_t> allocations(0);
+std::atomic<size_t> bytesInUse(0);
+std::atomic<size_t> peakBytesInUse(0);
+
+// every allocation is preceded by its size, keeping the alignment malloc gives
+const size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void ResetPeak()
+{
+  peakBytesInUse = bytesInUse.load();
+}
+}
+
+void* operator new(size_t size)
+{
+  allocations++;
+  char *ptr = static_cast<char*>(malloc(HEADER_SIZE + size));
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+
+  *reinterpret_cast<size_t*>(ptr) = size;
+  const size_t inUse = bytesInUse += size;
+  size_t peak = peakBytesInUse;
+  while (inUse > peak && !peakBytesInUse.compare_exchange_weak(peak, inUse))
+    ;
+  return ptr + HEADER_SIZE;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (ptr == nullptr)
+    return;
+
+  char *block = static_cast<char*>(ptr) - HEADER_SIZE;
+  bytesInUse -= *reinterpret_cast<size_t*>(block);
+  free(block);
+}
+
+void operator delete(void *ptr, size_t size) noexcept
+{
+  operator delete(ptr);
+}
+
+namespace
+{
+std::string CreateLibraryResponse(int movies)
+{
+  // a typical VideoLibrary.GetMovies response
+  CVariant response(CVariant::VariantTypeObject);
+  response["jsonrpc"] = "2.0";
+  response["id"] = 1;
+  CVariant result(CVariant::VariantTypeObject);
+  for (int i = 0; i < movies; i++)
+  {
+    CVariant movie(CVariant::VariantTypeObject);
+    movie["movieid"] = i;
+    movie["label"] = "Movie " + std::to_string(i);
+    movie["title"] = "Movie " + std::to_string(i);
+    movie["year"] = 1950 + i % 70;
+    movie["rating"] = 6.5;
+    movie["playcount"] = i % 3;
+    movie["runtime"] = 5400 + i;
+    movie["genre"].push_back("Drama");
+    movie["genre"].push_back("Comedy");
+    movie["file"] = "/movies/Movie " + std::to_string(i) + ".mkv";
+    movie["thumbnail"] = "image://%2fmovies%2fMovie%20" + std::to_string(i) + ".jpg/";
+    result["movies"].push_back(std::move(movie));
+  }
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = movies;
+  result["limits"]["total"] = movies;
+  response["result"] = std::move(result);
+
+  std::string json;
+  CJSONVariantWriter::Write(response, json, true);
+  return json;
+}
+
+CVariant CreateSongs(int songs)
+{
+  // a synthetic AudioLibrary.GetSongs result
+  CVariant result(CVariant::VariantTypeObject);
+  CVariant& items = result["songs"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < songs; i++)
+  {
+    CVariant song(CVariant::VariantTypeObject);
+    song["songid"] = i;
+    song["label"] = "Song " + std::to_string(i);
+    song["title"] = "Song " + std::to_string(i);
+    song["album"] = "Album " + std::to_string(i / 12);
+    song["artist"].push_back("Artist " + std::to_string(i / 120));
+    song["duration"] = 180 + i % 120;
+    song["rating"] = 7.5;
+    song["file"] = "/music/Artist " + std::to_string(i / 120) + "/Album " + std::to_string(i / 12) + "/" + std::to_string(i) + ".flac";
+    song["genre"] = CVariant(CVariant::VariantTypeArray);
+    items.push_back(std::move(song));
+  }
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = songs;
+  result["limits"]["total"] = songs;
+  return result;
+}
+}
+
+TEST(BenchmarkVariant, Payloads)
+{
+  const std::string request = "{\"jsonrpc\":\"2.0\",\"method\":\"Player.GetItem\",\"id\":\"VideoGetItem\","
+    "\"params\":{\"playerid\":1,\"properties\":[\"title\",\"album\",\"artist\",\"season\",\"episode\","
+    "\"duration\",\"showtitle\",\"tvshowid\",\"thumbnail\",\"file\",\"fanart\",\"streamdetails\"]}}";
+  const std::string response = CreateLibraryResponse(1000);
+  const int requests = 10000;
+  const int responses = 20;
+
+  CVariant variant;
+  auto begin = std::chrono::steady_clock::now();
+  size_t before = allocations;
+  for (int i = 0; i < requests; i++)
+    ASSERT_TRUE(CJSONVariantParser::Parse(request, variant));
+  const size_t requestAllocations = (allocations - before) / requests;
+  const auto requestTime = std::chrono::steady_clock::now() - begin;
+  EXPECT_STREQ("Player.GetItem", variant["method"].c_str());
+  EXPECT_EQ(12u, variant["params"]["properties"].size());
+
+  begin = std::chrono::steady_clock::now();
+  before = allocations;
+  for (int i = 0; i < responses; i++)
+    ASSERT_TRUE(CJSONVariantParser::Parse(response, variant));
+  const size_t responseAllocations = (allocations - before) / responses;
+  const auto responseTime = std::chrono::steady_clock::now() - begin;
+  EXPECT_EQ(1000u, variant["result"]["movies"].size());
+
+  begin = std::chrono::steady_clock::now();
+  before = allocations;
+  std::string json;
+  for (int i = 0; i < responses; i++)
+    ASSERT_TRUE(CJSONVariantWriter::Write(variant, json, true));
+  const size_t writeAllocations = (allocations - before) / responses;
+  const auto writeTime = std::chrono::steady_clock::now() - begin;
+  EXPECT_EQ(response, json);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  RecordProperty("requestAllocations", static_cast<int>(requestAllocations));
+  RecordProperty("requestNanoseconds", static_cast<int>(std::chrono::duration_cast<std::chrono::nanoseconds>(requestTime).count() / requests));
+  RecordProperty("responseAllocations", static_cast<int>(responseAllocations));
+  RecordProperty("responseMicroseconds", static_cast<int>(duration_cast<microseconds>(responseTime).count() / responses));
+  RecordProperty("writeAllocations", static_cast<int>(writeAllocations));
+  RecordProperty("writeMicroseconds", static_cast<int>(duration_cast<microseconds>(writeTime).count() / responses));
+}
+
+TEST(BenchmarkVariant, LargeLibraryResponse)
+{
+  const int songs = 50000;
+
+  // the result a method handler builds, which both ways of sending it start with
+  size_t before = bytesInUse;
+  ResetPeak();
+  CVariant result = CreateSongs(songs);
+  const size_t resultBytes = bytesInUse - before;
+
+  // the response used to get a copy of the result and was serialized into a string, which the
+  // web server copied once more. rapidjson's own buffer comes on top, it isn't allocated with new.
+  size_t jsonBytes = 0;
+  {
+    CVariant response(CVariant::VariantTypeObject);
+    response["jsonrpc"] = "2.0";
+    response["id"] = 1;
+    response["result"] = result;
+    std::string json;
+    ASSERT_TRUE(CJSONVariantWriter::Write(response, json, true));
+    const std::string sent(json);
+    jsonBytes = sent.size();
+  }
+  const size_t stringPeakBytes = peakBytesInUse - before;
+
+  // now the result is moved into the response, which is serialized piece by piece as it's sent
+  before = bytesInUse;
+  ResetPeak();
+  size_t streamed = 0;
+  {
+    CVariant response(CVariant::VariantTypeObject);
+    response["jsonrpc"] = "2.0";
+    response["id"] = 1;
+    response["result"] = std::move(result);
+    CJSONVariantStreamWriter writer(response, true);
+    char piece[65536];
+    size_t size;
+    while ((size = writer.Read(piece, sizeof(piece))) > 0)
+      streamed += size;
+    EXPECT_TRUE(writer.IsComplete());
+  }
+  const size_t streamPeakBytes = resultBytes + peakBytesInUse - before;
+
+  EXPECT_EQ(jsonBytes, streamed);
+
+  RecordProperty("songs", songs);
+  RecordProperty("jsonBytes", static_cast<int>(jsonBytes));
+  RecordProperty("resultBytes", static_cast<int>(resultBytes));
+  RecordProperty("stringPeakBytes", static_cast<int>(stringPeakBytes));
+  RecordProperty("streamPeakBytes", static_cast<int>(streamPeakBytes));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
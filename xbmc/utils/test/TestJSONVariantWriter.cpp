@@ -9,6 +9,8 @@
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+#include <string>
+
 #include <gtest/gtest.h>
 
 TEST(TestJSONVariantWriter, CanWriteNull)
@@ -149,3 +151,83 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+namespace
+{
+CVariant CreateLibrary(int songs)
+{
+  // a synthetic AudioLibrary.GetSongs result
+  CVariant result(CVariant::VariantTypeObject);
+  CVariant& items = result["songs"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < songs; i++)
+  {
+    CVariant song(CVariant::VariantTypeObject);
+    song["songid"] = i;
+    song["label"] = "Song " + std::to_string(i);
+    song["title"] = "Song " + std::to_string(i);
+    song["album"] = "Album " + std::to_string(i / 12);
+    song["artist"].push_back("Artist " + std::to_string(i / 120));
+    song["duration"] = 180 + i % 120;
+    song["rating"] = 7.5;
+    song["file"] = "/music/Artist " + std::to_string(i / 120) + "/Album " + std::to_string(i / 12) + "/" + std::to_string(i) + ".flac";
+    song["genre"] = CVariant(CVariant::VariantTypeArray);
+    items.push_back(std::move(song));
+  }
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = songs;
+  result["limits"]["total"] = songs;
+  return result;
+}
+}
+
+TEST(TestJSONVariantWriter, StreamMatchesString)
+{
+  CVariant variant = CreateLibrary(100);
+  variant["empty"]["array"] = CVariant(CVariant::VariantTypeArray);
+  variant["empty"]["object"] = CVariant(CVariant::VariantTypeObject);
+  variant["escaped"] = "\"quoted\"\n";
+
+  for (bool compact : { true, false })
+  {
+    std::string expected;
+    ASSERT_TRUE(CJSONVariantWriter::Write(variant, expected, compact));
+
+    std::string streamed;
+    ASSERT_TRUE(CJSONVariantWriter::Write(variant, [&streamed](const char *data, size_t size) {
+      streamed.append(data, size);
+      return true;
+    }, compact));
+    EXPECT_EQ(expected, streamed);
+
+    // in pieces smaller than most values
+    CJSONVariantStreamWriter stream(variant, compact);
+    std::string pieces;
+    char buffer[3];
+    size_t size;
+    while ((size = stream.Read(buffer, sizeof(buffer))) > 0)
+      pieces.append(buffer, size);
+    EXPECT_TRUE(stream.IsComplete());
+    EXPECT_EQ(expected, pieces);
+  }
+}
+
+TEST(TestJSONVariantWriter, StreamScalar)
+{
+  const CVariant variant("string");
+  CJSONVariantStreamWriter stream(variant, true);
+  char buffer[64];
+  size_t size = stream.Read(buffer, sizeof(buffer));
+  EXPECT_EQ("\"string\"", std::string(buffer, size));
+  EXPECT_EQ(0u, stream.Read(buffer, sizeof(buffer)));
+  EXPECT_TRUE(stream.IsComplete());
+}
+
+TEST(TestJSONVariantWriter, StreamStop)
+{
+  CVariant variant = CreateLibrary(10000);
+  int pieces = 0;
+  EXPECT_FALSE(CJSONVariantWriter::Write(variant, [&pieces](const char *data, size_t size) {
+    return ++pieces < 2;
+  }, true));
+  EXPECT_EQ(2, pieces);
+}
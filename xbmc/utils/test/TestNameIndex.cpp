@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/NameIndex.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string DATABASE = "/userdata/Database/MyMusic72.db";
+
+std::vector<int> Find(const CNameIndex &index, const std::string &term)
+{
+  std::vector<int> ids;
+  EXPECT_TRUE(index.Find(DATABASE, term, ids));
+  return ids;
+}
+}
+
+TEST(TestNameIndex, Find)
+{
+  CNameIndex index;
+  std::vector<int> ids;
+  EXPECT_FALSE(index.IsLoaded(DATABASE));
+  EXPECT_FALSE(index.Find(DATABASE, "news", ids));
+
+  ASSERT_TRUE(index.Load(DATABASE, index.BeginLoad(), {{3, "Yellow Submarine"}, {7, "Help!"}, {9, "Let It Be"}}));
+  EXPECT_TRUE(index.IsLoaded(DATABASE));
+  EXPECT_EQ(3u, index.GetSize());
+
+  // like a LIKE '%term%', which ignores case
+  EXPECT_EQ(std::vector<int>({3}), Find(index, "SUB"));
+  EXPECT_EQ(std::vector<int>({3}), Find(index, "w sub"));
+  EXPECT_EQ(std::vector<int>({3, 7, 9}), Find(index, "e"));
+  EXPECT_TRUE(Find(index, "it help").empty());
+
+  // the index of one database is no use for another
+  EXPECT_FALSE(index.IsLoaded("/userdata/Database/MyMusic82.db"));
+  EXPECT_FALSE(index.Find("/userdata/Database/MyMusic82.db", "sub", ids));
+}
+
+TEST(TestNameIndex, Changes)
+{
+  CNameIndex index;
+  ASSERT_TRUE(index.Load(DATABASE, index.BeginLoad(), {{1, "Abbey Road"}, {2, "Revolver"}}));
+
+  index.Set(DATABASE, 3, "Rubber Soul");
+  index.Set(DATABASE, 2, "Let It Be");
+  index.Remove(DATABASE, 1);
+  EXPECT_EQ(std::vector<int>({3}), Find(index, "soul"));
+  EXPECT_EQ(std::vector<int>({2}), Find(index, "let"));
+  EXPECT_TRUE(Find(index, "revolver").empty());
+  EXPECT_TRUE(Find(index, "abbey").empty());
+  EXPECT_EQ(2u, index.GetSize());
+
+  // changes of other databases are ignored
+  index.Set("/userdata/Database/MyMusic82.db", 4, "Rubber Soul");
+  EXPECT_EQ(std::vector<int>({3}), Find(index, "soul"));
+
+  // everything is loaded again after changes too large to apply one by one
+  index.Invalidate();
+  std::vector<int> ids;
+  EXPECT_FALSE(index.Find(DATABASE, "soul", ids));
+}
+
+TEST(TestNameIndex, ChangedWhileLoading)
+{
+  CNameIndex index;
+  const unsigned int token = index.BeginLoad();
+
+  // a song added after the names were read is missing from them
+  index.Set(DATABASE, 3, "Rubber Soul");
+  EXPECT_FALSE(index.Load(DATABASE, token, {{1, "Abbey Road"}}));
+  EXPECT_FALSE(index.IsLoaded(DATABASE));
+
+  EXPECT_TRUE(index.Load(DATABASE, index.BeginLoad(), {{1, "Abbey Road"}, {3, "Rubber Soul"}}));
+  EXPECT_EQ(std::vector<int>({3}), Find(index, "soul"));
+}
+
+TEST(TestNameIndex, SyntheticLibrary)
+{
+  // a large music library, many titles sharing their words
+  std::vector<std::pair<int, std::string>> names;
+  for (int i = 0; i < 100000; ++i)
+    names.emplace_back(i + 1, "Song " + std::to_string(i % 7919) + " Of The Album " + std::to_string(i % 311));
+  names[54321].second = "Needle In A Haystack";
+
+  CNameIndex index;
+  auto begin = std::chrono::steady_clock::now();
+  ASSERT_TRUE(index.Load(DATABASE, index.BeginLoad(), names));
+  const auto loadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  // what a LIKE '%term%' has to do for every row
+  begin = std::chrono::steady_clock::now();
+  std::vector<int> scanned;
+  for (const auto& name : names)
+  {
+    std::string lowerName(name.second);
+    StringUtils::ToLower(lowerName);
+    if (lowerName.find("haystack") != std::string::npos)
+      scanned.emplace_back(name.first);
+  }
+  const auto scanTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  begin = std::chrono::steady_clock::now();
+  const std::vector<int> found = Find(index, "haystack");
+  const auto indexTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  EXPECT_EQ(std::vector<int>({54322}), scanned);
+  EXPECT_EQ(scanned, found);
+  RecordProperty("names", static_cast<int>(names.size()));
+  RecordProperty("loadMicroseconds", static_cast<int>(loadTime.count()));
+  RecordProperty("scanMicroseconds", static_cast<int>(scanTime.count()));
+  RecordProperty("indexMicroseconds", static_cast<int>(indexTime.count()));
+}
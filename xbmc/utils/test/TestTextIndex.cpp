@@ -0,0 +1,195 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/TextIndex.h"
+#include "utils/TextSearch.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CTextIndex MakeIndex(const std::vector<std::string> &texts)
+{
+  CTextIndex index;
+  for (size_t i = 0; i < texts.size(); ++i)
+    index.Add(static_cast<int>(i), texts[i]);
+  return index;
+}
+
+// a week of programmes on 1000 channels, many of them repeats with the same title
+std::vector<std::string> CreateGuideTitles()
+{
+  std::vector<std::string> titles;
+  for (int i = 0; i < 1000 * 7 * 24; ++i)
+    titles.emplace_back("Programme " + std::to_string(i % 5000) + " Episode " + std::to_string(i % 13));
+  titles[123456] = "The Needle In The Haystack";
+  return titles;
+}
+
+std::vector<int> Candidates(const CTextIndex &index, const std::string &term)
+{
+  std::vector<int> ids;
+  EXPECT_TRUE(index.GetCandidates(CTextSearch(term), ids));
+  return ids;
+}
+}
+
+TEST(TestTextIndex, Words)
+{
+  const CTextIndex index = MakeIndex({"The News", "Sports News", "Weather"});
+  EXPECT_EQ(4u, index.GetWordCount());
+
+  std::vector<int> ids;
+  EXPECT_TRUE(index.GetCandidates("news", ids));
+  EXPECT_EQ(std::vector<int>({0, 1}), ids);
+
+  // parts of words and case
+  EXPECT_TRUE(index.GetCandidates("EAT", ids));
+  EXPECT_EQ(std::vector<int>({2}), ids);
+
+  // each part of a term with spaces must be found
+  EXPECT_TRUE(index.GetCandidates("sports news", ids));
+  EXPECT_EQ(std::vector<int>({1}), ids);
+  EXPECT_TRUE(index.GetCandidates("sports weather", ids));
+  EXPECT_TRUE(ids.empty());
+
+  EXPECT_FALSE(index.GetCandidates(" ", ids));
+}
+
+TEST(TestTextIndex, Search)
+{
+  const CTextIndex index = MakeIndex({"The News", "Sports News", "Weather", "Sports"});
+
+  // the default search mode ORs the terms
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), Candidates(index, "news weather"));
+  EXPECT_EQ(std::vector<int>({1}), Candidates(index, "sports + news"));
+  EXPECT_EQ(std::vector<int>({1}), Candidates(index, "\"sports news\""));
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), Candidates(index, "weather | sports"));
+
+  // an empty search can't be narrowed down
+  std::vector<int> ids;
+  EXPECT_FALSE(index.GetCandidates(CTextSearch(""), ids));
+}
+
+TEST(TestTextIndex, SeveralPartsPerId)
+{
+  CTextIndex index;
+  index.Add(0, "Title");
+  index.Add(0, "title outline");
+  index.Add(1, "Other");
+  EXPECT_EQ(std::vector<int>({0}), Candidates(index, "title"));
+  EXPECT_EQ(std::vector<int>({0}), Candidates(index, "outline"));
+
+  index.Clear();
+  EXPECT_TRUE(Candidates(index, "title").empty());
+}
+
+TEST(TestTextIndex, Remove)
+{
+  CTextIndex index;
+  index.Add(2, "Sports News");
+  index.Add(0, "The News");
+  index.Add(1, "Weather");
+  EXPECT_EQ(5u, index.GetIdCount());
+  EXPECT_EQ(std::vector<int>({0, 2}), Candidates(index, "news"));
+
+  index.Remove(2, "Sports News");
+  EXPECT_EQ(std::vector<int>({0}), Candidates(index, "news"));
+  EXPECT_TRUE(Candidates(index, "sports").empty());
+  EXPECT_EQ(3u, index.GetWordCount());
+  EXPECT_EQ(3u, index.GetIdCount());
+
+  // removing what isn't there changes nothing
+  index.Remove(1, "Sports");
+  index.Remove(5, "Weather");
+  EXPECT_EQ(std::vector<int>({1}), Candidates(index, "weather"));
+}
+
+TEST(TestTextIndex, Limit)
+{
+  const CTextIndex index = MakeIndex({"The News", "Sports News", "Weather", "News Sports"});
+
+  std::vector<int> ids;
+  EXPECT_TRUE(index.GetCandidates("news", ids, 3));
+  EXPECT_EQ(std::vector<int>({0, 1, 3}), ids);
+
+  // a single word in too many texts
+  EXPECT_FALSE(index.GetCandidates("news", ids, 2));
+  EXPECT_TRUE(ids.empty());
+
+  // words in few texts each that are too many together
+  EXPECT_FALSE(index.GetCandidates("e", ids, 3));
+
+  // only the texts containing all parts count
+  EXPECT_TRUE(index.GetCandidates("news sports", ids, 2));
+  EXPECT_EQ(std::vector<int>({1, 3}), ids);
+}
+
+TEST(TestTextIndex, SyntheticGuide)
+{
+  const std::vector<std::string> titles = CreateGuideTitles();
+  const CTextIndex index = MakeIndex(titles);
+  const CTextSearch search("needle");
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<int> scanned;
+  for (size_t i = 0; i < titles.size(); ++i)
+  {
+    if (search.Search(titles[i]))
+      scanned.emplace_back(static_cast<int>(i));
+  }
+  const auto scanTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  begin = std::chrono::steady_clock::now();
+  std::vector<int> found;
+  ASSERT_TRUE(index.GetCandidates(search, found));
+  const auto indexTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  EXPECT_EQ(std::vector<int>({123456}), scanned);
+  EXPECT_EQ(scanned, found);
+  RecordProperty("texts", static_cast<int>(titles.size()));
+  RecordProperty("scanMicroseconds", static_cast<int>(scanTime.count()));
+  RecordProperty("indexMicroseconds", static_cast<int>(indexTime.count()));
+}
+
+TEST(TestTextIndex, ShortTermLatency)
+{
+  const std::vector<std::string> titles = CreateGuideTitles();
+  const CTextIndex index = MakeIndex(titles);
+
+  // a digit is part of thousands of words that are in all titles together
+  std::vector<int> scanned;
+  for (size_t i = 0; i < titles.size(); ++i)
+  {
+    if (titles[i].find('1') != std::string::npos)
+      scanned.emplace_back(static_cast<int>(i));
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<int> found;
+  ASSERT_TRUE(index.GetCandidates("1", found));
+  const auto allTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+  EXPECT_EQ(scanned, found);
+  const int candidates = static_cast<int>(found.size());
+
+  // the databases don't narrow down to more than 10000 items
+  begin = std::chrono::steady_clock::now();
+  EXPECT_FALSE(index.GetCandidates("1", found, 10000));
+  EXPECT_FALSE(index.GetCandidates("e", found, 10000));
+  const auto limitedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+  RecordProperty("texts", static_cast<int>(titles.size()));
+  RecordProperty("words", static_cast<int>(index.GetWordCount()));
+  RecordProperty("candidates", candidates);
+  RecordProperty("allMicroseconds", static_cast<int>(allTime.count()));
+  RecordProperty("limitedMicroseconds", static_cast<int>(limitedTime.count()));
+}
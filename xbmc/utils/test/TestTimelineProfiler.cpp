@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/TimelineProfiler.h"
+#include "utils/Variant.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+class TestTimelineProfiler : public testing::Test
+{
+protected:
+  TestTimelineProfiler() { CTimelineProfiler::GetInstance().Start(); }
+  ~TestTimelineProfiler() override { CTimelineProfiler::GetInstance().Stop(); }
+};
+
+TEST_F(TestTimelineProfiler, RecordsSpans)
+{
+  {
+    CTimelineScope scope("test", "outer");
+    CTimelineScope inner("test", "inner");
+  }
+  CTimelineProfiler::GetInstance().AddInstant("test", "instant");
+
+  CVariant trace;
+  CTimelineProfiler::GetInstance().GetChromeTrace(trace);
+  ASSERT_TRUE(trace["traceEvents"].isArray());
+  ASSERT_EQ(3u, trace["traceEvents"].size());
+
+  const CVariant &inner = trace["traceEvents"][0];
+  EXPECT_STREQ("inner", inner["name"].asString().c_str());
+  EXPECT_STREQ("test", inner["cat"].asString().c_str());
+  EXPECT_STREQ("X", inner["ph"].asString().c_str());
+  EXPECT_GE(inner["dur"].asInteger(), 0);
+
+  const CVariant &outer = trace["traceEvents"][1];
+  EXPECT_STREQ("outer", outer["name"].asString().c_str());
+  EXPECT_LE(outer["ts"].asInteger(), inner["ts"].asInteger());
+  EXPECT_GE(outer["dur"].asInteger(), inner["dur"].asInteger());
+
+  const CVariant &instant = trace["traceEvents"][2];
+  EXPECT_STREQ("i", instant["ph"].asString().c_str());
+  EXPECT_FALSE(instant.isMember("dur"));
+}
+
+TEST_F(TestTimelineProfiler, SeparatesThreads)
+{
+  CTimelineProfiler::GetInstance().AddInstant("test", "main");
+  std::thread thread([]() { CTimelineProfiler::GetInstance().AddInstant("test", "thread"); });
+  thread.join();
+
+  CVariant trace;
+  CTimelineProfiler::GetInstance().GetChromeTrace(trace);
+  ASSERT_EQ(2u, trace["traceEvents"].size());
+  EXPECT_NE(trace["traceEvents"][0]["tid"].asUnsignedInteger(),
+            trace["traceEvents"][1]["tid"].asUnsignedInteger());
+}
+
+TEST_F(TestTimelineProfiler, IgnoresSpansWhenStopped)
+{
+  CTimelineProfiler::GetInstance().AddInstant("test", "recorded");
+  CTimelineProfiler::GetInstance().Stop();
+  CTimelineProfiler::GetInstance().AddInstant("test", "dropped");
+
+  CVariant trace;
+  CTimelineProfiler::GetInstance().GetChromeTrace(trace);
+  ASSERT_EQ(1u, trace["traceEvents"].size());
+  EXPECT_STREQ("recorded", trace["traceEvents"][0]["name"].asString().c_str());
+}
+
+TEST_F(TestTimelineProfiler, StartClearsTimeline)
+{
+  CTimelineProfiler::GetInstance().AddInstant("test", "old");
+  CTimelineProfiler::GetInstance().Start();
+  CTimelineProfiler::GetInstance().AddInstant("test", "new");
+
+  CVariant trace;
+  CTimelineProfiler::GetInstance().GetChromeTrace(trace);
+  ASSERT_EQ(1u, trace["traceEvents"].size());
+  EXPECT_STREQ("new", trace["traceEvents"][0]["name"].asString().c_str());
+}
+
+TEST_F(TestTimelineProfiler, OverwritesOldestSpans)
+{
+  for (size_t i = 0; i < CTimelineProfiler::RING_SIZE * 2; i++)
+    CTimelineProfiler::GetInstance().AddSpan("test", "span", i, i + 1);
+
+  CVariant trace;
+  CTimelineProfiler::GetInstance().GetChromeTrace(trace);
+  ASSERT_GT(trace["traceEvents"].size(), 0u);
+  EXPECT_LE(trace["traceEvents"].size(), CTimelineProfiler::RING_SIZE);
+  // the newest span is always kept
+  const CVariant &last = trace["traceEvents"][trace["traceEvents"].size() - 1];
+  EXPECT_EQ(static_cast<int64_t>(CTimelineProfiler::RING_SIZE * 2 - 1), last["ts"].asInteger());
+}
+
+TEST_F(TestTimelineProfiler, SamplesFrames)
+{
+  for (unsigned int frame = 0; frame < CTimelineProfiler::SAMPLE_INTERVAL * 3; frame++)
+  {
+    CTimelineScope sampled("test", "sampled", true);
+    CTimelineScope scope("test", "frame");
+    CTimelineProfiler::NextFrame();
+  }
+
+  CVariant trace;
+  CTimelineProfiler::GetInstance().GetChromeTrace(trace);
+  unsigned int frames = 0;
+  unsigned int sampled = 0;
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    if ((*it)["name"].asString() == "frame")
+      frames++;
+    else if ((*it)["name"].asString() == "sampled")
+      sampled++;
+  }
+  EXPECT_EQ(CTimelineProfiler::SAMPLE_INTERVAL * 3, frames);
+  // the first frame after Start() is always sampled
+  EXPECT_EQ(3u, sampled);
+}
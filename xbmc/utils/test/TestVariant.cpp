@@ -332,3 +332,80 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, SmallString)
+{
+  // up to 15 characters are kept within the variant
+  CVariant a("");
+  CVariant b("123456789012345");
+  CVariant c("1234567890123456");
+  CVariant d(std::string("with\0nul", 8));
+
+  EXPECT_TRUE(a.empty());
+  EXPECT_STREQ("", a.c_str());
+  EXPECT_EQ(15u, b.size());
+  EXPECT_STREQ("123456789012345", b.c_str());
+  EXPECT_EQ(16u, c.size());
+  EXPECT_STREQ("1234567890123456", c.c_str());
+  EXPECT_EQ(8u, d.size());
+  EXPECT_EQ(std::string("with\0nul", 8), d.asString());
+
+  CVariant e(b), f(c);
+  EXPECT_EQ(b, e);
+  EXPECT_EQ(c, f);
+  EXPECT_NE(b, f);
+
+  CVariant g(std::move(e)), h(std::move(f));
+  EXPECT_TRUE(e.isNull());
+  EXPECT_STREQ("123456789012345", g.c_str());
+  EXPECT_STREQ("1234567890123456", h.c_str());
+
+  g.swap(h);
+  EXPECT_STREQ("1234567890123456", g.c_str());
+  EXPECT_STREQ("123456789012345", h.c_str());
+
+  g.clear();
+  h.clear();
+  EXPECT_TRUE(g.empty());
+  EXPECT_TRUE(h.empty());
+  EXPECT_STREQ("", g.c_str());
+
+  EXPECT_EQ(42, CVariant("42").asInteger());
+  EXPECT_EQ(1.5, CVariant("1.5").asDouble());
+  EXPECT_FALSE(CVariant("false").asBoolean(true));
+  EXPECT_TRUE(CVariant("1234567890123456").asBoolean());
+}
+
+TEST(TestVariant, ObjectOrder)
+{
+  CVariant a(CVariant::VariantTypeObject);
+  a["title"] = "b";
+  a["album"] = 2;
+  a["year"] = 3;
+  a["artist"].push_back("d");
+  a["album"] = "a";
+
+  ASSERT_EQ(4u, a.size());
+  std::vector<std::string> keys;
+  for (CVariant::const_iterator_map it = a.begin_map(); it != a.end_map(); ++it)
+    keys.push_back(it->first);
+  EXPECT_EQ(std::vector<std::string>({ "album", "artist", "title", "year" }), keys);
+  EXPECT_STREQ("a", a["album"].c_str());
+
+  // objects compare equal independent of the order their members were added
+  CVariant b(CVariant::VariantTypeObject);
+  b["year"] = 3;
+  b["album"] = "a";
+  b["artist"].push_back("d");
+  b["title"] = "b";
+  EXPECT_EQ(a, b);
+
+  // a null member removed from the middle leaves the others untouched
+  a["genre"] = CVariant::ConstNullVariant;
+  a.erase("genre");
+  a.erase("artist");
+  EXPECT_EQ(3u, a.size());
+  EXPECT_FALSE(a.isMember("genre"));
+  EXPECT_STREQ("b", a["title"].c_str());
+  EXPECT_EQ(3, a["year"].asInteger());
+}
@@ -47,6 +47,7 @@
 #include "utils/FileUtils.h"
 #include "utils/GroupUtils.h"
 #include "utils/LabelFormatter.h"
+#include "utils/NameIndex.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -69,6 +70,10 @@ using namespace ADDON;
 using namespace KODI::MESSAGING;
 using namespace KODI::GUILIB;
 
+// titles searched for, shared by all connections and kept up to date when items are added, changed or removed
+static CNameIndex movieSearchIndex;
+static CNameIndex tvshowSearchIndex;
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -2501,6 +2506,7 @@ int CVideoDatabase::SetDetailsForMovie(const std::string& strFilenameAndPath, CV
       sql += PrepareSQL(", premiered = '%i'", details.GetYear());
     sql += PrepareSQL(" where idMovie=%i", idMovie);
     m_pDS->exec(sql);
+    movieSearchIndex.Set(GetSearchIndexKey(), idMovie, details.m_strTitle);
     CommitTransaction();
 
     return idMovie;
@@ -2601,6 +2607,7 @@ int CVideoDatabase::UpdateDetailsForMovie(int idMovie, CVideoInfoTag& details, c
       sql += PrepareSQL(", premiered = '%i'", details.GetYear());
     sql += PrepareSQL(" where idMovie=%i", idMovie);
     m_pDS->exec(sql);
+    movieSearchIndex.Set(GetSearchIndexKey(), idMovie, details.m_strTitle);
 
     CommitTransaction();
 
@@ -2761,6 +2768,7 @@ bool CVideoDatabase::UpdateDetailsForTvShow(int idTvShow, CVideoInfoTag &details
   sql += PrepareSQL(" WHERE idShow=%i", idTvShow);
   if (ExecuteQuery(sql))
   {
+    tvshowSearchIndex.Set(GetSearchIndexKey(), idTvShow, details.m_strTitle);
     CommitTransaction();
     return true;
   }
@@ -3480,6 +3488,7 @@ void CVideoDatabase::DeleteMovie(int idMovie, bool bKeepId /* = false */)
 
       std::string strSQL = PrepareSQL("delete from movie where idMovie=%i", idMovie);
       m_pDS->exec(strSQL);
+      movieSearchIndex.Remove(GetSearchIndexKey(), idMovie);
     }
 
     //! @todo move this below CommitTransaction() once UPnP doesn't rely on this anymore
@@ -3538,6 +3547,7 @@ void CVideoDatabase::DeleteTvShow(int idTvShow, bool bKeepId /* = false */)
     {
       strSQL=PrepareSQL("delete from tvshow where idShow=%i", idTvShow);
       m_pDS->exec(strSQL);
+      tvshowSearchIndex.Remove(GetSearchIndexKey(), idTvShow);
 
       for (const auto &i : paths)
       {
@@ -4772,6 +4782,35 @@ bool CVideoDatabase::GetArtTypes(const MediaType &mediaType, std::vector<std::st
   return false;
 }
 
+bool CVideoDatabase::GetArtURLs(std::vector<std::string> &urls)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    int numRows = RunQuery("SELECT DISTINCT url FROM art");
+    if (numRows <= 0)
+      return numRows == 0;
+
+    urls.reserve(urls.size() + numRows);
+    while (!m_pDS->eof())
+    {
+      urls.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 namespace
 {
 std::vector<std::string> GetBasicItemAvailableArtTypes(const CVideoInfoTag& tag)
@@ -8532,6 +8571,15 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
       strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
     else
       strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+
+    // the index narrows the search down to the movies whose title contains the term
+    std::string movieIds;
+    if (FindInSearchIndex(movieSearchIndex, "movie", "idMovie", StringUtils::Format("c%02d", VIDEODB_ID_TITLE), strSearch, movieIds))
+    {
+      if (movieIds.empty())
+        return;
+      strSQL += " AND movie.idMovie IN (" + movieIds + ")";
+    }
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8579,6 +8627,15 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
       strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
     else
       strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+
+    // the index narrows the search down to the shows whose title contains the term
+    std::string tvshowIds;
+    if (FindInSearchIndex(tvshowSearchIndex, "tvshow", "idShow", StringUtils::Format("c%02d", VIDEODB_ID_TV_TITLE), strSearch, tvshowIds))
+    {
+      if (tvshowIds.empty())
+        return;
+      strSQL += " AND tvshow.idShow IN (" + tvshowIds + ")";
+    }
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9100,6 +9157,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
       CLog::Log(LOGDEBUG, LOGDATABASE, "%s: Cleaning movie table", __FUNCTION__);
       sql = "DELETE FROM movie WHERE idMovie IN " + moviesToDelete;
       m_pDS->exec(sql);
+      for (const auto &i : movieIDs)
+        movieSearchIndex.Remove(GetSearchIndexKey(), i);
     }
 
     if (!episodeIDs.empty())
@@ -9175,6 +9234,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     {
       sql = "DELETE FROM tvshow WHERE idShow IN (" + StringUtils::TrimRight(tvshowsToDelete, ",") + ")";
       m_pDS->exec(sql);
+      for (const auto &i : tvshowIDs)
+        tvshowSearchIndex.Remove(GetSearchIndexKey(), i);
     }
 
     if (!musicVideoIDs.empty())
@@ -10223,6 +10284,14 @@ bool CVideoDatabase::CommitTransaction()
   return false;
 }
 
+void CVideoDatabase::RollbackTransaction()
+{
+  CDatabase::RollbackTransaction();
+  // titles changed in the transaction are back to what they were
+  movieSearchIndex.Invalidate();
+  tvshowSearchIndex.Invalidate();
+}
+
 bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue)
 {
   std::string strSQL;
@@ -10256,7 +10325,14 @@ bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbF
     if (strTable.empty())
       return false;
 
-    return SetSingleValue(strTable, StringUtils::Format("c%02u", dbField), strValue, strField, dbId);
+    if (!SetSingleValue(strTable, StringUtils::Format("c%02u", dbField), strValue, strField, dbId))
+      return false;
+
+    if (type == VIDEODB_CONTENT_MOVIES && dbField == VIDEODB_ID_TITLE)
+      movieSearchIndex.Set(GetSearchIndexKey(), dbId, strValue);
+    else if (type == VIDEODB_CONTENT_TVSHOWS && dbField == VIDEODB_ID_TV_TITLE)
+      tvshowSearchIndex.Set(GetSearchIndexKey(), dbId, strValue);
+    return true;
   }
   catch (...)
   {
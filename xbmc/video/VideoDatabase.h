@@ -421,6 +421,7 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+  void RollbackTransaction() override;
 
   int AddMovie(const std::string& strFilenameAndPath);
   int AddEpisode(int idShow, const std::string& strFilenameAndPath);
@@ -849,6 +850,12 @@ public:
   bool GetTvShowSeasonArt(int mediaId, std::map<int, std::map<std::string, std::string> > &seasonArt);
   bool GetArtTypes(const MediaType &mediaType, std::vector<std::string> &artTypes);
 
+  /*! \brief Fetch the urls of all art in the database, without duplicates.
+  \param urls [out] the urls of the art.
+  \return true on success, false otherwise.
+  */
+  bool GetArtURLs(std::vector<std::string> &urls);
+
   /*! \brief Fetch the distinct types of available-but-unassigned art held in the
   database for a specific media item.
   \param mediaId the id in the media table.
@@ -9,6 +9,7 @@
 #include "VideoLibraryRefreshingJob.h"
 
 #include "ServiceBroker.h"
+#include "TextureCache.h"
 #include "TextureDatabase.h"
 #include "addons/Scraper.h"
 #include "dialogs/GUIDialogSelect.h"
@@ -244,7 +245,10 @@ bool CVideoLibraryRefreshingJob::Work(CVideoDatabase &db)
     if (textureDb.Open())
     {
       for (const auto& artwork : m_item->GetArt())
+      {
         textureDb.InvalidateCachedTexture(artwork.second);
+        CTextureCache::GetInstance().InvalidateIndexedImage(artwork.second);
+      }
 
       textureDb.Close();
     }
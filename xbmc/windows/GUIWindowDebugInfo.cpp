@@ -97,21 +97,26 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     std::string strCores = g_cpuInfo.GetCoresUsageString();
     std::string lcAppName = CCompileInfo::GetAppName();
     StringUtils::ToLower(lcAppName);
+    unsigned int onDemandGlyphs, prewarmedGlyphs;
+    g_fontManager.GetGlyphCounters(onDemandGlyphs, prewarmedGlyphs);
 #if !defined(TARGET_POSIX)
-    info = StringUtils::Format("LOG: %s%s.log\nMEM: %" PRIu64"/%" PRIu64" KB - FPS: %2.1f fps\nCPU: %s%s",
+    info = StringUtils::Format("LOG: %s%s.log\nMEM: %" PRIu64"/%" PRIu64" KB - FPS: %2.1f fps - REDRAW: %3.1f%%\nGLYPHS: %u on demand, %u prewarmed\nCPU: %s%s",
                                CSpecialProtocol::TranslatePath("special://logpath").c_str(), lcAppName.c_str(),
                                stat.availPhys / 1024, stat.totalPhys / 1024, CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetSystemInfoProvider().GetFPS(),
-                               strCores.c_str(), profiling.c_str());
+                               CServiceBroker::GetGUI()->GetWindowManager().GetAverageRedrawnFraction() * 100.0f,
+                               onDemandGlyphs, prewarmedGlyphs, strCores.c_str(), profiling.c_str());
 #else
     double dCPU = m_resourceCounter.GetCPUUsage();
     std::string ucAppName = lcAppName;
     StringUtils::ToUpper(ucAppName);
     info = StringUtils::Format("LOG: %s%s.log\n"
-                                "MEM: %" PRIu64"/%" PRIu64" KB - FPS: %2.1f fps\n"
+                                "MEM: %" PRIu64"/%" PRIu64" KB - FPS: %2.1f fps - REDRAW: %3.1f%%\n"
+                                "GLYPHS: %u on demand, %u prewarmed\n"
                                 "CPU: %s (CPU-%s %4.2f%%%s)",
                                 CSpecialProtocol::TranslatePath("special://logpath").c_str(), lcAppName.c_str(),
                                 stat.availPhys / 1024, stat.totalPhys / 1024, CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetSystemInfoProvider().GetFPS(),
-                                strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
+                                CServiceBroker::GetGUI()->GetWindowManager().GetAverageRedrawnFraction() * 100.0f,
+                                onDemandGlyphs, prewarmedGlyphs, strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
   }
 